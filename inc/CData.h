@@ -16,8 +16,10 @@
 
 #include "VGlobalRunParameter.h"
 
+#include <cctype>
 #include <cstdlib>
 #include <iostream>
+#include <set>
 #include <string>
 #include <assert.h>
 
@@ -276,8 +278,12 @@ class CData
         float           Dir_Yoff;                 //!
         float           Dir_Erec;                 //!
 
+        set< string >   fUsedBranches;            //! branches registered with useBranch()
+
         CData( TTree* tree = 0, bool bMC = false, bool bShort = false );
         virtual ~CData();
+        void             activateAllBranches();
+        bool             activateUsedBranches( Long64_t iCacheSize = 30000000, bool iPrint = true );
         virtual Int_t    Cut( Long64_t entry );
         virtual Int_t    GetEntry( Long64_t entry );
         virtual Long64_t LoadTree( Long64_t entry );
@@ -285,6 +291,14 @@ class CData
         virtual void     Loop();
         virtual Bool_t   Notify();
         virtual void     Show( Long64_t entry = -1 );
+        void             useBranch( string iBranchName )
+        {
+            fUsedBranches.insert( iBranchName );
+        }
+        void             useCoreBranches();
+        void             useDirectionBranches();
+        void             useEnergyBranches();
+        void             useExpressionBranches( string iExpression );
         bool             isDeepLearner()
         {
             return fDeepLearner;
@@ -15,6 +15,9 @@
 
 #include "VGlobalRunParameter.h"
 
+#include <string>
+#include <vector>
+
 using namespace std;
 
 class Ctpars
@@ -197,6 +200,14 @@ class Ctpars
         TBranch*        b_PixelTimingT0;   //!
         TBranch*        b_PixelPE;   //!
         
+        vector< string > fBranchesWithAddress;    //! branches with branch address set in Init()
+        
+        template< typename T > void setBranchAddress( const char* iName, T* iAddress )
+        {
+            fChain->SetBranchAddress( iName, iAddress );
+            fBranchesWithAddress.push_back( iName );
+        }
+        
         Ctpars( TTree* tree = 0, bool iMC = false, unsigned int iShort = false );
         virtual ~Ctpars();
         virtual Int_t    GetEntry( Long64_t entry );
@@ -205,6 +216,7 @@ class Ctpars
         virtual void     Loop();
         virtual Bool_t   Notify();
         virtual void     Show( Long64_t entry = -1 );
+        void             disableUnusedBranches( vector< string > iUnusedBranches = vector< string >() );
         bool             isMC()
         {
             return bMC;
@@ -311,6 +323,7 @@ void Ctpars::Init( TTree* tree )
     }
     fChain = tree;
     fCurrent = -1;
+    fBranchesWithAddress.clear();
     bParameterErrors = false;
     if( fChain->GetBranchStatus( "dcen_x" ) )
     {
@@ -326,26 +339,26 @@ void Ctpars::Init( TTree* tree )
     //    (reading only a limited number of branches accelerates the reading process)
     if( bShort <= 2 )
     {
-        fChain->SetBranchAddress( "meanPedvar_Image", &meanPedvar_Image );
-        fChain->SetBranchAddress( "length", &length );
-        fChain->SetBranchAddress( "width", &width );
+        setBranchAddress( "meanPedvar_Image", &meanPedvar_Image );
+        setBranchAddress( "length", &length );
+        setBranchAddress( "width", &width );
         if( fChain->GetBranchStatus( "size2" ) )
         {
-            fChain->SetBranchAddress( "size2", &size2 );
+            setBranchAddress( "size2", &size2 );
         }
         else
         {
             size2 = 0.;
         }
-        fChain->SetBranchAddress( "size", &size );
-        fChain->SetBranchAddress( "loss", &loss );
+        setBranchAddress( "size", &size );
+        setBranchAddress( "loss", &loss );
     }
     //    bShort = 1:  read limited number of branches needed for lookup table analysis
     if( bShort <= 1 )
     {
         if( fChain->GetBranchStatus( "eventNumber" ) )
         {
-            fChain->SetBranchAddress( "eventNumber", &eventNumber );
+            setBranchAddress( "eventNumber", &eventNumber );
         }
         else
         {
@@ -353,17 +366,17 @@ void Ctpars::Init( TTree* tree )
         }
         if( fChain->GetBranchStatus( "meanPed_Image" ) )
         {
-            fChain->SetBranchAddress( "meanPed_Image", &meanPed_Image );
+            setBranchAddress( "meanPed_Image", &meanPed_Image );
         }
         else
         {
             meanPed_Image = 0.;
         }
-        fChain->SetBranchAddress( "cen_x", &cen_x );
-        fChain->SetBranchAddress( "cen_y", &cen_y );
+        setBranchAddress( "cen_x", &cen_x );
+        setBranchAddress( "cen_y", &cen_y );
         if( fChain->GetBranchStatus( "f_d" ) )
         {
-            fChain->SetBranchAddress( "f_d", &f_d );
+            setBranchAddress( "f_d", &f_d );
         }
         else
         {
@@ -371,7 +384,7 @@ void Ctpars::Init( TTree* tree )
         }
         if( fChain->GetBranchStatus( "f_s" ) )
         {
-            fChain->SetBranchAddress( "f_s", &f_s );
+            setBranchAddress( "f_s", &f_s );
         }
         else
         {
@@ -379,19 +392,19 @@ void Ctpars::Init( TTree* tree )
         }
         if( fChain->GetBranchStatus( "f_sdevxy" ) )
         {
-            fChain->SetBranchAddress( "f_sdevxy", &f_sdevxy );
+            setBranchAddress( "f_sdevxy", &f_sdevxy );
         }
         else
         {
             f_sdevxy = 0.;
         }
         
-        fChain->SetBranchAddress( "size", &size );
-        fChain->SetBranchAddress( "loss", &loss );
+        setBranchAddress( "size", &size );
+        setBranchAddress( "loss", &loss );
         if( fChain->GetBranchStatus( "fracLow" ) )
         {
         
-            fChain->SetBranchAddress( "fracLow", &fracLow );
+            setBranchAddress( "fracLow", &fracLow );
         }
         else
         {
@@ -399,44 +412,44 @@ void Ctpars::Init( TTree* tree )
         }
         if( fChain->GetBranchStatus( "fui" ) )
         {
-            fChain->SetBranchAddress( "fui", &fui );
+            setBranchAddress( "fui", &fui );
         }
         else
         {
             fui = 0.;
         }
-        fChain->SetBranchAddress( "dist", &dist );
-        fChain->SetBranchAddress( "ntubes", &ntubes );
-        fChain->SetBranchAddress( "cosphi", &cosphi );
-        fChain->SetBranchAddress( "sinphi", &sinphi );
+        setBranchAddress( "dist", &dist );
+        setBranchAddress( "ntubes", &ntubes );
+        setBranchAddress( "cosphi", &cosphi );
+        setBranchAddress( "sinphi", &sinphi );
         if( fChain->GetBranchStatus( "ntubesBNI" ) )
         {
-            fChain->SetBranchAddress( "ntubesBNI", &ntubesBNI );
+            setBranchAddress( "ntubesBNI", &ntubesBNI );
         }
         else
         {
             ntubesBNI = 0;
         }
-        fChain->SetBranchAddress( "nsat", &nsat );
+        setBranchAddress( "nsat", &nsat );
         if( fChain->GetBranchStatus( "nlowgain" ) )
         {
-            fChain->SetBranchAddress( "nlowgain", &nlowgain );
+            setBranchAddress( "nlowgain", &nlowgain );
         }
         else
         {
             nlowgain = 0;
         }
-        fChain->SetBranchAddress( "asymmetry", &asymmetry );
-        fChain->SetBranchAddress( "tgrad_x", &tgrad_x );
-        fChain->SetBranchAddress( "Fitstat", &Fitstat );
+        setBranchAddress( "asymmetry", &asymmetry );
+        setBranchAddress( "tgrad_x", &tgrad_x );
+        setBranchAddress( "Fitstat", &Fitstat );
         // errors on variables (only for LL runs)
         if( fChain->GetBranchStatus( "dcen_x" ) )
         {
-            fChain->SetBranchAddress( "dcen_x", &dcen_x );
-            fChain->SetBranchAddress( "dcen_y", &dcen_y );
-            fChain->SetBranchAddress( "dlength", &dlength );
-            fChain->SetBranchAddress( "dwidth", &dwidth );
-            fChain->SetBranchAddress( "dphi", &dphi );
+            setBranchAddress( "dcen_x", &dcen_x );
+            setBranchAddress( "dcen_y", &dcen_y );
+            setBranchAddress( "dlength", &dlength );
+            setBranchAddress( "dwidth", &dwidth );
+            setBranchAddress( "dphi", &dphi );
         }
         else
         {
@@ -448,12 +461,12 @@ void Ctpars::Init( TTree* tree )
         }
         if( fChain->GetBranchStatus( "PixelListN" ) )
         {
-            fChain->SetBranchAddress( "PixelListN", &PixelListN );
-            fChain->SetBranchAddress( "PixelID", PixelID );
-            fChain->SetBranchAddress( "PixelType", PixelType );
-            fChain->SetBranchAddress( "PixelIntensity", PixelIntensity );
-            fChain->SetBranchAddress( "PixelTimingT0", PixelTimingT0 );
-            fChain->SetBranchAddress( "PixelPE", PixelPE );
+            setBranchAddress( "PixelListN", &PixelListN );
+            setBranchAddress( "PixelID", PixelID );
+            setBranchAddress( "PixelType", PixelType );
+            setBranchAddress( "PixelIntensity", PixelIntensity );
+            setBranchAddress( "PixelTimingT0", PixelTimingT0 );
+            setBranchAddress( "PixelPE", PixelPE );
         }
         else
         {
@@ -483,7 +496,7 @@ void Ctpars::Init( TTree* tree )
         //muon analysis//
         if( fChain->GetBranchStatus( "muonX0" ) )
         {
-            fChain->SetBranchAddress( "muonX0", &muonX0 );
+            setBranchAddress( "muonX0", &muonX0 );
         }
         else
         {
@@ -491,7 +504,7 @@ void Ctpars::Init( TTree* tree )
         }
         if( fChain->GetBranchStatus( "muonY0" ) )
         {
-            fChain->SetBranchAddress( "muonY0", &muonY0 );
+            setBranchAddress( "muonY0", &muonY0 );
         }
         else
         {
@@ -499,7 +512,7 @@ void Ctpars::Init( TTree* tree )
         }
         if( fChain->GetBranchStatus( "muonRadius" ) )
         {
-            fChain->SetBranchAddress( "muonRadius", &muonRadius );
+            setBranchAddress( "muonRadius", &muonRadius );
         }
         else
         {
@@ -507,7 +520,7 @@ void Ctpars::Init( TTree* tree )
         }
         if( fChain->GetBranchStatus( "muonRSigma" ) )
         {
-            fChain->SetBranchAddress( "muonRSigma", &muonRSigma );
+            setBranchAddress( "muonRSigma", &muonRSigma );
         }
         else
         {
@@ -515,7 +528,7 @@ void Ctpars::Init( TTree* tree )
         }
         if( fChain->GetBranchStatus( "muonSize" ) )
         {
-            fChain->SetBranchAddress( "muonSize", &muonSize );
+            setBranchAddress( "muonSize", &muonSize );
         }
         else
         {
@@ -523,7 +536,7 @@ void Ctpars::Init( TTree* tree )
         }
         if( fChain->GetBranchStatus( "muonSize" ) )
         {
-            fChain->SetBranchAddress( "muonSize", &muonSize );
+            setBranchAddress( "muonSize", &muonSize );
         }
         else
         {
@@ -531,7 +544,7 @@ void Ctpars::Init( TTree* tree )
         }
         if( fChain->GetBranchStatus( "muonIPCorrectedSize" ) )
         {
-            fChain->SetBranchAddress( "muonIPCorrectedSize", &muonIPCorrectedSize );
+            setBranchAddress( "muonIPCorrectedSize", &muonIPCorrectedSize );
         }
         else
         {
@@ -539,7 +552,7 @@ void Ctpars::Init( TTree* tree )
         }
         if( fChain->GetBranchStatus( "muonValid" ) )
         {
-            fChain->SetBranchAddress( "muonValid", &muonValid );
+            setBranchAddress( "muonValid", &muonValid );
         }
         else
         {
@@ -547,7 +560,7 @@ void Ctpars::Init( TTree* tree )
         }
         if( fChain->GetBranchStatus( "houghMuonValid" ) )
         {
-            fChain->SetBranchAddress( "houghMuonValid", &houghMuonValid );
+            setBranchAddress( "houghMuonValid", &houghMuonValid );
         }
         else
         {
@@ -558,12 +571,12 @@ void Ctpars::Init( TTree* tree )
     // bShort == 0: read all branches
     if( bShort == 0 )
     {
-        fChain->SetBranchAddress( "alpha", &alpha );
-        fChain->SetBranchAddress( "los", &los );
-        fChain->SetBranchAddress( "phi", &phi );
-        fChain->SetBranchAddress( "max", max );
-        fChain->SetBranchAddress( "index_of_max", index_of_max );
-        fChain->SetBranchAddress( "tchisq_x", &tchisq_x );
+        setBranchAddress( "alpha", &alpha );
+        setBranchAddress( "los", &los );
+        setBranchAddress( "phi", &phi );
+        setBranchAddress( "max", max );
+        setBranchAddress( "index_of_max", index_of_max );
+        setBranchAddress( "tchisq_x", &tchisq_x );
     }
     Notify();
 }
@@ -814,6 +827,41 @@ Bool_t Ctpars::Notify()
 }
 
 
+/*
+    read only branches with branch addresses
+
+    (all active branches are read by GetEntry(), independent of
+     a branch address being set)
+
+    iUnusedBranches: branches with addresses which are not needed
+                     by the caller and are disabled as well
+*/
+void Ctpars::disableUnusedBranches( vector< string > iUnusedBranches )
+{
+    if( !fChain )
+    {
+        return;
+    }
+    fChain->SetBranchStatus( "*", 0 );
+    for( unsigned int i = 0; i < fBranchesWithAddress.size(); i++ )
+    {
+        bool bUnused = false;
+        for( unsigned int j = 0; j < iUnusedBranches.size(); j++ )
+        {
+            if( fBranchesWithAddress[i] == iUnusedBranches[j] )
+            {
+                bUnused = true;
+                break;
+            }
+        }
+        if( !bUnused )
+        {
+            fChain->SetBranchStatus( fBranchesWithAddress[i].c_str(), 1 );
+        }
+    }
+}
+
+
 void Ctpars::Show( Long64_t entry )
 {
     // Print contents of entry.
@@ -47,7 +47,8 @@ class VAnaSum
         
         void doStereoAnalysis();
         void initialize( string i_longlistfilename, unsigned int iRunType,
-                         string i_outfile, int iRandomSeed, string fRunParameterfile );
+                         string i_outfile, int iRandomSeed, string fRunParameterfile,
+                         int iSelectedRun = -1 );
         void terminate();
         
     private:
@@ -169,6 +169,10 @@ class VAnaSumRunParameter : public TNamed, public VGlobalRunParameter
         int    fEffectiveAreaVsEnergyMC;
         int    fEnergyEffectiveAreaSmoothingIterations;
         double fEnergyEffectiveAreaSmoothingThreshold;
+        // cell widths in ze, wobble offset and pedvar for caching of interpolated effective areas (<= 0: no caching)
+        double fEnergyEffectiveAreaCache_dZe;
+        double fEnergyEffectiveAreaCache_dWoff;
+        double fEnergyEffectiveAreaCache_dPedVar;
         vector< double > fMCZe;                   // zenith angle interval for Monte Carlo
         
         // dead time calculation method
@@ -180,8 +184,15 @@ class VAnaSumRunParameter : public TNamed, public VGlobalRunParameter
         
         unsigned int fWriteEventTree;   // 0=don't fill the event tree; 1=write all events; 2=write events after direction cuts (default)
         
+        // read all data tree branches and validate the list of used branches (see VStereoAnalysis::validateUsedBranches())
+        bool fValidateUsedBranches;
+        
+        // ring background model: alpha maps from precomputed ring kernels (default: random sampling)
+        bool fRingKernelIntegration;
+        
         // Likelihood Spectral Analysis
         bool fLikelihoodAnalysis;
+        bool fLikelihoodResponseMatrixEventWeighted;   // mean response matrix weighted by number of events (default: run-averaged)
         
         // vector with all run parameters
         vector< VAnaSumRunParameterDataClass > fRunList;
@@ -256,6 +267,7 @@ class VAnaSumRunParameter : public TNamed, public VGlobalRunParameter
         void printStereoParameter( unsigned int icounter );
         void printStereoParameter( int irun );
         int  readRunParameter( string i_filename, bool fIgnoreZeroExclusionRegion = false );
+        bool selectRun( unsigned int i );
         bool setRunTimes( unsigned int irun, double iMJDStart, double iMJDStopp );
         bool setSkyMapCentreJ2000( unsigned int i, double ra, double dec );
         bool setTargetRADecJ2000( unsigned int i, double ra, double dec, string iTargetName );
@@ -264,6 +276,6 @@ class VAnaSumRunParameter : public TNamed, public VGlobalRunParameter
         bool writeListOfExcludedSkyRegions( int inonRun );
         bool getListOfExcludedSkyRegions( TFile* f, int inonRun );
         
-        ClassDef( VAnaSumRunParameter, 17 );
+        ClassDef( VAnaSumRunParameter, 21 );
 };
 #endif
@@ -0,0 +1,46 @@
+// VAnalysisThreadPool small pool of worker threads for parallel analysis steps
+
+#ifndef VAnalysisThreadPool_H
+#define VAnalysisThreadPool_H
+
+#include <condition_variable>
+#include <functional>
+#include <iostream>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+using namespace std;
+
+class VAnalysisThreadPool
+{
+    private:
+        unsigned int fNThreads;
+        vector< thread > fWorkers;
+
+        mutex fMutex;
+        condition_variable fCondition_newTask;
+        condition_variable fCondition_taskDone;
+
+        // current task: function( job index, worker index )
+        function< void( unsigned int, unsigned int ) > fTask;
+        unsigned int fNJobs;
+        unsigned int fNextJob;
+        unsigned int fNJobsDone;
+        unsigned long int fTaskGeneration;
+        bool fStop;
+
+        void worker( unsigned int iWorkerID );
+
+    public:
+        VAnalysisThreadPool( unsigned int iNThreads = 1 );
+        ~VAnalysisThreadPool();
+
+        unsigned int getNThreads()
+        {
+            return fNThreads;
+        }
+        void run( unsigned int iNJobs, function< void( unsigned int, unsigned int ) > iTask );
+};
+
+#endif
@@ -9,8 +9,12 @@
 #include <VPacket.h>
 
 #include <bitset>
+#include <condition_variable>
+#include <deque>
 #include <iostream>
+#include <mutex>
 #include <string>
+#include <thread>
 #include <vector>
 
 using namespace std;
@@ -30,6 +34,23 @@ class VBFDataReader : public VBaseRawDataReader
         
         vector< bool > ib_temp;
         
+        // packet prefetching (reader thread)
+        unsigned int fNPrefetchPackets;                   //!< maximum number of packets in prefetch queue (0 = off)
+        thread fPrefetchThread;
+        mutex fPrefetchMutex;
+        condition_variable fPrefetchCondition_filled;
+        condition_variable fPrefetchCondition_free;
+        deque< VPacket* > fPrefetchQueue;
+        unsigned fPrefetchIndex;                          //!< index of next packet to be read by the reader thread
+        bool fPrefetchEndOfFile;
+        bool fPrefetchStop;
+        string fPrefetchError;
+        unsigned int fPrefetchNTel;                       //!< number of telescopes (determined before the reader thread starts)
+        
+        void      prefetchPackets();
+        VPacket*  readNextPacket( bool& bEndOfFile );
+        void      stopPacketPrefetch();
+        
     public:
         VBFDataReader( string,
                        int isourcetype,
@@ -77,5 +98,6 @@ class VBFDataReader : public VBaseRawDataReader
         {
             iB = false;
         }
+        void              startPacketPrefetch( unsigned int iNPackets );
 };
 #endif
@@ -239,6 +239,8 @@ class VBaseRawDataReader : public VVirtualDataReader, public VSimulationDataRead
         }
         uint8_t                     getSample( unsigned channel, unsigned sample, bool iNewNoiseTrace = true );
         std::vector< uint8_t >      getSamplesVec();
+        bool                        getSampleBlock( vector< uint16_t >& iSampleBlock, unsigned int iNSamples,
+                unsigned int iSampleOffset = 0 );
         uint32_t                    getHitID( uint32_t i );
         bool                        getHiLo( uint32_t i );
         unsigned int                getTelescopeID()
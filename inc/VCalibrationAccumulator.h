@@ -0,0 +1,92 @@
+//! VCalibrationAccumulator  integer-binned distributions of a calibration quantity for all channels of a camera
+
+#ifndef VCALIBRATIONACCUMULATOR_H
+#define VCALIBRATIONACCUMULATOR_H
+
+#include "TH1F.h"
+#include "TMath.h"
+
+#include <string>
+#include <vector>
+
+using namespace std;
+
+class VCalibrationAccumulator
+{
+    private:
+        unsigned int fNChannels;
+        int          fNBins;
+        double       fXmin;
+        double       fXmax;
+
+        vector< UInt_t > fBinContent;         //!< [channel][bin] (bin = 0..fNBins+1, including under/overflow bins)
+        vector< UInt_t > fEntries;            //!< [channel]
+        // statistics of entries inside the histogram range (as in TH1)
+        vector< double > fSumW;               //!< [channel]
+        vector< double > fSumWX;              //!< [channel]
+        vector< double > fSumWX2;             //!< [channel]
+
+        string fHistogramName;                //!< name format of materialised histograms (one %d for the channel)
+        string fHistogramTitle;               //!< title format of materialised histograms (one %d for the channel)
+    
+        // same bin finding as TAxis::FindBin() (fixed bin widths)
+        int    findBin( double x )
+        {
+            if( x < fXmin )
+            {
+                return 0;
+            }
+            else if( !( x < fXmax ) )
+            {
+                return fNBins + 1;
+            }
+            return 1 + int( fNBins * ( x - fXmin ) / ( fXmax - fXmin ) );
+        }
+
+    public:
+        VCalibrationAccumulator();
+        ~VCalibrationAccumulator() {}
+
+        void   fill( unsigned int iChannel, double x )
+        {
+            if( iChannel >= fNChannels )
+            {
+                return;
+            }
+            int i_bin = findBin( x );
+            fBinContent[( size_t )iChannel * ( fNBins + 2 ) + i_bin]++;
+            fEntries[iChannel]++;
+            if( i_bin > 0 && i_bin <= fNBins )
+            {
+                fSumW[iChannel]++;
+                fSumWX[iChannel] += x;
+                fSumWX2[iChannel] += x * x;
+            }
+        }
+        double getEntries( unsigned int iChannel )
+        {
+            return ( iChannel < fNChannels ? ( double )fEntries[iChannel] : 0. );
+        }
+        TH1F*  getHistogram( unsigned int iChannel, string iName, string iTitle );
+        TH1F*  getHistogram( unsigned int iChannel );
+        double getMean( unsigned int iChannel );
+        unsigned int getNChannels()
+        {
+            return fNChannels;
+        }
+        int    getQuantile( unsigned int iChannel, double iProb, double& iQuantile );
+        double getRMS( unsigned int iChannel );
+        void   initialize( unsigned int iNChannels, int iNBins, double iXmin, double iXmax );
+        bool   isInitialized()
+        {
+            return ( fNChannels > 0 );
+        }
+        void   reset();
+        void   setHistogramNames( string iNameFormat, string iTitleFormat )
+        {
+            fHistogramName = iNameFormat;
+            fHistogramTitle = iTitleFormat;
+        }
+};
+
+#endif
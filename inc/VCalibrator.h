@@ -3,11 +3,11 @@
 #ifndef VCALIBRATOR_H
 #define VCALIBRATOR_H
 
+#include "VCalibrationAccumulator.h"
 #include "VImageBaseAnalyzer.h"
 #include "VPedestalCalculator.h"
 #include "VDB_CalibrationInfo.h"
 
-#include "TClonesArray.h"
 #include "TFile.h"
 #include "TH1F.h"
 #include "TLeaf.h"
@@ -35,15 +35,14 @@ class VCalibrator : public VImageBaseAnalyzer
 
         TFile* fPedSingleOutFile;
         map< ULong64_t, TFile* > fPedOutFile;
-        map< ULong64_t, vector< vector<TH1F* > > > hpedPerTelescopeType;  //<! one histogram per teltype/channel/sumwindow
-        map< ULong64_t, vector< vector<TH1F* > > > hped_vec;     //<! one histogram per telescope/channel/sumwindow
-        map< ULong64_t, TClonesArray* > fPedestalsHistoClonesArray;
+        map< ULong64_t, vector< VCalibrationAccumulator > > hpedPerTelescopeType;  //<! IPR charge distributions per teltype/sumwindow (all channels)
+        map< ULong64_t, vector< VCalibrationAccumulator > > hped_vec;     //<! pedestal distributions per teltype/sumwindow (all channels)
         TFile* opfgain;
         TFile* opftoff;
-        vector<TH1F* > hgain;
+        VCalibrationAccumulator hgain;                          //!< gain distributions (all channels)
         vector<TProfile* > hpulse;
         vector<TProfile* > htcpulse;
-        vector<TH1F* > htoff;
+        VCalibrationAccumulator htoff;                          //!< toffset distributions (all channels)
         vector<TProfile* > htoff_vs_sum;
         int fPedPerTelescopeTypeMinCnt;                         // statistical limit for IPR calculation
 
@@ -67,9 +66,9 @@ class VCalibrator : public VImageBaseAnalyzer
 
         // average Tzero calculation
         vector< TFile* > fTZeroOutFile;
-        // one histogram per telescope and channel
-        vector< vector< TH1F* > > htzero;
-        vector< vector< TH1F* > > htaverage;
+        // one distribution per telescope and channel
+        vector< VCalibrationAccumulator > htzero;
+        vector< VCalibrationAccumulator > htaverage;
 
         vector< string > fPedFileNameC;
         vector< string > fGainFileNameC;
@@ -84,7 +83,8 @@ class VCalibrator : public VImageBaseAnalyzer
         vector< string > fLowGainMultiplierNameC;
         vector< string > fLowGainTZeroFileNameC;
 
-        TTree* fillCalibrationSummaryTree( unsigned int itel, string iName, vector<TH1F* > h );
+        TTree* fillCalibrationSummaryTree( unsigned int itel, string iName, VCalibrationAccumulator& h );
+        void   writeCalibrationHistograms( VCalibrationAccumulator& h );
         bool   fillPedestalTree( unsigned int tel, VPedestalCalculator* iP );
         bool   initializePedestalHistograms( ULong64_t iTelType, bool iLowGain,
                                              vector< double > minSumPerSumWindow,
@@ -113,6 +113,7 @@ class VCalibrator : public VImageBaseAnalyzer
         void readTOffsets( bool iLowGain = false );
         bool readAverageTZeros( bool iLowGain = false );
         void setCalibrationFileNames();
+        bool usePedestalChannel( unsigned int iChannel, bool iLowGain, valarray< double >& iSums );
 
         void writeGains( bool iLowGain = false );
         void writePeds( bool iLowGain, VPedestalCalculator* iP = 0, bool iWriteAsciiFile = true );
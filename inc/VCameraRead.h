@@ -128,6 +128,17 @@ class VCameraRead : public VGlobalRunParameter
                 return 9999;
             }
         }
+        unsigned int getCameraCentreTubeIndex( unsigned int iTel )
+        {
+            if( iTel < fCameraCentreTubeIndex.size() )
+            {
+                return fCameraCentreTubeIndex[iTel];
+            }
+            else
+            {
+                return 9999;
+            }
+        }
         string               getCameraName()      //!< get camera name
         {
             return fCameraName[fTelID];
@@ -192,15 +203,27 @@ class VCameraRead : public VGlobalRunParameter
         {
             return fMaxNeighbour[fTelID];
         }
+        unsigned int         getMaxNeighbour( unsigned int iTel )
+        {
+            return fMaxNeighbour[iTel];
+        }
         float                getMaximumFOV_deg();
         vector<vector<int> >& getNeighbours()     //!< neighbour identifier
         {
             return fNeighbour[fTelID];
         }
+        vector<vector<int> >& getNeighbours( unsigned int iTel )
+        {
+            return fNeighbour[iTel];
+        }
         vector<unsigned int>& getNNeighbours()    //!< number of neighbours
         {
             return fNNeighbour[fTelID];
         }
+        vector<unsigned int>& getNNeighbours( unsigned int iTel )
+        {
+            return fNNeighbour[iTel];
+        }
         int                  getNPatches()        //!< return number of patches
         {
             return fNPatches;
@@ -214,6 +237,10 @@ class VCameraRead : public VGlobalRunParameter
         {
             return fXTube[fTelID].size();
         }
+        unsigned int         getNumChannels( unsigned int iTel )
+        {
+            return fXTube[iTel].size();
+        }
         unsigned int         getNumSamples()      //!< get number of FADC samples
         {
             return fCNSamples[fTelID];
@@ -353,6 +380,10 @@ class VCameraRead : public VGlobalRunParameter
         {
             return fEdgePixel[fTelID];
         }
+        vector<bool>&        isEdgePixel( unsigned int iTel )
+        {
+            return fEdgePixel[iTel];
+        }
         bool                 makeNeighbourList( vector< float > iNeighbourSearchScaleFactor,
                                                 vector< bool > iSquarePixels );
         void                 print( bool bDetailed = true );             //!< print all data vectors to stdout
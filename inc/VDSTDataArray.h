@@ -0,0 +1,249 @@
+//! VDSTDataArray  per-telescope pixel data arrays of the DST tree (rows allocated on demand)
+
+#ifndef VDSTDataArray_H
+#define VDSTDataArray_H
+
+#include <algorithm>
+#include <string>
+#include <vector>
+
+#include "VGlobalRunParameter.h"
+
+using namespace std;
+
+/*
+ * pixel data of all telescopes with data in an event
+ *
+ * Layout of each row (one row per telescope with data) is [level][channel].
+ * Rows are sized by the number of channels and levels (e.g. FADC samples) of the
+ * telescope (see setRowSize()); rows without size set are allocated on first access
+ * with VDST_MAXCHANNELS channels and all levels.
+ * Memory scales with the number of telescopes with data and their camera size
+ * and not with VDST_MAXTELESCOPES x VDST_MAXCHANNELS.
+ *
+ */
+template< class T > class VDSTDataArray
+{
+    protected:
+        vector< vector< T > > fRows;
+        vector< unsigned int > fRowNChannels;  // number of channels per row (0 = not allocated)
+        vector< unsigned int > fRowNLevels;    // number of levels per row
+        unsigned int fNLevels;                 // maximum number of values per channel (e.g. timing levels, FADC samples)
+        T fDefault;                            // value after reset
+
+    public:
+        VDSTDataArray( unsigned int iNLevels = 1, T iDefault = 0 )
+        {
+            fNLevels = iNLevels;
+            fDefault = iDefault;
+        }
+        ~VDSTDataArray() {}
+
+        T get( unsigned int iRow, unsigned int iChannel, unsigned int iLevel = 0 )
+        {
+            if( iRow >= fRows.size() || iChannel >= fRowNChannels[iRow] || iLevel >= fRowNLevels[iRow] )
+            {
+                return fDefault;
+            }
+            return fRows[iRow][( size_t )iLevel * fRowNChannels[iRow] + iChannel];
+        }
+        T getDefault()
+        {
+            return fDefault;
+        }
+        unsigned int getNChannels( unsigned int iRow )
+        {
+            return ( iRow < fRows.size() ? fRowNChannels[iRow] : 0 );
+        }
+        unsigned int getNLevels()
+        {
+            return fNLevels;
+        }
+        unsigned int getNLevels( unsigned int iRow )
+        {
+            return ( iRow < fRows.size() ? fRowNLevels[iRow] : 0 );
+        }
+        unsigned int getNRows()
+        {
+            return fRows.size();
+        }
+        /* pointer to row (allocated with maximum size if no size was set) */
+        T* getRow( unsigned int iRow )
+        {
+            if( iRow >= fRows.size() || fRowNChannels[iRow] == 0 )
+            {
+                setRowSize( iRow, VDST_MAXCHANNELS, fNLevels );
+            }
+            return &fRows[iRow][0];
+        }
+        /* set number of channels and levels of a row (values are reset if the size changes) */
+        void setRowSize( unsigned int iRow, unsigned int iNChannels, unsigned int iNLevels )
+        {
+            if( iNChannels > VDST_MAXCHANNELS || iNChannels == 0 )
+            {
+                iNChannels = VDST_MAXCHANNELS;
+            }
+            if( iNLevels > fNLevels || iNLevels == 0 )
+            {
+                iNLevels = fNLevels;
+            }
+            if( iRow >= fRows.size() )
+            {
+                fRows.resize( iRow + 1 );
+                fRowNChannels.resize( iRow + 1, 0 );
+                fRowNLevels.resize( iRow + 1, 0 );
+            }
+            if( fRowNChannels[iRow] == iNChannels && fRowNLevels[iRow] == iNLevels )
+            {
+                return;
+            }
+            fRows[iRow].assign( ( size_t )iNChannels * iNLevels, fDefault );
+            fRowNChannels[iRow] = iNChannels;
+            fRowNLevels[iRow] = iNLevels;
+        }
+        /* true if all levels of this channel are at default value */
+        bool isDefault( unsigned int iRow, unsigned int iChannel, unsigned int iNLevels )
+        {
+            if( iRow >= fRows.size() || iChannel >= fRowNChannels[iRow] )
+            {
+                return true;
+            }
+            const T* r = &fRows[iRow][iChannel];
+            for( unsigned int l = 0; l < iNLevels && l < fRowNLevels[iRow]; l++ )
+            {
+                if( r[( size_t )l * fRowNChannels[iRow]] != fDefault )
+                {
+                    return false;
+                }
+            }
+            return true;
+        }
+        /* append values of iNLevels levels of this channel */
+        void pack( unsigned int iRow, unsigned int iChannel, unsigned int iNLevels, vector< T >& iBuffer )
+        {
+            for( unsigned int l = 0; l < iNLevels && l < fNLevels; l++ )
+            {
+                iBuffer.push_back( get( iRow, iChannel, l ) );
+            }
+        }
+        /* set values of iNLevels levels of this channel (row size must be set) */
+        void unpack( unsigned int iRow, unsigned int iChannel, unsigned int iNLevels, const T* iValues )
+        {
+            if( iRow >= fRows.size() || iChannel >= fRowNChannels[iRow] )
+            {
+                return;
+            }
+            T* r = &fRows[iRow][iChannel];
+            for( unsigned int l = 0; l < iNLevels && l < fRowNLevels[iRow]; l++ )
+            {
+                r[( size_t )l * fRowNChannels[iRow]] = iValues[l];
+            }
+        }
+        /* copy a row from an array with layout [level][iStride] (row size must be set) */
+        void unpackRow( unsigned int iRow, const T* iValues, unsigned int iStride )
+        {
+            if( iRow >= fRows.size() )
+            {
+                return;
+            }
+            const unsigned int n = ( fRowNChannels[iRow] < iStride ? fRowNChannels[iRow] : iStride );
+            for( unsigned int l = 0; l < fRowNLevels[iRow]; l++ )
+            {
+                std::copy( iValues + ( size_t )l * iStride, iValues + ( size_t )l * iStride + n,
+                           fRows[iRow].begin() + ( size_t )l * fRowNChannels[iRow] );
+            }
+        }
+        /* reset all levels of this channel */
+        void resetChannel( unsigned int iRow, unsigned int iChannel, unsigned int iNLevels )
+        {
+            if( iRow >= fRows.size() || iChannel >= fRowNChannels[iRow] )
+            {
+                return;
+            }
+            T* r = &fRows[iRow][iChannel];
+            for( unsigned int l = 0; l < iNLevels && l < fRowNLevels[iRow]; l++ )
+            {
+                r[( size_t )l * fRowNChannels[iRow]] = fDefault;
+            }
+        }
+        /* reset the first iNLevels levels of all allocated rows */
+        void reset( unsigned int iNLevels = 99999 )
+        {
+            for( unsigned int i = 0; i < fRows.size(); i++ )
+            {
+                size_t n = ( size_t )( iNLevels < fRowNLevels[i] ? iNLevels : fRowNLevels[i] ) * fRowNChannels[i];
+                std::fill( fRows[i].begin(), fRows[i].begin() + n, fDefault );
+            }
+        }
+        /* set all allocated rows to the given value */
+        void fill( T iValue )
+        {
+            for( unsigned int i = 0; i < fRows.size(); i++ )
+            {
+                std::fill( fRows[i].begin(), fRows[i].end(), iValue );
+            }
+        }
+};
+
+/*
+ * array with one value per channel: a[tel][channel]
+ */
+template< class T > class VDSTChannelArray : public VDSTDataArray< T >
+{
+    public:
+        VDSTChannelArray( T iDefault = 0 ) : VDSTDataArray< T >( 1, iDefault ) {}
+        T* operator[]( unsigned int iRow )
+        {
+            return this->getRow( iRow );
+        }
+};
+
+/*
+ * one row of an array with several values per channel: row[level][channel]
+ */
+template< class T > class VDSTLevelRow
+{
+    private:
+        T* fRow;
+        unsigned int fNChannels;
+    
+    public:
+        VDSTLevelRow( T* iRow, unsigned int iNChannels )
+        {
+            fRow = iRow;
+            fNChannels = iNChannels;
+        }
+        T* operator[]( unsigned int iLevel )
+        {
+            return fRow + ( size_t )iLevel * fNChannels;
+        }
+};
+
+/*
+ * array with several values per channel: a[tel][level][channel]
+ */
+template< class T, unsigned int NLevels > class VDSTLevelArray : public VDSTDataArray< T >
+{
+    public:
+        VDSTLevelArray( T iDefault = 0 ) : VDSTDataArray< T >( NLevels, iDefault ) {}
+        VDSTLevelRow< T > operator[]( unsigned int iRow )
+        {
+            T* r = this->getRow( iRow );
+            return VDSTLevelRow< T >( r, this->getNChannels( iRow ) );
+        }
+};
+
+/*
+ * pixel data branch of the DST tree
+ *
+ * sparse layout: values of stored pixels only
+ * fixed-size layout (older files): values of all telescopes [ntel_data][levels][VDST_MAXCHANNELS]
+ */
+template< class T > struct sDSTSparseBranch
+{
+    string fName;
+    VDSTDataArray< T >* fArray;
+    vector< T > fBuffer;
+};
+
+#endif
@@ -270,6 +270,8 @@ class VDSTReader : public VVirtualDataReader
         vector< uint8_t >             getSamplesVec();
         uint8_t                       getSample( unsigned channel, unsigned sample, bool iNewNoiseTrace = true );
         vector< uint16_t >            getSamplesVec16Bit();
+        bool                          getSampleBlock( vector< uint16_t >& iSampleBlock, unsigned int iNSamples,
+                unsigned int iSampleOffset = 0 );
         uint16_t                      getSample16Bit( unsigned channel, unsigned sample, bool iNewNoiseTrace = true );
         valarray< double >&           getSums( unsigned int iNChannel = 99999 )
         {
@@ -16,6 +16,7 @@
 #include <string>
 #include <vector>
 
+#include "VDSTDataArray.h"
 #include "VGlobalRunParameter.h"
 
 ////////////////////////////////////////////////////////////////////////////////////////
@@ -77,53 +78,51 @@ class VDSTTree
         float        fDSTpointElevation[VDST_MAXTELESCOPES];
         int          fDSTpointTrackingKnown[VDST_MAXTELESCOPES];
 
-        unsigned short int fDSTChan[VDST_MAXTELESCOPES][VDST_MAXCHANNELS];
-
         // data recording parameters
-        unsigned short int fDSTRecord[VDST_MAXTELESCOPES][VDST_MAXCHANNELS];
+        VDSTChannelArray< unsigned short int > fDSTRecord;
         unsigned short int fDSTTelescopeZeroSupression[VDST_MAXTELESCOPES];
 
         // adc parameters
-        float        fDSTpedestal[VDST_MAXTELESCOPES][VDST_MAXCHANNELS];
-        float        fDSTsums[VDST_MAXTELESCOPES][VDST_MAXCHANNELS];                // integrated charge
-        float        fDSTsums2[VDST_MAXTELESCOPES][VDST_MAXCHANNELS];                // integrated charge
-        unsigned short int fDSTdead[VDST_MAXTELESCOPES][VDST_MAXCHANNELS];
-        unsigned short int fDSTZeroSuppressed[VDST_MAXTELESCOPES][VDST_MAXCHANNELS];
-        unsigned short int fDSTsumwindow[VDST_MAXTELESCOPES][VDST_MAXCHANNELS];
-        unsigned short int fDSTsumfirst[VDST_MAXTELESCOPES][VDST_MAXCHANNELS];
-        float        fDSTt0[VDST_MAXTELESCOPES][VDST_MAXCHANNELS];
-        short        fDSTMax[VDST_MAXTELESCOPES][VDST_MAXCHANNELS];
-        unsigned short int    fDSTPadcHG[VDST_MAXTELESCOPES][VDST_MAXCHANNELS];
-        unsigned short int    fDSTPadcLG[VDST_MAXTELESCOPES][VDST_MAXCHANNELS];
+        VDSTChannelArray< float > fDSTpedestal;
+        VDSTChannelArray< float > fDSTsums;                // integrated charge
+        VDSTChannelArray< float > fDSTsums2;               // integrated charge
+        VDSTChannelArray< unsigned short int > fDSTdead;
+        VDSTChannelArray< unsigned short int > fDSTZeroSuppressed;
+        VDSTChannelArray< unsigned short int > fDSTsumwindow;
+        VDSTChannelArray< unsigned short int > fDSTsumfirst;
+        VDSTChannelArray< float > fDSTt0;
+        VDSTChannelArray< short > fDSTMax;
+        VDSTChannelArray< unsigned short int > fDSTPadcHG;
+        VDSTChannelArray< unsigned short int > fDSTPadcLG;
         // assume that all pulse timing levels are the same for all channels in a telescope
         float        fDSTpulsetiminglevels[VDST_MAXTELESCOPES][VDST_MAXTIMINGLEVELS];
-        float        fDSTpulsetiming[VDST_MAXTELESCOPES][VDST_MAXTIMINGLEVELS][VDST_MAXCHANNELS];
-        short int    fDSTRawMax[VDST_MAXTELESCOPES][VDST_MAXCHANNELS];
+        VDSTLevelArray< float, VDST_MAXTIMINGLEVELS > fDSTpulsetiming;
+        VDSTChannelArray< short > fDSTRawMax;
         float        fDSTLTtime[VDST_MAXTELESCOPES];
         float        fDSTLDTtime[VDST_MAXTELESCOPES];
         unsigned short int fDSTL2TrigType[VDST_MAXTELESCOPES];
-        unsigned short int fDSTHiLo[VDST_MAXTELESCOPES][VDST_MAXCHANNELS];
-        unsigned short int fDSTN255[VDST_MAXTELESCOPES][VDST_MAXCHANNELS];
+        VDSTChannelArray< unsigned short int > fDSTHiLo;
+        VDSTChannelArray< unsigned short int > fDSTN255;
         unsigned short int fDSTnL1trig[VDST_MAXTELESCOPES];
-        unsigned short int fDSTL1trig[VDST_MAXTELESCOPES][VDST_MAXCHANNELS];
+        VDSTChannelArray< unsigned short int > fDSTL1trig;
         //////////////////////////////////////////////////////////////////////////////////////
         // FADC traces
         bool               fReadWriteFADC;
         unsigned short int fDSTnumSamples[VDST_MAXTELESCOPES];
-        unsigned short int fDSTtrace[VDST_MAXTELESCOPES][VDST_MAXSUMWINDOW][VDST_MAXCHANNELS];
+        VDSTLevelArray< unsigned short int, VDST_MAXSUMWINDOW > fDSTtrace;
         //////////////////////////////////////////////////////////////////////////////////////
         // photoelectrons
         bool  fFillPELeaf;
-        unsigned short int fDSTPe[VDST_MAXTELESCOPES][VDST_MAXCHANNELS]; // sum of Che pe in each pixel
+        VDSTChannelArray< unsigned short int > fDSTPe; // sum of Che pe in each pixel
         // peak ADC values
         bool  fFillPeakADC;
 
         // mean pulse timing
-        float fDSTMeanPulseTiming[VDST_MAXTELESCOPES][VDST_MAXCHANNELS];
-        float fDSTMeanPulseTiming_N[VDST_MAXTELESCOPES][VDST_MAXCHANNELS];
+        VDSTChannelArray< float > fDSTMeanPulseTiming;
+        VDSTChannelArray< float > fDSTMeanPulseTiming_N;
         float fDSTMeanPulseTimingMinLightLevel;
         TH1F* fDSTMeanPulseTimingHistogram[VDST_MAXTELESCOPES];
-        float fDSTTraceWidth[VDST_MAXTELESCOPES][VDST_MAXCHANNELS];
+        VDSTChannelArray< float > fDSTTraceWidth;
         //////////////////////////////////////////////////////////////////////////////////////
         // MC parameters
         unsigned short int fDSTprimary;
@@ -134,6 +133,33 @@ class VDSTTree
         float fDSTze;
         float fDSTTel_xoff;
         float fDSTTel_yoff;
+        
+        //////////////////////////////////////////////////////////////////////////////////////
+        // sparse tree layout: pixel data is stored for pixels with data only
+        // (pixels with all values at default are not written)
+        bool fSparse;
+        unsigned int fDSTnpix;                          //!< number of stored pixels
+        unsigned int fDSTntrace;                        //!< number of stored FADC samples
+        vector< unsigned short int > fDSTpix_tel;       //!< telescope (index in tel_data) of stored pixel
+        vector< unsigned short int > fDSTpix_chan;      //!< channel of stored pixel
+        vector< sDSTSparseBranch< float > > fSparseF;
+        vector< sDSTSparseBranch< unsigned short int > > fSparseUS;
+        vector< sDSTSparseBranch< short > > fSparseS;
+        vector< unsigned short int > fSparseTrace;
+        // fixed-size array layout (older files): number of telescopes in branch buffers
+        unsigned int fNTelFixed;
+        
+        void addPixelBranch( string iName, VDSTDataArray< float >* iArray, bool iRead = false );
+        void addPixelBranch( string iName, VDSTDataArray< unsigned short int >* iArray, bool iRead = false );
+        void addPixelBranch( string iName, VDSTDataArray< short >* iArray, bool iRead = false );
+        unsigned int getDSTMaxNChannels();
+        unsigned int getNChannelsTelData( unsigned int iTelData );
+        void packSparseTree();
+        void resetSparsePixels();
+        void setFixedBranchAddresses( unsigned int iNTel );
+        void setSparseBranchAddresses();
+        void unpackFixedTree();
+        void unpackSparseTree();
 
         //////////////////////////////////////////////////////////////////////////////////////
         VDSTTree();
@@ -161,6 +187,12 @@ class VDSTTree
         bool initDSTTree( bool iFullTree = false, bool iCalibrationTree = false );
         bool initDSTTree( TTree* t, TTree* c );
         bool initMCTree();
+        int  fillDSTTree();
+        int  getEntry( Long64_t iEntry );
+        bool isSparse()
+        {
+            return fSparse;
+        }
         map< unsigned int, VDSTTelescopeConfiguration > readArrayConfig( string );
         map< unsigned int, unsigned int > readTelescopeTypeList( string );
         void resetDataVectors( unsigned int iCH = 0,
@@ -186,6 +218,7 @@ class VDSTTree
         {
             fMC = iMC;
         }
+        void setTelescopeDataSize( unsigned int iTelData, unsigned int iNChannels, unsigned int iNSamples );
 
         // getters for all variables
         uint32_t     getDSTRunNumber()
@@ -17,6 +17,13 @@ class VDetectorGeometry : public VCameraRead
         vector< unsigned int > fNChannels;
         vector< bool >         fSampleWarning;
         
+        // flat neighbour tables (one per camera type)
+        vector< unsigned int >           fNeighbourTableID;      //!< [telescope] index of neighbour table
+        vector< vector< unsigned int > > fNeighbourTableOffset;  //!< [table][channel] first entry of channel in fNeighbourTable (size nchannels+1)
+        vector< vector< unsigned int > > fNeighbourTable;        //!< [table] neighbours of all channels
+        
+        bool           hasSameNeighbours( unsigned int iTelID, unsigned int iTelID_ref );
+        
     public:
         VDetectorGeometry() {}
         VDetectorGeometry( unsigned int iNTel, bool iDebug = false );
@@ -43,6 +50,11 @@ class VDetectorGeometry : public VCameraRead
             return fNSamples;
         }
         void           addDataVector( unsigned int iNTel, vector< unsigned int > iNChannels );
+        void           fillNeighbourTables();
+        vector< unsigned int >& getNeighbourTable();
+        vector< unsigned int >& getNeighbourTable( unsigned int iTelID );
+        vector< unsigned int >& getNeighbourTableOffset();
+        vector< unsigned int >& getNeighbourTableOffset( unsigned int iTelID );
         unsigned int   getNSamples( unsigned int iTelID )
         {
             if( iTelID < fNSamples.size() )
@@ -20,6 +20,9 @@ using namespace std;
 
 class VDispAnalyzer
 {
+        // testDispHeadTail: compares the head/tail sign search with a test of all sign combinations
+        friend class VDispAnalyzerTest;
+
     private:
 
         bool                fDebug;
@@ -72,20 +75,46 @@ class VDispAnalyzer
 
         vector<ULong64_t> fTelescopeTypeList;
 
-        void calculateMeanShowerDirection( vector< float > v_x, vector< float > v_y, vector< float > v_weight,
+        // head/tail sign search (see find_smallest_diff_signs())
+        unsigned int fHeadTailSearch_NImages_max;     //!< use intersection point for head/tail above this multiplicity
+        vector< float > fSignSearch_px;               //!< disp directions per image and sign [2*image+sign]
+        vector< float > fSignSearch_py;
+        vector< float > fSignSearch_xs;               //!< disp directions of the current sign combination
+        vector< float > fSignSearch_ys;
+        vector< double > fSignSearch_pairCost;        //!< weighted distances [((n*N+m)*2+a)*2+b]
+        vector< double > fSignSearch_partialCost;     //!< summed distances to assigned images [2*image+sign]
+        vector< double > fSignSearch_minPairCost;     //!< lower bound for pairs of unassigned images [depth]
+        vector< unsigned int > fSignSearch_order;     //!< search order of images
+        vector< int > fSignSearch_sign;               //!< current sign combination (0: +1, 1: -1)
+        vector< int > fSignSearch_bestSign;
+        float  fSignSearch_bestDiff;
+        double fSignSearch_weightSum;
+        unsigned int fSignSearch_nNodes;
+        unsigned int fSignSearch_nNodes_max;
+
+        void calculateMeanShowerDirection( const vector< float >& v_x, const vector< float >& v_y,
+                                           const vector< float >& v_weight,
                                            float& xs, float& ys, float& dispdiff, unsigned int iMaxN );
 
-        unsigned int find_smallest_diff_element(
-            vector< vector< float > > i_sign,
-            vector< float > x, vector< float > y,
-            vector< float > cosphi, vector< float > sinphi,
-            vector< float > v_disp, vector< float > v_weight );
-        vector< vector< float > > get_sign_permutation_vector( unsigned int x_size );
+        vector< float > find_smallest_diff_signs(
+            const vector< float >& x, const vector< float >& y,
+            const vector< float >& cosphi, const vector< float >& sinphi,
+            const vector< float >& v_disp, const vector< float >& v_weight );
+        void evaluateImages( unsigned int i_ntel, float iArrayElevation, float iArrayAzimuth,
+                             ULong64_t* iTelType,
+                             double* img_size, double* img_cen_x, double* img_cen_y,
+                             double* img_width, double* img_length, double* img_asym,
+                             double* img_tgrad, double* img_loss, int* img_ntubes,
+                             double xoff_4, double yoff_4, double* img_fui,
+                             vector< float >& i_disp, vector< bool >& i_quality );
+        bool isSmallerSignCombination( const vector< int >& a, const vector< int >& b );
+        void searchSigns( unsigned int iDepth, double iCost, const vector< float >& v_weight );
+        void testSignCombination( const vector< float >& v_weight );
 
     public:
 
         VDispAnalyzer();
-        ~VDispAnalyzer() {}
+        ~VDispAnalyzer();
 
         void calculateCore( unsigned int i_ntel, float iArrayElevation, float iArrayAzimuth,
                             double* itelX, double* itelY, double* itelZ,
@@ -114,9 +143,9 @@ class VDispAnalyzer
                                 double* img_fui = 0 );
 
         void  calculateMeanDirection( float& xs, float& ys,
-                                      vector< float > x, vector< float > y,
-                                      vector< float > cosphi, vector< float > sinphi,
-                                      vector< float > v_disp, vector< float > v_weight,
+                                      const vector< float >& x, const vector< float >& y,
+                                      const vector< float >& cosphi, const vector< float >& sinphi,
+                                      vector< float > v_disp, const vector< float >& v_weight,
                                       float& dispdiff,
                                       float x_off4 = -999., float yoff_4 = -999. );
 
@@ -235,6 +264,10 @@ class VDispAnalyzer
         {
             fDebug = iFDebug;
         }
+        void  setHeadTailSearch_NImages_max( unsigned int iN = 5 )
+        {
+            fHeadTailSearch_NImages_max = iN;
+        }
         void  setDispErrorWeighting( bool iW = false, float iWeight = 5. )
         {
             fDispErrorWeighting = iW;
@@ -28,6 +28,7 @@
 #include "TProfile.h"
 #include "TTree.h"
 
+#include <algorithm>
 #include <iomanip>
 #include <iostream>
 #include <map>
@@ -275,6 +276,31 @@ class VEffectiveAreaCalculator
         double fEffectiveAreas_meanIndex;
         double fEffectiveAreas_meanN;
         
+        // cache of interpolated effective areas (reading of effective areas)
+        // (cells in ze, wobble offset and pedvar; one cell per event if cell widths are <= 0 (default))
+        struct sEffectiveAreaCell
+        {
+            vector< float > fEff;                 //!< effective area vs energy (fEff_E0)
+            vector< float > fEffMC;               //!< effective area vs MC energy (likelihood analysis)
+            vector< float > fE_MC_Res;            //!< response matrix values (likelihood analysis)
+            vector< float > fE_Rec_Res;
+            vector< float > fE_Rec_Res_Err;
+            vector< float > fResponseMatrix;      //!< normalized response matrix (filled once per cell)
+            unsigned int    fNEvents_ResponseMatrix; //!< events not yet added to the mean response matrix
+            bool            bValid;
+        };
+        double fEffAreaCache_dZe;
+        double fEffAreaCache_dWoff;
+        double fEffAreaCache_dPedVar;
+        double fEffAreaCache_Index;               //!< spectral index of cached effective areas
+        vector< sEffectiveAreaCell > fEffAreaCache;
+        map< ULong64_t, unsigned int > fEffAreaCache_Map;
+        ULong64_t    fEffAreaCache_LastKey;
+        unsigned int fEffAreaCache_LastCell;
+        sEffectiveAreaCell fEffAreaCache_Event;
+        
+        bool fResponseMatrixEventWeighted;        //!< mean response matrix weighted by number of events per cell
+        
         // Gaussian function for approximating the response matrix
         TF1* fGauss;
         // Bool to handle if likelihood analysis is required
@@ -285,7 +311,12 @@ class VEffectiveAreaCalculator
         bool               binomialDivide( TGraphAsymmErrors* g, TH1D* hrec, TH1D* hmc,
                                            float* eff = 0, float* eff_error = 0 );
         void               copyProfileHistograms( TProfile*,  TProfile* );
+        void               addToMeanResponseMatrix( const vector< float >& i_emc, const vector< float >& iResponseMatrix,
+                double iWeight = 1., bool iNormalize = true );
         void               copyHistograms( TH1*,  TH1*, bool );
+        void               fillMeanResponseMatrix();
+        bool               fillResponseMatrix( const vector< float >& i_emc, const vector< float >& i_erec,
+                                               const vector< float >& i_erec_err, vector< float >& iResponseMatrix );
         void               fillAngularResolution( unsigned int i_az, bool iContaintment_80p );
         void               fillDL2EventDataTree( CData* c, UChar_t iCutClass, float iMVA );
         void               fillEcutSub( double iE, enum E_HIS1D iCutIndex );
@@ -296,12 +327,15 @@ class VEffectiveAreaCalculator
         double             getCRWeight( double iEMC_TeV_lin, TH1* h , bool for_back_map = false, TH1* hF = 0 );
         double             getEffectiveAreasFromHistograms( double erec, double ze, double woff, double iPedVar,
                 double iSpectralIndex, bool bAddtoMeanEffectiveArea = true );
+        sEffectiveAreaCell* getEffectiveAreaCell( double ze, double woff, double iPedVar, double iSpectralIndex );
         string             getEffectiveAreaNamefromEnumInt( int i, string iType );
         VGammaHadronCuts*  getGammaHadronCuts( CData* c );
         bool               getMonteCarloSpectra( VEffectiveAreaCalculatorMCHistograms* );
         double             getMCSolidAngleNormalization();
         vector< unsigned int > getUpperLowBins( vector< double > i_values, double d );
         bool   initializeEffectiveAreasFromHistograms( TTree*, TH1D*, double azmin, double azmax, double ispectralindex, double ipedvar );
+        bool               interpolateEffectiveAreas( double ze, double woff, double iPedVar, double iSpectralIndex,
+                sEffectiveAreaCell& iCell );
         vector< float >    interpolate_effectiveArea( double iV, double iVLower, double iVupper,
                 vector< float > iEL, vector< float > iEU, bool iCos = true );
         bool               newEffectiveAreaHistogram( string iType, int iHisN, string iHisTitle,
@@ -409,11 +443,18 @@ class VEffectiveAreaCalculator
         }
         void                setWobbleOffset( double x, double y );
         
-        void 				addMeanResponseMatrix( vector <float> i_emc, vector <float> i_erec , vector <float> i_erec_err );
-        TH2D* 				getMeanResponseMatrix()
+        void 				addMeanResponseMatrix( vector <float> i_emc, vector <float> i_erec , vector <float> i_erec_err,
+                double iWeight = 1., bool iNormalize = true );
+        TH2D* 				getMeanResponseMatrix();
+        void                setEffectiveAreaCache( double iDZe = 0.25, double iDWoff = 0.02, double iDPedVar = 0.1 )
+        {
+            fEffAreaCache_dZe = iDZe;
+            fEffAreaCache_dWoff = iDWoff;
+            fEffAreaCache_dPedVar = iDPedVar;
+        }
+        void                setResponseMatrixEventWeighting( bool iB = false )
         {
-            VHistogramUtilities::normalizeTH2D_y( hMeanResponseMatrix );
-            return ( TH2D* )hMeanResponseMatrix->Clone();
+            fResponseMatrixEventWeighted = iB;
         }
 };
 #endif
@@ -53,7 +53,8 @@ class VEvndispData
         
         // telescope data
         static unsigned int fNTel;                //!< total number of telescopes
-        static unsigned int fTelID;               //!< telescope number of current telescope
+        //!< telescope number of current telescope (per thread, see VTelescopeAnalysisContext)
+        static thread_local unsigned int fTelID;
         static vector< unsigned int > fTeltoAna;  //!< analyze only this subset of telescopes (this is dynamic and can change from event to event)
         // telescope pointing (one per telescope)
         static VArrayPointing* fArrayPointing;
@@ -1034,6 +1035,10 @@ class VEvndispData
         {
             return fRunPar->fDF_PoleZero[fTelID];
         }
+        unsigned int        getSlidingWindowMethod()
+        {
+            return fRunPar->fSlidingWindowMethod[fTelID];
+        }
         bool                hasFADCData()
         {
             return ( bool )fRunPar->fTraceIntegrationMethod[fTelID];
@@ -1604,6 +1609,7 @@ class VEvndispData
             fAnaData[fTelID]->fTCorrectedSum2Last[iChannel] = iT;
         }
         void                setTelID( unsigned int iTel );
+        void                setThreadTelID( unsigned int iTel );
         void                setTeltoAna( vector< unsigned int > iT );
         void                setTOffsets( double iToff, bool iLowGain = false )
         {
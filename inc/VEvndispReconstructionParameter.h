@@ -132,6 +132,7 @@ class VEvndispReconstructionParameter : public TNamed
         bool readKeyWord_FADCDOUBLEPASS( vector< string > iTemp, int t_temp );
         bool readKeyWord_FADCSUMMATIONWINDOW( vector< string > iTemp, int t_temp );
         bool readKeyWord_FADCSUMMATIONSTART( vector< string > iTemp, int t_temp );
+        bool readKeyWord_FADCSLIDINGWINDOW( vector< string > iTemp, int t_temp );
         bool readKeyWord_CLEANING( vector< string > iTemp, int t_temp );
         bool readKeyWord_BRIGHTSTARS( vector< string > iTemp );
         bool readKeyWord_LLEDGEFIT( vector< string > iTemp, int t_temp );
@@ -74,6 +74,8 @@ class VEvndispRunParameter : public TNamed, public VGlobalRunParameter
         int    fFirstEvent;                       // skip up till this event
         int    fTimeCutsMin_min;                  // start to analyse run at this min
         int    fTimeCutsMin_max;                  // stop to analyse this run at this min
+        unsigned int fNThreads;                   // number of threads for image analysis (telescopes analysed in parallel)
+        unsigned int fNPrefetchPackets;           // number of raw data packets decoded ahead in a separate thread (VBF only; 0 = off)
 
         bool fprintdeadpixelinfo ;       // DEADCHAN if true, will print list of dead pixels
         // at end of run to evndisp.log
@@ -191,6 +193,7 @@ class VEvndispRunParameter : public TNamed, public VGlobalRunParameter
         vector< unsigned int > fDF_DigitalFilter; // use a digital filter in the trace analysis
         vector< unsigned int > fDF_UpSample;      // digital filter: up sample parameter
         vector< float >        fDF_PoleZero;      // digital filter: pole-zero cancellation parameter
+        vector< unsigned int > fSlidingWindowMethod;  // sliding window integration: 0 = running sum, 1 = prefix sums
         vector<int> fsumfirst;                    // parameter for window summation start (window 1)
         vector<unsigned int>   fSearchWindowLast; // last sample searched for trace integration
         vector<int> fsumwindow_1;                 // parameter for window summation (window 1)
@@ -328,6 +331,6 @@ class VEvndispRunParameter : public TNamed, public VGlobalRunParameter
             return fuseDB;
         }
 
-        ClassDef( VEvndispRunParameter, 1002 ); //(increase this number)
+        ClassDef( VEvndispRunParameter, 1005 ); //(increase this number)
 };
 #endif
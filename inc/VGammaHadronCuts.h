@@ -265,6 +265,7 @@ class VGammaHadronCuts : public VAnalysisUtilities
         bool   applyStereoShapeCuts();
         bool   applyTMVACut( int i );
         bool   applyTelTypeTest( bool bCount = false );
+        void   evaluateTMVABatch( Long64_t iEntry_min, Long64_t iNEntries );
         
         TF1*   getAngularResolutionFunction()
         {
@@ -386,6 +387,7 @@ class VGammaHadronCuts : public VAnalysisUtilities
         void   printSignalEfficiency();
         void   printTMVA_MVACut();
         bool   readCuts( string i_cutfilename, int iPrint = 1 );
+        void   registerUsedBranches( CData* iData );
         void   resetCutValues();
         void   resetCutStatistics();
         void   initializeCuts( int irun = -1, string iDir = "" );
@@ -422,6 +424,13 @@ class VGammaHadronCuts : public VAnalysisUtilities
         {
             fCut_Theta2_max = it2;
         }
+        void   setTMVAResultCaching( bool iB = true )
+        {
+            if( fTMVAEvaluator )
+            {
+                fTMVAEvaluator->setResultCaching( iB );
+            }
+        }
         void   terminate( bool iShort = false, string iObjectName = "GammaHadronCuts" );
         bool   useDeepLearnerCuts()
         {
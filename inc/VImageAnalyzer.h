@@ -8,10 +8,13 @@
 #include "TTree.h"
 #include "TROOT.h"
 
+#include "VAnalysisThreadPool.h"
 #include "VImageBaseAnalyzer.h"
 #include "VImageParameterCalculation.h"
 #include "VImageCleaning.h"
+#include "VTelescopeAnalysisContext.h"
 
+#include <algorithm>
 #include <iostream>
 #include <fstream>
 #include <stdint.h>
@@ -32,27 +35,40 @@ class VImageAnalyzer : public VImageBaseAnalyzer
         
         bool fInit;
         
-        // temporary vectors for dead pixel smoothing
-        vector< unsigned int > savedDead;
-        vector< unsigned int > savedDeadLow;
-        valarray< double > savedGains;
-        valarray< double > savedGainsLow;
+        // per-telescope analysis contexts (cleaner, parameter calculation, temporary vectors)
+        vector< VTelescopeAnalysisContext* > fTelescopeContext;
+        VAnalysisThreadPool* fThreadPool;         //!< thread pool for parallel telescope analysis
+        
+        // analysis steps (see doAnalysis())
+        bool doAnalysis_initEvent();
+        void doAnalysis_traceIntegration();
+        void doAnalysis_imagePass1( VTelescopeAnalysisContext* iContext );
+        void doAnalysis_imageFitPass1( VTelescopeAnalysisContext* iContext );
+        void doAnalysis_afterImagePass1( VTelescopeAnalysisContext* iContext );
+        bool doAnalysis_traceIntegrationPass2( VTelescopeAnalysisContext* iContext );
+        void doAnalysis_imagePass2( VTelescopeAnalysisContext* iContext );
+        void doAnalysis_imageFitPass2( VTelescopeAnalysisContext* iContext );
+        void doAnalysis_imageFitLL( VTelescopeAnalysisContext* iContext );
+        void doAnalysis_terminateEvent( VTelescopeAnalysisContext* iContext );
         
         void fillOutputTree();                    //!< fill tree with image parameterisation results
-        void imageCleaning( bool iDoublePass = false );  //!< image cleaning
+        VTelescopeAnalysisContext* getTelescopeContext( unsigned int iTelID );
+        void imageCleaning( VTelescopeAnalysisContext* iContext, bool iDoublePass = false );  //!< image cleaning
         bool initEvent();                         //! reset image calculation for next event
-        void muonRingAnalysis();                  //! muon ring analysis
-        void houghMuonRingAnalysis();                  //! hough transform muon ring analysis
+        void initTelescopeContexts();
+        void muonRingAnalysis( VTelescopeAnalysisContext* iContext );        //! muon ring analysis
+        void houghMuonRingAnalysis( VTelescopeAnalysisContext* iContext );   //! hough transform muon ring analysis
         void printTrace( int i_channel );         //!< print trace information for one channel (debugging)
         void setAnaDir( unsigned int iTel );      //!< set directories in root output file
         void setNTrigger();
-        void smoothDeadTubes();                   //!< reduce the effect of dead tubes
+        void smoothDeadTubes( VTelescopeAnalysisContext* iContext );         //!< reduce the effect of dead tubes
         
     public:
         VImageAnalyzer();
         ~VImageAnalyzer();
         
         void doAnalysis();                        //!< do the actual analysis (called for each event)
+        void doAnalysis( vector< unsigned int > iTelList );  //!< analyse list of telescopes (parallel if possible)
         VImageCleaning*  getImageCleaner()
         {
             return fVImageCleaning;    //! return pointer to image cleaner
@@ -19,6 +19,10 @@ class VImageBaseAnalyzer : public VEvndispData
     protected:
         vector<bool> fCalibrated;                 //!  true = calibration is done
         bool fRaw;
+        vector< double > fTraceBlockPed;           //!< pedestals per hit (vectorized trace analysis)
+        vector< double > fTraceBlockLowGain;       //!< low-gain multiplier per hit (vectorized trace analysis)
+        vector< valarray< double > > fWindowSums; //!< sums per summation window and channel (see calcSumsAllWindows())
+        vector< double > fTraceWindowSums;        //!< sums per summation window of the current trace
 
         void calcSecondTZerosSums();
         void calcTZeros( int , int );
@@ -32,16 +36,23 @@ class VImageBaseAnalyzer : public VEvndispData
 
         void initializeTrace( bool iMakingPeds, unsigned int i_channelHitID,
                               unsigned int i, unsigned int iTraceIntegrationMethod );
+        bool initializeTraceBlock( bool iMakingPeds );
 
     public:
         VImageBaseAnalyzer() {}
         ~VImageBaseAnalyzer() {}
 
         void           calcSums( int iFirst , int iLast, bool iMakingPeds, bool iLowGainOnly = false, unsigned int iTraceIntegrationMethod = 9999 );
+        void           calcSumsAllWindows( int iFirst, unsigned int iNWindows, bool iMakingPeds, bool iLowGainOnly = false,
+                                           unsigned int iTraceIntegrationMethod = 9999 );
         unsigned int   fillHiLo();                          //!< fill hi/low gain vector
         int            fillSaturatedChannels();
         unsigned int   fillZeroSuppressed();
         void           findDeadChans( bool iLowGain = false, bool iFirst = true );
         void           gainCorrect();
+        valarray< double >& getWindowSums( unsigned int iWindow )
+        {
+            return fWindowSums[iWindow];
+        }
 };
 #endif
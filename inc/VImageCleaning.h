@@ -7,6 +7,9 @@
 #include "TGraphErrors.h"
 
 #include "VImageCleaningRunParameter.h"
+#include "VNNProbabilityCurve.h"
+
+#include <stdint.h>
 
 using namespace std;
 
@@ -17,6 +20,19 @@ class VImageCleaning
         VEvndispData* fData;
         bool fWriteGraphToFileRecreate;
 
+        // tailcut cleaning with channel bit masks (64 channels per word)
+        vector< double >   fThreshImage;                //!< [channel] image threshold of current event
+        vector< double >   fThreshBorder;               //!< [channel] border threshold of current event
+        vector< double >   fThreshBright;               //!< [channel] bright pixel threshold of current event
+        vector< uint64_t > fMaskImage;                  //!< image pixels
+        vector< uint64_t > fMaskBorderCandidate;        //!< pixels above border threshold
+        vector< uint64_t > fMaskBorder;                 //!< border pixels
+        vector< uint64_t > fMaskBright;                 //!< bright pixels
+        vector< uint64_t > fMaskDilated;                //!< neighbours of image pixels
+
+        void cleanImageTailcut( double hithresh, double lothresh, double brightthresh, bool bPedvars );
+        void fillTailcutThresholds( double hithresh, double lothresh, double brightthresh, bool bPedvars );
+
         void cleanImageWithTiming( VImageCleaningRunParameter* iImageCleaningParameters, bool isFixed );
         void fillImageBorderNeighbours();
         void fillBorderBorderNeighbours();
@@ -42,6 +58,13 @@ class VImageCleaning
         TObjArray* fProb2nnCurves;
         TObjArray* fProbBoundCurves;
         TObjArray* fIPRgraphs;
+        // tabulated rate contour curves [teltype] (used in NN group search)
+        vector< VNNProbabilityCurve > fProb4nnTables;
+        vector< VNNProbabilityCurve > fProb3nnrelTables;
+        vector< VNNProbabilityCurve > fProb2plus1Tables;
+        vector< VNNProbabilityCurve > fProb2nnTables;
+        vector< VNNProbabilityCurve > fProbBoundTables;
+        vector< vector< float > > fNNPreThresh;                    // [nteltypes][6] pre-search thresholds
         vector< float > fIPRgraphs_xmax;
         vector< vector< bool > > fifActiveNN;                      // [nteltypes][nngroups]
         bool ifActiveNN[VDST_MAXNNGROUPTYPES][VDST_MAXTELTYPES];   // if  NN groups is searched in NN-image cleaning procedure
@@ -55,11 +78,6 @@ class VImageCleaning
         bool   setExplicitSampleTimeSlice;      // Set the sample time slice and number of ADC bins to read explicitly
         float  sampleTimeSlice;                // Size of time slice in ns (usually 1 or 2 ns)
         unsigned int  nBinsADC;                // Number of ADC bins summed up, each bin the size of sampleTimeSlice
-        float fIPR_save_mincharge;
-        float fIPR_save_dT_from_probCurve;
-        unsigned int fIPR_save_telid;
-        double fIPR_save_ProbCurve_par1;
-        double fIPR_save_ProbCurve_par2;
 
         float INTENSITY[VDST_MAXCHANNELS];     //
         float TIMES[VDST_MAXCHANNELS];         //
@@ -69,10 +87,10 @@ class VImageCleaning
         void  LocMax( int n, float* ptr, float& max );
 
         // main functions
-        bool  BoundarySearch( unsigned int TrigSimTelType, float thresh, TF1* fProbCurve, float refdT, int refvalidity, int idx );
-        unsigned int   NNGroupSearchProbCurve( unsigned int TrigSimTelType, TF1* fProbCurve, float PreCut );
-        unsigned int   NNGroupSearchProbCurveRelaxed( unsigned int TrigSimTelType, TF1* fProbCurve, float PreCut );
-        bool  NNChargeAndTimeCut( TGraph* IPR,  float iIPR_max, TF1* fProbCurve, float charge, float dT,
+        bool  BoundarySearch( unsigned int TrigSimTelType, float thresh, VNNProbabilityCurve* iProbCurve, float refdT, int refvalidity, int idx );
+        unsigned int   NNGroupSearchProbCurve( unsigned int TrigSimTelType, VNNProbabilityCurve* iProbCurve, float PreCut );
+        unsigned int   NNGroupSearchProbCurveRelaxed( unsigned int TrigSimTelType, VNNProbabilityCurve* iProbCurve, float PreCut );
+        bool  NNChargeAndTimeCut( VNNProbabilityCurve* iProbCurve, float charge, float dT,
                                   float iCoincWinLimit, bool bInvert = false );
         void  ScaleCombFactors( unsigned int TrigSimTelType, float scale );
         void  ResetCombFactors( unsigned int TrigSimTelType );
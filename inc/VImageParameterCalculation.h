@@ -13,6 +13,7 @@
 #include "VHoughTransform.h"
 #include "VImageParameter.h"
 #include "VImageParameterFitter.h"
+#include "VTraceKernels.h"
 
 #include "TError.h"
 #include "TMath.h"
@@ -48,6 +49,14 @@ class VImageParameterCalculation
         double getFractionOfImageBorderPixelUnderImage( double, double, double, double, double, double );
         void   setImageBorderPixelPosition( VImageParameter* iPar );
 
+        // image moments
+        vector< vector< double > > fPixelX;                //!< [telescope][channel] pixel x-position (cached camera geometry)
+        vector< vector< double > > fPixelY;                //!< [telescope][channel] pixel y-position (cached camera geometry)
+        vector< unsigned char >    fPixelMask;             //!< [channel] image or border pixel (current event)
+        vector< unsigned int >     fImageBorderPixel;      //!< list of image and border pixels (current event)
+
+        void   cacheCameraGeometry();
+
         // Hough transform
         VHoughTransform* fHoughTransform;
 
@@ -80,6 +89,10 @@ class VImageParameterCalculation
         {
             return fParLL;
         }
+        bool isLLFitReentrant()                   //!< log likelihood fits can run concurrently for different telescopes
+        {
+            return ( fImageFitter && fImageFitter->isReentrant() );
+        }
         bool getboolCalcGeo()                     //!< get image parameters calculated flag
         {
             return fboolCalcGeo;
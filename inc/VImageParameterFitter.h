@@ -7,6 +7,7 @@
 #include <vector>
 
 #include "VEvndispData.h"
+#include "VImageParameterLLMinimizer.h"
 
 #include "TF2.h"
 #include "TMinuit.h"
@@ -37,6 +38,10 @@ class VImageParameterFitter : public TObject
         // image fitting function
         bool bRotatedNormalDistributionFit;
 
+        // minimizer for rotated normal distribution fit
+        // (analytic derivatives; minuit is used for the non-rotated distribution only)
+        VImageParameterLLMinimizer fLLMinimizer;
+
         //  starting values for fit
         double fdistXmin;
         double fdistXmax;
@@ -89,6 +94,10 @@ class VImageParameterFitter : public TObject
 
         // fitting
         void defineFitParameters();
+        void fixFitParameter( unsigned int i );
+        void getFitParameter( unsigned int i, double& iValue, double& iError );
+        void releaseFitParameter( unsigned int i );
+        void setFitParameter( unsigned int i, string iName, double iValue, double iStep, double iMin, double iMax );
         void getFitStatistics();
         void getFitResults();
         void resetFitParameters();
@@ -120,6 +129,10 @@ class VImageParameterFitter : public TObject
             return fNormal2D;
         }
         void initMinuit( int );
+        bool isReentrant()                          //!< fits of different fitters can run concurrently (no TMinuit)
+        {
+            return bRotatedNormalDistributionFit;
+        }
 
         VDetectorGeometry* getDetectorGeometry()
         {
@@ -0,0 +1,100 @@
+//! VImageParameterLLMinimizer  log-likelihood fit of a rotated 2D Gaussian to camera images (analytic derivatives)
+
+#ifndef VImageParameterLLMinimizer_H
+#define VImageParameterLLMinimizer_H
+
+#include <cmath>
+#include <iostream>
+#include <string>
+#include <vector>
+
+using namespace std;
+
+/*
+ * fit parameters (same order as in the TMinuit based fit):
+ *
+ *   0: phi      orientation of the Gaussian
+ *   1: meanX    centroid x
+ *   2: sigmaX   sigma along the rotated x-axis
+ *   3: meanY    centroid y
+ *   4: sigmaY   sigma along the rotated y-axis
+ *   5: signal   normalisation
+ *   6: toffset  time offset (time gradient fit only)
+ *   7: tgrad    time gradient along the rotated x-axis (time gradient fit only)
+ *   8: tchi2    width of time distribution (always fixed)
+ */
+class VImageParameterLLMinimizer
+{
+    private:
+        static const unsigned int fNPar = 9;
+        static const unsigned int fNParDeriv = 8;     //!< number of parameters with derivatives (tchi2 is always fixed)
+
+        bool   fDebug;
+
+        // data (not owned)
+        const vector< double >* fX;
+        const vector< double >* fY;
+        const vector< double >* fSums;
+        const vector< double >* fT;
+        bool   fTimeGradient;                       //!< add time gradient term to log-likelihood
+
+        // fit parameters
+        string fParName[fNPar];
+        double fPar[fNPar];
+        double fParError[fNPar];
+        double fParMin[fNPar];
+        double fParMax[fNPar];
+        bool   fParFixed[fNPar];
+
+        // minimizer settings and fit statistics
+        unsigned int fMaxIterations;
+        double fEDMTolerance;
+        int    fFitStatus;
+        double fFmin;
+        double fEDM;
+        unsigned int fNIterations;
+
+        // work space
+        double fGrad[fNParDeriv];
+        double fHess[fNParDeriv * fNParDeriv];
+
+        bool   choleskyDecomposition( double* iA, unsigned int n );
+        void   choleskySolve( const double* iL, unsigned int n, double* iB );
+        double getEDM( const double* iGrad, const double* iHess, const vector< unsigned int >& iPar, bool& bPosDef );
+        bool   isAtLimit( unsigned int i, const double* iGrad );
+
+    public:
+        VImageParameterLLMinimizer();
+        ~VImageParameterLLMinimizer() {}
+
+        void   fixParameter( unsigned int i );
+        double getFmin()
+        {
+            return fFmin;
+        }
+        double getEDM()
+        {
+            return fEDM;
+        }
+        int    getFitStatus()
+        {
+            return fFitStatus;
+        }
+        double getLogLikelihood( const double* iPar, double* iGrad = 0, double* iHess = 0 );
+        unsigned int getNIterations()
+        {
+            return fNIterations;
+        }
+        void   getParameter( unsigned int i, double& iValue, double& iError );
+        bool   minimize();
+        void   releaseParameter( unsigned int i );
+        void   setData( const vector< double >* iX, const vector< double >* iY,
+                        const vector< double >* iSums, const vector< double >* iT, bool iTimeGradient );
+        void   setDebug( bool iDebug = true )
+        {
+            fDebug = iDebug;
+        }
+        void   setParameter( unsigned int i, string iName, double iValue, double iMin, double iMax );
+};
+
+#endif
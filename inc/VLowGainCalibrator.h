@@ -1,6 +1,7 @@
 #ifndef VLowGainCalibrator_h
 #define VLowGainCalibrator_h
 
+#include "VDSTTree.h"
 #include "VGlobalRunParameter.h"
 
 #include "TCanvas.h"
@@ -119,15 +120,10 @@ class VLowGainCalibrator
         bool isNewPixel( int tel, int iChan );
         
         
-        unsigned int eventNumber;
-        float sumHiLo[VDST_MAXTELESCOPES][VDST_MAXCHANNELS];
-        float sumMonitor[VDST_MAXTELESCOPES][VDST_MAXCHANNELS];
-        UShort_t sumfirst[VDST_MAXTELESCOPES][VDST_MAXCHANNELS];
-        UShort_t HiLo[VDST_MAXTELESCOPES][VDST_MAXCHANNELS];
-        UShort_t sumwindow[VDST_MAXTELESCOPES][VDST_MAXCHANNELS];
-        UShort_t dead[VDST_MAXTELESCOPES][VDST_MAXCHANNELS];
-        Short_t RawMax[VDST_MAXTELESCOPES][VDST_MAXCHANNELS];
-        float pulsetiming[VDST_MAXTELESCOPES][VDST_MAXTIMINGLEVELS][VDST_MAXCHANNELS];
+        // DST tree reader (pixel data of telescope counter [tel])
+        VDSTTree* fDST;                                 //!
+        VDSTChannelArray< float >* fSumHiLo;            //! sum or sum2 (see sw2monitor)
+        VDSTChannelArray< float >* fSumMonitor;         //!
         
         double calcMonitorCharge( int tel, int ientry = -1 );
         double calcMeanMonitorCharge( int tel , int ientry = -1 );
@@ -0,0 +1,49 @@
+//! VNNProbabilityCurve  tabulated rate contour (probability) curve for NN image cleaning
+
+#ifndef VNNPROBABILITYCURVE_H
+#define VNNPROBABILITYCURVE_H
+
+#include "TGraph.h"
+#include "TMath.h"
+
+#include <iostream>
+#include <vector>
+
+using namespace std;
+
+class VNNProbabilityCurve
+{
+    private:
+        TGraph* fIPR;                    //!< IPR graph (rate vs charge)
+        float   fNfold;                  //!< multiplicity of NN group
+        bool    fBoundary;               //!< rate contour for boundary pixels
+        double  fExponent;               //!< exponent of IPR rate in rate contour
+        double  fNorm;                   //!< normalisation (depends on rate, combinatorial factor)
+        float   fChargeMin;              //!< lower edge of charge table (lowest charge of IPR graph or 0)
+        float   fChargeMax;              //!< upper edge of charge table (maximum charge of IPR graph)
+        float   fChargeBinWidth_inv;
+        vector< float > fIPRTable;       //!< IPR rate (>=100 Hz) at charge bins
+        vector< float > fContourTable;   //!< (IPR rate)^exponent at charge bins
+        float   fContour_overflow;       //!< (100 Hz)^exponent for charges above fChargeMax
+
+        double  getIPR_fromGraph( float iCharge );
+
+    public:
+        VNNProbabilityCurve();
+        ~VNNProbabilityCurve() {}
+
+        bool   fill( TGraph* iIPR, float iChargeMax, float iNfold, bool iBoundary = false, unsigned int iNBins = 16384 );
+        float  getDeltaT( float iCharge );
+        float  getIPR( float iCharge );
+        float  getNfold()
+        {
+            return fNfold;
+        }
+        bool   isFilled()
+        {
+            return ( fIPR && fContourTable.size() > 1 );
+        }
+        void   setParameters( double iRate, double iCombFactor, double iRefIPR = 1. );
+};
+
+#endif
@@ -0,0 +1,105 @@
+//! VQuantileSketch  mergeable streaming quantile sketch (merging t-digest) for weighted values
+
+#ifndef VQUANTILESKETCH_H
+#define VQUANTILESKETCH_H
+
+#include "TMath.h"
+
+#include <algorithm>
+#include <vector>
+
+using namespace std;
+
+struct sQuantileSketchCentroid
+{
+    float fMean;
+    float fWeight;
+    
+    bool operator<( const sQuantileSketchCentroid& c ) const
+    {
+        return fMean < c.fMean;
+    }
+};
+
+class VQuantileSketch
+{
+    private:
+        double fCompression;                             //!< t-digest compression (number of centroids is of this order)
+        unsigned int fBufferSize;                        //!< number of unmerged values before compression
+    
+        vector< sQuantileSketchCentroid > fCentroids;    //!< merged centroids [0,fNMerged) (sorted), followed by unmerged values
+        unsigned int fNMerged;
+        double fSumW;
+        double fSumWX;
+        unsigned int fEntries;                           //!< number of filled values (unweighted)
+        float fMin;
+        float fMax;
+    
+        double kScale( double q );
+        double kScaleInverse( double k );
+    
+    public:
+        VQuantileSketch( double iCompression = 100. );
+        ~VQuantileSketch() {}
+    
+        void   addCentroids( unsigned int iEntries, float iMin, float iMax,
+                             unsigned int iN, const float* iMean, const float* iWeight );
+        void   compress();
+        void   fill( double x, double w = 1. )
+        {
+            if( w <= 0. )
+            {
+                return;
+            }
+            if( fEntries == 0 || x < fMin )
+            {
+                fMin = ( float )x;
+            }
+            if( fEntries == 0 || x > fMax )
+            {
+                fMax = ( float )x;
+            }
+            sQuantileSketchCentroid c;
+            c.fMean = ( float )x;
+            c.fWeight = ( float )w;
+            fCentroids.push_back( c );
+            fSumW += w;
+            fSumWX += w * x;
+            fEntries++;
+            if( fCentroids.size() >= fNMerged + fBufferSize )
+            {
+                compress();
+            }
+        }
+        unsigned int getCentroids( vector< float >& iMean, vector< float >& iWeight );
+        double getCompression()
+        {
+            return fCompression;
+        }
+        unsigned int getEntries()
+        {
+            return fEntries;
+        }
+        float  getMax()
+        {
+            return fMax;
+        }
+        double getMean()
+        {
+            return ( fSumW > 0. ? fSumWX / fSumW : 0. );
+        }
+        float  getMin()
+        {
+            return fMin;
+        }
+        double getQuantile( double iProb );
+        void   getQuantiles( int iN, double* iQuantiles, const double* iProb );
+        double getSumOfWeights()
+        {
+            return fSumW;
+        }
+        void   merge( const VQuantileSketch& iS );
+        void   reset();
+};
+
+#endif
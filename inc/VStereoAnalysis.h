@@ -260,6 +260,9 @@ class VStereoAnalysis
         void   defineAstroSource();
         bool   closeDataFile();
         CData* getDataFromFile( int i_runNumber );
+        void   getEventSelection( int icounter, int irun, Long64_t iEntry, vector< double >& iR );
+        void   registerUsedBranches( CData* c );
+        bool   validateUsedBranches( int icounter, int irun, int iBatchSize );
         
         void fill_TreeWithSelectedEvents( CData*, double, double, double, bool );
         bool init_TreeWithSelectedEvents( int, bool );
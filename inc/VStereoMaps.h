@@ -14,7 +14,11 @@
 #include "TRandom3.h"
 #include "TTree.h"
 
+#include <cstdlib>
 #include <iostream>
+#include <map>
+#include <utility>
+#include <vector>
 
 using namespace std;
 
@@ -28,6 +32,9 @@ struct sRE_REGIONS
 
 class VStereoMaps
 {
+        // tests with access to private methods (testStereoMaps, testRingKernel)
+        friend class VStereoMapsTest;
+    
     private:
     
         VAnaSumRunParameterDataClass fRunList;
@@ -58,6 +65,22 @@ class VStereoMaps
         int fInitRun;
         
         void makeTwoDStereo_BoxSmooth( double, double, double, double, double );
+    
+        // correlated maps: events collected per smoothing radius
+        // (filled in finalize(), see fillCorrelatedMaps())
+        struct sCorrelatedMapLayer
+        {
+            double fThetaCutMax;
+            double fWeight;
+            double fMeanSignalBackgroundAreaRatio;
+            vector< double > fX;                  //!< event positions (derotated)
+            vector< double > fY;
+        };
+        bool fCorrelatedMapsFromEventList;
+        vector< sCorrelatedMapLayer > fCorrelatedMapLayer;
+        map< pair< double, pair< double, double > >, unsigned int > fCorrelatedMapLayerIndex;
+        
+        void addFillsToBin( TH1* h, int iBin, double iSumW, double iSumW2 );
         
         // theta2 calculation
         unsigned int fTheta2_length;
@@ -76,6 +99,11 @@ class VStereoMaps
         void RM_calculate_norm();
         void RM_getAlpha( bool );
         
+        // ring kernel integration of acceptance map (see RM_getAlpha_RingKernel())
+        bool fRM_RingKernel;
+        void RM_getAlpha_RingKernel( bool iIsOn, double i_rS, double i_rL, double i_rU, double iNB_expected );
+        double RM_getTriangularCDF( double t );
+        
         // REFLECTED REGION MODEL:
         vector< vector< sRE_REGIONS > > fRE_off;  //!< off region parameters
         double fRE_roffTemp;                      //!< radius of off source region
@@ -124,6 +152,7 @@ class VStereoMaps
         void              calculateTheta2( bool, double, double );
         bool              fill( bool is_on, double x_sky, double y_sky, double theta2CutMax,
                                 int irun, bool ishapecuts, double& i_theta2 );
+        void              fillCorrelatedMaps();
         void              finalize( bool iIsOn , double OnOff_Alpha = 1.0 );
         VRadialAcceptance*      getAcceptance()
         {
@@ -153,6 +182,22 @@ class VStereoMaps
         {
             return hAuxHisList;
         }
+        void              registerUsedBranches( CData* c )
+        {
+            if( c )
+            {
+                c->useBranch( "MSCW" );
+                c->useBranch( "MSCL" );
+            }
+        }
+        void              setCorrelatedMapsFromEventList( bool iB = true )
+        {
+            fCorrelatedMapsFromEventList = iB;
+        }
+        void              setRingKernelIntegration( bool iB = true )
+        {
+            fRM_RingKernel = iB;
+        }
         void              setData( CData* c )
         {
             fData = c;
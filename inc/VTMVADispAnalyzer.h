@@ -17,6 +17,8 @@
 #include "TMVA/Reader.h"
 #include "TMVA/Tools.h"
 
+#include "VTMVAForest.h"
+
 using namespace std;
 
 class VTMVADispAnalyzer
@@ -28,8 +30,22 @@ class VTMVADispAnalyzer
         string fDispType;
         
         vector<ULong64_t> fTelescopeTypeList;
-        map< ULong64_t, TMVA::Reader* > fTMVAReader;
+        vector< TMVA::Reader* > fTMVAReader;          //!< [telescope type] (used if no compiled forest is available)
+        vector< VTMVAForest* > fTMVAForest;           //!< [telescope type]
+        vector< vector< float* > > fTMVAVariables;     //!< [telescope type][variable]: input variables in the order of the weight file
+        ULong64_t    fCachedTelType;
+        unsigned int fCachedTelTypeIndex;
+        
+        // batch evaluation (see addImage() and evaluateImages())
+        vector< unsigned int > fBatch_TelTypeIndex;   //!< [image]
+        vector< unsigned int > fBatch_Offset;         //!< [image] first variable in fBatch_Variables
+        vector< float > fBatch_Variables;
+        vector< float > fBatch_Result;                //!< [image]
+        vector< unsigned int > fBatch_List;           //!< work space: images of one telescope type
+        vector< float > fBatch_TypeVariables;
+        vector< double > fBatch_TypeResult;
         
+
         float fWidth;
         float fLength;
         float fWoL;
@@ -49,15 +65,27 @@ class VTMVADispAnalyzer
         float fRcore;
         float fEHeight;
         
+        float evaluateVariables( unsigned int iTelTypeIndex );
+        unsigned int getTelescopeTypeIndex( ULong64_t iTelType );
+        bool  setVariables( float iWidth, float iLength, float iSize, float iAsymm, float iLoss,
+                            float iTGrad, float icen_x, float icen_y, float xoff_4, float yoff_4,
+                            float iZe, float iAz, float iRcore,
+                            float iEHeight, float iDist, float iFui, float iNtubes );
+        
     public:
     
         VTMVADispAnalyzer( string iFile, vector< ULong64_t > iTelTypeList, string iDispType = "BDTDisp" );
-        ~VTMVADispAnalyzer() {}
+        ~VTMVADispAnalyzer();
         
+        void  addImage( float iWidth, float iLength, float iSize, float iAsymm, float iLoss,
+                        float iTGrad, float icen_x, float icen_y, float xoff_4, float yoff_4,
+                        ULong64_t iTelType, float iZe, float iAz, float iRcore,
+                        float iEHeight = -1., float iDist = -1., float iFui = -1., float iNtubes = -1 );
         float evaluate( float iWidth, float iLength, float iSize, float iAsymm, float iLoss,
                         float iTGrad, float icen_x, float icen_y, float xoff_4, float yoff_4,
                         ULong64_t iTelType, float iZe, float iAz, float iRcore,
                         float iEHeight = -1., float iDist = -1., float iFui = -1., float iNtubes = -1 );
+        const vector< float >& evaluateImages();
         bool isZombie()
         {
             return bZombie;
@@ -9,12 +9,15 @@
 #include "VHistogramUtilities.h"
 #include "VPlotUtilities.h"
 #include "VStatistics.h"
+#include "VTMVAForest.h"
 #include "VTMVARunData.h"
 #include "VUtilities.h"
 
+#include <cstring>
 #include <fstream>
 #include <iostream>
 #include <map>
+#include <set>
 #include <sstream>
 #include <string>
 #include <vector>
@@ -168,6 +171,24 @@ class VTMVAEvaluator : public TNamed, public VPlotUtilities
         float    fDispAbsSumWeigth;
         float    fDummy;
         
+        // compiled BDTs of all data bins (TMVA readers are used for all other methods)
+        VTMVAForest*     fTMVAForest;                           //!
+        vector< int >    fTMVAForestID;                         //!  [data bin] forest index (-1: use TMVA reader)
+        vector< vector< float* > > fTMVAVariables;              //!  [data bin] input variables (order of weight file)
+        set< string >    fTMVAVariableExpressions;              //!  input variables of all data bins (see registerUsedBranches())
+        vector< float >  fTMVAVariableValues;                   //!  work space
+        
+        // MVA values cached per event (see evaluate())
+        bool                fTMVAResultCaching;
+        vector< double >    fTMVAResultCache_MVA;               //!  [entry]
+        vector< ULong64_t > fTMVAResultCache_Key;               //!  [entry] event key (0 for no entry)
+        
+        // work space for batch evaluation (see evaluateBatch())
+        vector< vector< Long64_t > >  fBatchEntry;              //!  [data bin][event] tree entry
+        vector< vector< ULong64_t > > fBatchKey;                //!  [data bin][event] event key
+        vector< vector< float > >     fBatchVariables;          //!  [data bin][event x variable]
+        vector< double >              fBatchMVA;                //!  [event]
+        
         bool     bPlotEfficiencyPlotsPerBin;
         bool     fPrintPlotting;
         unsigned int      fWeightFileIndex_Emin;
@@ -176,7 +197,11 @@ class VTMVAEvaluator : public TNamed, public VPlotUtilities
         unsigned int      fWeightFileIndex_Zmax;
         
         
+        void             addVariable( unsigned int iDataBin, string iVarName, float* iVar );
         double           evaluateInterPolateMVA( double iErec_log10TeV, double iZe, unsigned int evaluateInterPolateMVA );
+        double           evaluateMVA( unsigned int iDataBin, Long64_t iEntry = -1 );
+        bool             fillEventVariables();
+        void             fillVariableValues( unsigned int iDataBin );
         TH1D*            getEfficiencyHistogram( string iName, TFile* iF, string iMethodTag_2 );
         double           getMeanEnergyAfterCut( TFile* f, double iCut, unsigned int iDataBin );
         bool             optimizeSensitivity( unsigned int iDataBin, string iOptimizationType, string iEpoch = "noepoch" );
@@ -221,6 +246,7 @@ class VTMVAEvaluator : public TNamed, public VPlotUtilities
                                              string iFileSuffix );
         void             smoothAndInterpolateMVAValue( unsigned int iE_min, unsigned int iE_max,
                 unsigned int iZ_min, unsigned int iZ_max, double iEnergyStepSize );
+        ULong64_t        getEventKey( unsigned int iDataBin );
         TGraphAsymmErrors* fillSmoothedEfficencyGraph( TGraphAsymmErrors* g, unsigned int iZe, bool iSignalEff = true );
         TGraphAsymmErrors* fillSmoothedMVACutGraph( TGraphAsymmErrors* g, unsigned int iZe );
         TGraphAsymmErrors* smoothMVAGraph( TGraphAsymmErrors* g,
@@ -239,7 +265,8 @@ class VTMVAEvaluator : public TNamed, public VPlotUtilities
         VTMVAEvaluator();
         ~VTMVAEvaluator();
         
-        bool    evaluate();
+        bool    evaluate( Long64_t iEntry = -1 );
+        void    evaluateBatch( Long64_t iEntry_min, Long64_t iNEntries );
         TGraph* getOptimalTheta2Cut_Graph();
         vector< double > getBackgroundEfficiency();
         vector< bool >   getOptimumCutValueFound();
@@ -276,6 +303,7 @@ class VTMVAEvaluator : public TNamed, public VPlotUtilities
         void   printSensitivityOptimizationParameters();
         void   printSignalEfficiency();
         void   printSourceStrength_CU();
+        void   registerUsedBranches( CData* iC );
         void   setDebug( bool iB = false )
         {
             fDebug = iB;
@@ -317,6 +345,10 @@ class VTMVAEvaluator : public TNamed, public VPlotUtilities
         {
             fPrintPlotting = iPrintPlotting;
         }
+        void   setResultCaching( bool iB = true )
+        {
+            fTMVAResultCaching = iB;
+        }
         void   setSignalEfficiency( double iSignalEfficiency = -99. );
         void   setSignalEfficiency( map< unsigned int, double > iMSignalEfficiency );
         void   setSmoothAndInterpolateMVAValues( bool iS = true )
@@ -353,7 +385,7 @@ class VTMVAEvaluator : public TNamed, public VPlotUtilities
         void   setTMVAMethod( string iMethodName = "BDT", int iMethodCounter = 0 );
         bool   writeOptimizedMVACutValues( string iRootFile );
         
-        ClassDef( VTMVAEvaluator, 52 );
+        ClassDef( VTMVAEvaluator, 53 );
 };
 
 #endif
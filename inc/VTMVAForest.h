@@ -0,0 +1,118 @@
+//! VTMVAForest  TMVA BDT weight files compiled into a flat node array
+
+#ifndef VTMVAForest_H
+#define VTMVAForest_H
+
+#include "TXMLEngine.h"
+
+#include <cmath>
+#include <cstdlib>
+#include <iostream>
+#include <limits>
+#include <string>
+#include <vector>
+
+using namespace std;
+
+class VTMVAForest
+{
+    private:
+
+        // decision tree node
+        // (children are ordered such that fChild[ x >= fCut ] is the next node)
+        struct sNode
+        {
+            int          fVar;                //!< variable index (-1 for leaf nodes)
+            float        fCut;
+            unsigned int fChild[2];
+            float        fResponse;           //!< leaf value (regression response, node type or purity)
+        };
+
+        // one BDT (weight file)
+        struct sForest
+        {
+            string       fFileName;
+            bool         fRegression;
+            bool         fGrad;               //!< BoostType=Grad
+            unsigned int fTree_min;           //!< index of first tree in fTreeRoot
+            unsigned int fNTrees;
+            vector< string > fVariableExpression; //!< variable expressions (in order of the weight file)
+
+            // variable normalisation (VarTransform=N)
+            vector< char >  fVarNormalise;    //!< [variable]
+            vector< float > fVarOffset;
+            vector< float > fVarScale;
+            bool         fTargetNormalise;
+            float        fTargetOffset;
+            float        fTargetScale;
+        };
+
+        bool   fDebug;
+        bool   bZombie;
+
+        vector< sForest > fForest;
+        vector< sNode >  fNode;               //!< nodes of all trees of all forests
+        vector< unsigned int > fTreeRoot;     //!< index of root node of each tree
+        vector< double > fBoostWeight;        //!< boost weight of each tree
+
+        vector< float > fTransformed;         //!< work space: transformed variables (variable by variable)
+        vector< double > fSum;                //!< work space: sum of tree responses per event
+        vector< char > fNaN;                  //!< work space: events with NaN input variables
+
+        int    addNode( TXMLEngine& iXML, XMLNodePointer_t iNode, sForest& iForest, int iLeafValue );
+        double getResponse( const sForest& iForest, double iSum, double iNorm );
+        bool   readTransformation( TXMLEngine& iXML, XMLNodePointer_t iNode, sForest& iForest );
+        bool   readTrees( TXMLEngine& iXML, XMLNodePointer_t iNode, sForest& iForest, int iLeafValue );
+
+    public:
+
+        VTMVAForest();
+        ~VTMVAForest() {}
+
+        int    addForest( string iXMLFile );
+        void   evaluate( unsigned int iForest, unsigned int iNEvents, const float* iVar, double* iResult );
+        void   evaluate( unsigned int iNEvents, const float* iVar, double* iResult )
+        {
+            evaluate( 0, iNEvents, iVar, iResult );
+        }
+        double evaluate( unsigned int iForest, const float* iVar );
+        double evaluate( const float* iVar )
+        {
+            return evaluate( 0, iVar );
+        }
+        unsigned int getNForests()
+        {
+            return fForest.size();
+        }
+        unsigned int getNNodes()
+        {
+            return fNode.size();
+        }
+        unsigned int getNTrees( unsigned int iForest = 0 )
+        {
+            return ( iForest < fForest.size() ? fForest[iForest].fNTrees : 0 );
+        }
+        unsigned int getNVariables( unsigned int iForest = 0 )
+        {
+            return ( iForest < fForest.size() ? fForest[iForest].fVariableExpression.size() : 0 );
+        }
+        string getVariableExpression( unsigned int i, unsigned int iForest = 0 )
+        {
+            if( iForest < fForest.size() && i < fForest[iForest].fVariableExpression.size() )
+            {
+                return fForest[iForest].fVariableExpression[i];
+            }
+            return "";
+        }
+        bool   initialize( string iXMLFile );
+        bool   isZombie()
+        {
+            return bZombie;
+        }
+        void   setDebug( bool iB = true )
+        {
+            fDebug = iB;
+        }
+};
+
+#endif
@@ -9,10 +9,11 @@
 #include "TH2F.h"
 #include "TMath.h"
 #include "TProfile2D.h"
+#include "TTree.h"
 
 #include "VGlobalRunParameter.h"
 #include "VHistogramUtilities.h"
-#include "VMedianCalculator.h"
+#include "VQuantileSketch.h"
 #include "VStatistics.h"
 
 #include <cmath>
@@ -41,6 +42,7 @@ class VTableCalculator
         {
             return fOutDir;
         }
+        bool readQuantileSketches( TTree* t );
         void setCalculateEnergies()
         {
             fEnergy = true;
@@ -63,6 +65,15 @@ class VTableCalculator
             fMinShowerPerBin = iM;
         }
         void setNormalizeTableValues( double i_value_min = -9999., double i_value_max = -9999. );
+        void setQuantileSketchCompression( double iC = 100. )
+        {
+            fQuantileSketchCompression = iC;
+        }
+        void setQuantileSketchDirectory( TDirectory* iD )
+        {
+            fQuantileSketchDir = iD;
+        }
+        void setTableValues( double* iMedian, double* iSigma );
         void setVHistograms( vector< TH2F* >& hM );
         void setInterpolationConstants( int, int );
         void setOutputDirectory( TDirectory* iF )
@@ -86,6 +97,8 @@ class VTableCalculator
         float* fBinning1Dxbins;
         
         float fMinShowerPerBin;        // minimum number per bin required (table writing)
+        double fQuantileSketchCompression;     // compression of quantile sketches (table writing)
+        TDirectory* fQuantileSketchDir;        // directory for quantile sketches (0: output directory)
         
         double fValueNormalizationRange_min;   // lookup table value normalization: min value
         double fValueNormalizationRange_max;   // lookup table value normalization: max value
@@ -104,19 +117,28 @@ class VTableCalculator
         string fHName_Add;
         
         bool fEnergy;                             //!< true if tables are used for energy calculation
+        bool fPE;                                 //!< table binning for MC with values in PE
         int  fUseMedianEnergy;
         
         // event selection cut
         double fEventSelectionCut_lossCutMax;
         double fEventSelectionCut_distanceCutMax;
         
-        bool fFillMedianApproximations;
-        vector< vector< TH1F* > > Oh;
-        vector< vector< VMedianCalculator* > > OMedian;
+        vector< vector< VQuantileSketch* > > fQuantileSketch;    //!< [size bin][distance bin] distribution of table variable
         TProfile2D* hMean;
         TH2F* hMedian;
         string hMedianName;
         vector< TH2F* > hVMedian;
+        double* fTableValueMedian;                //!< [ntel] expected values (interpolated externally, see setTableValues())
+        double* fTableValueSigma;                 //!< [ntel] sigma of expected values
+        
+        // scratch buffers for calc() (reused for all events)
+        vector< double > fCalc_w_fill;
+        vector< double > fCalc_energy_tel;
+        vector< double > fCalc_sigma2_tel;
+        vector< double > fCalc_sigma2_tel_noRadiusWeigth;
+        vector< double > fCalc_sigma_tel;
+        vector< bool >   fCalc_good_image;
         
         // histogram interpolation
         int fInterPolWidth;
@@ -128,14 +150,15 @@ class VTableCalculator
         
         bool    fWriteTables;
         
-        bool   create1DHistogram( int i, int j );
-        bool   createMedianApprox( int i, int j );
+        TH1F*  create1DHistogram( int i, int j );
+        bool   createQuantileSketch( int i, int j );
         double getWeightMeanBinContent( TH2F*, int, int, double, double );
         void   fillMPV( TH2F*, int, int, TH1F*, double, double );
         double interpolate( TH2F* h, double x, double y, bool iError );
         bool   readHistograms();
         void   setBinning();
         void   setConstants( bool iPE = false );
+        void   writeQuantileSketches();
         
 };
 #endif
@@ -7,9 +7,12 @@
 #include "TError.h"
 #include "TFile.h"
 #include "TMath.h"
+#include "TROOT.h"
 #include "TSystem.h"
 
+#include "VAnalysisThreadPool.h"
 #include "VStatistics.h"
+#include "VTableLookupCompiled.h"
 #include "VTableLookupDataHandler.h"
 #include "VTableLookupRunParameter.h"
 #include "VTablesToRead.h"
@@ -36,12 +39,17 @@ class VTableCalculatorData
         // n-dimensional vectors [tel_type][NSB][ze][woff][az]
         vector< vector< vector< vector< vector< VTableCalculator* > > > > > fTable;
         
+        // compiled tables (contiguous arrays) and table index [tel_type][NSB][ze][woff][az]
+        VTableLookupCompiled* fCompiledTable;
+        vector< vector< vector< vector< vector< int > > > > > fCompiledTableID;
+        
         double fValueNormalizationRange_min;
         double fValueNormalizationRange_max;
         
         VTableCalculatorData();
         ~VTableCalculatorData() {}
         bool    assertTableVector( unsigned int wobble_bin );
+        bool    compile();
         void    print();
         void    terminate( TFile* iFile );
         
@@ -55,8 +63,10 @@ class VTableLookup
         enum E_TLvalue { E_MSCW, E_MSCL, E_EREC, E_TGRA };
         
         VTableLookupRunParameter* fTLRunParameter; // lookup table run parameter
+        bool bOwnRunParameter;                   // run parameter is a copy owned by this reader (parallel table reading)
         
         int fNTel;
+        unsigned int fWorkerID;                  // entry range for parallel table reading (0 for serial reading)
         
         //////////////////////////////////////////////////////////////////////
         // event data
@@ -89,6 +99,7 @@ class VTableLookup
         
         // used for calculations
         VTableCalculator*       fTableCalculator;
+        bool                    fCompiledTables;     // use compiled tables (see VTableLookupCompiled)
         
         // big and ugly
         VTablesToRead* s_NupZupWup;
@@ -118,8 +129,10 @@ class VTableLookup
         // private functions
         
         void             calculateMSFromTables( VTablesToRead* s );
+        bool             compileLookupTables();
         bool             cut( bool bWrite = false );  // apply cuts on successfull reconstruction to input data
         void             fillLookupTable();
+        void             fillTableValues( VTablesToRead* s );
         int              getAzBin( double az );
         void             getIndexBoundary( unsigned int* ib, unsigned int* il, vector< double >& iV, double x );
         vector< string > getSortedListOfDirectories( TDirectory* );
@@ -129,6 +142,7 @@ class VTableLookup
         void             initializeLookupTableDataVector();
         void             interpolate( VTablesToRead* s1, double w1, VTablesToRead* s2, double w2, VTablesToRead* s, double w, bool iCos = false );
         void             readLookupTable();
+        void             readLookupTable_parallel();
         void             readNoiseLevel( bool bWriteToRunPara = true ); // read noise level from pedvar histograms of data files
         bool             sanityCheckLookupTableFile( bool iPrint = false );
         bool             setInputFiles( vector< string > iInputFiles ); // set input files from evndisp
@@ -136,10 +150,12 @@ class VTableLookup
         void             setMCTableFiles_forTableWriting( string, double, int, map< ULong64_t, double >, string, string ); // set MC table file names
         void             setOutputFile( string outputfile, string writeoption, string tablefile ); // set file for output tree with mscw, energy, etc.
         void             setSpectralIndex( double iS );
+        void             setTableCalculatorTables( VTablesToRead* s, unsigned int iTableType );
         
     public:
         VTableLookup( VTableLookupRunParameter* iTLRunParameter );
-        ~VTableLookup() {}
+        VTableLookup( VTableLookup* iLookup, unsigned int iWorkerID, Long64_t iFirstEntry, Long64_t iLastEntry );
+        ~VTableLookup();
         
         double getMaxTotalTime()
         {
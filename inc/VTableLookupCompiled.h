@@ -0,0 +1,65 @@
+//! VTableLookupCompiled  lookup tables of one type (e.g. mscw) compiled into contiguous arrays
+
+#ifndef VTableLookupCompiled_H
+#define VTableLookupCompiled_H
+
+#include "TH2F.h"
+
+#include "VStatistics.h"
+
+#include <iostream>
+#include <vector>
+
+using namespace std;
+
+class VTableLookupCompiled
+{
+    private:
+        // axis definition per table (fixed bin widths only)
+        struct sTableAxes
+        {
+            int    fNX;
+            double fXmin;
+            double fXmax;
+            double fXBinWidth;
+            int    fNY;
+            double fYmin;
+            double fYmax;
+            double fYBinWidth;
+            unsigned int fOffset;             //!< offset of first bin in fMedian and fSigma
+        };
+        
+        vector< sTableAxes > fAxes;           //!< [table]
+        vector< float >      fMedian;         //!< median values of all tables (including under/overflow bins)
+        vector< float >      fSigma;          //!< sigma (bin errors) of all tables
+        
+        int    findBin( double x, int n, double xmin, double xmax )
+        {
+            if( x < xmin )
+            {
+                return 0;
+            }
+            else if( !( x < xmax ) )
+            {
+                return n + 1;
+            }
+            return 1 + int( n * ( x - xmin ) / ( xmax - xmin ) );
+        }
+    
+    public:
+        VTableLookupCompiled() {}
+        ~VTableLookupCompiled() {}
+        
+        int    addTable( TH2F* h );
+        void   interpolate( int iTable, double x, double y, double& iMedian, double& iSigma );
+        unsigned int getNTables()
+        {
+            return fAxes.size();
+        }
+        unsigned int getSize()
+        {
+            return fMedian.size();
+        }
+};
+
+#endif
@@ -25,6 +25,7 @@
 #include "TObjArray.h"
 #include "TRandom3.h"
 #include "TKey.h"
+#include "TSystem.h"
 
 #include "Cshowerpars.h"
 #include "Ctelconfig.h"
@@ -55,7 +56,7 @@ class VTableLookupDataHandler
         unsigned int fNTel;                       //!< number of telescopes
         unsigned int fNTelComb;                   //!< number of telescope combinations
         Long64_t fNEntries;                       //!< total number of events in input tree
-        int fEventCounter;                        //!< event counter for input tree
+        Long64_t fEventCounter;                   //!< event counter for input tree
         int fMethod;                              //!< which direction and core reconstruction method data should be used
 
         double fMaxTotalTime;                     //!< time to analyse in a run (in [s])
@@ -99,6 +100,7 @@ class VTableLookupDataHandler
         vector< TChain* > fTtpars;
         vector< Ctpars* > ftpars;
         vector< VPointingCorrectionsTreeReader* > fpointingCorrections;
+        vector< TChain* > fTpointingCorrections;
         TChain* fDeepLearnerpars;
 
         double fEventWeight;
@@ -383,7 +385,7 @@ class VTableLookupDataHandler
         /////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
         /////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
         VTableLookupDataHandler( bool iWrite, VTableLookupRunParameter* iT = 0 );
-        ~VTableLookupDataHandler() {}
+        ~VTableLookupDataHandler();
 
         bool cut()                                //!< apply cuts on successful reconstruction to input data
         {
@@ -448,7 +450,7 @@ class VTableLookupDataHandler
         {
             return sqrt( fMCxoff * fMCxoff + fMCyoff * fMCyoff );
         }
-        int    getEventCounter()
+        Long64_t getEventCounter()
         {
             return fEventCounter;
         }
@@ -619,6 +621,7 @@ class VTableLookupDataHandler
             return sqrt( fXoff * fXoff + fYoff * fYoff );
         }
         bool isReconstructed( bool isReconstructed = false );
+        bool merge( VTableLookupDataHandler* iD );      //!< add output tree, cut statistics and MC histograms of another data handler
         bool readRunParameter();
         void reset();                             //!< reset a few output variables
         void resetAll();
@@ -629,6 +632,7 @@ class VTableLookupDataHandler
             fdES = idES;
             feAbsError = ieAbsError;
         }
+        void setEventRange( Long64_t iFirstEntry, Long64_t iLastEntry );
         void setEnergyT( int i, double iETS )
         {
             fES[i] = iETS;
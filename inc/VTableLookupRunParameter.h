@@ -114,6 +114,9 @@ class VTableLookupRunParameter : public TNamed, public VGlobalRunParameter
         // write (for debugging) all 1D distribution to
         // lookup table file
         bool fWrite1DHistograms;
+        // compression of quantile sketches per table bin
+        // (larger values: more precise quantiles, more memory)
+        float fQuantileSketchCompression;
         // spectral index used to re-weight events while filling the
         // lookup tables
         double fSpectralIndex;
@@ -164,6 +167,8 @@ class VTableLookupRunParameter : public TNamed, public VGlobalRunParameter
         bool fWritePixelLists;
         // maximum time (in s) used of this run
         double fMaxRunTime;
+        // number of threads for table reading (events are split into entry ranges)
+        unsigned int fNThreads;
         // parameters to be used in anasum
         double meanpedvars;                       // mean pedvar
         vector< double > pedvars;                 // mean pedvar per telescope
@@ -175,6 +180,7 @@ class VTableLookupRunParameter : public TNamed, public VGlobalRunParameter
         double fRerunStereoReconstruction_minAngle;
         string fRerunStereoReconstruction_BDTFileName;
         unsigned int fRerunStereoReconstruction_BDTNImages_max;
+        unsigned int fRerunStereoReconstruction_HeadTailNImages_max;
         string fEnergyReconstruction_BDTFileName;
         string fCoreReconstruction_BDTFileName;
         string fDispError_BDTFileName;
@@ -189,6 +195,6 @@ class VTableLookupRunParameter : public TNamed, public VGlobalRunParameter
         void print( int iB = 0 );
         void printHelp();
 
-        ClassDef( VTableLookupRunParameter, 1001 ); //for any changes to this file: increase this number
+        ClassDef( VTableLookupRunParameter, 1004 ); //for any changes to this file: increase this number
 };
 #endif
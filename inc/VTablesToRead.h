@@ -20,6 +20,9 @@ class VTablesToRead
         unsigned int    fNTel;
         map< unsigned int, vector< TH2F* > > hMedian;
         map< unsigned int, vector< TH2F* > > hSigma;
+        map< unsigned int, vector< int > > table_index;      // index of compiled table [table type][tel]
+        map< unsigned int, double* > table_median;           // expected value from compiled table [table type][tel]
+        map< unsigned int, double* > table_sigma;            // sigma of expected value from compiled table [table type][tel]
         
         map< unsigned int, double > value;
         map< unsigned int, double > value_Chi2;
@@ -0,0 +1,56 @@
+//! VTelescopeAnalysisContext  per-telescope state for (parallel) image analysis
+
+#ifndef VTelescopeAnalysisContext_H
+#define VTelescopeAnalysisContext_H
+
+#include "VEvndispData.h"
+#include "VImageCleaning.h"
+#include "VImageParameterCalculation.h"
+
+#include <valarray>
+#include <vector>
+
+using namespace std;
+
+class VTelescopeAnalysisContext
+{
+    private:
+        unsigned int fTelID;
+        bool fOwner;                                                //!< context owns cleaner and parameter calculator
+        VEvndispData* fData;
+        VImageCleaning* fImageCleaning;
+        VImageParameterCalculation* fImageParameterCalculation;
+
+    public:
+        // temporary vectors for dead pixel smoothing
+        vector< unsigned int > fSavedDead;
+        vector< unsigned int > fSavedDeadLow;
+        valarray< double > fSavedGains;
+        valarray< double > fSavedGainsLow;
+
+        VTelescopeAnalysisContext( unsigned int iTelID, VEvndispData* iData );
+        VTelescopeAnalysisContext( unsigned int iTelID, VEvndispData* iData,
+                                   VImageCleaning* iImageCleaning,
+                                   VImageParameterCalculation* iImageParameterCalculation );
+        ~VTelescopeAnalysisContext();
+
+        void bind();
+        VImageCleaning* getImageCleaner()
+        {
+            return fImageCleaning;
+        }
+        VImageParameterCalculation* getImageParameterCalculation()
+        {
+            return fImageParameterCalculation;
+        }
+        unsigned int getTelID()
+        {
+            return fTelID;
+        }
+        bool isOwner()
+        {
+            return fOwner;
+        }
+};
+
+#endif
@@ -8,6 +8,7 @@
 #include <stdint.h>
 #include <vector>
 
+#include "VTraceKernels.h"
 #include "VVirtualDataReader.h"
 
 using namespace std;
@@ -37,6 +38,25 @@ class VTraceHandler
         int fMaxThreshold;
         unsigned int fMC_FADCTraceStart;          // start of FADC trace (in case the simulated trace is longer than needed)
         bool     kIPRmeasure;                     // if signal extractor is in IPR measurements mode
+        unsigned int fSlidingWindowMethod;        // sliding window integration: 0 = running sum, 1 = prefix sums
+        vector< double > fPrefixSum;              //!< prefix sums of trace (sliding window method 1)
+        vector< double > fPrefixTCharge;          //!< prefix sums of time weighted trace (sliding window method 1)
+        
+        // samples of all channels of the current telescope (see setSampleBlock())
+        vector< uint16_t > fSampleBlock;          //!< channel-major sample block (grows only)
+        unsigned int fSampleBlockNChannels;
+        unsigned int fSampleBlockNSamples;
+        bool         fSampleBlockValid;
+        // traces of all channels of the sample block (sample-major, see fillTraceBlock())
+        vector< double > fTraceBlock;
+        vector< double > fTraceBlockPed;
+        vector< double > fTraceBlockSum;
+        vector< double > fTraceBlockTCharge;
+        vector< double > fTraceBlockWindowSum;   //!< [window][channel] (see calculateTraceBlockSums_allWindows())
+        unsigned int fTraceBlockNWindows;
+        vector< double > fTraceBlockMax;
+        vector< unsigned int > fTraceBlockMaxPos;
+        bool         fTraceBlockValid;
         
         // digital filter parameters
         unsigned int fDF_method;
@@ -49,6 +69,9 @@ class VTraceHandler
         bool     apply_lowgain( double );
         double   calculateTraceSum_fixedWindow( unsigned int , unsigned int, bool );
         double   calculateTraceSum_slidingWindow( unsigned int iSearchStart, unsigned int iSearchEnd, int iIntegrationWindow, bool fRaw );
+        double   calculateTraceSum_slidingWindow_prefixSum( unsigned int iSearchStart, unsigned int iSearchEnd, unsigned int iIntegrationWindow,
+                bool iReusePrefixSums = false );
+        void     fillPrefixSums( unsigned int iSearchStart, unsigned int iN, double ped );
         
         void     reset();
         
@@ -87,6 +110,8 @@ class VTraceHandler
                                     unsigned int iTraceIntegrationMethod = 9999,
                                     bool iForceWindowStart = false,
                                     unsigned int iSlidingWindowLast = 9999 );
+        void    getTraceSums( unsigned int iSumWindowFirst, unsigned int iNSumWindows, bool iRaw,
+                              unsigned int iSlidingWindowLast, vector< double >& iSums );
         virtual vector< float >& getPulseTiming( unsigned int fFirst, unsigned int fLast,
                 unsigned int fTFirst, unsigned int fTLast,
                 bool iReverseSearchinLowGain = false );
@@ -126,6 +151,27 @@ class VTraceHandler
             kIPRmeasure = iIPRmeasure;
         }
         void    setPulseTimingLevels( vector< float > iP );
+        void    setSlidingWindowMethod( unsigned int iM = 0 )
+        {
+            fSlidingWindowMethod = iM;
+        }
+        bool    setSampleBlock( VVirtualDataReader* iReader, unsigned int iNSamples );
+        void    resetSampleBlock()
+        {
+            fSampleBlockValid = false;
+            fTraceBlockValid = false;
+        }
+        bool    fillTraceBlock( vector< double >& iPed, vector< double >& iLowGainMultiplier );
+        bool    calculateTraceBlockSums_fixedWindow( unsigned int iFirst, unsigned int iLast, bool iRaw );
+        bool    calculateTraceBlockSums_allWindows( unsigned int iFirst, unsigned int iNWindows, bool iRaw );
+        bool    calculateTraceBlockMax();
+        double  getTraceBlockSum( unsigned int iHitID, double& iAverageTime );
+        double  getTraceBlockWindowSum( unsigned int iWindow, unsigned int iHitID );
+        double  getTraceBlockMax( unsigned int iHitID, unsigned int& n255, unsigned int& maxpos );
+        bool    isTraceBlockValid()
+        {
+            return fTraceBlockValid;
+        }
         bool    setTraceIntegrationmethod( unsigned int iT = 1 );
 };
 #endif
@@ -0,0 +1,74 @@
+//! VTraceKernels  vectorized trace analysis for all channels of a telescope
+
+#ifndef VTRACEKERNELS_H
+#define VTRACEKERNELS_H
+
+#include <iostream>
+#include <stdint.h>
+#include <string.h>
+#include <string>
+
+using namespace std;
+
+/*
+ * traces are stored sample-major (structure of arrays):
+ *
+ *   iTrace[sample * iStride + channel]
+ *
+ * each SIMD lane processes one channel; samples are accumulated in the
+ * same order as in the per-channel code of VTraceHandler, results are
+ * therefore identical
+ *
+ * image moments are summed in the same (fixed) order for all instruction sets
+ */
+class VTraceKernels
+{
+    private:
+        static unsigned int fInstructionSet;           //!< instruction set forced with setInstructionSet() (9999: best available)
+
+        static unsigned int detectInstructionSet();
+
+        static void addPixelMoments( const double* iX, const double* iY, const double* iSignal,
+                                     unsigned int j, bool iSquared, double* iMoments );
+        static void imageMoments_scalar( const double* iX, const double* iY, const double* iSignal, const unsigned char* iMask,
+                                         unsigned int iN, bool iSquared, double* iMoments );
+
+        static void fixedWindowSums_scalar( const double* iTrace, unsigned int iStride, unsigned int iChannelFirst, unsigned int iNChannels,
+                                            unsigned int iFirst, unsigned int iLast, const double* iPed, bool iRaw,
+                                            double* iSum, double* iTCharge );
+        static void traceMax_scalar( const double* iTrace, unsigned int iStride, unsigned int iChannelFirst, unsigned int iNChannels,
+                                     unsigned int iFirst, unsigned int iLast, double* iMax, unsigned int* iMaxPos );
+#if defined( __x86_64__ ) || defined( __i386__ )
+        static void fixedWindowSums_sse2( const double* iTrace, unsigned int iStride, unsigned int iNChannels,
+                                          unsigned int iFirst, unsigned int iLast, const double* iPed, bool iRaw,
+                                          double* iSum, double* iTCharge );
+        static void fixedWindowSums_avx2( const double* iTrace, unsigned int iStride, unsigned int iNChannels,
+                                          unsigned int iFirst, unsigned int iLast, const double* iPed, bool iRaw,
+                                          double* iSum, double* iTCharge );
+        static void traceMax_sse2( const double* iTrace, unsigned int iStride, unsigned int iNChannels,
+                                   unsigned int iFirst, unsigned int iLast, double* iMax, unsigned int* iMaxPos );
+        static void traceMax_avx2( const double* iTrace, unsigned int iStride, unsigned int iNChannels,
+                                   unsigned int iFirst, unsigned int iLast, double* iMax, unsigned int* iMaxPos );
+        static void imageMoments_avx2( const double* iX, const double* iY, const double* iSignal, const unsigned char* iMask,
+                                       unsigned int iN, bool iSquared, double* iMoments );
+#endif
+
+    public:
+        static const unsigned int SCALAR = 0;
+        static const unsigned int SSE2 = 1;
+        static const unsigned int AVX2 = 2;
+
+        static void fixedWindowSums( const double* iTrace, unsigned int iStride, unsigned int iNChannels,
+                                     unsigned int iFirst, unsigned int iLast, const double* iPed, bool iRaw,
+                                     double* iSum, double* iTCharge );
+        static unsigned int getBestInstructionSet();
+        static unsigned int getInstructionSet();
+        static void imageMoments( const double* iX, const double* iY, const double* iSignal, const unsigned char* iMask,
+                                  unsigned int iN, bool iSquared, double* iMoments );
+        static string getInstructionSetName( unsigned int iSet = 9999 );
+        static bool setInstructionSet( unsigned int iSet );
+        static void traceMax( const double* iTrace, unsigned int iStride, unsigned int iNChannels,
+                              unsigned int iFirst, unsigned int iLast, double* iMax, unsigned int* iMaxPos );
+};
+
+#endif
@@ -167,6 +167,12 @@ class VVirtualDataReader
         {
             return iSampleVec16bit;
         }
+        // samples of all hit channels of the current telescope (channel-major; false if not available)
+        virtual bool                        getSampleBlock( vector< uint16_t >& iSampleBlock, unsigned int iNSamples,
+                unsigned int iSampleOffset = 0 )
+        {
+            return false;
+        }
         virtual void                        selectHitChan( uint32_t ) = 0;
         void                                setNumSamples( unsigned int iT, uint16_t iS )
         {
@@ -717,6 +717,9 @@ bool DST_fillEvent( VDSTTree* fData, AllHessData* hsdata, map< unsigned int, VDS
             fGlobalMaxNumberofPixels = ( unsigned int )hsdata->camera_set[telID].num_pixels;
         }
         
+        // size of pixel data arrays
+        fData->setTelescopeDataSize( i_ntel_data, hsdata->camera_set[telID].num_pixels, fData->fDSTnumSamples[i_ntel_data] );
+        
         /////////////////////////////////////
         // loop over all pixel
         for( int p = 0; p < hsdata->camera_set[telID].num_pixels; p++ )
@@ -724,7 +727,6 @@ bool DST_fillEvent( VDSTTree* fData, AllHessData* hsdata, map< unsigned int, VDS
             // reset low gain switch (filled later)
             unsigned int iLowGain = false;
             fData->fDSTHiLo[i_ntel_data][p] = iLowGain;
-            fData->fDSTChan[i_ntel_data][p] = ( unsigned int )p;
             
             // channels not known are set dead
             fData->fDSTdead[i_ntel_data][p] = !( hsdata->event.teldata[telID].raw->adc_known[HI_GAIN][p] );
@@ -985,7 +987,7 @@ bool DST_fillEvent( VDSTTree* fData, AllHessData* hsdata, map< unsigned int, VDS
     
     if( fData->fDST_tree )
     {
-        fData->fDST_tree->Fill();
+        fData->fillDSTTree();
     }
     
     return true;
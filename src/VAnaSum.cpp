@@ -29,8 +29,11 @@ VAnaSum::VAnaSum( string i_datadir )
 
    check run mode
 
+   iSelectedRun >= 0: analyse only this run of the run list (index in list)
+
 */
-void VAnaSum::initialize( string i_LongListFilename, unsigned int iRunType, string i_outfile, int iRandomSeed, string iRunParameterfile )
+void VAnaSum::initialize( string i_LongListFilename, unsigned int iRunType, string i_outfile, int iRandomSeed, string iRunParameterfile,
+                          int iSelectedRun )
 {
     char i_temp[2000];
     char i_title[200];
@@ -71,6 +74,16 @@ void VAnaSum::initialize( string i_LongListFilename, unsigned int iRunType, stri
         cout << "...exiting" << endl;
         exit( EXIT_FAILURE );
     }
+    // analyse a single run of the list
+    if( iSelectedRun >= 0 )
+    {
+        if( !fRunPara->selectRun( ( unsigned int )iSelectedRun ) )
+        {
+            cout << "...exiting" << endl;
+            exit( EXIT_FAILURE );
+        }
+        i_npair = 1;
+    }
     if( fAnalysisRunMode != 1 )
     {
         cout << "Random seed for stereo maps: " << iRandomSeed << endl;
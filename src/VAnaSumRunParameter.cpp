@@ -136,6 +136,10 @@ VAnaSumRunParameter::VAnaSumRunParameter()
     fEnergySpectrumBinSize = 0.05;
     fEnergyEffectiveAreaSmoothingIterations = -1;
     fEnergyEffectiveAreaSmoothingThreshold = -1.;
+    // no caching of interpolated effective areas
+    fEnergyEffectiveAreaCache_dZe = 0.;
+    fEnergyEffectiveAreaCache_dWoff = 0.;
+    fEnergyEffectiveAreaCache_dPedVar = 0.;
     fDeadTimeCalculationMethod = 0;
     
     // background model
@@ -158,9 +162,13 @@ VAnaSumRunParameter::VAnaSumRunParameter()
     fTimeIntervall = 4. * 60.;
     
     fWriteEventTree = 2;
+    fValidateUsedBranches = false;
+    
+    fRingKernelIntegration = false;
     
     // Binned Likelihood
     fLikelihoodAnalysis = false;
+    fLikelihoodResponseMatrixEventWeighted = false;
     
     // if 0, use default 1D radial acceptance
     // if >0, use alternate 2D-dependent acceptance
@@ -716,6 +724,20 @@ int VAnaSumRunParameter::readRunParameter( string i_filename, bool fIgnoreZeroEx
             {
                 fEnergyEffectiveAreaSmoothingThreshold = atof( temp2.c_str() );
             }
+            // effective area caching: interpolation once per cell in ze, wobble offset and pedvar
+            // (cell widths; default: no caching, interpolation for each event)
+            else if( temp == "ENERGYEFFAREACACHE" )
+            {
+                if( checkNumberOfArguments( is_line ) != 5 )
+                {
+                    return returnWithError( "VAnaSumRunparameter: not enough parameters: ", is_line, "* ENERGYEFFAREACACHE dZe dWoff dPedVar" );
+                }
+                fEnergyEffectiveAreaCache_dZe = atof( temp2.c_str() );
+                is_stream >> temp2;
+                fEnergyEffectiveAreaCache_dWoff = atof( temp2.c_str() );
+                is_stream >> temp2;
+                fEnergyEffectiveAreaCache_dPedVar = atof( temp2.c_str() );
+            }
             
             ////////////////////////////////////////////
             // Option USE2DACCEPTANCE within ANASUM.runparameter
@@ -738,6 +760,22 @@ int VAnaSumRunParameter::readRunParameter( string i_filename, bool fIgnoreZeroEx
             {
                 fWriteEventTree = ( unsigned int )atoi( temp2.c_str() );
             }
+            ///////////////////////////////////////////////////////////
+            // VALIDATEUSEDBRANCHES
+            // debugging: read all branches of the data tree and compare event selection
+            // with reading of the used branches only (1 = validate, 0 = used branches only (default))
+            else if( temp == "VALIDATEUSEDBRANCHES" )
+            {
+                fValidateUsedBranches = ( atoi( temp2.c_str() ) == 1 );
+            }
+            ///////////////////////////////////////////////////////////
+            // RINGKERNELINTEGRATION
+            // ring background model: alpha maps from precomputed ring kernels
+            // (1 = ring kernels, 0 = random sampling (default))
+            else if( temp == "RINGKERNELINTEGRATION" )
+            {
+                fRingKernelIntegration = ( atoi( temp2.c_str() ) == 1 );
+            }
             /// enable likelihood analysis ///
             else if( temp == "ENABLEBINNEDLIKELIHOOD" )
             {
@@ -747,6 +785,11 @@ int VAnaSumRunParameter::readRunParameter( string i_filename, bool fIgnoreZeroEx
                     fLikelihoodAnalysis = true;
                 }
             }
+            /// likelihood analysis: mean response matrix weighted by number of events ///
+            else if( temp == "LIKELIHOODEVENTWEIGHTEDRESPONSEMATRIX" )
+            {
+                fLikelihoodResponseMatrixEventWeighted = ( atoi( temp2.c_str() ) == 1 );
+            }
             else
             {
                 cout << "Warning: unknown line in parameter file " << i_filename << ": " << endl;
@@ -1090,6 +1133,27 @@ int VAnaSumRunParameter::loadLongFileList( string i_listfilename, bool bShortLis
     return i_nline;
 }
 
+/*
+ * reduce list of runs to a single run
+ * (run i in the run list; used by the parallel analysis of a run list)
+ *
+ */
+bool VAnaSumRunParameter::selectRun( unsigned int i )
+{
+    if( i >= fRunList.size() )
+    {
+        cout << "VAnaSumRunParameter::selectRun error: run " << i << " not in list of runs (" << fRunList.size() << " runs)" << endl;
+        return false;
+    }
+    VAnaSumRunParameterDataClass i_sT = fRunList[i];
+    fRunList.clear();
+    fRunList.push_back( i_sT );
+    fMapRunList.clear();
+    fMapRunList[i_sT.fRunOn] = fRunList.back();
+    
+    return true;
+}
+
 
 void VAnaSumRunParameter::printStereoParameter( int ion )
 {
@@ -0,0 +1,117 @@
+/*  VAnalysisThreadPool
+ *
+ *  fixed-size pool of worker threads
+ *
+ *  run() distributes jobs 0..N-1 over all workers and returns
+ *  after all jobs are finished (barrier). Jobs are executed
+ *  in the calling thread if the pool has only one thread.
+ *
+ *  Second argument of the task function is the index of the
+ *  worker executing this job (0..getNThreads()-1), which can be
+ *  used to select per-worker scratch data.
+ *
+ */
+
+#include "VAnalysisThreadPool.h"
+
+VAnalysisThreadPool::VAnalysisThreadPool( unsigned int iNThreads )
+{
+    fNThreads = iNThreads;
+    if( fNThreads < 1 )
+    {
+        fNThreads = 1;
+    }
+    fNJobs = 0;
+    fNextJob = 0;
+    fNJobsDone = 0;
+    fTaskGeneration = 0;
+    fStop = false;
+
+    if( fNThreads > 1 )
+    {
+        for( unsigned int i = 0; i < fNThreads; i++ )
+        {
+            fWorkers.push_back( thread( &VAnalysisThreadPool::worker, this, i ) );
+        }
+    }
+}
+
+VAnalysisThreadPool::~VAnalysisThreadPool()
+{
+    {
+        unique_lock< mutex > i_lock( fMutex );
+        fStop = true;
+    }
+    fCondition_newTask.notify_all();
+    for( unsigned int i = 0; i < fWorkers.size(); i++ )
+    {
+        if( fWorkers[i].joinable() )
+        {
+            fWorkers[i].join();
+        }
+    }
+}
+
+/*
+ * execute iTask( job, worker ) for all jobs 0..iNJobs-1
+ *
+ * returns when all jobs are done
+ */
+void VAnalysisThreadPool::run( unsigned int iNJobs, function< void( unsigned int, unsigned int ) > iTask )
+{
+    if( iNJobs == 0 )
+    {
+        return;
+    }
+    // serial execution
+    if( fWorkers.size() == 0 || iNJobs == 1 )
+    {
+        for( unsigned int i = 0; i < iNJobs; i++ )
+        {
+            iTask( i, 0 );
+        }
+        return;
+    }
+
+    unique_lock< mutex > i_lock( fMutex );
+    fTask = iTask;
+    fNJobs = iNJobs;
+    fNextJob = 0;
+    fNJobsDone = 0;
+    fTaskGeneration++;
+    fCondition_newTask.notify_all();
+    fCondition_taskDone.wait( i_lock, [this] { return fNJobsDone == fNJobs; } );
+    fTask = nullptr;
+    fNJobs = 0;
+}
+
+void VAnalysisThreadPool::worker( unsigned int iWorkerID )
+{
+    unsigned long int i_generation = 0;
+    unique_lock< mutex > i_lock( fMutex );
+    for( ;; )
+    {
+        fCondition_newTask.wait( i_lock, [this, &i_generation]
+        {
+            return fStop || ( fTaskGeneration != i_generation && fNextJob < fNJobs );
+        } );
+        if( fStop )
+        {
+            return;
+        }
+        i_generation = fTaskGeneration;
+        // take jobs until all are distributed
+        while( fNextJob < fNJobs )
+        {
+            unsigned int i_job = fNextJob++;
+            i_lock.unlock();
+            fTask( i_job, iWorkerID );
+            i_lock.lock();
+            fNJobsDone++;
+        }
+        if( fNJobsDone == fNJobs )
+        {
+            fCondition_taskDone.notify_all();
+        }
+    }
+}
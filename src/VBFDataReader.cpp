@@ -2,11 +2,24 @@
 
     steering class for reading vbf data format
 
+    optional: packets are read and decoded by a separate reader thread
+    (startPacketPrefetch()) and handed to getNextEvent() through a bounded
+    queue in file order
+
+    (reader stage only: events are still analysed and written one at a time
+    by the event loop, as event data are kept in static members of VEvndispData)
+
+    follow-up: analysis workers on independent event copies and an ordered
+    writer stage (requires per-event data instead of the static members of
+    VEvndispData, the trace handler and the data readers)
+
 
 */
 
 #include <VBFDataReader.h>
 
+#include <stdexcept>
+
 VBFDataReader::VBFDataReader( string sourcefile, int isourcetype, unsigned int iNTel, bool iDebug, unsigned int iPrintDetectorConfig ):
     VBaseRawDataReader( sourcefile, isourcetype, iNTel, iDebug ),
     pack( NULL ),
@@ -19,6 +32,11 @@ VBFDataReader::VBFDataReader( string sourcefile, int isourcetype, unsigned int i
     fNIncompleteEvent.assign( iNTel, 0 );
     setDebug( iDebug );
     fPrintDetectorConfig = iPrintDetectorConfig;
+    fNPrefetchPackets = 0;
+    fPrefetchIndex = 0;
+    fPrefetchEndOfFile = false;
+    fPrefetchStop = false;
+    fPrefetchNTel = 0;
 }
 
 
@@ -28,6 +46,7 @@ VBFDataReader::~VBFDataReader()
     {
         cout << "VBFDataReader::~VBFDataReader()" << endl;
     }
+    stopPacketPrefetch();
     if( pack != NULL )
     {
         delete pack;
@@ -51,15 +70,11 @@ bool VBFDataReader::getNextEvent()
         }
         for( ;; )
         {
-            if( !reader.hasPacket( index ) )
-            {
-                setEventStatus( 999 );
-                return false;
-            }
+            bool bEndOfFile = false;
             VPacket* old_pack = pack;
             try
             {
-                pack = reader.readPacket( index );
+                pack = readNextPacket( bEndOfFile );
             }
             catch( const std::exception& e )
             {
@@ -69,6 +84,12 @@ bool VBFDataReader::getNextEvent()
                 setEventStatus( 0 );
                 return false;
             }
+            if( bEndOfFile )
+            {
+                pack = old_pack;
+                setEventStatus( 999 );
+                return false;
+            }
             delete old_pack;
             if( fDebug )
             {
@@ -236,8 +257,162 @@ bool VBFDataReader::getNextEvent()
 }
 
 
+/*
+ * return next packet of the file (NULL and bEndOfFile = true at end of file)
+ *
+ * packets are taken from the prefetch queue if the reader thread is running
+ * (exceptions of the reader thread are rethrown here)
+ */
+VPacket* VBFDataReader::readNextPacket( bool& bEndOfFile )
+{
+    bEndOfFile = false;
+    // serial reading
+    if( fNPrefetchPackets == 0 )
+    {
+        if( !reader.hasPacket( index ) )
+        {
+            bEndOfFile = true;
+            return 0;
+        }
+        return reader.readPacket( index );
+    }
+    
+    unique_lock< mutex > i_lock( fPrefetchMutex );
+    fPrefetchCondition_filled.wait( i_lock, [this]
+    {
+        return fPrefetchQueue.size() > 0 || fPrefetchEndOfFile || fPrefetchError.size() > 0;
+    } );
+    if( fPrefetchQueue.size() == 0 )
+    {
+        if( fPrefetchError.size() > 0 )
+        {
+            throw runtime_error( fPrefetchError );
+        }
+        bEndOfFile = true;
+        return 0;
+    }
+    VPacket* i_pack = fPrefetchQueue.front();
+    fPrefetchQueue.pop_front();
+    i_lock.unlock();
+    fPrefetchCondition_free.notify_one();
+    
+    return i_pack;
+}
+
+/*
+ * start reader thread decoding up to iNPackets packets ahead
+ * of the current packet
+ *
+ * (call before the first getNextEvent() or between two events)
+ */
+void VBFDataReader::startPacketPrefetch( unsigned int iNPackets )
+{
+    if( iNPackets == 0 || fNPrefetchPackets > 0 )
+    {
+        return;
+    }
+    // getNTel() must not access the VBF reader while the reader thread runs
+    fPrefetchNTel = getNTel();
+    fNPrefetchPackets = iNPackets;
+    fPrefetchIndex = index;
+    fPrefetchEndOfFile = false;
+    fPrefetchStop = false;
+    fPrefetchError = "";
+    fPrefetchThread = thread( &VBFDataReader::prefetchPackets, this );
+}
+
+void VBFDataReader::stopPacketPrefetch()
+{
+    if( fNPrefetchPackets == 0 )
+    {
+        return;
+    }
+    {
+        unique_lock< mutex > i_lock( fPrefetchMutex );
+        fPrefetchStop = true;
+    }
+    fPrefetchCondition_free.notify_all();
+    if( fPrefetchThread.joinable() )
+    {
+        fPrefetchThread.join();
+    }
+    for( unsigned int i = 0; i < fPrefetchQueue.size(); i++ )
+    {
+        delete fPrefetchQueue[i];
+    }
+    fPrefetchQueue.clear();
+    fNPrefetchPackets = 0;
+}
+
+/*
+ * reader thread: read packets in file order into the prefetch queue
+ *
+ * stops at end of file, on a read error, or if the queue is stopped
+ */
+void VBFDataReader::prefetchPackets()
+{
+    for( ;; )
+    {
+        {
+            unique_lock< mutex > i_lock( fPrefetchMutex );
+            fPrefetchCondition_free.wait( i_lock, [this]
+            {
+                return fPrefetchStop || fPrefetchQueue.size() < fNPrefetchPackets;
+            } );
+            if( fPrefetchStop )
+            {
+                return;
+            }
+        }
+        
+        VPacket* i_pack = 0;
+        bool bEndOfFile = false;
+        string i_error;
+        try
+        {
+            if( !reader.hasPacket( fPrefetchIndex ) )
+            {
+                bEndOfFile = true;
+            }
+            else
+            {
+                i_pack = reader.readPacket( fPrefetchIndex );
+                fPrefetchIndex++;
+            }
+        }
+        catch( const std::exception& e )
+        {
+            i_error = e.what();
+            if( i_error.size() == 0 )
+            {
+                i_error = "unknown read error";
+            }
+        }
+        
+        {
+            unique_lock< mutex > i_lock( fPrefetchMutex );
+            if( i_pack )
+            {
+                fPrefetchQueue.push_back( i_pack );
+            }
+            fPrefetchEndOfFile = bEndOfFile;
+            fPrefetchError = i_error;
+        }
+        fPrefetchCondition_filled.notify_one();
+        if( bEndOfFile || i_error.size() > 0 )
+        {
+            return;
+        }
+    }
+}
+
+
 unsigned int VBFDataReader::getNTel()
 {
+    if( fNPrefetchPackets > 0 )
+    {
+        return fPrefetchNTel;
+    }
     unsigned int z = 0;
     unsigned int t = reader.getConfigMask().size();
     for( unsigned int i = 0; i < t; i++ )
@@ -525,6 +525,62 @@ std::vector< uint8_t > VBaseRawDataReader::getSamplesVec()
 }
 
 
+/*
+ * fill samples of all hit channels of the current telescope into iSampleBlock
+ *
+ * iSampleBlock[hit * iNSamples + sample] = getSample( hit, sample + iSampleOffset )
+ *
+ * not available if noise is added to the traces (random numbers are drawn
+ * per sample in the order of the analysis)
+ */
+bool VBaseRawDataReader::getSampleBlock( vector< uint16_t >& iSampleBlock, unsigned int iNSamples, unsigned int iSampleOffset )
+{
+    if( fTelID >= fEvent.size() || !fEvent[fTelID] )
+    {
+        return false;
+    }
+    if( fNoiseFileReader || ( finjectGaussianNoise > 0. && fRandomInjectGaussianNoise ) )
+    {
+        return false;
+    }
+    unsigned int nhits = fEvent[fTelID]->getNumChannelsHit();
+    if( iSampleBlock.size() < nhits * iNSamples )
+    {
+        iSampleBlock.resize( nhits * iNSamples );
+    }
+    bool bThroughputCorrection = ( fTraceAmplitudeCorrectionS.size() > 0 && fTelID < fTraceAmplitudeCorrectionS.size() );
+    try
+    {
+        uint16_t* i_block = iSampleBlock.data();
+        for( unsigned int i = 0; i < nhits; i++ )
+        {
+            if( !bThroughputCorrection )
+            {
+                for( unsigned int s = 0; s < iNSamples; s++ )
+                {
+                    i_block[s] = fEvent[fTelID]->getSample( i, s + iSampleOffset );
+                }
+            }
+            else
+            {
+                for( unsigned int s = 0; s < iNSamples; s++ )
+                {
+                    i_block[s] = VBaseRawDataReader::getSample( i, s + iSampleOffset );
+                }
+            }
+            i_block += iNSamples;
+        }
+    }
+    catch( ... )
+    {
+        // fall back to reading sample by sample
+        return false;
+    }
+    
+    return true;
+}
+
+
 void VBaseRawDataReader::selectHitChan( uint32_t i )
 {
     fHitID = i;
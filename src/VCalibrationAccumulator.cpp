@@ -0,0 +1,173 @@
+/*! \class VCalibrationAccumulator
+    \brief integer-binned distributions of a calibration quantity for all channels of a camera
+
+    Replaces one TH1F per channel (e.g. pedestal or IPR charge distributions
+    per channel and summation window) by one contiguous array of integer bin
+    contents for all channels, with one common binning.
+
+    Filling, entries, mean, RMS and quantiles follow TH1::Fill(), TH1::GetEntries(),
+    TH1::GetMean(), TH1::GetRMS() and TH1::GetQuantiles() (statistics from
+    entries inside the histogram range only).
+    getHistogram() creates a TH1F with identical contents and statistics
+    (to be called for writing only).
+
+*/
+
+#include "VCalibrationAccumulator.h"
+
+#include <algorithm>
+#include <cstdio>
+
+VCalibrationAccumulator::VCalibrationAccumulator()
+{
+    fNChannels = 0;
+    fNBins = 0;
+    fXmin = 0.;
+    fXmax = 1.;
+}
+
+/*
+ * define binning (identical for all channels) and reset all contents
+ */
+void VCalibrationAccumulator::initialize( unsigned int iNChannels, int iNBins, double iXmin, double iXmax )
+{
+    fNChannels = iNChannels;
+    fNBins = ( iNBins > 0 ? iNBins : 0 );
+    fXmin = iXmin;
+    fXmax = iXmax;
+    reset();
+}
+
+void VCalibrationAccumulator::reset()
+{
+    fBinContent.assign( ( size_t )fNChannels * ( fNBins + 2 ), 0 );
+    fEntries.assign( fNChannels, 0 );
+    fSumW.assign( fNChannels, 0. );
+    fSumWX.assign( fNChannels, 0. );
+    fSumWX2.assign( fNChannels, 0. );
+}
+
+double VCalibrationAccumulator::getMean( unsigned int iChannel )
+{
+    if( iChannel >= fNChannels || fSumW[iChannel] == 0. )
+    {
+        return 0.;
+    }
+    return fSumWX[iChannel] / fSumW[iChannel];
+}
+
+/*
+ * standard deviation (as TH1::GetStdDev(), including the absolute value
+ * for rounding errors in channels with (nearly) constant values)
+ */
+double VCalibrationAccumulator::getRMS( unsigned int iChannel )
+{
+    if( iChannel >= fNChannels || fSumW[iChannel] == 0. )
+    {
+        return 0.;
+    }
+    double x = fSumWX[iChannel] / fSumW[iChannel];
+    return TMath::Sqrt( TMath::Abs( fSumWX2[iChannel] / fSumW[iChannel] - x * x ) );
+}
+
+/*
+ * quantile for probability iProb (as TH1::GetQuantiles() for one probability)
+ *
+ * returns 0 and leaves iQuantile unchanged if there are no entries inside the
+ * histogram range
+ */
+int VCalibrationAccumulator::getQuantile( unsigned int iChannel, double iProb, double& iQuantile )
+{
+    if( iChannel >= fNChannels || fNBins < 1 )
+    {
+        return 0;
+    }
+    const UInt_t* i_content = &fBinContent[( size_t )iChannel * ( fNBins + 2 )];
+    // normalised cumulative distribution (TH1::ComputeIntegral())
+    vector< double > i_integral( fNBins + 1, 0. );
+    for( int i = 1; i <= fNBins; i++ )
+    {
+        i_integral[i] = i_integral[i - 1] + ( double )i_content[i];
+    }
+    if( i_integral[fNBins] == 0. )
+    {
+        return 0;
+    }
+    for( int i = 1; i <= fNBins; i++ )
+    {
+        i_integral[i] /= i_integral[fNBins];
+    }
+    // bin search as TMath::BinarySearch() over [0,fNBins-1]
+    vector< double >::iterator i_pos = std::lower_bound( i_integral.begin(), i_integral.begin() + fNBins, iProb );
+    int i_bin = ( int )( i_pos - i_integral.begin() );
+    if( i_pos == i_integral.begin() + fNBins || *i_pos != iProb )
+    {
+        i_bin--;
+    }
+    while( i_bin < fNBins - 1 && i_integral[i_bin + 1] == iProb )
+    {
+        if( i_integral[i_bin + 2] == iProb )
+        {
+            i_bin++;
+        }
+        else
+        {
+            break;
+        }
+    }
+    double i_width = ( fXmax - fXmin ) / ( double )fNBins;
+    iQuantile = fXmin + i_bin * i_width;
+    double i_dint = i_integral[i_bin + 1] - i_integral[i_bin];
+    if( i_dint > 0. )
+    {
+        iQuantile += i_width * ( iProb - i_integral[i_bin] ) / i_dint;
+    }
+    return 1;
+}
+
+/*
+ * histogram of channel iChannel (name and title from setHistogramNames())
+ */
+TH1F* VCalibrationAccumulator::getHistogram( unsigned int iChannel )
+{
+    char i_name[400];
+    char i_title[400];
+    snprintf( i_name, sizeof( i_name ), fHistogramName.c_str(), iChannel );
+    snprintf( i_title, sizeof( i_title ), fHistogramTitle.c_str(), iChannel );
+    return getHistogram( iChannel, i_name, i_title );
+}
+
+/*
+ * histogram of channel iChannel
+ *
+ * (not added to any directory; to be deleted by the caller)
+ */
+TH1F* VCalibrationAccumulator::getHistogram( unsigned int iChannel, string iName, string iTitle )
+{
+    if( iChannel >= fNChannels )
+    {
+        return 0;
+    }
+    TH1F* h = new TH1F();
+    h->SetName( iName.c_str() );
+    h->SetTitle( iTitle.c_str() );
+    h->SetBins( fNBins, fXmin, fXmax );
+    const UInt_t* i_content = &fBinContent[( size_t )iChannel * ( fNBins + 2 )];
+    for( int i = 0; i <= fNBins + 1; i++ )
+    {
+        if( i_content[i] > 0 )
+        {
+            h->SetBinContent( i, ( double )i_content[i] );
+        }
+    }
+    // statistics as filled by TH1::Fill() (weights = 1)
+    double i_stats[4];
+    i_stats[0] = fSumW[iChannel];
+    i_stats[1] = fSumW[iChannel];
+    i_stats[2] = fSumWX[iChannel];
+    i_stats[3] = fSumWX2[iChannel];
+    h->PutStats( i_stats );
+    h->SetEntries( ( double )fEntries[iChannel] );
+    
+    return h;
+}
@@ -20,7 +20,7 @@ VCalibrator::VCalibrator()
 }
 
 /*
- * initialize all pedestals and IPR histograms
+ * initialize all pedestals and IPR distributions
  *
  * called once per telescope and per run
  *
@@ -35,7 +35,6 @@ bool VCalibrator::initializePedestalHistograms( ULong64_t iTelType, bool iLowGai
     }
     
     string ioutfile;
-    char ic[800];
     if( getDebugFlag() )
     {
         cout << "\t void VCalibrator::initializePedestalHistograms(): creating histograms and files:";
@@ -77,10 +76,10 @@ bool VCalibrator::initializePedestalHistograms( ULong64_t iTelType, bool iLowGai
         cout << " (no single or array of output files defined)" << endl;
         exit( EXIT_FAILURE );
     }
-    // init histograms etc (only done before first event)
+    // init distributions (only done before first event)
+    // (one binning per summation window for all channels)
     if( fReader->getMaxChannels() )
     {
-        unsigned int z = 0;
         // loop over all sumwindows
         for( unsigned int i = 0; i < hped_vec[iTelType].size(); i++ )
         {
@@ -99,54 +98,15 @@ bool VCalibrator::initializePedestalHistograms( ULong64_t iTelType, bool iLowGai
             {
                 nBins = 2000;
             }
-            /////////////////////////////////////////
-            // histograms for pedestal calculation
-            
-            // loop over all channels
-            for( unsigned int j = 0; j < hped_vec[iTelType][i].size(); j++ )
+            // pedestal distributions
+            if( !hped_vec[iTelType][i].isInitialized() )
             {
-                if( !hped_vec[iTelType][i][j] )
-                {
-                    char pedkey[100];
-                    sprintf( pedkey, "hped_%d_%d_%d", ( int )iTelType, i + 1, j );
-                    // If no trace, readout window is constant and pedestal does not grow with summation window
-                    // if (getNSamples() - getSumFirst() > 0) max *= ( ( double )i + 1. );
-                    sprintf( ic, "ped distribution (tel type %d, channel %d, sumwindow %d)", ( int )iTelType, j, i + 1 );
-                    if( fPedestalsHistoClonesArray.find( iTelType ) != fPedestalsHistoClonesArray.end() )
-                    {
-                        hped_vec[iTelType][i][j] = ( TH1F* )fPedestalsHistoClonesArray[iTelType]->ConstructedAt( z );
-                        hped_vec[iTelType][i][j]->SetName( pedkey );
-                        hped_vec[iTelType][i][j]->SetTitle( ic );
-                        hped_vec[iTelType][i][j]->SetBins( nBins, min, max );
-                        z++;
-                    }
-                }
+                hped_vec[iTelType][i].initialize( getNChannels(), nBins, min, max );
             }
-            
-            /////////////////////////////////////////
-            // histograms for IPR graph calculation
-            min = 0.;
-            // max /= iMeanGain;
-            
-            // loop over all channels
-            for( unsigned int j = 0; j < hpedPerTelescopeType[iTelType][i].size(); j++ )
+            // IPR distributions
+            if( !hpedPerTelescopeType[iTelType][i].isInitialized() )
             {
-                if( !hpedPerTelescopeType[iTelType][i][j] )
-                {
-                    char pedkey[100];
-                    sprintf( pedkey, "hpedPerTelescopeType_%d_%d_%d", ( int )iTelType, i + 1, j );
-                    // If no trace, readout window is constant and pedestal does not grow with summation window
-                    // if (getNSamples() - getSumFirst() > 0) max *= ( ( double )i + 1. );
-                    sprintf( ic, "IPR distribution (tel type %d, channel %d, sumwindow %d)", ( int )iTelType, j, i + 1 );
-                    if( fPedestalsHistoClonesArray.find( iTelType ) != fPedestalsHistoClonesArray.end() )
-                    {
-                        hpedPerTelescopeType[iTelType][i][j] = ( TH1F* )fPedestalsHistoClonesArray[iTelType]->ConstructedAt( z );
-                        hpedPerTelescopeType[iTelType][i][j]->SetName( pedkey );
-                        hpedPerTelescopeType[iTelType][i][j]->SetTitle( ic );
-                        hpedPerTelescopeType[iTelType][i][j]->SetBins( nBins, min, max );
-                        z++;
-                    }
-                }
+                hpedPerTelescopeType[iTelType][i].initialize( getNChannels(), nBins, 0., max );
             }
         }
     }
@@ -155,10 +115,44 @@ bool VCalibrator::initializePedestalHistograms( ULong64_t iTelType, bool iLowGai
     return true;
 }
 
+/*
+ * use this channel for pedestal or IPR calculation?
+ *
+ * - exclude low gain channels from pedestal calculation (and vice versa)
+ * - calculate pedestals only for channels with valid hitbit
+ *   (important if trying to generate pedestals for zero supressed
+ *    runs without injected pedestal events)
+ */
+bool VCalibrator::usePedestalChannel( unsigned int iChannel, bool iLowGain, valarray< double >& iSums )
+{
+    if( iChannel < getHiLo().size() )
+    {
+        if( iLowGain && !getHiLo()[iChannel] )
+        {
+            return false;
+        }
+        else if( !iLowGain && getHiLo()[iChannel] )
+        {
+            return false;
+        }
+    }
+    if( iChannel >= iSums.size() || !( iSums[iChannel] > 0. ) )
+    {
+        return false;
+    }
+    if( fRunPar->fRunIsZeroSuppressed && !fReader->getChannelHitIndex( iChannel ).first )
+    {
+        return false;
+    }
+    return true;
+}
 
 /*
 
-   pedestal calculation and filling of charge histograms for IPR calculation
+   pedestal calculation and filling of charge distributions for IPR calculation
+
+   trace sums for all summation windows are calculated in one pass
+   over each trace (see VImageBaseAnalyzer::calcSumsAllWindows())
 
  */
 void VCalibrator::calculatePedestals( bool iLowGain )
@@ -170,7 +164,7 @@ void VCalibrator::calculatePedestals( bool iLowGain )
     
     /////////////////////////////////////////////////////////////
     // get telescope type of current telescope
-    // all histograms in the following are filled per telescope type
+    // all distributions in the following are filled per telescope type
     ULong64_t iTelType = 0;
     if( getTelID() < getDetectorGeometry()->getTelType().size() )
     {
@@ -182,65 +176,33 @@ void VCalibrator::calculatePedestals( bool iLowGain )
         cout << getTelID() << "\t" << getDetectorGeometry()->getTelType().size() << endl;
         exit( EXIT_FAILURE );
     }
+    unsigned int iNSumWindows = hped_vec[iTelType].size();
     //////////////////////////////////////////////////////////////////////////////
-    // first call of this function (first event?): define histograms and output files for pedestals
+    // first call of this function (first event?): define distributions and output files for pedestals
     if( !getCalibrated() )
     {
         vector<double> maxSumPerSumWindow;
         vector<double> minSumPerSumWindow;
+        // calculate trace sums for all sumwindows (with iMakingPeds=true)
+        // (always use trace integration method 1 here)
+        calcSumsAllWindows( fRunPar->fCalibrationSumFirst, iNSumWindows, true, iLowGain, 1 );
         // loop over all sumwindows
-        for( unsigned int i = 0; i < hped_vec[iTelType].size(); i++ )
+        for( unsigned int i = 0; i < iNSumWindows; i++ )
         {
-            // calculate trace sums  (with calcSums(...iMakingPeds=true))
-            // (always use trace integration method 1 here)
-            calcSums( fRunPar->fCalibrationSumFirst, fRunPar->fCalibrationSumFirst + ( i + 1 ), true, iLowGain, 1 );
-            
             // calculate the min/max sum for all channels
             double maxSum = 0.;
             double minSum = 1.e10;
-            for( unsigned int j = 0; j < hped_vec[iTelType][i].size(); j++ )
+            for( unsigned int j = 0; j < getNChannels(); j++ )
             {
-                // exclude low gain channels from pedestal calculation
-                if( j < getHiLo().size() )
+                if( usePedestalChannel( j, iLowGain, getWindowSums( i ) ) )
                 {
-                    if( iLowGain && !getHiLo()[j] )
+                    if( maxSum < getWindowSums( i )[j] )
                     {
-                        continue;
+                        maxSum = getWindowSums( i )[j];
                     }
-                    else if( !iLowGain && getHiLo()[j] )
+                    if( getWindowSums( i )[j] < minSum )
                     {
-                        continue;
-                    }
-                }
-                // calculate pedestals only for channels with valid hitbit
-                //   important if trying to generate pedestals for zero supressed
-                //   runs without injected pedestal events
-                if( j < getSums().size() && getSums()[j] > 0. )
-                {
-                    if( fRunPar->fRunIsZeroSuppressed )
-                    {
-                        if( fReader->getChannelHitIndex( j ).first )
-                        {
-                            if( maxSum < getSums()[j] )
-                            {
-                                maxSum = getSums()[j];
-                            }
-                            if( getSums()[j] > 0. && getSums()[j] < minSum )
-                            {
-                                minSum = getSums()[j];
-                            }
-                        }
-                    }
-                    else
-                    {
-                        if( maxSum < getSums()[j] )
-                        {
-                            maxSum = getSums()[j];
-                        }
-                        if( getSums()[j] > 0. && getSums()[j] < minSum )
-                        {
-                            minSum = getSums()[j];
-                        }
+                        minSum = getWindowSums( i )[j];
                     }
                 }
             }
@@ -259,92 +221,40 @@ void VCalibrator::calculatePedestals( bool iLowGain )
     // fill pedestal sum for current telescope type
     fNumberPedestalEvents[iTelType]++;
     
-    // loop over all sumwindows
-    for( unsigned int i = 0; i < hped_vec[iTelType].size(); i++ )
+    //////////////////////////////////////////////////////////
+    // calculate trace sums for all sumwindows (with iMakingPeds=true)
+    // (always use trace integration method 1 here)
+    calcSumsAllWindows( fRunPar->fCalibrationSumFirst, iNSumWindows, true, iLowGain, 1 );
+    
+    // fill pedestal distributions for all channels
+    for( unsigned int i = 0; i < iNSumWindows; i++ )
     {
-        // calculate trace sums  (with calcSums(...iMakingPeds=true))
-        // (always use trace integration method 1 here)
-        calcSums( fRunPar->fCalibrationSumFirst, fRunPar->fCalibrationSumFirst + ( i + 1 ), true, iLowGain, 1 );
-        
-        // fill pedestal histograms for all channels
-        for( unsigned int j = 0; j < hped_vec[iTelType][i].size(); j++ )
+        for( unsigned int j = 0; j < hped_vec[iTelType][i].getNChannels(); j++ )
         {
-            // exclude low gain channels from pedestal calculation
-            if( j < getHiLo().size() )
+            if( usePedestalChannel( j, iLowGain, getWindowSums( i ) ) )
             {
-                if( iLowGain && !getHiLo()[j] )
-                {
-                    continue;
-                }
-                else if( !iLowGain && getHiLo()[j] )
-                {
-                    continue;
-                }
-            }
-            // calculate pedestals only for channels with valid hitbit
-            //   important if trying to generate pedestals for zero supressed
-            //   runs without injected pedestal events
-            if( j < getSums().size() && getSums()[j] > 0. )
-            {
-                if( fRunPar->fRunIsZeroSuppressed )
-                {
-                    if( fReader->getChannelHitIndex( j ).first )
-                    {
-                        hped_vec[iTelType][i][j]->Fill( getSums()[j] );
-                    }
-                }
-                else
-                {
-                    hped_vec[iTelType][i][j]->Fill( getSums()[j] );
-                }
+                hped_vec[iTelType][i].fill( j, getWindowSums( i )[j] );
             }
         }
-        
-        //////////////////////////////////////////////////////////
-        // calculate trace sums for IPR graph (with calcSums(...iMakingPeds=false)) for charge extraction (not pedestal)
-        // (should always be trace integration method 2)
-        fTraceHandler->setIPRmeasure( !fRunPar->fCombineChannelsForPedestalCalculation );
-        calcSums(
-            getSumFirst(),
-            getSumFirst() + ( i + 1 ),
-            false,
-            iLowGain,
-            getTraceIntegrationMethod()
-        );
-        // loop over all channels
-        for( unsigned int j = 0; j < hped_vec[iTelType][i].size(); j++ )
+    }
+    
+    //////////////////////////////////////////////////////////
+    // calculate trace sums for IPR graph (with iMakingPeds=false) for charge extraction (not pedestal)
+    // (should always be trace integration method 2)
+    fTraceHandler->setIPRmeasure( !fRunPar->fCombineChannelsForPedestalCalculation );
+    calcSumsAllWindows( getSumFirst(), iNSumWindows, false, iLowGain, getTraceIntegrationMethod() );
+    fTraceHandler->setIPRmeasure( false );
+    
+    // fill IPR distributions for all channels
+    for( unsigned int i = 0; i < iNSumWindows; i++ )
+    {
+        for( unsigned int j = 0; j < hpedPerTelescopeType[iTelType][i].getNChannels(); j++ )
         {
-            // exclude low gain channels from IPR calculation
-            if( j < getHiLo().size() )
+            if( usePedestalChannel( j, iLowGain, getWindowSums( i ) ) )
             {
-                if( iLowGain && !getHiLo()[j] )
-                {
-                    continue;
-                }
-                else if( !iLowGain && getHiLo()[j] )
-                {
-                    continue;
-                }
-            }
-            // calculate IPR charges only for channels with valid hitbit
-            //   important if trying to generate pedestals for zero supressed
-            //   runs without injected pedestal events
-            if( j < getSums().size() && getSums()[j] > 0. )
-            {
-                if( fRunPar->fRunIsZeroSuppressed )
-                {
-                    if( fReader->getChannelHitIndex( j ).first )
-                    {
-                        hpedPerTelescopeType[iTelType][i][j]->Fill( getSums()[j] );
-                    }
-                }
-                else
-                {
-                    hpedPerTelescopeType[iTelType][i][j]->Fill( getSums()[j] );
-                }
+                hpedPerTelescopeType[iTelType][i].fill( j, getWindowSums( i )[j] );
             }
         }
-        fTraceHandler->setIPRmeasure( false );
     }
 }
 
@@ -424,25 +334,21 @@ void VCalibrator::writePeds( bool iLowGain, VPedestalCalculator* iPedestalCalcul
                     cout << "VCalibrator::writePeds(): ERROR, unable to write pedestals to " << ioutfile << " (" << iLowGain << ")" << endl;
                     exit( EXIT_FAILURE );
                 }
-                for( unsigned int i = 0; i < hped_vec[telType][0].size(); i++ )
+                for( unsigned int i = 0; i < hped_vec[telType][0].getNChannels(); i++ )
                 {
-                    // get pedestal and pedestal variances from pedestal histograms
+                    // get pedestal and pedestal variances from pedestal distributions
                     // (require at least 100 entries in pedestal events)
                     os << t << " " << i << " ";
-                    if( hped_vec[telType][fRunPar->fCalibrationSumWindow - 1][i]
-                            && hped_vec[telType][fRunPar->fCalibrationSumWindow - 1][i]->GetEntries() > 100 )
+                    if( hped_vec[telType][fRunPar->fCalibrationSumWindow - 1].getEntries( i ) > 100 )
                     {
-                        os << hped_vec[telType][fRunPar->fCalibrationSumWindow - 1][i]->GetMean() / ( double )fRunPar->fCalibrationSumWindow << " ";
+                        os << hped_vec[telType][fRunPar->fCalibrationSumWindow - 1].getMean( i ) / ( double )fRunPar->fCalibrationSumWindow << " ";
                     }
                     else
                     {
                         cout << "VCalibrator::writePeds(): WARNING, less than 100 events ";
-                        if( hped_vec[telType][fRunPar->fCalibrationSumWindow - 1][i] )
-                        {
-                            cout << "(";
-                            cout << hped_vec[telType][fRunPar->fCalibrationSumWindow - 1][i]->GetEntries();
-                            cout << " events)";
-                        }
+                        cout << "(";
+                        cout << hped_vec[telType][fRunPar->fCalibrationSumWindow - 1].getEntries( i );
+                        cout << " events)";
                         cout << ", setting pedestal to 0 for telescope (type) ";
                         cout << telType << ", channel " << i << endl;
                         os << 0. << " ";
@@ -450,9 +356,9 @@ void VCalibrator::writePeds( bool iLowGain, VPedestalCalculator* iPedestalCalcul
                     // loop over all window sizes
                     for( unsigned int j = 0; j < hped_vec[telType].size(); j++ )
                     {
-                        if( hped_vec[telType][j][i] && hped_vec[telType][j][i]->GetEntries() > 100 )
+                        if( hped_vec[telType][j].getEntries( i ) > 100 )
                         {
-                            os << hped_vec[telType][j][i]->GetRMS() << " ";
+                            os << hped_vec[telType][j].getRMS( i ) << " ";
                         }
                         else
                         {
@@ -477,29 +383,40 @@ void VCalibrator::writePeds( bool iLowGain, VPedestalCalculator* iPedestalCalcul
             fillPedestalTree( tel, iPedestalCalculator );
             
             // write 1D histograms to directory calibration_TEL
+            // (histograms are created from the pedestal and IPR distributions one by one)
             std::ostringstream iSname;
             iSname << "distributions_" << telType;
             TDirectory* i_dist = getPedestalRootFile( telType )->mkdir( iSname.str().c_str() );
             if( i_dist->cd() )
             {
                 i_dist->cd();
+                char pedkey[100];
+                char ic[800];
                 for( unsigned int i = 0; i < hped_vec[telType].size(); i++ )
                 {
-                    for( unsigned int j = 0; j < hped_vec[telType][i].size(); j++ )
+                    for( unsigned int j = 0; j < hped_vec[telType][i].getNChannels(); j++ )
                     {
-                        if( hped_vec[telType][i][j] )
+                        sprintf( pedkey, "hped_%d_%d_%d", ( int )telType, i + 1, j );
+                        sprintf( ic, "ped distribution (tel type %d, channel %d, sumwindow %d)", ( int )telType, j, i + 1 );
+                        TH1F* h = hped_vec[telType][i].getHistogram( j, pedkey, ic );
+                        if( h )
                         {
-                            hped_vec[telType][i][j]->Write();
+                            h->Write();
+                            delete h;
                         }
                     }
                 }
                 for( unsigned int i = 0; i < hpedPerTelescopeType[telType].size(); i++ )
                 {
-                    for( unsigned int j = 0; j < hpedPerTelescopeType[telType][i].size(); j++ )
+                    for( unsigned int j = 0; j < hpedPerTelescopeType[telType][i].getNChannels(); j++ )
                     {
-                        if( hpedPerTelescopeType[telType][i][j] )
+                        sprintf( pedkey, "hpedPerTelescopeType_%d_%d_%d", ( int )telType, i + 1, j );
+                        sprintf( ic, "IPR distribution (tel type %d, channel %d, sumwindow %d)", ( int )telType, j, i + 1 );
+                        TH1F* h = hpedPerTelescopeType[telType][i].getHistogram( j, pedkey, ic );
+                        if( h )
                         {
-                            hpedPerTelescopeType[telType][i][j]->Write();
+                            h->Write();
+                            delete h;
                         }
                     }
                 }
@@ -507,14 +424,14 @@ void VCalibrator::writePeds( bool iLowGain, VPedestalCalculator* iPedestalCalcul
             iFileWritten[telType] = true;
         }
     }   // end loop over all telescopes
-    // delete all histograms
-    map< ULong64_t, TClonesArray* >::iterator i_PedestalsHistoClonesArray_iter;
-    for( i_PedestalsHistoClonesArray_iter = fPedestalsHistoClonesArray.begin();
-            i_PedestalsHistoClonesArray_iter != fPedestalsHistoClonesArray.end(); i_PedestalsHistoClonesArray_iter++ )
+    // free memory of all distributions
+    map< ULong64_t, vector< VCalibrationAccumulator > >::iterator i_ped_iter;
+    for( i_ped_iter = hped_vec.begin(); i_ped_iter != hped_vec.end(); i_ped_iter++ )
     {
-        if( i_PedestalsHistoClonesArray_iter->second )
+        for( unsigned int i = 0; i < i_ped_iter->second.size(); i++ )
         {
-            i_PedestalsHistoClonesArray_iter->second->Delete();
+            i_ped_iter->second[i].initialize( 0, 0, 0., 1. );
+            hpedPerTelescopeType[i_ped_iter->first][i].initialize( 0, 0, 0., 1. );
         }
     }
     // close all pedestal files
@@ -707,34 +624,31 @@ bool VCalibrator::fillPedestalTree( unsigned int tel, VPedestalCalculator* iPede
     // tree filling
     
     // loop over all channels
-    for( unsigned int i = 0; i < hped_vec[iTelType][0].size(); i++ )
+    for( unsigned int i = 0; i < hped_vec[iTelType][0].getNChannels(); i++ )
     {
         ichannel = ( Int_t )i;
         
-        // get pedestal and pedestal variances from pedestal histograms
+        // get pedestal and pedestal variances from pedestal distributions
         if( fRunPar->fCalibrationSumWindow > 0 && hasFADCData() )
         {
-            iped = hped_vec[iTelType][fRunPar->fCalibrationSumWindow - 1][i]->GetMean() / ( double )fRunPar->fCalibrationSumWindow;
+            iped = hped_vec[iTelType][fRunPar->fCalibrationSumWindow - 1].getMean( i ) / ( double )fRunPar->fCalibrationSumWindow;
         }
         else if( !hasFADCData() )
         {
-            if( hped_vec[iTelType][fRunPar->fCalibrationSumWindow - 1][i] )
-            {
-                iped = hped_vec[iTelType][fRunPar->fCalibrationSumWindow - 1][i]->GetMean();
-            }
+            iped = hped_vec[iTelType][fRunPar->fCalibrationSumWindow - 1].getMean( i );
         }
         else
         {
             iped = 0.;
         }
-        inevents = ( Int_t )hped_vec[iTelType][fRunPar->fCalibrationSumWindow - 1][i]->GetEntries();
+        inevents = ( Int_t )hped_vec[iTelType][fRunPar->fCalibrationSumWindow - 1].getEntries( i );
         
         // loop over all summation window sizes
         insumw = ( UInt_t )hped_vec[iTelType].size();
         for( unsigned int j = 0; j < hped_vec[iTelType].size(); j++ )
         {
             isumw[j] = ( Float_t )j + 1;
-            ipedv[j] = hped_vec[iTelType][j][i]->GetRMS();
+            ipedv[j] = hped_vec[iTelType][j].getRMS( i );
         }
         
         /////////////////////////////////////////////////
@@ -806,26 +720,23 @@ void VCalibrator::calculateAverageTZero( bool iLowGain )
         /////////////////////
         // create histograms
         int telID = 0;
+        char toffkey[100];
+        char ic[100];
+        htzero.assign( getNTel(), VCalibrationAccumulator() );
+        htaverage.assign( getNTel(), VCalibrationAccumulator() );
         for( unsigned int t = 0; t < getNTel(); t++ )
         {
             telID = t + 1;
-            vector< TH1F* > ih_tzero;
-            vector< TH1F* > ih_taverage;
-            for( unsigned int i = 0; i < getNChannels(); i++ )
-            {
-                char toffkey[100];
-                char ic[100];
-                double imin = 0.;
-                double imax = ( double )getNSamples();
-                sprintf( toffkey, "htzero_%d_%d", telID, i );
-                sprintf( ic, "TZero distribution (tel %d, channel %d)", telID, i );
-                ih_tzero.push_back( new TH1F( toffkey, ic, 150, imin, imax ) );
-                sprintf( toffkey, "htaverage_%d_%d", telID, i );
-                sprintf( ic, "TAverageArrTime distribution (tel %d, channel %d)", telID, i );
-                ih_taverage.push_back( new TH1F( toffkey, ic, 150, imin, imax ) );
-            }
-            htzero.push_back( ih_tzero );
-            htaverage.push_back( ih_taverage );
+            double imin = 0.;
+            double imax = ( double )getNSamples();
+            htzero[t].initialize( getNChannels(), 150, imin, imax );
+            sprintf( toffkey, "htzero_%d_%%d", telID );
+            sprintf( ic, "TZero distribution (tel %d, channel %%d)", telID );
+            htzero[t].setHistogramNames( toffkey, ic );
+            htaverage[t].initialize( getNChannels(), 150, imin, imax );
+            sprintf( toffkey, "htaverage_%d_%%d", telID );
+            sprintf( ic, "TAverageArrTime distribution (tel %d, channel %%d)", telID );
+            htaverage[t].setHistogramNames( toffkey, ic );
         }
         ////////////////////
         // root output file
@@ -880,9 +791,9 @@ void VCalibrator::calculateAverageTZero( bool iLowGain )
         // require a min sum for tzero filling
         if( getSums()[i] > fRunPar->fCalibrationIntSumMin && !getDead()[i] && !getMasked()[i] )
         {
-            if( getTraceAverageTime( false )[i] > 0. && i < htaverage[fTelID].size() && htaverage[fTelID][i] )
+            if( getTraceAverageTime( false )[i] > 0. && fTelID < htaverage.size() )
             {
-                htaverage[fTelID][i]->Fill( getTraceAverageTime( false )[i] );
+                htaverage[fTelID].fill( i, getTraceAverageTime( false )[i] );
             }
         }
     }
@@ -906,9 +817,9 @@ void VCalibrator::calculateAverageTZero( bool iLowGain )
         // require a min sum for tzero filling
         if( getSums()[i] > fRunPar->fCalibrationIntSumMin && !getDead()[i] && !getMasked()[i] )
         {
-            if( getTZeros()[i] > 0. && i < htzero[fTelID].size() && htzero[fTelID][i] )
+            if( getTZeros()[i] > 0. && fTelID < htzero.size() )
             {
-                htzero[fTelID][i]->Fill( getTZeros()[i] );
+                htzero[fTelID].fill( i, getTZeros()[i] );
             }
         }
     }
@@ -956,20 +867,8 @@ void VCalibrator::writeAverageTZeros( bool iLowGain )
         fTZeroOutFile[tel]->cd();
         if( t < htzero.size() && t < htaverage.size() )
         {
-            for( unsigned int i = 0; i < htzero[t].size(); i++ )
-            {
-                if( htzero[t][i] )
-                {
-                    htzero[t][i]->Write();
-                }
-            }
-            for( unsigned int i = 0; i < htaverage[t].size(); i++ )
-            {
-                if( htaverage[t][i] )
-                {
-                    htaverage[t][i]->Write();
-                }
-            }
+            writeCalibrationHistograms( htzero[t] );
+            writeCalibrationHistograms( htaverage[t] );
             TTree* i_tree = fillCalibrationSummaryTree( t, "TZero", htzero[t] );
             if( i_tree )
             {
@@ -1000,7 +899,7 @@ void VCalibrator::calculateGainsAndTOffsets( bool iLowGain )
     }
     ////////////////////////////////////////////////
     // initialize output files and histograms
-    if( fReader->getMaxChannels() > 0 && hgain.size() == 0 )
+    if( fReader->getMaxChannels() > 0 && !hgain.isInitialized() )
     {
         findDeadChans( iLowGain );
         
@@ -1023,20 +922,16 @@ void VCalibrator::calculateGainsAndTOffsets( bool iLowGain )
         cout << " (start at " << fRunPar->fCalibrationSumFirst << ")" << endl;
         
         // create histograms
+        char ic[100];
+        hgain.initialize( getNChannels(), 150, 0.0, 5.0 );
+        sprintf( ic, "gain distribution (tel %d, channel %%d)", getTelID() + 1 );
+        hgain.setHistogramNames( "hgain_%d", ic );
         for( unsigned int i = 0; i < getNChannels(); i++ )
         {
-            char gainkey[100];
-            char ic[100];
-            sprintf( gainkey, "hgain_%d", i );
-            double imin = 0.0;
-            double imax = 5.0;
-            sprintf( ic, "gain distribution (tel %d, channel %d)", getTelID() + 1, i );
-            hgain.push_back( new TH1F( gainkey, ic, 150, imin, imax ) );
-            
             char pulsekey[100];
             sprintf( pulsekey, "hpulse_%d", i );
-            imin = 0;
-            imax = getNSamples();
+            double imin = 0;
+            double imax = getNSamples();
             hpulse.push_back( new TProfile( pulsekey, "Mean pulse", ( int )( imax - imin ), imin, imax, -100., 10000. ) );
             
             char spekey[100];
@@ -1059,19 +954,14 @@ void VCalibrator::calculateGainsAndTOffsets( bool iLowGain )
         for( unsigned int i = 0; i < getNChannels(); i++ )
         {
             char toff_vs_sumkey[100];
-            char ic[100];
             sprintf( toff_vs_sumkey, "htoff_vs_sum_%d", i );
             double imin = 5;
             double imax = 405;
             htoff_vs_sum.push_back( new TProfile( toff_vs_sumkey, "TOff vs Sum", 20, imin, imax ) );
-            
-            char toffkey[100];
-            sprintf( toffkey, "htoff_%d", i );
-            imin = -10;
-            imax = 10;
-            sprintf( ic, "TOffset distribution (tel %d, channel %d)", getTelID() + 1, i );
-            htoff.push_back( new TH1F( toffkey, ic, 150, imin, imax ) );
         }
+        htoff.initialize( getNChannels(), 150, -10., 10. );
+        sprintf( ic, "TOffset distribution (tel %d, channel %%d)", getTelID() + 1 );
+        htoff.setHistogramNames( "htoff_%d", ic );
         
         if( getRunParameter()->fWriteExtraCalibTree )
         {
@@ -1333,11 +1223,11 @@ void VCalibrator::calculateGainsAndTOffsets( bool iLowGain )
                         fExtra_use->at( i ) = 1;
                     }
                     
-                    hgain[i]->Fill( ( float )getSums()[i] / m_sums );
+                    hgain.fill( i, ( float )getSums()[i] / m_sums );
                     if( getTZeros()[i] >= 0. )
                     {
                     
-                        htoff[i]->Fill( ( float )getTZeros()[i] - m_tzero );
+                        htoff.fill( i, ( float )getTZeros()[i] - m_tzero );
                         htoff_vs_sum[i]->Fill( ( float )getSums()[i], ( float )getTZeros()[i] - m_tzero );
                     }
                 }
@@ -1407,16 +1297,13 @@ void VCalibrator::writeGains( bool iLowGain )
         {
             for( unsigned int i = 0; i < getNChannels(); i++ )
             {
-                os   << i << " " << hgain[i]->GetMean() << " " << hgain[i]->GetRMS() << endl;
+                os   << i << " " << hgain.getMean( i ) << " " << hgain.getRMS( i ) << endl;
             }
         }
         os.close();
         
         opfgain->cd();
-        for( unsigned int i = 0; i < hgain.size(); i++ )
-        {
-            hgain[i]->Write();
-        }
+        writeCalibrationHistograms( hgain );
         
         if( getRunParameter()->fwriteAverageLaserPulse )
         {
@@ -1445,7 +1332,7 @@ void VCalibrator::writeGains( bool iLowGain )
    generic function to write calibration tree for e.g. gains, toffs, average tzeros
 
 */
-TTree* VCalibrator::fillCalibrationSummaryTree( unsigned int itel, string iName, vector<TH1F* > h )
+TTree* VCalibrator::fillCalibrationSummaryTree( unsigned int itel, string iName, VCalibrationAccumulator& h )
 {
     setTelID( itel );
     
@@ -1476,11 +1363,11 @@ TTree* VCalibrator::fillCalibrationSummaryTree( unsigned int itel, string iName,
     for( unsigned int i = 0; i < getNChannels(); i++ )
     {
         ichannel = ( int )i;
-        if( i < h.size() && h[i] && h[i]->GetEntries() > 0 )
+        if( h.getEntries( i ) > 0 )
         {
-            i_mean = h[i]->GetMean();
-            i_rms  = h[i]->GetRMS();
-            h[i]->GetQuantiles( 1, i_b, i_a );
+            i_mean = h.getMean( i );
+            i_rms  = h.getRMS( i );
+            h.getQuantile( i, i_a[0], i_b[0] );
             i_median = i_b[0];
         }
         else
@@ -1495,6 +1382,24 @@ TTree* VCalibrator::fillCalibrationSummaryTree( unsigned int itel, string iName,
     return t;
 }
 
+/*
+
+   write distributions of all channels as histograms to the current directory
+
+*/
+void VCalibrator::writeCalibrationHistograms( VCalibrationAccumulator& h )
+{
+    for( unsigned int i = 0; i < h.getNChannels(); i++ )
+    {
+        TH1F* i_h = h.getHistogram( i );
+        if( i_h )
+        {
+            i_h->Write();
+            delete i_h;
+        }
+    }
+}
+
 
 void VCalibrator::writeTOffsets( bool iLowGain )
 {
@@ -1527,15 +1432,12 @@ void VCalibrator::writeTOffsets( bool iLowGain )
         }
         else for( unsigned int i = 0; i < getNChannels(); i++ )
             {
-                os << i << " " << htoff[i]->GetMean() << " " << htoff[i]->GetRMS() << endl;
+                os << i << " " << htoff.getMean( i ) << " " << htoff.getRMS( i ) << endl;
             }
         os.close();
         
         opftoff->cd();
-        for( unsigned int i = 0; i < htoff.size(); i++ )
-        {
-            htoff[i]->Write();
-        }
+        writeCalibrationHistograms( htoff );
         for( unsigned int i = 0; i < htoff_vs_sum.size(); i++ )
         {
             htoff_vs_sum[i]->SetErrorOption( "S" );
@@ -3070,40 +2972,23 @@ void VCalibrator::initialize()
             }
             setTelID( iTelID );
             
-            unsigned int i_nclones = 0;
             cout << "VCalibrator::initialize: setting ped histos and files for telescope type " << i_TelTypeList[t] << endl;
             fPedSingleOutFile = 0;
             if( !getRunParameter()->fPedestalSingleRootFile )
             {
                 fPedOutFile[i_TelTypeList[t]] = 0;
             }
-            vector< vector< TH1F* > > iped_vec;
-            vector< vector< TH1F* > > iped_ttype_vec;
-            for( int i = 0; i < getRunParameter()->fCalibrationSumWindow; i++ )
+            // pedestal and IPR distributions for all channels, one per summation window
+            // (binning is defined with the first pedestal event, see initializePedestalHistograms())
+            unsigned int i_nsumwindows = 0;
+            if( getRunParameter()->fCalibrationSumWindow > 0 )
             {
-                vector<TH1F* > ihped;
-                for( unsigned int j = 0; j < getNChannels(); j++ )
-                {
-                    ihped.push_back( 0 );
-                }
-                iped_vec.push_back( ihped );
-                i_nclones += ihped.size();
-                
-                vector<TH1F* > ihped_ttype;
-                for( unsigned int j = 0; j < getNChannels(); j++ )
-                {
-                    ihped_ttype.push_back( 0 );
-                }
-                iped_ttype_vec.push_back( ihped_ttype );
-                i_nclones += ihped_ttype.size();
+                i_nsumwindows = getRunParameter()->fCalibrationSumWindow;
             }
-            
-            hped_vec[i_TelTypeList[t]] = iped_vec;
-            hpedPerTelescopeType[i_TelTypeList[t]] = iped_ttype_vec;
+            hped_vec[i_TelTypeList[t]].assign( i_nsumwindows, VCalibrationAccumulator() );
+            hpedPerTelescopeType[i_TelTypeList[t]].assign( i_nsumwindows, VCalibrationAccumulator() );
             // number of pedestal events
             fNumberPedestalEvents[i_TelTypeList[t]] = 0;
-            // create a TClonesArray for all pedestals histograms
-            fPedestalsHistoClonesArray[i_TelTypeList[t]] = new TClonesArray( "TH1F", i_nclones );
         }
         
     }
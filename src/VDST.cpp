@@ -179,7 +179,7 @@ void VDST::fill()
     if( fReader->isMC() && fDSTLTrig == 0 )
     {
         resetDataVectors();
-        fDST_tree->Fill();
+        fillDSTTree();
         return;
     }
     
@@ -251,10 +251,9 @@ void VDST::fill()
         }
         
         // fill dst arrays
+        setTelescopeDataSize( i, getNChannels(), fDSTnumSamples[i] );
         for( unsigned int j = 0; j < getNChannels(); j++ )
         {
-            fDSTChan[i][j] = j;
-            
             // fill values for this event, this telescope and this pixel if:
             //    i) this is a valid laser event
             //           or
@@ -359,7 +358,7 @@ void VDST::fill()
     {
         return;
     }
-    fDST_tree->Fill();
+    fillDSTTree();
 }
 
 
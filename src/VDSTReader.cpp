@@ -117,7 +117,7 @@ bool VDSTReader::init()
         // FADC Trace
         vector< uint16_t > i_trace_sample( VDST_MAXSUMWINDOW, 0 );
         vector< vector< uint16_t > > i_trace_sample_VV;
-        for( unsigned int t = 0; t < VDST_MAXCHANNELS; t++ )
+        for( unsigned int t = 0; t < fNChannel[i]; t++ )
         {
             i_trace_sample_VV.push_back( i_trace_sample );
         }
@@ -160,7 +160,7 @@ bool VDSTReader::getNextEvent()
     }
     
     int i_succ = 0;
-    i_succ = fDSTTree->getDSTTree()->GetEntry( fDSTtreeEvent );
+    i_succ = fDSTTree->getEntry( fDSTtreeEvent );
     
     // no next event
     if( i_succ <= 0 )
@@ -329,6 +329,48 @@ vector< uint8_t > VDSTReader::getSamplesVec()
     return fDummySample;
 }
 
+/*
+ * fill samples of all channels of the current telescope into iSampleBlock
+ * (channel-major; missing samples are set to 3, as in getSample16Bit())
+ */
+bool VDSTReader::getSampleBlock( vector< uint16_t >& iSampleBlock, unsigned int iNSamples, unsigned int iSampleOffset )
+{
+    if( fTelID >= fPerformFADCAnalysis.size() || !fPerformFADCAnalysis[fTelID] || fTelID >= fFADCTrace.size() )
+    {
+        return false;
+    }
+    unsigned int nhits = getNumChannelsHit();
+    if( iSampleBlock.size() < nhits * iNSamples )
+    {
+        iSampleBlock.resize( nhits * iNSamples );
+    }
+    uint16_t* i_block = iSampleBlock.data();
+    for( unsigned int i = 0; i < nhits; i++ )
+    {
+        unsigned int i_nsamples = 0;
+        if( i < fFADCTrace[fTelID].size() && fFADCTrace[fTelID][i].size() > iSampleOffset )
+        {
+            i_nsamples = fFADCTrace[fTelID][i].size() - iSampleOffset;
+            if( i_nsamples > iNSamples )
+            {
+                i_nsamples = iNSamples;
+            }
+            const uint16_t* i_trace = &fFADCTrace[fTelID][i][iSampleOffset];
+            for( unsigned int s = 0; s < i_nsamples; s++ )
+            {
+                i_block[s] = i_trace[s];
+            }
+        }
+        for( unsigned int s = i_nsamples; s < iNSamples; s++ )
+        {
+            i_block[s] = 3;
+        }
+        i_block += iNSamples;
+    }
+    
+    return true;
+}
+
 uint8_t  VDSTReader::getSample( unsigned channel, unsigned sample, bool iNewNoiseTrace )
 {
     return ( uint8_t )getSample16Bit( channel, sample, iNewNoiseTrace );
@@ -3,12 +3,25 @@
 
     output is after pedestal substraction, gain and toffset correction
 
+    Tree layouts:
+
+    - sparse (written by this class): pixel data is stored only for pixels with
+      at least one value different from its default. Pixels are listed in
+      pix_tel[npix] (index in tel_data) and pix_chan[npix]; per-pixel branches
+      have the dimension [npix] (or [npix][levels]), FADC traces are stored as
+      Trace[ntrace] with numSamples values per stored pixel.
+    - fixed-size arrays (older files, read only): per-pixel branches with the
+      dimensions [ntel_data][VDST_MAXCHANNELS]; read into separate buffers and
+      copied to the pixel data arrays after each entry (see unpackFixedTree())
+
+    Pixel data arrays are allocated per telescope with data and sized by the
+    number of channels and FADC samples of the telescope (see VDSTDataArray).
 
 */
 
 #include <VDSTTree.h>
 
-VDSTTree::VDSTTree()
+VDSTTree::VDSTTree() : fDSTRecord( 1 )
 {
     // source data monte carlo?
     fMC = true;
@@ -23,6 +36,11 @@ VDSTTree::VDSTTree()
     fDST_tree = 0;
     fDST_conf = 0;
     
+    fSparse = false;
+    fDSTnpix = 0;
+    fDSTntrace = 0;
+    fNTelFixed = 0;
+    
     // initialize
     fTelescopeCounter_temp = -1;
     fDSTLTrig = 0;
@@ -53,11 +71,6 @@ VDSTTree::VDSTTree()
     for( unsigned int i = 0; i < VDST_MAXTELESCOPES; i++ )
     {
         fDSTMeanPulseTimingHistogram[i] = 0;
-        for( unsigned int j = 0; j < VDST_MAXCHANNELS; j++ )
-        {
-            fDSTMeanPulseTiming[i][j] = 0.;
-            fDSTMeanPulseTiming_N[i][j] = 0.;
-        }
     }
     
     resetDataVectors();
@@ -137,71 +150,64 @@ bool VDSTTree::initDSTTree( bool iFullTree, bool iCalibrationTree )
     {
         fDST_tree->Branch( "tel_data", fDSTtel_data, "tel_data[ntel_data]/i" );
         fDST_tree->Branch( "tel_zero_suppression", fDSTTelescopeZeroSupression, "tel_zero_suppression[ntel_data]/s" );
-        sprintf( tname, "chan[ntel_data][%d]/s", VDST_MAXCHANNELS );
-        fDST_tree->Branch( "chan", fDSTChan, tname );
-        sprintf( tname, "recorded[ntel_data][%d]/s", VDST_MAXCHANNELS );
-        fDST_tree->Branch( "recorded", fDSTRecord, tname );
         fDST_tree->Branch( "nL1trig", fDSTnL1trig, "nL1trig[ntel_data]/s" );
-        sprintf( tname, "L1trig[ntel_data][%d]/s", VDST_MAXCHANNELS );
-        fDST_tree->Branch( "L1trig", fDSTL1trig, tname );
-    }
-    sprintf( tname, "ped[ntel_data][%d]/F", VDST_MAXCHANNELS );
-    fDST_tree->Branch( "ped", fDSTpedestal, tname );
-    sprintf( tname, "sum[ntel_data][%d]/F", VDST_MAXCHANNELS );
-    fDST_tree->Branch( "sum", fDSTsums, tname );
-    sprintf( tname, "sum2[ntel_data][%d]/F", VDST_MAXCHANNELS );
-    fDST_tree->Branch( "sum2", fDSTsums2, tname );
-    sprintf( tname, "dead[ntel_data][%d]/s", VDST_MAXCHANNELS );
-    fDST_tree->Branch( "dead", fDSTdead, tname );
+        sprintf( tname, "pulsetiminglevel[ntel_data][%d]/F", VDST_MAXTIMINGLEVELS );
+        fDST_tree->Branch( "pulsetiminglevel", fDSTpulsetiminglevels, tname );
+    }
+    fDST_tree->Branch( "numSamples", fDSTnumSamples, "numSamples[ntel_data]/s" );
+    
+    // pixel data (sparse)
+    fSparse = true;
+    fSparseF.clear();
+    fSparseUS.clear();
+    fSparseS.clear();
+    fDSTpix_tel.assign( 1, 0 );
+    fDSTpix_chan.assign( 1, 0 );
+    fSparseTrace.assign( 1, 0 );
+    fDST_tree->Branch( "npix", &fDSTnpix, "npix/i" );
+    fDST_tree->Branch( "pix_tel", &fDSTpix_tel[0], "pix_tel[npix]/s" );
+    fDST_tree->Branch( "pix_chan", &fDSTpix_chan[0], "pix_chan[npix]/s" );
     if( !iCalibrationTree )
     {
-        sprintf( tname, "zerosuppressed[ntel_data][%d]/s", VDST_MAXCHANNELS );
-        fDST_tree->Branch( "zerosuppressed", fDSTZeroSuppressed, tname );
+        addPixelBranch( "recorded", &fDSTRecord );
+        addPixelBranch( "L1trig", &fDSTL1trig );
     }
-    sprintf( tname, "sumwindow[ntel_data][%d]/s", VDST_MAXCHANNELS );
-    fDST_tree->Branch( "sumwindow", fDSTsumwindow, tname );
-    sprintf( tname, "sumfirst[ntel_data][%d]/s", VDST_MAXCHANNELS );
-    fDST_tree->Branch( "sumfirst", fDSTsumfirst, tname );
+    addPixelBranch( "ped", &fDSTpedestal );
+    addPixelBranch( "sum", &fDSTsums );
+    addPixelBranch( "sum2", &fDSTsums2 );
+    addPixelBranch( "dead", &fDSTdead );
     if( !iCalibrationTree )
     {
-        sprintf( tname, "tzero[ntel_data][%d]/F", VDST_MAXCHANNELS );
-        fDST_tree->Branch( "tzero", fDSTt0, tname );
-        sprintf( tname, "Width[ntel_data][%d]/F", VDST_MAXCHANNELS );
-        fDST_tree->Branch( "Width", fDSTTraceWidth, tname );
-        // timing levels
-        sprintf( tname, "pulsetiminglevel[ntel_data][%d]/F", VDST_MAXTIMINGLEVELS );
-        fDST_tree->Branch( "pulsetiminglevel", fDSTpulsetiminglevels, tname );
-        sprintf( tname, "pulsetiming[ntel_data][%d][%d]/F", VDST_MAXTIMINGLEVELS, VDST_MAXCHANNELS );
-        fDST_tree->Branch( "pulsetiming", fDSTpulsetiming, tname );
-        sprintf( tname, "Max[ntel_data][%d]/S", VDST_MAXCHANNELS );
-        fDST_tree->Branch( "Max", fDSTMax, tname );
+        addPixelBranch( "zerosuppressed", &fDSTZeroSuppressed );
+    }
+    addPixelBranch( "sumwindow", &fDSTsumwindow );
+    addPixelBranch( "sumfirst", &fDSTsumfirst );
+    if( !iCalibrationTree )
+    {
+        addPixelBranch( "tzero", &fDSTt0 );
+        addPixelBranch( "Width", &fDSTTraceWidth );
+        addPixelBranch( "pulsetiming", &fDSTpulsetiming );
+        addPixelBranch( "Max", &fDSTMax );
     }
     if( iFullTree )
     {
-        sprintf( tname, "RawMax[ntel_data][%d]/S", VDST_MAXCHANNELS );
-        fDST_tree->Branch( "RawMax", fDSTRawMax, tname );
+        addPixelBranch( "RawMax", &fDSTRawMax );
     }
-    sprintf( tname, "HiLo[ntel_data][%d]/s", VDST_MAXCHANNELS );
-    fDST_tree->Branch( "HiLo", fDSTHiLo, tname );
-    sprintf( tname, "N255[ntel_data][%d]/s", VDST_MAXCHANNELS );
-    fDST_tree->Branch( "N255", fDSTN255, tname );
+    addPixelBranch( "HiLo", &fDSTHiLo );
+    addPixelBranch( "N255", &fDSTN255 );
     // FADC trace
-    fDST_tree->Branch( "numSamples", fDSTnumSamples, "numSamples[ntel_data]/s" );
     if( fReadWriteFADC )
     {
-        sprintf( tname, "FADC[ntel_data][%d][%d]/s", VDST_MAXSUMWINDOW, VDST_MAXCHANNELS );
-        fDST_tree->Branch( "Trace", fDSTtrace, tname );
+        fDST_tree->Branch( "ntrace", &fDSTntrace, "ntrace/i" );
+        fDST_tree->Branch( "Trace", &fSparseTrace[0], "Trace[ntrace]/s" );
     }
     
     //PhotoElectrons
     if( fMC && !iCalibrationTree )//to be changed to something like fReadPE...
     {
-        sprintf( tname, "Pe[ntel_data][%d]/s", VDST_MAXCHANNELS );
-        fDST_tree->Branch( "Pe", fDSTPe, tname );
-        sprintf( tname, "ADC_HG[ntel_data][%d]/s", VDST_MAXCHANNELS );
-        fDST_tree->Branch( "ADC_HG", fDSTPadcHG, tname );
-        sprintf( tname, "ADC_LG[ntel_data][%d]/s", VDST_MAXCHANNELS );
-        fDST_tree->Branch( "ADC_LG", fDSTPadcLG, tname );
+        addPixelBranch( "Pe", &fDSTPe );
+        addPixelBranch( "ADC_HG", &fDSTPadcHG );
+        addPixelBranch( "ADC_LG", &fDSTPadcLG );
     }
     
     // MC block
@@ -277,14 +283,11 @@ void VDSTTree::resetDataVectors( unsigned int iCH, unsigned int iMaxNTel, unsign
         for( unsigned int i = 0; i < iMaxNTel; i++ )
         {
             fDSTLDTtime[i] = 0.;
-            for( unsigned int j = 0; j < iMaxNChannels; j++ )
-            {
-                fDSTt0[i][j] = 0.;
-                fDSTRawMax[i][j] = 0;
-                fDSTTraceWidth[i][j] = 0.;
-                fDSTN255[i][j] = 0;
-            }
         }
+        fDSTt0.reset();
+        fDSTRawMax.reset();
+        fDSTTraceWidth.reset();
+        fDSTN255.reset();
     }
     
     // loop over all telescopes with data in the previous event
@@ -295,54 +298,477 @@ void VDSTTree::resetDataVectors( unsigned int iCH, unsigned int iMaxNTel, unsign
         fDSTnumSamples[i] = 0;
     }
     
-    for( unsigned int i = 0; i < iMaxPrevNTel; i++ )
+    // (pixel data arrays: reset only telescopes allocated so far)
+    fDSTdead.reset();
+    fDSTZeroSuppressed.reset();
+    fDSTL1trig.reset();
+    // FADC mode
+    if( fReadWriteFADC )
+    {
+        fDSTtrace.reset( iMaxNSamples );
+    }
+    // QADC mode
+    else
+    {
+        fDSTRecord.reset();
+        fDSTpedestal.reset();
+        fDSTsums.reset();
+        fDSTsums2.reset();
+        fDSTpulsetiming.reset();
+        std::fill( &fDSTpulsetiminglevels[0][0], &fDSTpulsetiminglevels[0][0] + VDST_MAXTELESCOPES * VDST_MAXTIMINGLEVELS, 0. );
+        fDSTsumwindow.reset();
+        fDSTsumfirst.reset();
+        fDSTMax.reset();
+        if( fFillPeakADC )
+        {
+            fDSTPadcHG.reset();
+            fDSTPadcLG.reset();
+        }
+    }
+    // write PEs
+    if( fFillPELeaf )
+    {
+        fDSTPe.reset();
+    }
+    fDSTHiLo.reset();
+    
+}
+
+/*
+ * helper functions for the sparse tree layout
+ * (applied to all branches of one type)
+ */
+template< class T > static bool isDefaultPixel( vector< sDSTSparseBranch< T > >& b, unsigned int i, unsigned int j )
+{
+    for( unsigned int k = 0; k < b.size(); k++ )
+    {
+        if( !b[k].fArray->isDefault( i, j, b[k].fArray->getNLevels() ) )
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+template< class T > static void packPixel( vector< sDSTSparseBranch< T > >& b, unsigned int i, unsigned int j )
+{
+    for( unsigned int k = 0; k < b.size(); k++ )
+    {
+        b[k].fArray->pack( i, j, b[k].fArray->getNLevels(), b[k].fBuffer );
+    }
+}
+
+template< class T > static void unpackPixel( vector< sDSTSparseBranch< T > >& b, unsigned int i, unsigned int j, unsigned int p )
+{
+    for( unsigned int k = 0; k < b.size(); k++ )
+    {
+        b[k].fArray->unpack( i, j, b[k].fArray->getNLevels(), &b[k].fBuffer[p * b[k].fArray->getNLevels()] );
+    }
+}
+
+template< class T > static void resetPixel( vector< sDSTSparseBranch< T > >& b, unsigned int i, unsigned int j )
+{
+    for( unsigned int k = 0; k < b.size(); k++ )
+    {
+        b[k].fArray->resetChannel( i, j, b[k].fArray->getNLevels() );
+    }
+}
+
+template< class T > static void clearBuffers( vector< sDSTSparseBranch< T > >& b )
+{
+    for( unsigned int k = 0; k < b.size(); k++ )
+    {
+        b[k].fBuffer.clear();
+    }
+}
+
+template< class T > static unsigned int getMaxNChannels( vector< sDSTSparseBranch< T > >& b, unsigned int i )
+{
+    unsigned int n = 0;
+    for( unsigned int k = 0; k < b.size(); k++ )
+    {
+        if( b[k].fArray->getNChannels( i ) > n )
+        {
+            n = b[k].fArray->getNChannels( i );
+        }
+    }
+    return n;
+}
+
+/*
+ * set branch addresses (buffers are resized to hold iNPix pixels)
+ */
+template< class T > static void setBufferAddresses( TTree* t, vector< sDSTSparseBranch< T > >& b, unsigned int iNPix )
+{
+    for( unsigned int k = 0; k < b.size(); k++ )
+    {
+        unsigned int n = ( iNPix > 0 ? iNPix : 1 ) * b[k].fArray->getNLevels();
+        if( b[k].fBuffer.size() < n )
+        {
+            b[k].fBuffer.resize( n, b[k].fArray->getDefault() );
+        }
+        t->SetBranchAddress( b[k].fName.c_str(), &b[k].fBuffer[0] );
+    }
+}
+
+template< class T > static bool addSparseBranch( TTree* t, vector< sDSTSparseBranch< T > >& b, string iName,
+        VDSTDataArray< T >* iArray, string iType, bool iRead )
+{
+    if( !t || !iArray )
+    {
+        return false;
+    }
+    if( iRead && !t->GetBranch( iName.c_str() ) )
+    {
+        return false;
+    }
+    sDSTSparseBranch< T > i_branch;
+    i_branch.fName = iName;
+    i_branch.fArray = iArray;
+    i_branch.fBuffer.assign( iArray->getNLevels(), iArray->getDefault() );
+    b.push_back( i_branch );
+    if( !iRead )
+    {
+        char tname[1000];
+        if( iArray->getNLevels() > 1 )
+        {
+            sprintf( tname, "%s[npix][%d]/%s", iName.c_str(), iArray->getNLevels(), iType.c_str() );
+        }
+        else
+        {
+            sprintf( tname, "%s[npix]/%s", iName.c_str(), iType.c_str() );
+        }
+        t->Branch( iName.c_str(), &b.back().fBuffer[0], tname );
+    }
+    return true;
+}
+
+/*
+ * add a pixel data branch to the sparse tree
+ *
+ * iRead = true: add branch only if it exists in the tree (reading)
+ *
+ */
+void VDSTTree::addPixelBranch( string iName, VDSTDataArray< float >* iArray, bool iRead )
+{
+    addSparseBranch( fDST_tree, fSparseF, iName, iArray, "F", iRead );
+}
+
+void VDSTTree::addPixelBranch( string iName, VDSTDataArray< unsigned short int >* iArray, bool iRead )
+{
+    addSparseBranch( fDST_tree, fSparseUS, iName, iArray, "s", iRead );
+}
+
+void VDSTTree::addPixelBranch( string iName, VDSTDataArray< short >* iArray, bool iRead )
+{
+    addSparseBranch( fDST_tree, fSparseS, iName, iArray, "S", iRead );
+}
+
+/*
+ * set branch addresses of all pixel data branches of the sparse tree
+ * (buffers might have been reallocated)
+ */
+void VDSTTree::setSparseBranchAddresses()
+{
+    if( !fDST_tree || !fSparse )
+    {
+        return;
+    }
+    unsigned int n = ( fDSTnpix > 0 ? fDSTnpix : 1 );
+    if( fDSTpix_tel.size() < n )
+    {
+        fDSTpix_tel.resize( n, 0 );
+        fDSTpix_chan.resize( n, 0 );
+    }
+    fDST_tree->SetBranchAddress( "pix_tel", &fDSTpix_tel[0] );
+    fDST_tree->SetBranchAddress( "pix_chan", &fDSTpix_chan[0] );
+    setBufferAddresses( fDST_tree, fSparseF, fDSTnpix );
+    setBufferAddresses( fDST_tree, fSparseUS, fDSTnpix );
+    setBufferAddresses( fDST_tree, fSparseS, fDSTnpix );
+    if( fDST_tree->GetBranch( "Trace" ) )
     {
-        for( unsigned int j = 0; j < iMaxNChannels; j++ )
+        if( fSparseTrace.size() < ( fDSTntrace > 0 ? fDSTntrace : 1 ) )
         {
-            if( iCH != 0 )
+            fSparseTrace.resize( ( fDSTntrace > 0 ? fDSTntrace : 1 ), 0 );
+        }
+        fDST_tree->SetBranchAddress( "Trace", &fSparseTrace[0] );
+    }
+}
+
+/*
+ * set branch addresses of all pixel data branches of the fixed-size array layout
+ * (buffers for iNTel telescopes; addresses are not changed afterwards)
+ */
+template< class T > static void setFixedBufferAddresses( TTree* t, vector< sDSTSparseBranch< T > >& b, unsigned int iNTel )
+{
+    for( unsigned int k = 0; k < b.size(); k++ )
+    {
+        b[k].fBuffer.assign( ( size_t )iNTel * b[k].fArray->getNLevels() * VDST_MAXCHANNELS, b[k].fArray->getDefault() );
+        t->SetBranchAddress( b[k].fName.c_str(), &b[k].fBuffer[0] );
+    }
+}
+
+template< class T > static void unpackFixedRow( vector< sDSTSparseBranch< T > >& b, unsigned int i )
+{
+    for( unsigned int k = 0; k < b.size(); k++ )
+    {
+        b[k].fArray->unpackRow( i, &b[k].fBuffer[( size_t )i * b[k].fArray->getNLevels() * VDST_MAXCHANNELS], VDST_MAXCHANNELS );
+    }
+}
+
+void VDSTTree::setFixedBranchAddresses( unsigned int iNTel )
+{
+    if( !fDST_tree || fSparse )
+    {
+        return;
+    }
+    fNTelFixed = ( iNTel > 0 ? iNTel : 1 );
+    setFixedBufferAddresses( fDST_tree, fSparseF, fNTelFixed );
+    setFixedBufferAddresses( fDST_tree, fSparseUS, fNTelFixed );
+    setFixedBufferAddresses( fDST_tree, fSparseS, fNTelFixed );
+}
+
+/*
+ * fill pixel data arrays from fixed-size array buffers
+ * (rows are sized by the largest camera of the array)
+ */
+void VDSTTree::unpackFixedTree()
+{
+    unsigned int i_nchannels = getDSTMaxNChannels();
+    for( unsigned int i = 0; i < fDSTntel_data && i < fNTelFixed; i++ )
+    {
+        setTelescopeDataSize( i, i_nchannels, fDSTnumSamples[i] );
+        unpackFixedRow( fSparseF, i );
+        unpackFixedRow( fSparseUS, i );
+        unpackFixedRow( fSparseS, i );
+    }
+}
+
+/*
+ * number of channels of telescope with data iTelData
+ * (from telescope configuration; maximum number of channels if not found)
+ */
+unsigned int VDSTTree::getNChannelsTelData( unsigned int iTelData )
+{
+    int iTel = -1;
+    if( iTelData < fDSTntel_data && iTelData < VDST_MAXTELESCOPES )
+    {
+        iTel = getDSTTelescopeNumber( fDSTtel_data[iTelData] );
+    }
+    if( iTel >= 0 && iTel < VDST_MAXTELESCOPES && fDSTnchannel[iTel] > 0 && fDSTnchannel[iTel] <= VDST_MAXCHANNELS )
+    {
+        return fDSTnchannel[iTel];
+    }
+    return getDSTMaxNChannels();
+}
+
+/*
+ * largest number of channels of all telescopes in the telescope configuration
+ */
+unsigned int VDSTTree::getDSTMaxNChannels()
+{
+    unsigned int n = 0;
+    for( unsigned int i = 0; i < fDST_vlist_of_telescopes.size() && i < VDST_MAXTELESCOPES; i++ )
+    {
+        if( fDSTnchannel[i] > n && fDSTnchannel[i] <= VDST_MAXCHANNELS )
+        {
+            n = fDSTnchannel[i];
+        }
+    }
+    return ( n > 0 ? n : VDST_MAXCHANNELS );
+}
+
+/*
+ * set size of pixel data arrays for telescope with data iTelData
+ * (number of channels and FADC samples; arrays are reset if the size changes)
+ */
+void VDSTTree::setTelescopeDataSize( unsigned int iTelData, unsigned int iNChannels, unsigned int iNSamples )
+{
+    fDSTRecord.setRowSize( iTelData, iNChannels, 1 );
+    fDSTpedestal.setRowSize( iTelData, iNChannels, 1 );
+    fDSTsums.setRowSize( iTelData, iNChannels, 1 );
+    fDSTsums2.setRowSize( iTelData, iNChannels, 1 );
+    fDSTdead.setRowSize( iTelData, iNChannels, 1 );
+    fDSTZeroSuppressed.setRowSize( iTelData, iNChannels, 1 );
+    fDSTsumwindow.setRowSize( iTelData, iNChannels, 1 );
+    fDSTsumfirst.setRowSize( iTelData, iNChannels, 1 );
+    fDSTt0.setRowSize( iTelData, iNChannels, 1 );
+    fDSTMax.setRowSize( iTelData, iNChannels, 1 );
+    fDSTPadcHG.setRowSize( iTelData, iNChannels, 1 );
+    fDSTPadcLG.setRowSize( iTelData, iNChannels, 1 );
+    fDSTpulsetiming.setRowSize( iTelData, iNChannels, VDST_MAXTIMINGLEVELS );
+    fDSTRawMax.setRowSize( iTelData, iNChannels, 1 );
+    fDSTHiLo.setRowSize( iTelData, iNChannels, 1 );
+    fDSTN255.setRowSize( iTelData, iNChannels, 1 );
+    fDSTL1trig.setRowSize( iTelData, iNChannels, 1 );
+    fDSTPe.setRowSize( iTelData, iNChannels, 1 );
+    fDSTTraceWidth.setRowSize( iTelData, iNChannels, 1 );
+    fDSTtrace.setRowSize( iTelData, iNChannels, ( iNSamples > 0 ? iNSamples : 1 ) );
+}
+
+/*
+ * fill sparse tree buffers from pixel data arrays
+ * (all pixels with at least one value different from default)
+ */
+void VDSTTree::packSparseTree()
+{
+    fDSTpix_tel.clear();
+    fDSTpix_chan.clear();
+    clearBuffers( fSparseF );
+    clearBuffers( fSparseUS );
+    clearBuffers( fSparseS );
+    fSparseTrace.clear();
+    
+    for( unsigned int i = 0; i < fDSTntel_data && i < VDST_MAXTELESCOPES; i++ )
+    {
+        // (channels beyond the row sizes are at default values)
+        unsigned int i_nchannels = TMath::Max( TMath::Max( getMaxNChannels( fSparseF, i ), getMaxNChannels( fSparseUS, i ) ),
+                                               TMath::Max( getMaxNChannels( fSparseS, i ), fDSTtrace.getNChannels( i ) ) );
+        for( unsigned int j = 0; j < i_nchannels; j++ )
+        {
+            if( isDefaultPixel( fSparseF, i, j ) && isDefaultPixel( fSparseUS, i, j ) && isDefaultPixel( fSparseS, i, j )
+                    && ( !fReadWriteFADC || fDSTtrace.isDefault( i, j, fDSTnumSamples[i] ) ) )
             {
-                fDSTChan[i][j] = iCH;
+                continue;
             }
-            else
+            fDSTpix_tel.push_back( i );
+            fDSTpix_chan.push_back( j );
+            packPixel( fSparseF, i, j );
+            packPixel( fSparseUS, i, j );
+            packPixel( fSparseS, i, j );
+            if( fReadWriteFADC )
             {
-                fDSTChan[i][j] = j;
+                fDSTtrace.pack( i, j, fDSTnumSamples[i], fSparseTrace );
             }
         }
     }
+    fDSTnpix = fDSTpix_tel.size();
+    fDSTntrace = fSparseTrace.size();
+}
+
+/*
+ * reset pixels of previous event (sparse tree)
+ */
+void VDSTTree::resetSparsePixels()
+{
+    for( unsigned int p = 0; p < fDSTnpix && p < fDSTpix_tel.size(); p++ )
+    {
+        unsigned int i = fDSTpix_tel[p];
+        unsigned int j = fDSTpix_chan[p];
+        if( i >= VDST_MAXTELESCOPES || j >= VDST_MAXCHANNELS )
+        {
+            continue;
+        }
+        resetPixel( fSparseF, i, j );
+        resetPixel( fSparseUS, i, j );
+        resetPixel( fSparseS, i, j );
+        fDSTtrace.resetChannel( i, j, fDSTnumSamples[i] );
+    }
+}
+
+/*
+ * fill pixel data arrays from sparse tree buffers
+ */
+void VDSTTree::unpackSparseTree()
+{
+    // size of pixel data arrays of all telescopes with data
+    // (number of channels from telescope configuration, or from largest stored channel)
+    vector< unsigned int > i_nchannels( fDSTntel_data, 0 );
+    for( unsigned int i = 0; i < fDSTntel_data && i < VDST_MAXTELESCOPES; i++ )
+    {
+        i_nchannels[i] = getNChannelsTelData( i );
+    }
+    for( unsigned int p = 0; p < fDSTnpix; p++ )
+    {
+        if( fDSTpix_tel[p] < i_nchannels.size() && ( unsigned int )fDSTpix_chan[p] + 1 > i_nchannels[fDSTpix_tel[p]] )
+        {
+            i_nchannels[fDSTpix_tel[p]] = fDSTpix_chan[p] + 1;
+        }
+    }
+    for( unsigned int i = 0; i < i_nchannels.size(); i++ )
+    {
+        setTelescopeDataSize( i, i_nchannels[i], fDSTnumSamples[i] );
+    }
     
-    memset( fDSTdead, 0, VDST_MAXTELESCOPES * VDST_MAXCHANNELS * sizeof( fDSTdead[0][0] ) );
-    memset( fDSTZeroSuppressed, 0, VDST_MAXTELESCOPES * VDST_MAXCHANNELS * sizeof( fDSTZeroSuppressed[0][0] ) );
-    memset( fDSTL1trig, 0, VDST_MAXTELESCOPES * VDST_MAXCHANNELS * sizeof( fDSTL1trig[0][0] ) );
-    // FADC mode
-    if( fReadWriteFADC )
+    unsigned int i_trace = 0;
+    for( unsigned int p = 0; p < fDSTnpix; p++ )
     {
-        memset( fDSTtrace, 0, VDST_MAXTELESCOPES * VDST_MAXSUMWINDOW * VDST_MAXCHANNELS * sizeof( fDSTtrace[0][0][0] ) );
+        unsigned int i = fDSTpix_tel[p];
+        unsigned int j = fDSTpix_chan[p];
+        if( i >= VDST_MAXTELESCOPES || j >= VDST_MAXCHANNELS )
+        {
+            continue;
+        }
+        unpackPixel( fSparseF, i, j, p );
+        unpackPixel( fSparseUS, i, j, p );
+        unpackPixel( fSparseS, i, j, p );
+        if( fDSTntrace > 0 && i_trace + fDSTnumSamples[i] <= fDSTntrace )
+        {
+            fDSTtrace.unpack( i, j, fDSTnumSamples[i], &fSparseTrace[i_trace] );
+            i_trace += fDSTnumSamples[i];
+        }
     }
-    // QADC mode
-    else
+}
+
+/*
+ * fill current event into DST tree
+ */
+int VDSTTree::fillDSTTree()
+{
+    if( !fDST_tree )
     {
-        std::fill( &fDSTRecord[0][0], &fDSTRecord[0][0] + VDST_MAXTELESCOPES * VDST_MAXCHANNELS, 1 );
-        std::fill( &fDSTpedestal[0][0], &fDSTpedestal[0][0] + VDST_MAXTELESCOPES * VDST_MAXCHANNELS, 0. );
-        std::fill( &fDSTsums[0][0], &fDSTsums[0][0] + VDST_MAXTELESCOPES * VDST_MAXCHANNELS, 0. );
-        std::fill( &fDSTsums2[0][0], &fDSTsums2[0][0] + VDST_MAXTELESCOPES * VDST_MAXCHANNELS, 0. );
-        std::fill( &fDSTpulsetiming[0][0][0], &fDSTpulsetiming[0][0][0] + VDST_MAXTELESCOPES * VDST_MAXCHANNELS * VDST_MAXTIMINGLEVELS, 0. );
-        std::fill( &fDSTpulsetiminglevels[0][0], &fDSTpulsetiminglevels[0][0] + VDST_MAXTELESCOPES * VDST_MAXTIMINGLEVELS, 0. );
-        memset( fDSTsumwindow, 0, VDST_MAXTELESCOPES * VDST_MAXCHANNELS * sizeof( fDSTsumwindow[0][0] ) );
-        memset( fDSTsumfirst, 0, VDST_MAXTELESCOPES * VDST_MAXCHANNELS * sizeof( fDSTsumfirst[0][0] ) );
-        memset( fDSTMax, 0, VDST_MAXTELESCOPES * VDST_MAXCHANNELS * sizeof( fDSTMax[0][0] ) );
-        if( fFillPeakADC )
+        return 0;
+    }
+    if( fSparse )
+    {
+        packSparseTree();
+        setSparseBranchAddresses();
+    }
+    return fDST_tree->Fill();
+}
+
+/*
+ * read an event from the DST tree (both tree layouts)
+ */
+int VDSTTree::getEntry( Long64_t iEntry )
+{
+    if( !fDST_tree )
+    {
+        return 0;
+    }
+    if( !fSparse )
+    {
+        int i_succ = fDST_tree->GetEntry( iEntry );
+        if( i_succ > 0 )
         {
-            memset( fDSTPadcHG, 0, VDST_MAXTELESCOPES * VDST_MAXCHANNELS * sizeof( fDSTPadcHG[0][0] ) );
-            memset( fDSTPadcLG, 0, VDST_MAXTELESCOPES * VDST_MAXCHANNELS * sizeof( fDSTPadcLG[0][0] ) );
+            unpackFixedTree();
         }
+        return i_succ;
     }
-    // write PEs
-    if( fFillPELeaf )
+    // reset pixel data of previous event
+    resetSparsePixels();
+    // buffer sizes
+    if( fDST_tree->GetBranch( "npix" )->GetEntry( iEntry ) <= 0 )
+    {
+        fDSTnpix = 0;
+        return 0;
+    }
+    if( fDST_tree->GetBranch( "ntrace" ) )
     {
-        memset( fDSTPe, 0, VDST_MAXTELESCOPES * VDST_MAXCHANNELS * sizeof( fDSTPe[0][0] ) );
+        fDST_tree->GetBranch( "ntrace" )->GetEntry( iEntry );
     }
-    memset( fDSTHiLo, 0, VDST_MAXTELESCOPES * VDST_MAXCHANNELS * sizeof( fDSTHiLo[0][0] ) );
+    setSparseBranchAddresses();
     
+    int i_succ = fDST_tree->GetEntry( iEntry );
+    if( i_succ > 0 )
+    {
+        unpackSparseTree();
+    }
+    else
+    {
+        fDSTnpix = 0;
+    }
+    return i_succ;
 }
 
 /*
@@ -372,6 +798,7 @@ bool VDSTTree::initDSTTree( TTree* t, TTree* c )
         fDSTnchannel[i] = iNChannels;
         fDST_vlist_of_telescopes.push_back( fTelID );
     }
+    unsigned int iNTel = fDSTntel;
     
     if( fDST_tree->GetBranch( "gpsyear" ) )
     {
@@ -413,62 +840,94 @@ bool VDSTTree::initDSTTree( TTree* t, TTree* c )
     {
         fDST_tree->SetBranchAddress( "tel_zero_suppression", fDSTTelescopeZeroSupression );
     }
-    if( fDST_tree->GetBranchStatus( "recorded" ) )
-    {
-        fDST_tree->SetBranchAddress( "recorded", fDSTRecord );
-    }
     fDST_tree->SetBranchAddress( "nL1trig", fDSTnL1trig );
-    fDST_tree->SetBranchAddress( "L1trig", fDSTL1trig );
-    if( fDST_tree->GetBranchStatus( "ped" ) )
-    {
-        fDST_tree->SetBranchAddress( "ped", fDSTpedestal );
-    }
-    
-    fDST_tree->SetBranchAddress( "sum", fDSTsums );
-    if( fDST_tree->GetBranchStatus( "sum2" ) )
-    {
-        fDST_tree->SetBranchAddress( "sum2", fDSTsums2 );
-    }
-    else
-    {
-        fDST_tree->SetBranchAddress( "sum", fDSTsums );
-    }
-    fDST_tree->SetBranchAddress( "dead", fDSTdead );
-    if( fDST_tree->GetBranchStatus( "zerosuppressed" ) )
+    if( fDST_tree->GetBranchStatus( "numSamples" ) )
     {
-        fDST_tree->SetBranchAddress( "zerosuppressed", fDSTZeroSuppressed );
+        fDST_tree->SetBranchAddress( "numSamples", fDSTnumSamples );
     }
-    fDST_tree->SetBranchAddress( "tzero", fDSTt0 );
-    fDST_tree->SetBranchAddress( "Width", fDSTTraceWidth );
+    fDST_tree->SetBranchAddress( "pulsetiminglevel", fDSTpulsetiminglevels );
     if( fDST_tree->GetBranchStatus( "Trace" ) )
     {
-        fDST_tree->SetBranchAddress( "Trace", fDSTtrace );
         setFADC( true );
     }
     if( fDST_tree->GetBranchStatus( "Pe" ) )
     {
-        fDST_tree->SetBranchAddress( "Pe", fDSTPe );
         setMC( true );
     }
-    if( fDST_tree->GetBranchStatus( "numSamples" ) )
-    {
-        fDST_tree->SetBranchAddress( "numSamples", fDSTnumSamples );
-    }
-    fDST_tree->SetBranchAddress( "pulsetiminglevel", fDSTpulsetiminglevels );
-    fDST_tree->SetBranchAddress( "pulsetiming", fDSTpulsetiming );
-    fDST_tree->SetBranchAddress( "Max", fDSTMax );
-    if( fDST_tree->GetBranchStatus( "ADC_HG" )
-            && fDST_tree->GetBranchStatus( "ADC_LG" ) )
-    {
-        fDST_tree->SetBranchAddress( "ADC_HG", fDSTPadcHG );
-        fDST_tree->SetBranchAddress( "ADC_LG", fDSTPadcLG );
-        //                fDST_ADC_set = true;
-    }
-    if( fFullTree )
+    
+    ////////////////////////////////////////////
+    // sparse tree: pixel data of stored pixels
+    fSparse = ( fDST_tree->GetBranch( "npix" ) != 0 );
+    fSparseF.clear();
+    fSparseUS.clear();
+    fSparseS.clear();
+    if( fSparse )
+    {
+        fDSTpix_tel.assign( 1, 0 );
+        fDSTpix_chan.assign( 1, 0 );
+        fSparseTrace.assign( 1, 0 );
+        fDST_tree->SetBranchAddress( "npix", &fDSTnpix );
+        if( fDST_tree->GetBranch( "ntrace" ) )
+        {
+            fDST_tree->SetBranchAddress( "ntrace", &fDSTntrace );
+        }
+        // (only branches available in the tree are added)
+        addPixelBranch( "recorded", &fDSTRecord, true );
+        addPixelBranch( "L1trig", &fDSTL1trig, true );
+        addPixelBranch( "ped", &fDSTpedestal, true );
+        addPixelBranch( "sum", &fDSTsums, true );
+        addPixelBranch( "sum2", &fDSTsums2, true );
+        addPixelBranch( "dead", &fDSTdead, true );
+        addPixelBranch( "zerosuppressed", &fDSTZeroSuppressed, true );
+        addPixelBranch( "sumwindow", &fDSTsumwindow, true );
+        addPixelBranch( "sumfirst", &fDSTsumfirst, true );
+        addPixelBranch( "tzero", &fDSTt0, true );
+        addPixelBranch( "Width", &fDSTTraceWidth, true );
+        addPixelBranch( "pulsetiming", &fDSTpulsetiming, true );
+        addPixelBranch( "Max", &fDSTMax, true );
+        addPixelBranch( "RawMax", &fDSTRawMax, true );
+        addPixelBranch( "HiLo", &fDSTHiLo, true );
+        addPixelBranch( "N255", &fDSTN255, true );
+        addPixelBranch( "Pe", &fDSTPe, true );
+        addPixelBranch( "ADC_HG", &fDSTPadcHG, true );
+        addPixelBranch( "ADC_LG", &fDSTPadcLG, true );
+        setSparseBranchAddresses();
+    }
+    ////////////////////////////////////////////
+    // fixed-size arrays [ntel_data][VDST_MAXCHANNELS]
+    // (branch addresses point to buffers for all telescopes; values are
+    //  copied to the pixel data arrays in getEntry())
+    else
     {
-        fDST_tree->SetBranchAddress( "RawMax", fDSTRawMax );
+        addPixelBranch( "recorded", &fDSTRecord, true );
+        addPixelBranch( "L1trig", &fDSTL1trig, true );
+        addPixelBranch( "ped", &fDSTpedestal, true );
+        addPixelBranch( "sum", &fDSTsums, true );
+        addPixelBranch( "sum2", &fDSTsums2, true );
+        addPixelBranch( "dead", &fDSTdead, true );
+        addPixelBranch( "zerosuppressed", &fDSTZeroSuppressed, true );
+        addPixelBranch( "sumwindow", &fDSTsumwindow, true );
+        addPixelBranch( "sumfirst", &fDSTsumfirst, true );
+        addPixelBranch( "tzero", &fDSTt0, true );
+        addPixelBranch( "Width", &fDSTTraceWidth, true );
+        addPixelBranch( "Trace", &fDSTtrace, true );
+        addPixelBranch( "Pe", &fDSTPe, true );
+        addPixelBranch( "pulsetiming", &fDSTpulsetiming, true );
+        addPixelBranch( "Max", &fDSTMax, true );
+        if( fDST_tree->GetBranchStatus( "ADC_HG" )
+                && fDST_tree->GetBranchStatus( "ADC_LG" ) )
+        {
+            addPixelBranch( "ADC_HG", &fDSTPadcHG, true );
+            addPixelBranch( "ADC_LG", &fDSTPadcLG, true );
+            //                fDST_ADC_set = true;
+        }
+        if( fFullTree )
+        {
+            addPixelBranch( "RawMax", &fDSTRawMax, true );
+        }
+        addPixelBranch( "HiLo", &fDSTHiLo, true );
+        setFixedBranchAddresses( iNTel );
     }
-    fDST_tree->SetBranchAddress( "HiLo", fDSTHiLo );
     if( fMC )
     {
         fDST_tree->SetBranchAddress( "MCprim", &fDSTprimary );
@@ -551,16 +1010,16 @@ double VDSTTree::getDSTPedestal( int iChannelID, bool iPrint )
     {
         cout << "\t getDSTPedestal " << fTelescopeCounter_temp << "\t channel " << iChannelID;
         cout << "\t max channel " << VDST_MAXCHANNELS << endl;
-        cout << "\t pedestal " << fDSTpedestal[fTelescopeCounter_temp][iChannelID];
+        cout << "\t pedestal " << fDSTpedestal.get( fTelescopeCounter_temp, iChannelID );
         cout << endl;
     }
-    if( fTelescopeCounter_temp < 0 && iChannelID < VDST_MAXCHANNELS )
+    if( fTelescopeCounter_temp < 0 || iChannelID >= VDST_MAXCHANNELS )
     {
         return 0.;
     }
     else
     {
-        return fDSTpedestal[fTelescopeCounter_temp][iChannelID];
+        return fDSTpedestal.get( fTelescopeCounter_temp, iChannelID );
     }
     return 0;
 }
@@ -575,7 +1034,7 @@ double VDSTTree::getDSTPedestal( int iChannelID, bool iPrint )
 
 double VDSTTree::getDSTSums( int iChannelID )
 {
-    if( fTelescopeCounter_temp < 0 && iChannelID < VDST_MAXCHANNELS )
+    if( fTelescopeCounter_temp < 0 || iChannelID >= VDST_MAXCHANNELS )
     {
         return 0.;
     }
@@ -583,29 +1042,29 @@ double VDSTTree::getDSTSums( int iChannelID )
     {
         if( getDSTHiLo( iChannelID ) )
         {
-            return ( double )fDSTPadcHG[fTelescopeCounter_temp][iChannelID];
+            return ( double )fDSTPadcHG.get( fTelescopeCounter_temp, iChannelID );
         }
         else
         {
-            return ( double )fDSTPadcLG[fTelescopeCounter_temp][iChannelID];
+            return ( double )fDSTPadcLG.get( fTelescopeCounter_temp, iChannelID );
         }
     }
     else
     {
-        return fDSTsums[fTelescopeCounter_temp][iChannelID];
+        return fDSTsums.get( fTelescopeCounter_temp, iChannelID );
     }
     return 0;
 }
 
 unsigned short int  VDSTTree::getDSTPe( int iChannelID )
 {
-    if( fTelescopeCounter_temp < 0 && iChannelID < VDST_MAXCHANNELS )
+    if( fTelescopeCounter_temp < 0 || iChannelID >= VDST_MAXCHANNELS )
     {
         return 0.;
     }
     else
     {
-        return fDSTPe[fTelescopeCounter_temp][iChannelID];
+        return fDSTPe.get( fTelescopeCounter_temp, iChannelID );
     }
     return 0;
 }
@@ -618,11 +1077,11 @@ unsigned short int VDSTTree::getDSTPadcHG( int iTelID, int iChannelID )
 
 unsigned short int VDSTTree::getDSTPadcHG( int iChannelID )
 {
-    if( fTelescopeCounter_temp < 0 && iChannelID < VDST_MAXCHANNELS )
+    if( fTelescopeCounter_temp < 0 || iChannelID >= VDST_MAXCHANNELS )
     {
         return 0;
     }
-    return ( unsigned short int )( fDSTPadcHG[fTelescopeCounter_temp][iChannelID] );
+    return ( unsigned short int )( fDSTPadcHG.get( fTelescopeCounter_temp, iChannelID ) );
 }
 unsigned short int VDSTTree::getDSTPadcLG( int iTelID, int iChannelID )
 {
@@ -632,12 +1091,12 @@ unsigned short int VDSTTree::getDSTPadcLG( int iTelID, int iChannelID )
 
 unsigned short int VDSTTree::getDSTPadcLG( int iChannelID )
 {
-    if( fTelescopeCounter_temp < 0 && iChannelID < VDST_MAXCHANNELS )
+    if( fTelescopeCounter_temp < 0 || iChannelID >= VDST_MAXCHANNELS )
     {
         return 0;
     }
     
-    return ( unsigned short int )( fDSTPadcLG[fTelescopeCounter_temp][iChannelID] );
+    return ( unsigned short int )( fDSTPadcLG.get( fTelescopeCounter_temp, iChannelID ) );
 }
 
 double VDSTTree::getDSTMax( int iTelID, int iChannelID )
@@ -648,13 +1107,13 @@ double VDSTTree::getDSTMax( int iTelID, int iChannelID )
 
 double VDSTTree::getDSTMax( int iChannelID )
 {
-    if( fTelescopeCounter_temp < 0 && iChannelID < VDST_MAXCHANNELS )
+    if( fTelescopeCounter_temp < 0 || iChannelID >= VDST_MAXCHANNELS )
     {
         return 0.;
     }
     else
     {
-        return ( double )( fDSTMax[fTelescopeCounter_temp][iChannelID] );
+        return ( double )( fDSTMax.get( fTelescopeCounter_temp, iChannelID ) );
     }
     
     return 0;
@@ -668,13 +1127,13 @@ double VDSTTree::getDSTRawMax( int iTelID, int iChannelID )
 
 double VDSTTree::getDSTRawMax( int iChannelID )
 {
-    if( fTelescopeCounter_temp < 0 && iChannelID < VDST_MAXCHANNELS )
+    if( fTelescopeCounter_temp < 0 || iChannelID >= VDST_MAXCHANNELS )
     {
         return 0.;
     }
     else
     {
-        return ( double )( fDSTRawMax[fTelescopeCounter_temp][iChannelID] ) / 100.;
+        return ( double )( fDSTRawMax.get( fTelescopeCounter_temp, iChannelID ) ) / 100.;
     }
     
     return 0;
@@ -685,13 +1144,13 @@ double VDSTTree::getDSTWidth( int iTelID, int iChannelID )
 {
     int iTel = hasData( iTelID );
     
-    if( iTel < 0 && iChannelID < VDST_MAXCHANNELS )
+    if( iTel < 0 || iChannelID >= VDST_MAXCHANNELS )
     {
         return 0.;
     }
     else
     {
-        return ( double )( fDSTTraceWidth[iTel][iChannelID] );
+        return ( double )( fDSTTraceWidth.get( iTel, iChannelID ) );
     }
     
     return 0;
@@ -702,13 +1161,13 @@ double VDSTTree::getDSTTZeros( int iTelID, int iChannelID )
 {
     int iTel = hasData( iTelID );
     
-    if( iTel < 0 && iChannelID < VDST_MAXCHANNELS )
+    if( iTel < 0 || iChannelID >= VDST_MAXCHANNELS )
     {
         return 0.;
     }
     else
     {
-        return ( double )( fDSTt0[iTel][iChannelID] );
+        return ( double )( fDSTt0.get( iTel, iChannelID ) );
     }
     
     return 0;
@@ -722,13 +1181,13 @@ double VDSTTree::getDSTpulsetiming( int iTelID, int iChannelID, int iTimingLevel
 
 double VDSTTree::getDSTpulsetiming( int iChannelID, int iTimingLevelN )
 {
-    if( fTelescopeCounter_temp < 0 && iChannelID < VDST_MAXCHANNELS )
+    if( fTelescopeCounter_temp < 0 || iChannelID >= VDST_MAXCHANNELS )
     {
         return 0.;
     }
     else if( iTimingLevelN < VDST_MAXTIMINGLEVELS )
     {
-        return ( double )( fDSTpulsetiming[fTelescopeCounter_temp][iTimingLevelN][iChannelID] );
+        return ( double )( fDSTpulsetiming.get( fTelescopeCounter_temp, iChannelID, iTimingLevelN ) );
     }
     
     return 0;
@@ -742,13 +1201,13 @@ unsigned int VDSTTree::getDSTDead( int iTelID, int iChannelID )
 
 unsigned int VDSTTree::getDSTDead( int iChannelID )
 {
-    if( fTelescopeCounter_temp < 0 && iChannelID < VDST_MAXCHANNELS )
+    if( fTelescopeCounter_temp < 0 || iChannelID >= VDST_MAXCHANNELS )
     {
         return 0;
     }
     else
     {
-        return fDSTdead[fTelescopeCounter_temp][iChannelID];
+        return fDSTdead.get( fTelescopeCounter_temp, iChannelID );
     }
     
     return 0;
@@ -762,13 +1221,13 @@ unsigned short int VDSTTree::getZeroSupppressed( int iTelID, int iChannelID )
 
 unsigned short int VDSTTree::getZeroSupppressed( int iChannelID )
 {
-    if( fTelescopeCounter_temp < 0 && iChannelID < VDST_MAXCHANNELS )
+    if( fTelescopeCounter_temp < 0 || iChannelID >= VDST_MAXCHANNELS )
     {
         return 0;
     }
     else
     {
-        return fDSTZeroSuppressed[fTelescopeCounter_temp][iChannelID];
+        return fDSTZeroSuppressed.get( fTelescopeCounter_temp, iChannelID );
     }
     
     // default return value: not suppressed
@@ -795,13 +1254,13 @@ UShort_t VDSTTree::getDSTHiLo( int iTelID, int iChannelID )
 
 UShort_t VDSTTree::getDSTHiLo( int iChannelID )
 {
-    if( fTelescopeCounter_temp < 0 && iChannelID < VDST_MAXCHANNELS )
+    if( fTelescopeCounter_temp < 0 || iChannelID >= VDST_MAXCHANNELS )
     {
         return 0;
     }
     else
     {
-        return fDSTHiLo[fTelescopeCounter_temp][iChannelID];
+        return fDSTHiLo.get( fTelescopeCounter_temp, iChannelID );
     }
     
     return 0;
@@ -820,7 +1279,7 @@ unsigned short int VDSTTree::getDSTTrace( unsigned int iChannelID, unsigned shor
         return 3;
     }
     
-    return fDSTtrace[fTelescopeCounter_temp][iSample][iChannelID];
+    return fDSTtrace.get( fTelescopeCounter_temp, iChannelID, iSample );
 }
 
 unsigned int VDSTTree::getTrigL1( int iTelID, int iChannelID )
@@ -831,13 +1290,13 @@ unsigned int VDSTTree::getTrigL1( int iTelID, int iChannelID )
 
 unsigned int VDSTTree::getTrigL1( int iChannelID )
 {
-    if( fTelescopeCounter_temp < 0 && iChannelID < VDST_MAXCHANNELS )
+    if( fTelescopeCounter_temp < 0 || iChannelID >= VDST_MAXCHANNELS )
     {
         return 0;
     }
     else
     {
-        return fDSTL1trig[fTelescopeCounter_temp][iChannelID];
+        return fDSTL1trig.get( fTelescopeCounter_temp, iChannelID );
     }
     
     return 0;
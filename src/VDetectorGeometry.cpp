@@ -116,3 +116,121 @@ void VDetectorGeometry::setNChannels( unsigned int iTelID, unsigned int iNChanne
         fNChannels[iTelID] = iNChannels;
     }
 }
+
+/*
+ * flat (CSR) neighbour tables for fast image cleaning
+ *
+ * neighbours of channel i are
+ *
+ *    fNeighbourTable[t][j] for fNeighbourTableOffset[t][i] <= j < fNeighbourTableOffset[t][i+1]
+ *
+ * (invalid entries (<0) of the neighbour lists are removed)
+ *
+ * telescopes with identical neighbour lists (same camera type) share one table
+ *
+ * note: call this function after the neighbour lists are final
+ *       (i.e. after reading the reconstruction parameters, see VEventLoop)
+ *       and before any parallel image analysis
+ */
+void VDetectorGeometry::fillNeighbourTables()
+{
+    fNeighbourTableID.clear();
+    fNeighbourTableOffset.clear();
+    fNeighbourTable.clear();
+    
+    // telescope which defines a neighbour table
+    vector< unsigned int > i_tableTelID;
+    for( unsigned int t = 0; t < fNeighbour.size(); t++ )
+    {
+        unsigned int i_table = i_tableTelID.size();
+        for( unsigned int n = 0; n < i_tableTelID.size(); n++ )
+        {
+            if( hasSameNeighbours( t, i_tableTelID[n] ) )
+            {
+                i_table = n;
+                break;
+            }
+        }
+        fNeighbourTableID.push_back( i_table );
+        if( i_table < i_tableTelID.size() )
+        {
+            continue;
+        }
+        
+        // new camera type
+        i_tableTelID.push_back( t );
+        vector< unsigned int > i_offset( fNeighbour[t].size() + 1, 0 );
+        vector< unsigned int > i_neighbours;
+        for( unsigned int i = 0; i < fNeighbour[t].size(); i++ )
+        {
+            i_offset[i] = i_neighbours.size();
+            unsigned int i_nn = fNeighbour[t][i].size();
+            if( t < fNNeighbour.size() && i < fNNeighbour[t].size() && fNNeighbour[t][i] < i_nn )
+            {
+                i_nn = fNNeighbour[t][i];
+            }
+            for( unsigned int j = 0; j < i_nn; j++ )
+            {
+                if( fNeighbour[t][i][j] >= 0 )
+                {
+                    i_neighbours.push_back( ( unsigned int )fNeighbour[t][i][j] );
+                }
+            }
+        }
+        i_offset[fNeighbour[t].size()] = i_neighbours.size();
+        fNeighbourTableOffset.push_back( i_offset );
+        fNeighbourTable.push_back( i_neighbours );
+    }
+    if( fDebug )
+    {
+        cout << "VDetectorGeometry::fillNeighbourTables: " << fNeighbourTable.size();
+        cout << " neighbour table(s) for " << fNeighbourTableID.size() << " telescope(s)" << endl;
+    }
+}
+
+bool VDetectorGeometry::hasSameNeighbours( unsigned int iTelID, unsigned int iTelID_ref )
+{
+    if( iTelID >= fNeighbour.size() || iTelID_ref >= fNeighbour.size()
+            || iTelID >= fNNeighbour.size() || iTelID_ref >= fNNeighbour.size() )
+    {
+        return false;
+    }
+    return ( fNNeighbour[iTelID] == fNNeighbour[iTelID_ref] && fNeighbour[iTelID] == fNeighbour[iTelID_ref] );
+}
+
+/*
+ * flat neighbour list of the current telescope
+ * (tables are filled on first use if fillNeighbourTables() has not been called)
+ */
+vector< unsigned int >& VDetectorGeometry::getNeighbourTable()
+{
+    return getNeighbourTable( fTelID );
+}
+
+vector< unsigned int >& VDetectorGeometry::getNeighbourTableOffset()
+{
+    return getNeighbourTableOffset( fTelID );
+}
+
+/*
+ * flat neighbour list of telescope iTelID
+ *
+ * (parallel image analysis: call fillNeighbourTables() before starting the threads)
+ */
+vector< unsigned int >& VDetectorGeometry::getNeighbourTable( unsigned int iTelID )
+{
+    if( fNeighbourTableID.size() != fNeighbour.size() )
+    {
+        fillNeighbourTables();
+    }
+    return fNeighbourTable[fNeighbourTableID[iTelID]];
+}
+
+vector< unsigned int >& VDetectorGeometry::getNeighbourTableOffset( unsigned int iTelID )
+{
+    if( fNeighbourTableID.size() != fNeighbour.size() )
+    {
+        fillNeighbourTables();
+    }
+    return fNeighbourTableOffset[fNeighbourTableID[iTelID]];
+}
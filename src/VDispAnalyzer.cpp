@@ -34,11 +34,23 @@ VDispAnalyzer::VDispAnalyzer()
     fdisp_sum_abs_weigth = 0.;
 
     fUseIntersectForHeadTail = false;
+    fSignSearch_bestDiff = 0.;
+    fSignSearch_weightSum = 0.;
+    fSignSearch_nNodes = 0;
+    fSignSearch_nNodes_max = 0;
 
+    setHeadTailSearch_NImages_max();
     setQualityCuts();
     setDispErrorWeighting();
     setDebug( false );
 }
+
+VDispAnalyzer::~VDispAnalyzer()
+{
+    delete fDispTableAnalyzer;
+    delete fTMVADispAnalyzer;
+}
+
 void VDispAnalyzer::setTelescopeTypeList( vector<ULong64_t> iTelescopeTypeList )
 {
     fTelescopeTypeList = iTelescopeTypeList;
@@ -145,73 +157,275 @@ float VDispAnalyzer::evaluate( float iWidth, float iLength, float iAsymm, float
 ///////////////////////////////////////////////////////////////////////////////////////////////
 ///////////////////////////////////////////////////////////////////////////////////////////////
 /*
- * return permutation vector with all possible pairs of signs
+ * compare two sign combinations in the order of the enumeration of all
+ * 2^N combinations (bit n set for sign -1 of image n)
  *
+ * (used to resolve ties in the same way as a test of all combinations)
  */
-vector< vector< float > > VDispAnalyzer::get_sign_permutation_vector( unsigned int x_size )
+bool VDispAnalyzer::isSmallerSignCombination( const vector< int >& a, const vector< int >& b )
 {
-    unsigned int ncombinations = ( 1 << x_size ) - 1;
-    vector< vector< float > > i_sign;
-    for( unsigned int i = 0; i <= ncombinations; i++ )
-    {
-        int y = i;
-        int i_counter = 0;
-        vector< float > i_temp_v( x_size, 1. );
-        while( y > 0 )
+    for( unsigned int n = a.size(); n > 0; n-- )
+    {
+        if( a[n - 1] != b[n - 1] )
         {
-            if(( y & 1 ) == 1 )
-            {
-                i_temp_v[i_counter] = -1.;
-            }
-            y = y >> 1;
-            i_counter++;
+            return ( a[n - 1] < b[n - 1] );
         }
-        i_sign.push_back( i_temp_v );
     }
-    return i_sign;
+    return false;
 }
 
 /*
- * calculate smallest diff element of a set of disp
- * values
+ * calculate dispersion of disp directions for the current sign combination
+ * and keep it if it is the best combination found so far
  *
  */
-unsigned int VDispAnalyzer::find_smallest_diff_element(
-    vector< vector< float > > i_sign,
-    vector< float > x, vector< float > y,
-    vector< float > cosphi, vector< float > sinphi,
-    vector< float > v_disp, vector< float > v_weight )
+void VDispAnalyzer::testSignCombination( const vector< float >& v_weight )
 {
-    vector< float > v_disp_diff( i_sign.size(), 0. );
-    vector< float > v_dist( i_sign.size(), 0. );
-    vector< float > v_xs( x.size(), 0. );
-    vector< float > v_ys( x.size(), 0. );
+    for( unsigned int i = 0; i < fSignSearch_sign.size(); i++ )
+    {
+        fSignSearch_xs[i] = fSignSearch_px[2 * i + fSignSearch_sign[i]];
+        fSignSearch_ys[i] = fSignSearch_py[2 * i + fSignSearch_sign[i]];
+    }
     float xs = 0.;
     float ys = 0.;
     float disp_diff = 0.;
-    for( unsigned int s = 0; s < i_sign.size(); s++ )
+    calculateMeanShowerDirection( fSignSearch_xs, fSignSearch_ys, v_weight, xs, ys, disp_diff, fSignSearch_xs.size() );
+    if( fSignSearch_bestSign.size() != fSignSearch_sign.size()
+            || disp_diff < fSignSearch_bestDiff
+            || ( disp_diff == fSignSearch_bestDiff && isSmallerSignCombination( fSignSearch_sign, fSignSearch_bestSign ) ) )
+    {
+        fSignSearch_bestDiff = disp_diff;
+        fSignSearch_bestSign = fSignSearch_sign;
+    }
+}
+
+/*
+ * depth-first branch-and-bound search for the sign combination with the
+ * smallest dispersion
+ *
+ * lower bound for a partial sign combination: weighted distances between
+ * all assigned images, plus the smallest possible distances of each
+ * unassigned image to the assigned images, plus the smallest possible
+ * distances between pairs of unassigned images
+ *
+ */
+void VDispAnalyzer::searchSigns( unsigned int iDepth, double iCost, const vector< float >& v_weight )
+{
+    if( fSignSearch_nNodes >= fSignSearch_nNodes_max )
     {
-        for( unsigned int i = 0; i < x.size(); i++ )
+        return;
+    }
+    fSignSearch_nNodes++;
+
+    const unsigned int N = fSignSearch_sign.size();
+    // lower bound (small margin to allow for rounding differences
+    // to the float arithmetic in calculateMeanShowerDirection())
+    double i_bound = iCost + fSignSearch_minPairCost[iDepth];
+    for( unsigned int k = iDepth; k < N; k++ )
+    {
+        unsigned int m = fSignSearch_order[k];
+        i_bound += TMath::Min( fSignSearch_partialCost[2 * m], fSignSearch_partialCost[2 * m + 1] );
+    }
+    if( i_bound / fSignSearch_weightSum > fSignSearch_bestDiff + 1.e-4 * TMath::Abs( fSignSearch_bestDiff ) + 1.e-6 )
+    {
+        return;
+    }
+    if( iDepth == N )
+    {
+        testSignCombination( v_weight );
+        return;
+    }
+
+    // test sign with smaller distances to the assigned images first
+    unsigned int n = fSignSearch_order[iDepth];
+    int i_first = ( fSignSearch_partialCost[2 * n + 1] < fSignSearch_partialCost[2 * n] ? 1 : 0 );
+    for( int s = 0; s < 2; s++ )
+    {
+        int a = ( s == 0 ? i_first : 1 - i_first );
+        fSignSearch_sign[n] = a;
+        for( unsigned int k = iDepth + 1; k < N; k++ )
         {
-            v_xs[i] = x[i] - i_sign[s][i] * v_disp[i] * cosphi[i];
-            v_ys[i] = y[i] - i_sign[s][i] * v_disp[i] * sinphi[i];
+            unsigned int m = fSignSearch_order[k];
+            fSignSearch_partialCost[2 * m]     += fSignSearch_pairCost[(( n * N + m ) * 2 + a ) * 2];
+            fSignSearch_partialCost[2 * m + 1] += fSignSearch_pairCost[(( n * N + m ) * 2 + a ) * 2 + 1];
+        }
+        searchSigns( iDepth + 1, iCost + fSignSearch_partialCost[2 * n + a], v_weight );
+        for( unsigned int k = iDepth + 1; k < N; k++ )
+        {
+            unsigned int m = fSignSearch_order[k];
+            fSignSearch_partialCost[2 * m]     -= fSignSearch_pairCost[(( n * N + m ) * 2 + a ) * 2];
+            fSignSearch_partialCost[2 * m + 1] -= fSignSearch_pairCost[(( n * N + m ) * 2 + a ) * 2 + 1];
         }
-        calculateMeanShowerDirection( v_xs, v_ys, v_weight, xs, ys, disp_diff, v_xs.size() );
-        v_disp_diff[s] = disp_diff;
-        v_dist[s] = sqrt( xs * xs + ys * ys );
     }
-    unsigned int i_mean_element = 0;
-    float i_smallest_dist = 1.e20;
+    fSignSearch_sign[n] = 0;
+}
 
-    for( unsigned int s = 0; s < v_disp_diff.size(); s++ )
+/*
+ * find combination of head/tail signs (one per image) with the smallest
+ * dispersion of the disp directions (see calculateMeanShowerDirection())
+ *
+ * Starting value is a greedy assignment (images ordered by weight) improved
+ * by flipping single signs. This is followed by a branch-and-bound search,
+ * limited to 512 + 16 * N^2 search nodes. Up to 8 images (at least) the search
+ * is complete and the result is identical to a test of all 2^N sign
+ * combinations (including the resolution of ties); for larger multiplicities
+ * the best combination found within the node limit is returned.
+ *
+ * returns vector of signs (+1/-1)
+ */
+vector< float > VDispAnalyzer::find_smallest_diff_signs(
+    const vector< float >& x, const vector< float >& y,
+    const vector< float >& cosphi, const vector< float >& sinphi,
+    const vector< float >& v_disp, const vector< float >& v_weight )
+{
+    const unsigned int N = x.size();
+    vector< float > i_sign( N, 1. );
+    if( N < 2 )
+    {
+        return i_sign;
+    }
+    // invalid weights: all combinations have the same (invalid) dispersion
+    float d_w_sum = 0.;
+    float z = 0.;
+    for( unsigned int n = 0; n < N; n++ )
+    {
+        for( unsigned int m = n + 1; m < N; m++ )
+        {
+            z += TMath::Abs( v_weight[n] ) * TMath::Abs( v_weight[m] );
+        }
+        d_w_sum += TMath::Abs( v_weight[n] );
+    }
+    if( !( d_w_sum > 0. && z > 0. ) )
+    {
+        return i_sign;
+    }
+
+    // disp directions for both signs
+    fSignSearch_px.assign( 2 * N, 0. );
+    fSignSearch_py.assign( 2 * N, 0. );
+    fSignSearch_xs.assign( N, 0. );
+    fSignSearch_ys.assign( N, 0. );
+    for( unsigned int i = 0; i < N; i++ )
+    {
+        for( unsigned int a = 0; a < 2; a++ )
+        {
+            float i_s = ( a == 0 ? 1. : -1. );
+            fSignSearch_px[2 * i + a] = x[i] - i_s * v_disp[i] * cosphi[i];
+            fSignSearch_py[2 * i + a] = y[i] - i_s * v_disp[i] * sinphi[i];
+        }
+    }
+    // weighted distances between all pairs of disp directions
+    fSignSearch_pairCost.assign( 4 * N * N, 0. );
+    fSignSearch_weightSum = 0.;
+    for( unsigned int n = 0; n < N; n++ )
+    {
+        for( unsigned int m = n + 1; m < N; m++ )
+        {
+            double w = TMath::Abs( v_weight[n] ) * TMath::Abs( v_weight[m] );
+            fSignSearch_weightSum += w;
+            for( unsigned int a = 0; a < 2; a++ )
+            {
+                for( unsigned int b = 0; b < 2; b++ )
+                {
+                    double dx = fSignSearch_px[2 * n + a] - fSignSearch_px[2 * m + b];
+                    double dy = fSignSearch_py[2 * n + a] - fSignSearch_py[2 * m + b];
+                    double d = sqrt( dx * dx + dy * dy ) * w;
+                    fSignSearch_pairCost[(( n * N + m ) * 2 + a ) * 2 + b] = d;
+                    fSignSearch_pairCost[(( m * N + n ) * 2 + b ) * 2 + a] = d;
+                }
+            }
+        }
+    }
+
+    // search order: images with large weights first
+    fSignSearch_order.resize( N );
+    for( unsigned int i = 0; i < N; i++ )
     {
-        if( v_disp_diff[s] < i_smallest_dist )
+        fSignSearch_order[i] = i;
+    }
+    for( unsigned int i = 1; i < N; i++ )
+    {
+        for( unsigned int j = i; j > 0
+                && TMath::Abs( v_weight[fSignSearch_order[j]] ) > TMath::Abs( v_weight[fSignSearch_order[j - 1]] ); j-- )
         {
-            i_mean_element = s;
-            i_smallest_dist = v_disp_diff[s];
+            swap( fSignSearch_order[j], fSignSearch_order[j - 1] );
         }
     }
-    return i_mean_element;
+    // lower bound for the distances between pairs of images at depth >= k
+    fSignSearch_minPairCost.assign( N + 1, 0. );
+    for( unsigned int k = N; k > 0; k-- )
+    {
+        unsigned int n = fSignSearch_order[k - 1];
+        fSignSearch_minPairCost[k - 1] = fSignSearch_minPairCost[k];
+        for( unsigned int l = k; l < N; l++ )
+        {
+            const double* c = &fSignSearch_pairCost[( n * N + fSignSearch_order[l] ) * 4];
+            fSignSearch_minPairCost[k - 1] += TMath::Min( TMath::Min( c[0], c[1] ), TMath::Min( c[2], c[3] ) );
+        }
+    }
+
+    // starting value: greedy assignment
+    fSignSearch_sign.assign( N, 0 );
+    fSignSearch_partialCost.assign( 2 * N, 0. );
+    for( unsigned int k = 0; k < N; k++ )
+    {
+        unsigned int n = fSignSearch_order[k];
+        int a = ( fSignSearch_partialCost[2 * n + 1] < fSignSearch_partialCost[2 * n] ? 1 : 0 );
+        fSignSearch_sign[n] = a;
+        for( unsigned int m = 0; m < N; m++ )
+        {
+            if( m != n )
+            {
+                fSignSearch_partialCost[2 * m]     += fSignSearch_pairCost[(( n * N + m ) * 2 + a ) * 2];
+                fSignSearch_partialCost[2 * m + 1] += fSignSearch_pairCost[(( n * N + m ) * 2 + a ) * 2 + 1];
+            }
+        }
+    }
+    // improve starting value by flipping single signs
+    // (fSignSearch_partialCost contains distances to all other images)
+    for( unsigned int i_sweep = 0; i_sweep < N; i_sweep++ )
+    {
+        bool bImproved = false;
+        for( unsigned int n = 0; n < N; n++ )
+        {
+            int a = fSignSearch_sign[n];
+            if( fSignSearch_partialCost[2 * n + 1 - a] < fSignSearch_partialCost[2 * n + a] * ( 1. - 1.e-9 ) )
+            {
+                fSignSearch_sign[n] = 1 - a;
+                for( unsigned int m = 0; m < N; m++ )
+                {
+                    if( m != n )
+                    {
+                        for( unsigned int b = 0; b < 2; b++ )
+                        {
+                            fSignSearch_partialCost[2 * m + b] += fSignSearch_pairCost[(( n * N + m ) * 2 + 1 - a ) * 2 + b]
+                                                                - fSignSearch_pairCost[(( n * N + m ) * 2 + a ) * 2 + b];
+                        }
+                    }
+                }
+                bImproved = true;
+            }
+        }
+        if( !bImproved )
+        {
+            break;
+        }
+    }
+    fSignSearch_bestSign.clear();
+    testSignCombination( v_weight );
+
+    // branch-and-bound search
+    fSignSearch_sign.assign( N, 0 );
+    fSignSearch_partialCost.assign( 2 * N, 0. );
+    fSignSearch_nNodes = 0;
+    fSignSearch_nNodes_max = 512 + 16 * N * N;
+    searchSigns( 0, 0., v_weight );
+
+    for( unsigned int i = 0; i < N; i++ )
+    {
+        i_sign[i] = ( fSignSearch_bestSign[i] == 0 ? 1. : -1. );
+    }
+    return i_sign;
 }
 
 
@@ -232,9 +446,9 @@ unsigned int VDispAnalyzer::find_smallest_diff_element(
  *
  */
 void VDispAnalyzer::calculateMeanDirection( float& xs, float& ys,
-        vector< float > x, vector< float > y,
-        vector< float > cosphi, vector< float > sinphi,
-        vector< float > v_disp, vector< float > v_weight,
+        const vector< float >& x, const vector< float >& y,
+        const vector< float >& cosphi, const vector< float >& sinphi,
+        vector< float > v_disp, const vector< float >& v_weight,
         float& dispdiff,
         float x_off4, float y_off4 )
 {
@@ -326,8 +540,7 @@ void VDispAnalyzer::calculateMeanDirection( float& xs, float& ys,
     fdisp_xs_T.assign( v_weight.size(), 0. );
     fdisp_ys_T.assign( v_weight.size(), 0. );
 
-    unsigned int i_smallest_diff_element = 0;
-    if( x.size() > 5 )
+    if( x.size() > fHeadTailSearch_NImages_max )
     {
         fUseIntersectForHeadTail = true;
     // (MVA disp analyzer using stereo reconstruction as starting value)
@@ -372,15 +585,12 @@ void VDispAnalyzer::calculateMeanDirection( float& xs, float& ys,
         fUseIntersectForHeadTail = false;
         // search for combination of images with smallest differences
         // in reconstructed images
-        vector< vector< float > > i_sign = get_sign_permutation_vector( x.size() );
-        i_smallest_diff_element = find_smallest_diff_element(
-                                      i_sign, x, y, cosphi, sinphi,
-                                      v_disp, v_weight );
+        vector< float > i_sign = find_smallest_diff_signs( x, y, cosphi, sinphi, v_disp, v_weight );
 
         for( unsigned int ii = 0; ii < x.size(); ii++ )
         {
-            fdisp_xs_T[ii] = x[ii] - i_sign[i_smallest_diff_element][ii] * v_disp[ii] * cosphi[ii];
-            fdisp_ys_T[ii] = y[ii] - i_sign[i_smallest_diff_element][ii] * v_disp[ii] * sinphi[ii];
+            fdisp_xs_T[ii] = x[ii] - i_sign[ii] * v_disp[ii] * cosphi[ii];
+            fdisp_ys_T[ii] = y[ii] - i_sign[ii] * v_disp[ii] * sinphi[ii];
         }
     }
     calculateMeanShowerDirection( fdisp_xs_T, fdisp_ys_T, v_weight, xs, ys, dispdiff, fdisp_xs_T.size() );
@@ -401,7 +611,8 @@ void VDispAnalyzer::calculateMeanDirection( float& xs, float& ys,
  *
 */
 void VDispAnalyzer::calculateMeanShowerDirection(
-        vector< float > v_x, vector< float > v_y, vector< float > v_weight,
+        const vector< float >& v_x, const vector< float >& v_y,
+        const vector< float >& v_weight,
         float& xs, float& ys, float& dispdiff,
         unsigned int iMaxN )
 {
@@ -454,6 +665,74 @@ void VDispAnalyzer::calculateMeanShowerDirection(
     }
 }
 
+/*
+ * calculate disp (or disp error/sign) for all images passing the quality cuts
+ *
+ * TMVA disp analyzers evaluate all images of the event in one call
+ *
+ * i_disp:     disp per telescope
+ * i_quality:  image passed quality cuts
+ *
+ */
+void VDispAnalyzer::evaluateImages( unsigned int i_ntel, float iArrayElevation, float iArrayAzimuth,
+                                    ULong64_t* iTelType,
+                                    double* img_size, double* img_cen_x, double* img_cen_y,
+                                    double* img_width, double* img_length, double* img_asym,
+                                    double* img_tgrad, double* img_loss, int* img_ntubes,
+                                    double xoff_4, double yoff_4, double* img_fui,
+                                    vector< float >& i_disp, vector< bool >& i_quality )
+{
+    i_disp.assign( i_ntel, -99. );
+    i_quality.assign( i_ntel, false );
+    for( unsigned int i = 0; i < i_ntel; i++ )
+    {
+        // quality cuts
+        if( img_size[i] > 0. && img_length[i] > 0.
+                && sqrt( img_cen_x[i]*img_cen_x[i] + img_cen_y[i]*img_cen_y[i] ) < fdistance_max
+                && img_loss[i] < floss_max
+                && img_fui[i] > fFui_min
+                && ( fdistanceQC_max == 0 || sqrt( img_cen_x[i]*img_cen_x[i] + img_cen_y[i]*img_cen_y[i] ) < fdistanceQC_max[i] )
+                && xoff_4 > -999. && yoff_4 > -999. )
+        {
+            i_quality[i] = true;
+            if( fTMVADispAnalyzer )
+            {
+                fTMVADispAnalyzer->addImage( ( float )img_width[i], ( float )img_length[i], ( float )img_size[i],
+                                             ( float )img_asym[i], ( float )img_loss[i], ( float )img_tgrad[i],
+                                             ( float )img_cen_x[i], ( float )img_cen_y[i],
+                                             ( float )xoff_4, ( float )yoff_4, iTelType[i],
+                                             ( float )( 90. - iArrayElevation ), ( float )iArrayAzimuth,
+                                             -99., -1.,
+                                             ( float )sqrt( img_cen_x[i] * img_cen_x[i] + img_cen_y[i] * img_cen_y[i] ),
+                                             ( float )img_fui[i], ( float )img_ntubes[i] );
+            }
+            else
+            {
+                i_disp[i] = evaluate( ( float )img_width[i], ( float )img_length[i], ( float )img_asym[i],
+                                      ( float )sqrt( img_cen_x[i] * img_cen_x[i] + img_cen_y[i] * img_cen_y[i] ),
+                                      ( float )img_size[i], 1., ( float )img_tgrad[i], ( float )img_loss[i],
+                                      ( float )img_cen_x[i], ( float )img_cen_y[i],
+                                      ( float )xoff_4, ( float )yoff_4, iTelType[i],
+                                      ( float )( 90. - iArrayElevation ), ( float )iArrayAzimuth,
+                                      -99., ( float )img_fui[i], ( float )img_ntubes[i] );
+            }
+        }
+    }
+    if( fTMVADispAnalyzer )
+    {
+        const vector< float >& i_result = fTMVADispAnalyzer->evaluateImages();
+        unsigned int n = 0;
+        for( unsigned int i = 0; i < i_ntel && n < i_result.size(); i++ )
+        {
+            if( i_quality[i] )
+            {
+                i_disp[i] = i_result[n++];
+                f_disp = i_disp[i];
+            }
+        }
+    }
+}
+
 /*
  * calculate mean disp direction using as input C arrays
  * (used primarily from lookup table code)
@@ -510,24 +789,21 @@ void VDispAnalyzer::calculateMeanDirection( unsigned int i_ntel,
     vector< float > sinphi;
 
     //////////////////////////////
-    // loop over all telescopes and calculate disp per telescope
+    // calculate disp per telescope
+    vector< float > i_disp;
+    vector< bool > i_quality;
+    evaluateImages( i_ntel, iArrayElevation, iArrayAzimuth, iTelType,
+                    img_size, img_cen_x, img_cen_y,
+                    img_width, img_length, img_asym,
+                    img_tgrad, img_loss, img_ntubes,
+                    xoff_4, yoff_4, img_fui,
+                    i_disp, i_quality );
+
     for( unsigned int i = 0; i < i_ntel; i++ )
     {
-        // quality cuts
-        if( img_size[i] > 0. && img_length[i] > 0.
-                && sqrt( img_cen_x[i]*img_cen_x[i] + img_cen_y[i]*img_cen_y[i] ) < fdistance_max
-                && img_loss[i] < floss_max
-                && img_fui[i] > fFui_min
-                && ( fdistanceQC_max == 0 || sqrt( img_cen_x[i]*img_cen_x[i] + img_cen_y[i]*img_cen_y[i] ) < fdistanceQC_max[i] )
-                && xoff_4 > -999. && yoff_4 > -999. )
+        if( i_quality[i] )
         {
-            disp = evaluate( ( float )img_width[i], ( float )img_length[i], ( float )img_asym[i],
-                             ( float )sqrt( img_cen_x[i] * img_cen_x[i] + img_cen_y[i] * img_cen_y[i] ),
-                             ( float )img_size[i], 1., ( float )img_tgrad[i], ( float )img_loss[i],
-                             ( float )img_cen_x[i], ( float )img_cen_y[i],
-                             ( float )xoff_4, ( float )yoff_4, iTelType[i],
-                             ( float )( 90. - iArrayElevation ), ( float )iArrayAzimuth,
-                             -99., ( float )img_fui[i], ( float )img_ntubes[i] );
+            disp = i_disp[i];
             if( disp < -98. )
             {
                 continue;
@@ -643,25 +919,21 @@ vector< float > VDispAnalyzer::calculateExpectedDirectionError_or_Sign( unsigned
     fdisp_error_T.assign( i_ntel, -99. );
 
     //////////////////////////////
-    // loop over all telescopes and calculate disp per telescope
+    // calculate disp error (or sign) per telescope
+    vector< float > i_error;
+    vector< bool > i_quality;
+    evaluateImages( i_ntel, iArrayElevation, iArrayAzimuth, iTelType,
+                    img_size, img_cen_x, img_cen_y,
+                    img_width, img_length, img_asym,
+                    img_tgrad, img_loss, img_ntubes,
+                    xoff_4, yoff_4, img_fui,
+                    i_error, i_quality );
+
     for( unsigned int i = 0; i < i_ntel; i++ )
     {
-
-        // quality cuts
-        if( img_size[i] > 0. && img_length[i] > 0.
-                && sqrt( img_cen_x[i]*img_cen_x[i] + img_cen_y[i]*img_cen_y[i] ) < fdistance_max
-                && img_loss[i] < floss_max
-                && img_fui[i] > fFui_min
-                && ( fdistanceQC_max == 0 || sqrt( img_cen_x[i]*img_cen_x[i] + img_cen_y[i]*img_cen_y[i] ) < fdistanceQC_max[i] )
-                && xoff_4 > -999. && yoff_4 > -999. )
+        if( i_quality[i] )
         {
-            fdisp_error_T[i] = evaluate( ( float )img_width[i], ( float )img_length[i], ( float )img_asym[i],
-                                         ( float )sqrt( img_cen_x[i] * img_cen_x[i] + img_cen_y[i] * img_cen_y[i] ),
-                                         ( float )img_size[i], 1., ( float )img_tgrad[i], ( float )img_loss[i],
-                                         ( float )img_cen_x[i], ( float )img_cen_y[i],
-                                         ( float )xoff_4, ( float )yoff_4, iTelType[i],
-                                         ( float )( 90. - iArrayElevation ), ( float )iArrayAzimuth,
-                                         -99., ( float )img_fui[i], ( float )img_ntubes[i] );
+            fdisp_error_T[i] = i_error[i];
             i_disp[i] = fdisp_error_T[i];
         }
     }
@@ -1311,6 +1311,18 @@ void VEffectiveAreaCalculator::reset()
     gMeanEffectiveAreaMC = 0;
     hMeanResponseMatrix = 0;
     
+    // cell widths for caching of interpolated effective areas
+    // (default: no caching, interpolation for each event; see setEffectiveAreaCache())
+    fEffAreaCache_dZe = 0.;
+    fEffAreaCache_dWoff = 0.;
+    fEffAreaCache_dPedVar = 0.;
+    fEffAreaCache_Index = 0.;
+    fEffAreaCache_LastKey = 0;
+    fEffAreaCache_LastCell = 0;
+    fEffAreaCache_Event.fNEvents_ResponseMatrix = 0;
+    fEffAreaCache_Event.bValid = true;
+    fResponseMatrixEventWeighted = false;
+    
     fMC_ScatterArea = 0.;
     
     bNOFILE = true;
@@ -2185,12 +2197,231 @@ vector< unsigned int > VEffectiveAreaCalculator::getUpperLowBins( vector< double
  *
  *  return effective area value for given ze, woff, iPedVar, ...
  *
+ *  effective areas vs energy are interpolated for each event, or once per cell in
+ *  ze, woff and pedvar if caching is switched on (see getEffectiveAreaCell())
  *
  */
 double VEffectiveAreaCalculator::getEffectiveAreasFromHistograms(
     double erec, double ze, double woff,
     double iPedVar, double iSpectralIndex,
     bool bAddtoMeanEffectiveArea )
+{
+    // log10 of energy
+    if( erec <= 0. )
+    {
+        return 0.;
+    }
+    float lerec = log10( erec );
+    
+    // calculate mean values of
+    // phase space parameters
+    fEffectiveAreas_meanZe     += ze;
+    fEffectiveAreas_meanWoff   += woff;
+    fEffectiveAreas_meanPedVar += iPedVar;
+    fEffectiveAreas_meanIndex   = iSpectralIndex;
+    fEffectiveAreas_meanN++;
+    
+    // interpolated effective areas
+    sEffectiveAreaCell* iCell = getEffectiveAreaCell( ze, woff, iPedVar, iSpectralIndex );
+    if( !iCell )
+    {
+        return -1.;
+    }
+    if( fEff_E0.size() == 0 )
+    {
+        return -1.;
+    }
+    const vector< float >& i_eff_temp = iCell->fEff;
+    
+    // mean effective area calculation
+    if( bAddtoMeanEffectiveArea && fVTimeBinnedMeanEffectiveArea.size() == i_eff_temp.size() )
+    {
+        for( unsigned int i = 0; i < i_eff_temp.size(); i++ )
+        {
+            fVTimeBinnedMeanEffectiveArea[i] += i_eff_temp[i];
+        }
+        fNTimeBinnedMeanEffectiveArea++;
+    }
+    
+    if( bLikelihoodAnalysis && bIsOn )
+    {
+        // Adding to mean effective area (MC)
+        if( bAddtoMeanEffectiveArea && fVTimeBinnedMeanEffectiveAreaMC.size() == iCell->fEffMC.size() )
+        {
+            for( unsigned int i = 0; i < fEff_E0.size() ; i++ )
+            {
+                if( iCell->fEffMC[i] > 1.e-9 )
+                {
+                    fVTimeBinnedMeanEffectiveAreaMC[i] += iCell->fEffMC[i];
+                }
+            }
+            fNTimeBinnedMeanEffectiveAreaMC++;
+        }
+        // response matrix of this event
+        // (calculated once per cached cell; for each event without caching)
+        if( iCell == &fEffAreaCache_Event || iCell->fResponseMatrix.size() == 0 )
+        {
+            fillResponseMatrix( iCell->fE_MC_Res, iCell->fE_Rec_Res, iCell->fE_Rec_Res_Err, iCell->fResponseMatrix );
+        }
+        // adding to mean response matrix
+        // (default: added and normalized for each event;
+        //  event-weighted: one response matrix per cached cell, added in fillMeanResponseMatrix())
+        if( iCell == &fEffAreaCache_Event || !fResponseMatrixEventWeighted )
+        {
+            addToMeanResponseMatrix( iCell->fE_MC_Res, iCell->fResponseMatrix );
+        }
+        else
+        {
+            iCell->fNEvents_ResponseMatrix++;
+        }
+    }
+    /////////////////////////////////////////
+    // effective area for a specific energy
+    // (as requested by VStereoAnalysis)
+    /////////////////////////////////////////
+    float i_eff_e = 1.;
+    unsigned int ie0_low = 0;
+    unsigned int ie0_up = 0;
+    
+    if( lerec <= fEff_E0[0] )
+    {
+        ie0_low = ie0_up = 0;
+    }
+    else if( lerec > fEff_E0[fEff_E0.size() - 1] )
+    {
+        ie0_low = ie0_up = fEff_E0.size() - 1;
+    }
+    else
+    {
+        // last bin j in [1, size-2] with lerec > fEff_E0[j]
+        unsigned int j = lower_bound( fEff_E0.begin() + 1, fEff_E0.end() - 1, lerec ) - fEff_E0.begin();
+        if( j > 1 )
+        {
+            ie0_low = j - 1;
+            ie0_up = j;
+        }
+    }
+    
+    ///////////////////////////////////
+    // final result on effective area:
+    // linear interpolate between two
+    // adjacent energy bins
+    ///////////////////////////////////
+    i_eff_e = VStatistics::interpolate( i_eff_temp[ie0_low], fEff_E0[ie0_low],
+                                        i_eff_temp[ie0_up], fEff_E0[ie0_up],
+                                        lerec, false );
+                                        
+    if( i_eff_e > 0. )
+    {
+        return 1. / i_eff_e;
+    }
+    
+    return -1.;
+}
+
+/*
+ * return interpolated effective areas for the cell in ze, woff and pedvar
+ * containing the given values
+ *
+ * Effective areas of a cell are interpolated once (at the cell centre)
+ * and are kept for all following events in this cell.
+ * No caching for cell widths <= 0 (interpolation for each event).
+ *
+ * returns 0 if interpolation failed
+ */
+VEffectiveAreaCalculator::sEffectiveAreaCell* VEffectiveAreaCalculator::getEffectiveAreaCell(
+    double ze, double woff, double iPedVar, double iSpectralIndex )
+{
+    // no caching
+    if( fEffAreaCache_dZe <= 0. || fEffAreaCache_dWoff <= 0. || fEffAreaCache_dPedVar <= 0. )
+    {
+        if( !interpolateEffectiveAreas( ze, woff, iPedVar, iSpectralIndex, fEffAreaCache_Event ) )
+        {
+            return 0;
+        }
+        return &fEffAreaCache_Event;
+    }
+    // cached cells are valid for one spectral index only
+    if( fEffAreaCache.size() > 0 && fabs( iSpectralIndex - fEffAreaCache_Index ) > 1.e-6 )
+    {
+        fillMeanResponseMatrix();
+        fEffAreaCache.clear();
+        fEffAreaCache_Map.clear();
+    }
+    
+    // cell indexes
+    Long64_t i_ze   = ( Long64_t )floor( ze / fEffAreaCache_dZe );
+    Long64_t i_woff = ( Long64_t )floor( woff / fEffAreaCache_dWoff );
+    Long64_t i_ped  = ( Long64_t )floor( iPedVar / fEffAreaCache_dPedVar );
+    ULong64_t iKey  = ( ( ULong64_t )( i_ze + 1048576 ) & 0x1FFFFF ) << 42;
+    iKey |= ( ( ULong64_t )( i_woff + 1048576 ) & 0x1FFFFF ) << 21;
+    iKey |= ( ( ULong64_t )( i_ped + 1048576 ) & 0x1FFFFF );
+    
+    // same cell as for previous event
+    if( fEffAreaCache.size() > 0 && iKey == fEffAreaCache_LastKey )
+    {
+        return ( fEffAreaCache[fEffAreaCache_LastCell].bValid ? &fEffAreaCache[fEffAreaCache_LastCell] : 0 );
+    }
+    
+    map< ULong64_t, unsigned int >::iterator iC = fEffAreaCache_Map.find( iKey );
+    if( iC == fEffAreaCache_Map.end() )
+    {
+        fEffAreaCache.push_back( sEffectiveAreaCell() );
+        fEffAreaCache.back().fNEvents_ResponseMatrix = 0;
+        fEffAreaCache.back().bValid = interpolateEffectiveAreas( ( i_ze + 0.5 ) * fEffAreaCache_dZe,
+                                      ( i_woff + 0.5 ) * fEffAreaCache_dWoff,
+                                      ( i_ped + 0.5 ) * fEffAreaCache_dPedVar,
+                                      iSpectralIndex, fEffAreaCache.back() );
+        fEffAreaCache_Index = iSpectralIndex;
+        iC = fEffAreaCache_Map.insert( make_pair( iKey, ( unsigned int )fEffAreaCache.size() - 1 ) ).first;
+    }
+    fEffAreaCache_LastKey = iKey;
+    fEffAreaCache_LastCell = iC->second;
+    
+    return ( fEffAreaCache[iC->second].bValid ? &fEffAreaCache[iC->second] : 0 );
+}
+
+/*
+ * add response matrices of all cached cells to the mean response matrix
+ * (weighted by the number of events in each cell; event-weighted
+ *  response matrix only, see setResponseMatrixEventWeighting())
+ *
+ */
+void VEffectiveAreaCalculator::fillMeanResponseMatrix()
+{
+    for( unsigned int i = 0; i < fEffAreaCache.size(); i++ )
+    {
+        if( fEffAreaCache[i].bValid && fEffAreaCache[i].fNEvents_ResponseMatrix > 0 )
+        {
+            addToMeanResponseMatrix( fEffAreaCache[i].fE_MC_Res, fEffAreaCache[i].fResponseMatrix,
+                                     ( double )fEffAreaCache[i].fNEvents_ResponseMatrix, false );
+            fEffAreaCache[i].fNEvents_ResponseMatrix = 0;
+        }
+    }
+}
+
+/*
+ * return mean response matrix (normalized in each y-row)
+ *
+ */
+TH2D* VEffectiveAreaCalculator::getMeanResponseMatrix()
+{
+    fillMeanResponseMatrix();
+    if( !hMeanResponseMatrix )
+    {
+        return 0;
+    }
+    VHistogramUtilities::normalizeTH2D_y( hMeanResponseMatrix );
+    return ( TH2D* )hMeanResponseMatrix->Clone();
+}
+
+/*
+ * step-by-step interpolation of effective areas (and response matrix
+ * values for likelihood analysis) in ze, woff, pedvar and spectral index
+ *
+ */
+bool VEffectiveAreaCalculator::interpolateEffectiveAreas( double ze, double woff, double iPedVar, double iSpectralIndex,
+        sEffectiveAreaCell& iCell )
 {
     vector< float > i_eff_temp( fEff_E0.size(), 0. );
     vector< float > i_eff_MC_temp;
@@ -2207,20 +2438,6 @@ double VEffectiveAreaCalculator::getEffectiveAreasFromHistograms(
     vector< vector < float > > i_ze_e_MC_Res_temp;
     vector< vector < float > > i_ze_e_Rec_Res_temp;
     vector< vector < float > > i_ze_e_Rec_Res_Err_temp;
-    // log10 of energy
-    if( erec <= 0. )
-    {
-        return 0.;
-    }
-    float lerec = log10( erec );
-    
-    // calculate mean values of
-    // phase space parameters
-    fEffectiveAreas_meanZe     += ze;
-    fEffectiveAreas_meanWoff   += woff;
-    fEffectiveAreas_meanPedVar += iPedVar;
-    fEffectiveAreas_meanIndex   = iSpectralIndex;
-    fEffectiveAreas_meanN++;
     
     ////////////////////////////////////////////////////////
     // get upper and lower zenith angle bins
@@ -2391,7 +2608,7 @@ double VEffectiveAreaCalculator::getEffectiveAreasFromHistograms(
                                 cout << " " << i_noise_bins[n] <<  fEff_SpectralIndex[i_ze_bins[i]][i_woff_bins[w]].size();
                             }
                             cout << endl;
-                            return -1.;
+                            return false;
                         }
                         ////////////////////////////////////////////////////////
                     }
@@ -2438,7 +2655,7 @@ double VEffectiveAreaCalculator::getEffectiveAreasFromHistograms(
                         cout << " " << i_woff_bins[w] << " " << fEff_Noise[i_ze_bins[i]].size() << endl;
                     }
                     cout << endl;
-                    return -1.;
+                    return false;
                 }
             }
             i_ze_eff_temp[i] = interpolate_effectiveArea( woff,
@@ -2479,7 +2696,7 @@ double VEffectiveAreaCalculator::getEffectiveAreasFromHistograms(
         {
             cout << "VEffectiveAreaCalculator::getEffectiveAreasFromHistograms error: woff index out of range: ";
             cout << i_ze_bins[i] << " " << fEff_WobbleOffsets.size() << endl;
-            return -1.;
+            return false;
         }
     }
     i_eff_temp = interpolate_effectiveArea( ze, fZe[i_ze_bins[0]], fZe[i_ze_bins[1]], i_ze_eff_temp[0], i_ze_eff_temp[1], true );
@@ -2498,81 +2715,17 @@ double VEffectiveAreaCalculator::getEffectiveAreasFromHistograms(
                                i_ze_e_Rec_Res_Err_temp[0], i_ze_e_Rec_Res_Err_temp[1], true );
                                
     }
-    if( fEff_E0.size() == 0 )
-    {
-        return -1.;
-    }
-    
-    // mean effective area calculation
-    if( bAddtoMeanEffectiveArea && fVTimeBinnedMeanEffectiveArea.size() == i_eff_temp.size() )
-    {
-        for( unsigned int i = 0; i < i_eff_temp.size(); i++ )
-        {
-            fVTimeBinnedMeanEffectiveArea[i] += i_eff_temp[i];
-        }
-        fNTimeBinnedMeanEffectiveArea++;
-    }
     
+    iCell.fEff = i_eff_temp;
     if( bLikelihoodAnalysis && bIsOn )
     {
-        // Adding to mean effective area (MC)
-        if( bAddtoMeanEffectiveArea && fVTimeBinnedMeanEffectiveAreaMC.size() == i_eff_MC_temp.size() )
-        {
-            for( unsigned int i = 0; i < fEff_E0.size() ; i++ )
-            {
-                if( i_eff_MC_temp[i] > 1.e-9 )
-                {
-                    fVTimeBinnedMeanEffectiveAreaMC[i] += i_eff_MC_temp[i];
-                }
-            }
-            fNTimeBinnedMeanEffectiveAreaMC++;
-        }
-        // adding to mean response matrix
-        addMeanResponseMatrix( i_e_MC_Res_temp, i_e_Rec_Res_temp, i_e_Rec_Res_Err_temp );
-    }
-    /////////////////////////////////////////
-    // effective area for a specific energy
-    // (as requested by VStereoAnalysis)
-    /////////////////////////////////////////
-    float i_eff_e = 1.;
-    unsigned int ie0_low = 0;
-    unsigned int ie0_up = 0;
-    
-    if( lerec <= fEff_E0[0] )
-    {
-        ie0_low = ie0_up = 0;
-    }
-    else if( lerec > fEff_E0[fEff_E0.size() - 1] )
-    {
-        ie0_low = ie0_up = fEff_E0.size() - 1;
-    }
-    else
-    {
-        for( unsigned int j = 1; j < fEff_E0.size() - 1; j++ )
-        {
-            if( lerec > fEff_E0[j] )
-            {
-                ie0_low = j;
-                ie0_up = j + 1;
-            }
-        }
-    }
-    
-    ///////////////////////////////////
-    // final result on effective area:
-    // linear interpolate between two
-    // adjacent energy bins
-    ///////////////////////////////////
-    i_eff_e = VStatistics::interpolate( i_eff_temp[ie0_low], fEff_E0[ie0_low],
-                                        i_eff_temp[ie0_up], fEff_E0[ie0_up],
-                                        lerec, false );
-                                        
-    if( i_eff_e > 0. )
-    {
-        return 1. / i_eff_e;
+        iCell.fEffMC = i_eff_MC_temp;
+        iCell.fE_MC_Res = i_e_MC_Res_temp;
+        iCell.fE_Rec_Res = i_e_Rec_Res_temp;
+        iCell.fE_Rec_Res_Err = i_e_Rec_Res_Err_temp;
     }
     
-    return -1.;
+    return true;
 }
 
 // reset the sum of effective areas
@@ -3634,90 +3787,137 @@ void VEffectiveAreaCalculator::fillDL2EventDataTree( CData* c, UChar_t iCutClass
 }
 
 
-void VEffectiveAreaCalculator::addMeanResponseMatrix( vector <float> i_emc, vector <float> i_erec , vector <float> i_erec_err )
+/*
+ * add response matrix (Gaussian approximation) with weight iWeight to mean response matrix
+ *
+ * iNormalize = false: no normalization of mean response matrix
+ * (done in getMeanResponseMatrix())
+ */
+void VEffectiveAreaCalculator::addMeanResponseMatrix( vector <float> i_emc, vector <float> i_erec , vector <float> i_erec_err,
+        double iWeight, bool iNormalize )
 {
+    vector< float > i_responseMatrix;
+    fillResponseMatrix( i_emc, i_erec, i_erec_err, i_responseMatrix );
+    addToMeanResponseMatrix( i_emc, i_responseMatrix, iWeight, iNormalize );
+}
 
-    // Getting binning
-    float i_binw = i_emc[1] - i_emc[0] ;
-    float* i_bins = new float[i_emc.size() + 1];
-    vector <float> i_binc( i_emc.size(), 0 );
+/*
+ * response matrix (Gaussian approximation), normalized in each row of MC energy
+ *
+ * iResponseMatrix[i * N + k]: MC energy bin i, reconstructed energy bin k
+ * (N = i_emc.size(); values in single precision, as for the TH2F used before)
+ *
+ */
+bool VEffectiveAreaCalculator::fillResponseMatrix( const vector< float >& i_emc, const vector< float >& i_erec,
+        const vector< float >& i_erec_err, vector< float >& iResponseMatrix )
+{
+    unsigned int i_nbins = i_emc.size();
+    iResponseMatrix.assign( i_nbins * i_nbins, 0. );
+    if( i_nbins < 2 || i_erec.size() < i_nbins || i_erec_err.size() < i_nbins )
+    {
+        return false;
+    }
     
+    // binning (bin centres as in TAxis::GetBinCenter() for variable bins)
+    float i_binw = i_emc[1] - i_emc[0] ;
+    vector< float > i_bins( i_nbins + 1, 0. );
     i_bins[0] = i_emc[0] - i_binw / 2.;
-    
-    for( unsigned int i = 0; i < i_emc.size() ; i++ )
+    for( unsigned int i = 0; i < i_nbins; i++ )
     {
-        i_binc[i] = i_emc[i];
         i_bins[i + 1] = i_bins[i] + i_binw;
     }
-    
-    // cout << i_emc.size() << " bins: " << i_emc[0] << " - " << i_emc[i_emc.size() -1] << endl;
-    int i_nbins = i_binc.size();
-    
-    TH2F* i_hist = new TH2F( "i_tmp", "i_tmp", i_nbins , i_bins, i_nbins, i_bins );
-    TF1* i_gaussian = new TF1( "i_gaussian", "gaus", -2, 2.5 );
-    
-    // Filling Histograms
-    for( int  i = 0; i < i_hist->GetYaxis()->GetNbins(); i++ )
+    vector< double > i_binc( i_nbins, 0. );
+    for( unsigned int i = 0; i < i_nbins; i++ )
     {
+        i_binc[i] = ( double )i_bins[i] + 0.5 * ( ( double )i_bins[i + 1] - ( double )i_bins[i] );
+    }
     
-        for( unsigned int j = 0; j < i_emc.size(); j++ )
+    // Gaussian distribution of reconstructed energies in each row of MC energy
+    vector< double > i_gaus( i_nbins, 0. );
+    for( unsigned int i = 0; i < i_nbins; i++ )
+    {
+        for( unsigned int j = 0; j < i_nbins; j++ )
         {
-            // Assuming a gaussian shape
-            i_gaussian->SetParameter( 0, 1 );
-            i_gaussian->SetParameter( 1, i_erec[j] );
-            i_gaussian->SetParameter( 2, i_erec_err[j] );
-            
-            // Filling bins
-            if( fabs( i_hist->GetYaxis()->GetBinCenter( i + 1 ) -  i_emc[j] ) < 1.e-4 && fabs( i_emc[j] ) > 1.e-9 )
+            if( fabs( i_binc[i] -  i_emc[j] ) < 1.e-4 && fabs( i_emc[j] ) > 1.e-9 )
             {
                 double j_tot = 0;
-                
-                for( int  k = 0; k < i_hist->GetXaxis()->GetNbins(); k++ )
+                for( unsigned int k = 0; k < i_nbins; k++ )
                 {
-                    j_tot += i_gaussian->Eval( i_hist->GetXaxis()->GetBinCenter( k + 1 ) );
-                    i_hist->SetBinContent( k + 1, i + 1,  i_gaussian->Eval( i_hist->GetXaxis()->GetBinCenter( k + 1 ) ) );
-                    
+                    double i_arg = ( i_binc[k] - ( double )i_erec[j] ) / ( double )i_erec_err[j];
+                    i_gaus[k] = exp( -0.5 * i_arg * i_arg );
+                    j_tot += i_gaus[k];
+                    iResponseMatrix[i * i_nbins + k] = ( float )i_gaus[k];
                 }
-                for( int  k = 0; k < i_hist->GetXaxis()->GetNbins(); k++ )
+                for( unsigned int k = 0; k < i_nbins; k++ )
                 {
-                    double i_entry = i_hist->GetBinContent( k + 1, i + 1 );
-                    // j_tot += i_gaussian->Eval( i_hist->GetXaxis()->GetBinCenter(k+1) );
-                    i_hist->SetBinContent( k + 1, i + 1,  i_entry / j_tot );
-                    
+                    iResponseMatrix[i * i_nbins + k] = ( float )( ( double )iResponseMatrix[i * i_nbins + k] / j_tot );
                 }
             }
         }
-        
-        
-        
+        // normalization (as VHistogramUtilities::normalizeTH2D_y())
+        double i_sum = 0.;
+        for( unsigned int k = 0; k < i_nbins; k++ )
+        {
+            i_sum += iResponseMatrix[i * i_nbins + k];
+        }
+        if( i_sum > 0. )
+        {
+            for( unsigned int k = 0; k < i_nbins; k++ )
+            {
+                iResponseMatrix[i * i_nbins + k] = ( float )( ( double )iResponseMatrix[i * i_nbins + k] / i_sum );
+            }
+        }
+    }
+    return true;
+}
+
+/*
+ * add response matrix (see fillResponseMatrix()) with weight iWeight to mean response matrix
+ *
+ * iNormalize = false: no normalization of mean response matrix
+ * (done in getMeanResponseMatrix())
+ */
+void VEffectiveAreaCalculator::addToMeanResponseMatrix( const vector< float >& i_emc, const vector< float >& iResponseMatrix,
+        double iWeight, bool iNormalize )
+{
+    int i_nbins = ( int )i_emc.size();
+    if( i_nbins < 2 || iResponseMatrix.size() != i_emc.size() * i_emc.size() )
+    {
+        return;
     }
     
-    // Normalization not required until final stage
-    // Hist scaled by NEntries (normalization will div by (n+const))
-    // VHistogramUtilities::normalizeTH2D_y(i_hist);
-    
-    // Checking if mean histogram exists
-    VHistogramUtilities::normalizeTH2D_y( i_hist );
     if( !hMeanResponseMatrix )
     {
         cout << "\t\tVEffectiveAreaCalculator::addMeanResponseMatrix Creating new histogram" << endl;
         
-        hMeanResponseMatrix = new TH2D( "hMeanResponseMatrix", "hMeanResponseMatrix", i_nbins , i_bins, i_nbins, i_bins );
-        hMeanResponseMatrix->Add( i_hist );
-        
+        float i_binw = i_emc[1] - i_emc[0] ;
+        vector< float > i_bins( i_nbins + 1, 0. );
+        i_bins[0] = i_emc[0] - i_binw / 2.;
+        for( int i = 0; i < i_nbins; i++ )
+        {
+            i_bins[i + 1] = i_bins[i] + i_binw;
+        }
+        hMeanResponseMatrix = new TH2D( "hMeanResponseMatrix", "hMeanResponseMatrix", i_nbins , &i_bins[0], i_nbins, &i_bins[0] );
+        iNormalize = false;
+    }
+    else if( hMeanResponseMatrix->GetNbinsX() != i_nbins || hMeanResponseMatrix->GetNbinsY() != i_nbins )
+    {
+        cout << "VEffectiveAreaCalculator::addMeanResponseMatrix: inconsistent binning of response matrix (";
+        cout << i_nbins << ", " << hMeanResponseMatrix->GetNbinsX() << ")" << endl;
+        return;
     }
     
-    
-    else
+    for( int i = 0; i < i_nbins; i++ )
+    {
+        for( int k = 0; k < i_nbins; k++ )
+        {
+            hMeanResponseMatrix->AddBinContent( hMeanResponseMatrix->GetBin( k + 1, i + 1 ), iWeight * iResponseMatrix[i * i_nbins + k] );
+        }
+    }
+    if( iNormalize )
     {
-        // cout << "VEffectiveAreaCalculator::addMeanResponseMatrix Adding Hist" << endl;
-        hMeanResponseMatrix->Add( i_hist );
         VHistogramUtilities::normalizeTH2D_y( hMeanResponseMatrix );
     }
-    
-    delete i_hist;
-    delete[] i_bins;
-    // fNMeanResponseMatrix++ ;
 }
 
 /*
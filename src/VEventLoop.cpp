@@ -72,7 +72,9 @@ VEventLoop::VEventLoop( VEvndispRunParameter* irunparameter )
         cout << fRunPar->freconstructionparameterfile << endl;
         exit( EXIT_FAILURE );
     }
-    
+    // flat neighbour tables for image cleaning (neighbour lists are final now)
+    getDetectorGeometry()->fillNeighbourTables();
+
     // set tracehandler
     fTraceHandler = new VTraceHandler();
     if( getRunParameter()->fTraceIntegrationMethod.size() > 0 )
@@ -155,6 +157,10 @@ void VEventLoop::printRunInfos()
                 cout << ", pole-zero cancellation parameter: " << fRunPar->fDF_PoleZero[fRunPar->fTelToAnalyze[i]];
                 cout << endl;
             }
+            if( fRunPar->fSlidingWindowMethod[fRunPar->fTelToAnalyze[i]] == 1 )
+            {
+                cout << "\t sliding window integration:\t prefix sums" << endl;
+            }
             cout << "\t start of summation window: \t" << fRunPar->fsumfirst[fRunPar->fTelToAnalyze[i]];
             cout << "\t(shifted by " << fRunPar->fTraceWindowShift[fRunPar->fTelToAnalyze[i]] << " samples)" << endl;
             cout << "\t length of summation window: \t" << fRunPar->fsumwindow_1[fRunPar->fTelToAnalyze[i]];
@@ -357,6 +363,15 @@ bool VEventLoop::initEventLoop( string iFileName )
                 cout << endl;
                 fRawDataReader->setDefaultMaxNChannels( i_nChannels );
                 ///////////////////////////////////////////////////////////////
+                // read and decode packets ahead of the analysis in a separate thread
+                if( fRunPar->fNPrefetchPackets > 0 )
+                {
+                    VBFDataReader* i_vbfReader = dynamic_cast< VBFDataReader* >( fRawDataReader );
+                    if( i_vbfReader )
+                    {
+                        i_vbfReader->startPacketPrefetch( fRunPar->fNPrefetchPackets );
+                    }
+                }
             }
             // sourcefile is MC vbf file; noise is read from separate file
             if( fRawDataReader && fRunPar->fsourcetype == 2 && fRunPar->fsimu_pedestalfile.size() > 0 )
@@ -1151,6 +1166,10 @@ int VEventLoop::analyzeEvent()
         }
     }
     
+    // telescopes to be analysed in parallel (analysis mode with several threads)
+    vector< unsigned int > i_telescopeAnalysis;
+    vector< unsigned int > i_telescopeCuts;
+    
     ////////////////////////////////////
     // analyze all requested telescopes
     ////////////////////////////////////
@@ -1255,6 +1274,16 @@ int VEventLoop::analyzeEvent()
                 if( fReader->getATEventType() != VEventType::PED_TRIGGER )
 #endif
                 {
+                    // parallel analysis: analyse all telescopes after this loop
+                    if( fRunPar->fNThreads > 1 )
+                    {
+                        if( !fRunPar->fWriteTriggerOnly || fReader->hasArrayTrigger() )
+                        {
+                            i_telescopeAnalysis.push_back( getTelID() );
+                        }
+                        i_telescopeCuts.push_back( getTelID() );
+                        break;
+                    }
                     if( !fRunPar->fWriteTriggerOnly || fReader->hasArrayTrigger() )
                     {
                         fAnalyzer->doAnalysis();
@@ -1366,6 +1395,27 @@ int VEventLoop::analyzeEvent()
                 
         }
     }
+    /////////////////////////////////////////////////////////////////////////
+    // parallel image analysis of all telescopes
+    if( i_telescopeCuts.size() > 0 )
+    {
+        fAnalyzer->doAnalysis( i_telescopeAnalysis );
+        // check user cuts
+        for( unsigned int i = 0; i < i_telescopeCuts.size(); i++ )
+        {
+            setTelID( i_telescopeCuts[i] );
+            i_cutTemp = checkCuts();
+            if( i_cut > 0 && !fCutTelescope )
+            {
+                i_cut = 1;
+            }
+            else
+            {
+                i_cut = i_cutTemp;
+            }
+        }
+    }
+    
     /////////////////////////////////////////////////////////////////////////
     // ARRAY ANALYSIS
     if( fRunMode != R_PED && fRunMode != R_GTO && fRunMode != R_GTOLOW && fRunMode != R_PEDLOW && fRunMode != R_TZERO && fRunMode != R_TZEROLOW )
@@ -102,6 +102,27 @@ void VEvndispData::setTelID( unsigned int iTel )
 }
 
 
+/*
+ * set current telescope for the calling thread only
+ *
+ * (used for parallel image analysis; the data reader and the detector
+ *  geometry are shared and their telescope IDs are not changed.
+ *  Code running in parallel calls the geometry getters with explicit
+ *  telescope ID, e.g. getDetectorGeo()->getX( getTelID() ) )
+ */
+void VEvndispData::setThreadTelID( unsigned int iTel )
+{
+    if( iTel < fNTel )
+    {
+        fTelID = iTel;
+    }
+    else
+    {
+        cout << "VEvndispData::setThreadTelID: error: invalid telescope number " << iTel << endl;
+    }
+}
+
+
 bool VEvndispData::initializeDataReader()
 {
     if( getDebugFlag() )
@@ -1247,7 +1268,7 @@ VEvndispRunParameter* VEvndispData::fRunPar = 0;
 
 // telescope data
 unsigned int VEvndispData::fNTel = 1;
-unsigned int VEvndispData::fTelID = 0;
+thread_local unsigned int VEvndispData::fTelID = 0;
 vector< unsigned int > VEvndispData::fTeltoAna;
 VDetectorGeometry* VEvndispData::fDetectorGeo = 0;
 VDetectorTree* VEvndispData::fDetectorTree = 0;
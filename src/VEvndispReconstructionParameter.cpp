@@ -628,6 +628,33 @@ bool VEvndispReconstructionParameter::readKeyWord_FADCSUMMATIONSTART( vector< st
     return true;
 }
 
+/*
+
+      read key word for sliding window integration method from runparameter file
+
+      0: running sum (default)
+      1: prefix sums (double precision; average time calculated from prefix sums)
+
+*/
+bool VEvndispReconstructionParameter::readKeyWord_FADCSLIDINGWINDOW( vector< string > iTemp, int t_temp )
+{
+    if( !fRunPara || iTemp.size() < 2 || iTemp[1].size() == 0 )
+    {
+        return false;
+    }
+    for( unsigned int i = 0; i < fTel_type_perTelescope.size(); i++ )
+    {
+        if( t_temp < 0 || getTelescopeType_counter( fTel_type_perTelescope[i] ) == t_temp )
+        {
+            if( i < fRunPara->fSlidingWindowMethod.size() )
+            {
+                fRunPara->fSlidingWindowMethod[i] = ( unsigned int )atoi( iTemp[1].c_str() );
+            }
+        }
+    }
+    return true;
+}
+
 /*
 
       read key words for cleaning from runparameter file
@@ -1286,6 +1313,11 @@ unsigned int VEvndispReconstructionParameter::read_arrayAnalysisCuts( string ifi
                 readKeyWord_FADCSUMMATIONSTART( iTemp, t_temp );
                 continue;
             }
+            else if( iTemp[0] == "FADCSLIDINGWINDOW" && fRunPara )
+            {
+                readKeyWord_FADCSLIDINGWINDOW( iTemp, t_temp );
+                continue;
+            }
             // image cleaning
             else if( iTemp[0].find( "CLEANING" ) != string::npos || iTemp[0].find( "TIMETWOLEVELPARAMETERS" ) != string::npos )
             {
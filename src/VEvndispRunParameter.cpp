@@ -62,6 +62,8 @@ VEvndispRunParameter::VEvndispRunParameter( bool bSetGlobalParameter ) : VGlobal
     fFirstEvent = -10000;
     fTimeCutsMin_min = -99;
     fTimeCutsMin_max = -99;
+    fNThreads = 1;
+    fNPrefetchPackets = 0;
     fIsMC = 0;
     fIgnoreCFGversions = false;
     fPrintAnalysisProgress = 25000;
@@ -185,6 +187,7 @@ VEvndispRunParameter::VEvndispRunParameter( bool bSetGlobalParameter ) : VGlobal
     fDF_DigitalFilter.push_back( 0 );
     fDF_UpSample.push_back( 4 );
     fDF_PoleZero.push_back( 0.75 );
+    fSlidingWindowMethod.push_back( 0 );
     fSumWindowMaxTimedifferenceToDoublePassPosition.push_back( -4. );
     fSumWindowMaxTimeDifferenceLGtoHG.push_back( -5. );
     fSmoothDead = false;
@@ -532,6 +535,14 @@ void VEvndispRunParameter::print( int iEv )
     {
         cout << "stop analysing at minute " << fTimeCutsMin_max << endl;
     }
+    if( fNThreads > 1 )
+    {
+        cout << "number of threads for image analysis: " << fNThreads << endl;
+    }
+    if( fNPrefetchPackets > 0 )
+    {
+        cout << "number of raw data packets read ahead: " << fNPrefetchPackets << endl;
+    }
     if( fNCalibrationEvents > 0 )
     {
         cout << "number of events in calibration analysis: " << fNCalibrationEvents << endl;
@@ -760,6 +771,10 @@ void VEvndispRunParameter::print( int iEv )
                     cout << ", pole-zero cancellation parameter: " << fDF_PoleZero[fTelToAnalyze[i]];
                     cout << endl;
                 }
+                if( fTelToAnalyze[i] < fSlidingWindowMethod.size() && fSlidingWindowMethod[fTelToAnalyze[i]] == 1 )
+                {
+                    cout << "\t sliding window integration using prefix sums" << endl;
+                }
                 cout << "\t start of summation window: \t" << fsumfirst[fTelToAnalyze[i]];
                 cout << "\t (shifted by " << fTraceWindowShift[fTelToAnalyze[i]] << " samples";
                 cout << " [method-" << fsumfirst_startingMethod[fTelToAnalyze[i]] << "], ";
@@ -1567,7 +1567,7 @@ bool VGammaHadronCuts::applyTMVACut( int i )
     fTMVA_EvaluationResult = -99.;
     if( fTMVAEvaluator )
     {
-        bool i_TMVA_Evaluation = fTMVAEvaluator->evaluate();
+        bool i_TMVA_Evaluation = fTMVAEvaluator->evaluate( i );
         fTMVA_EvaluationResult = fTMVAEvaluator->getTMVA_EvaluationResult();
         return i_TMVA_Evaluation;
     }
@@ -1575,6 +1575,20 @@ bool VGammaHadronCuts::applyTMVACut( int i )
     return false;
 }
 
+/*
+
+   calculate MVA values for a range of entries in the data tree
+   (results are cached and used by applyTMVACut(); see VTMVAEvaluator::evaluateBatch())
+
+*/
+void VGammaHadronCuts::evaluateTMVABatch( Long64_t iEntry_min, Long64_t iNEntries )
+{
+    if( useTMVACuts() && fTMVAEvaluator )
+    {
+        fTMVAEvaluator->evaluateBatch( iEntry_min, iNEntries );
+    }
+}
+
 /*
    apply deep learner cut
 */
@@ -1977,6 +1991,61 @@ bool VGammaHadronCuts::setDataTree( CData* idata )
     return true;
 }
 
+/*
+ * register data tree branches used by the cuts
+ * (see CData::activateUsedBranches())
+ *
+ * cuts are compiled code on CData members (no cut expressions): new cut
+ * variables must be added here (check with VStereoAnalysis::validateUsedBranches())
+ *
+ */
+void VGammaHadronCuts::registerUsedBranches( CData* iData )
+{
+    if( !iData )
+    {
+        return;
+    }
+    // stereo quality and shape cuts
+    iData->useBranch( "NImages" );
+    iData->useBranch( "ImgSel" );
+    iData->useBranch( "Chi2" );
+    iData->useBranch( "MSCW" );
+    iData->useBranch( "MSCL" );
+    iData->useBranch( "MWR" );
+    iData->useBranch( "MLR" );
+    iData->useBranch( "EmissionHeight" );
+    iData->useBranch( "SizeSecondMax" );
+    iData->useBranch( "DispNImages" );
+    iData->useEnergyBranches();
+    iData->useDirectionBranches();
+    // telescope type cuts
+    iData->useBranch( "NTtype" );
+    iData->useBranch( "NImages_Ttype" );
+    iData->useBranch( "TtypeID" );
+    // telescope-wise variables
+    iData->useBranch( "size" );
+    iData->useBranch( "width" );
+    iData->useBranch( "length" );
+    iData->useBranch( "dist" );
+    iData->useBranch( "R" );
+    iData->useBranch( "ES" );
+    if( iData->isMC() )
+    {
+        iData->useBranch( "MCxoff" );
+        iData->useBranch( "MCyoff" );
+        iData->useBranch( "MCaz" );
+    }
+    if( iData->isDeepLearner() )
+    {
+        iData->useBranch( "dl_gammaness" );
+        iData->useBranch( "dl_isGamma" );
+    }
+    if( fTMVAEvaluator )
+    {
+        fTMVAEvaluator->registerUsedBranches( iData );
+    }
+}
+
 
 bool VGammaHadronCuts::initProbabilityCuts( int irun )
 {
@@ -21,6 +21,7 @@ VImageAnalyzer::VImageAnalyzer()
     fRaw = false;
     fOutputfile = 0;
     fInit = false;
+    fThreadPool = 0;
     
     // image cleaning
     fVImageCleaning = new VImageCleaning( getData() );
@@ -73,6 +74,14 @@ VImageAnalyzer::VImageAnalyzer()
 
 VImageAnalyzer::~VImageAnalyzer()
 {
+    if( fThreadPool )
+    {
+        delete fThreadPool;
+    }
+    for( unsigned int i = 0; i < fTelescopeContext.size(); i++ )
+    {
+        delete fTelescopeContext[i];
+    }
     delete fVImageCleaning;
     delete fVImageParameterCalculation;
 }
@@ -81,10 +90,184 @@ VImageAnalyzer::~VImageAnalyzer()
 /*
  *  run through different steps of image cleaning and image parameterization
  *
- *  this is the main loop
+ *  this is the main loop (analysis of the current telescope)
  *
  */
 void VImageAnalyzer::doAnalysis()
+{
+    VTelescopeAnalysisContext* iContext = getTelescopeContext( getTelID() );
+    if( !iContext )
+    {
+        return;
+    }
+    
+    ///////////////////////////////////////////////////////////////////////////////////////////
+    // initialize event; don't do analysis if there was no array trigger
+    if( !doAnalysis_initEvent() )
+    {
+        return;
+    }
+    
+    ///////////////////////////////////////////////////////////////////////////////////////////
+    // integrate pulses and calculate timing parameters
+    doAnalysis_traceIntegration();
+    
+    ///////////////////////////////////////////////////////////////////////////////////////////
+    // image cleaning and image parameter calculation (first pass)
+    doAnalysis_imagePass1( iContext );
+    doAnalysis_imageFitPass1( iContext );
+    doAnalysis_afterImagePass1( iContext );
+    
+    ///////////////////////////////////////////////////////////////////////////////////////////
+    // second pass of image calculation using time gradient to adjust sum window (default)
+    if( doAnalysis_traceIntegrationPass2( iContext ) )
+    {
+        doAnalysis_imagePass2( iContext );
+        doAnalysis_imageFitPass2( iContext );
+    }
+    
+    ///////////////////////////////////////////////////////////////////////////////////////////
+    // log likelihood image analysis and filling of output trees
+    doAnalysis_imageFitLL( iContext );
+    doAnalysis_terminateEvent( iContext );
+}
+
+
+/*
+ *  analyse all telescopes in the given list (current event)
+ *
+ *  steps accessing the data reader, the trace handler, minuit or
+ *  the output trees are executed serially; image cleaning, image
+ *  parameter calculation and log likelihood image fits are executed
+ *  in parallel for all telescopes (one analysis context per telescope).
+ *  Log likelihood fits are serial if the fitter is not reentrant
+ *  (TMinuit fits).
+ *
+ *  All telescopes are analysed when this function returns, i.e. the
+ *  array analysis can be called afterwards.
+ *
+ */
+void VImageAnalyzer::doAnalysis( vector< unsigned int > iTelList )
+{
+    if( fDebug )
+    {
+        cout << "VImageAnalyzer::doAnalysis() for " << iTelList.size() << " telescopes" << endl;
+    }
+    // serial analysis
+    if( !fThreadPool || fThreadPool->getNThreads() < 2 )
+    {
+        for( unsigned int i = 0; i < iTelList.size(); i++ )
+        {
+            setTelID( iTelList[i] );
+            doAnalysis();
+        }
+        return;
+    }
+    
+    ///////////////////////////////////////////////////////////////////////////////////////////
+    // event initialization and trace integration (serial)
+    vector< VTelescopeAnalysisContext* > iContext;
+    for( unsigned int i = 0; i < iTelList.size(); i++ )
+    {
+        setTelID( iTelList[i] );
+        if( !getTelescopeContext( iTelList[i] ) || !doAnalysis_initEvent() )
+        {
+            continue;
+        }
+        doAnalysis_traceIntegration();
+        iContext.push_back( getTelescopeContext( iTelList[i] ) );
+    }
+    
+    ///////////////////////////////////////////////////////////////////////////////////////////
+    // image cleaning, parameterisation and log likelihood fitting (parallel)
+    fThreadPool->run( iContext.size(), [this, &iContext]( unsigned int iJob, unsigned int )
+    {
+        iContext[iJob]->bind();
+        doAnalysis_imagePass1( iContext[iJob] );
+        if( iContext[iJob]->getImageParameterCalculation()->isLLFitReentrant() )
+        {
+            doAnalysis_imageFitPass1( iContext[iJob] );
+        }
+    } );
+    
+    ///////////////////////////////////////////////////////////////////////////////////////////
+    // muon analysis and second pass trace integration (serial)
+    vector< VTelescopeAnalysisContext* > iContextPass2;
+    vector< VTelescopeAnalysisContext* > iContextPass1;
+    for( unsigned int i = 0; i < iContext.size(); i++ )
+    {
+        setTelID( iContext[i]->getTelID() );
+        if( !iContext[i]->getImageParameterCalculation()->isLLFitReentrant() )
+        {
+            doAnalysis_imageFitPass1( iContext[i] );
+        }
+        doAnalysis_afterImagePass1( iContext[i] );
+        if( doAnalysis_traceIntegrationPass2( iContext[i] ) )
+        {
+            iContextPass2.push_back( iContext[i] );
+        }
+        else
+        {
+            iContextPass1.push_back( iContext[i] );
+        }
+    }
+    
+    ///////////////////////////////////////////////////////////////////////////////////////////
+    // image cleaning, parameterisation and log likelihood fitting (second pass; parallel)
+    fThreadPool->run( iContextPass2.size(), [this, &iContextPass2]( unsigned int iJob, unsigned int )
+    {
+        iContextPass2[iJob]->bind();
+        doAnalysis_imagePass2( iContextPass2[iJob] );
+        if( iContextPass2[iJob]->getImageParameterCalculation()->isLLFitReentrant() )
+        {
+            doAnalysis_imageFitPass2( iContextPass2[iJob] );
+            doAnalysis_imageFitLL( iContextPass2[iJob] );
+        }
+    } );
+    
+    ///////////////////////////////////////////////////////////////////////////////////////////
+    // log likelihood image analysis for images without second pass (parallel)
+    if( fRunPar->fImageLL )
+    {
+        fThreadPool->run( iContextPass1.size(), [this, &iContextPass1]( unsigned int iJob, unsigned int )
+        {
+            iContextPass1[iJob]->bind();
+            if( iContextPass1[iJob]->getImageParameterCalculation()->isLLFitReentrant() )
+            {
+                doAnalysis_imageFitLL( iContextPass1[iJob] );
+            }
+        } );
+    }
+    
+    ///////////////////////////////////////////////////////////////////////////////////////////
+    // filling of output trees (serial)
+    for( unsigned int i = 0; i < iContext.size(); i++ )
+    {
+        setTelID( iContext[i]->getTelID() );
+        if( !iContext[i]->getImageParameterCalculation()->isLLFitReentrant() )
+        {
+            if( find( iContextPass2.begin(), iContextPass2.end(), iContext[i] ) != iContextPass2.end() )
+            {
+                doAnalysis_imageFitPass2( iContext[i] );
+            }
+            doAnalysis_imageFitLL( iContext[i] );
+        }
+        doAnalysis_terminateEvent( iContext[i] );
+    }
+}
+
+
+/*
+ *  event initialization for the current telescope
+ *
+ *  - first call: initialize and read calibration data, find dead channels, book trees
+ *  - check trigger conditions
+ *
+ *  returns false for events without (array) trigger; output trees are filled
+ *  for these events and no further analysis should be done
+ *
+ */
+bool VImageAnalyzer::doAnalysis_initEvent()
 {
     if( fDebug )
     {
@@ -139,15 +322,22 @@ void VImageAnalyzer::doAnalysis()
         setImageBorderNeighbour( false );
         setHiLo( false );
         setZeroSuppressed( 0 );
-        return;
+        return false;
     }
     if( getDebugFlag() )
     {
         cout << "VImageAnalyzer:doAnalysis array trigger: " << getReader()->hasArrayTrigger() << endl;
     }
-    
-    ///////////////////////////////////////////////////////////////////////////////////////////
-    // integrate pulses and calculate timing parameters
+    return true;
+}
+
+
+/*
+ *  integrate pulses and calculate timing parameters (first pass)
+ *
+ */
+void VImageAnalyzer::doAnalysis_traceIntegration()
+{
     if( isDoublePass() )
     {
         calcTZerosSums( getSumFirst(), getSumFirst() + getSumWindow_Pass1(), getTraceIntegrationMethod_pass1() );
@@ -171,10 +361,20 @@ void VImageAnalyzer::doAnalysis()
     ///////////////////////////////////////////////////////////////////////////////////////////
     // apply timing correction from laser calibration (flatfielding in time)
     timingCorrect();
-    
+}
+
+
+/*
+ *  image cleaning and image parameter calculation (first pass)
+ *
+ *  (no access to data reader or trace handler; can run in parallel for different telescopes)
+ *
+ */
+void VImageAnalyzer::doAnalysis_imagePass1( VTelescopeAnalysisContext* iContext )
+{
     ///////////////////////////////////////////////////////////////////////////////////////////
     // image cleaning & gain correction
-    imageCleaning( isDoublePass() );
+    imageCleaning( iContext, isDoublePass() );
     // print image and border pixels from double pass 1
     if( isDoublePass() && getDebugFlag() )
     {
@@ -205,14 +405,27 @@ void VImageAnalyzer::doAnalysis()
     
     ///////////////////////////////////////////////////////////////////////////////////////////
     // set parameters required for image parameter calculation
-    fVImageParameterCalculation->setDetectorGeometry( getDetectorGeometry() );
-    fVImageParameterCalculation->setParameters( getImageParameters() );
+    VImageParameterCalculation* iImageParameterCalculation = iContext->getImageParameterCalculation();
+    iImageParameterCalculation->setDetectorGeometry( getDetectorGeometry() );
+    iImageParameterCalculation->setParameters( getImageParameters() );
     
     ///////////////////////////////////////////////////////////////////////////////////////////
     // image parameter calculation
-    fVImageParameterCalculation->calcParameters();
-    fVImageParameterCalculation->calcTimingParameters( false );
-    
+    iImageParameterCalculation->calcParameters();
+    iImageParameterCalculation->calcTimingParameters( false );
+}
+
+
+/*
+ *  log likelihood fitting after first pass
+ *
+ *  (no access to data reader or trace handler; can run in parallel for different
+ *   telescopes if the fitter is reentrant)
+ *
+ */
+void VImageAnalyzer::doAnalysis_imageFitPass1( VTelescopeAnalysisContext* iContext )
+{
+    VImageParameterCalculation* iImageParameterCalculation = iContext->getImageParameterCalculation();
     ///////////////////////////////////////////////////////////////////////////////////////////
     // here: no double pass trace integration
     // do a log likelihood image fitting on events on the camera edge only
@@ -224,125 +437,267 @@ void VImageAnalyzer::doAnalysis()
         {
             if( !isEqualSummationWindows() )
             {
-                fVImageParameterCalculation->setParametersLogL( getImageParameters() );
-                setLLEst( fVImageParameterCalculation->calcLL( true, true ) );    // sum2
+                iImageParameterCalculation->setParametersLogL( getImageParameters() );
+                setLLEst( iImageParameterCalculation->calcLL( true, true ) );    // sum2
             }
-            fVImageParameterCalculation->setParametersLogL( getImageParameters() );
-            setLLEst( fVImageParameterCalculation->calcLL( false, true, isEqualSummationWindows() ) );   // sum
+            iImageParameterCalculation->setParametersLogL( getImageParameters() );
+            setLLEst( iImageParameterCalculation->calcLL( false, true, isEqualSummationWindows() ) );   // sum
         }
     }
-    
+}
+
+
+/*
+ *  muon analysis after first pass
+ *
+ */
+void VImageAnalyzer::doAnalysis_afterImagePass1( VTelescopeAnalysisContext* iContext )
+{
     ///////////////////////////////////////////////////////////////////////////////////////////
     // muon ring analysis
     if( fRunPar->fmuonmode && !isDoublePass() )
     {
-        muonRingAnalysis();
+        muonRingAnalysis( iContext );
     }
     
     ///////////////////////////////////////////////////////////////////////////////////////////
     // Hough transform muon ring analysis
     if( fRunPar->fhoughmuonmode && !isDoublePass() )
     {
-        houghMuonRingAnalysis();
+        houghMuonRingAnalysis( iContext );
+    }
+}
+
+
+/*
+ *  integrate pulses and calculate timing parameters taking time gradients over images into account
+ *
+ *  returns true if second pass analysis is required
+ *
+ */
+bool VImageAnalyzer::doAnalysis_traceIntegrationPass2( VTelescopeAnalysisContext* iContext )
+{
+    if( !isDoublePass() || !hasFADCData() )
+    {
+        return false;
+    }
+    if( iContext->getImageParameterCalculation()->getboolCalcGeo()
+            && iContext->getImageParameterCalculation()->getboolCalcTiming() )
+    {
+        calcSecondTZerosSums();
+    }
+    return true;
+}
+
+
+/*
+ *  image cleaning and image parameter calculation (second pass)
+ *
+ *  (no access to data reader or trace handler; can run in parallel for different telescopes)
+ *
+ */
+void VImageAnalyzer::doAnalysis_imagePass2( VTelescopeAnalysisContext* iContext )
+{
+    ///////////////////////////////////////////////////////////////////////////////////////////
+    // smoothing of dead or disabled pixels (first part)
+    if( fRunPar->fSmoothDead )
+    {
+        smoothDeadTubes( iContext );
     }
     
     ///////////////////////////////////////////////////////////////////////////////////////////
-    // second pass of image calculation using time gradient to adjust sum window (default)
-    if( isDoublePass() && hasFADCData() )
+    // image cleaning & gain correction (second pass)
+    imageCleaning( iContext, false );
+    
+    ///////////////////////////////////////////////////////////////////////////////////////////
+    // muon ring analysis (second pass)
+    if( fRunPar->fmuonmode )
     {
-        ///////////////////////////////////////////////////////////////////////////////////////////
-        // integrate pulses and calculate timing parameters taking time gradients over images into account
-        if( fVImageParameterCalculation->getboolCalcGeo() && fVImageParameterCalculation->getboolCalcTiming() )
+        muonRingAnalysis( iContext );
+    }
+    
+    ///////////////////////////////////////////////////////////////////////////////////////////
+    
+    ////////////////////////////////////////////////////////////////////////////////////////////////
+    //Hough transform muon ring analysis (second pass)
+    
+    if( fRunPar->fhoughmuonmode )
+    {
+        houghMuonRingAnalysis( iContext );
+    }
+    
+    ///////////////////////////////////////////////////////////////////////////////////////////
+    // smoothing of dead or disabled pixels (second part)
+    if( fRunPar->fSmoothDead )
+    {
+        for( unsigned int i = 0; i < getDead().size(); i++ )
         {
-            calcSecondTZerosSums();
+            getDead()[i] = iContext->fSavedDead[i];
+            getGains()[i] = iContext->fSavedGains[i];
+            getDead( true )[i] = iContext->fSavedDeadLow[i];
+            getGains( true )[i] = iContext->fSavedGainsLow[i];
         }
-        
-        ///////////////////////////////////////////////////////////////////////////////////////////
-        // smoothing of dead or disabled pixels (first part)
-        if( fRunPar->fSmoothDead )
+    }
+    
+    ///////////////////////////////////////////////////////////////////////////////////////////
+    // image parameter calculation
+    iContext->getImageParameterCalculation()->calcParameters();
+    iContext->getImageParameterCalculation()->calcTimingParameters( true );
+}
+
+
+/*
+ *  log likelihood fitting after second pass
+ *
+ *  (no access to data reader or trace handler; can run in parallel for different
+ *   telescopes if the fitter is reentrant)
+ *
+ */
+void VImageAnalyzer::doAnalysis_imageFitPass2( VTelescopeAnalysisContext* iContext )
+{
+    VImageParameterCalculation* iImageParameterCalculation = iContext->getImageParameterCalculation();
+    ///////////////////////////////////////////////////////////////////////////////////////////
+    // do a log likelihood image fitting on events on the camera edge only
+    if( getImageParameters()->ntubes > fRunPar->fLogLikelihood_Ntubes_min[getTelID()]
+            && ( fRunPar->fForceLLImageFit ||
+                 ( getImageParameters()->loss > fRunPar->fLogLikelihoodLoss_min[getTelID()] &&
+                   getImageParameters()->loss < fRunPar->fLogLikelihoodLoss_max[getTelID()] ) ) ) // FORCELL
+    {
+        if( !isEqualSummationWindows() )
         {
-            smoothDeadTubes();
+            iImageParameterCalculation->setParametersLogL( getImageParameters() );
+            setLLEst( iImageParameterCalculation->calcLL( true, true ) );
         }
-        
-        ///////////////////////////////////////////////////////////////////////////////////////////
-        // image cleaning & gain correction (second pass)
-        imageCleaning( false );
-        
-        ///////////////////////////////////////////////////////////////////////////////////////////
-        // muon ring analysis (second pass)
-        if( fRunPar->fmuonmode )
+        iImageParameterCalculation->setParametersLogL( getImageParameters() );
+        setLLEst( iImageParameterCalculation->calcLL( false, true, isEqualSummationWindows() ) );
+    }
+}
+
+
+/*
+ *  log likelihood image analysis (not default)
+ *
+ *  (no access to data reader or trace handler; can run in parallel for different
+ *   telescopes if the fitter is reentrant)
+ *
+ */
+void VImageAnalyzer::doAnalysis_imageFitLL( VTelescopeAnalysisContext* iContext )
+{
+    VImageParameterCalculation* iImageParameterCalculation = iContext->getImageParameterCalculation();
+    ///////////////////////////////////////////////////////////////////////////////////////////
+    // log likelihood image analysis (not default)
+    // calculate image parameters (mainly for edge images)
+    if( fRunPar->fImageLL )
+    {
+        // do this only if geometrical calculation found border/image channels
+        if( getImageParameters()->ntubes > 0 )
         {
-            muonRingAnalysis();
+            iImageParameterCalculation->setParametersLogL( getImageParametersLogL() );
+            setLLEst( iImageParameterCalculation->calcLL( true ) );
+            iImageParameterCalculation->setParametersLogL( getImageParametersLogL() );
+            setLLEst( iImageParameterCalculation->calcLL( false ) );
         }
-        
-        ///////////////////////////////////////////////////////////////////////////////////////////
-        
-        ////////////////////////////////////////////////////////////////////////////////////////////////
-        //Hough transform muon ring analysis (second pass)
-        
-        if( fRunPar->fhoughmuonmode )
+        else
         {
-            houghMuonRingAnalysis();
+            getImageParameters( fRunPar->fImageLL )->reset();
         }
-        
-        ///////////////////////////////////////////////////////////////////////////////////////////
-        // smoothing of dead or disabled pixels (second part)
-        if( fRunPar->fSmoothDead )
+    }
+}
+
+
+/*
+ *  filling of output trees
+ *
+ */
+void VImageAnalyzer::doAnalysis_terminateEvent( VTelescopeAnalysisContext* )
+{
+    ///////////////////////////////////////////////////////////////////////////////////////////
+    // fill results into output tree
+    fillOutputTree();
+}
+
+
+/*
+ *  return analysis context for the given telescope
+ *
+ *  (contexts are created at the first call)
+ */
+VTelescopeAnalysisContext* VImageAnalyzer::getTelescopeContext( unsigned int iTelID )
+{
+    if( fTelescopeContext.size() == 0 )
+    {
+        initTelescopeContexts();
+    }
+    if( iTelID < fTelescopeContext.size() )
+    {
+        return fTelescopeContext[iTelID];
+    }
+    return 0;
+}
+
+
+/*
+ *  initialize per-telescope analysis contexts and thread pool
+ *
+ *  parallel analysis is possible in analysis mode only and not for
+ *  methods requiring access to the data reader or trace handler
+ *  during image cleaning (GrIsu and PE readers, trace correlation
+ *  cleaning) or muon analysis
+ *
+ */
+void VImageAnalyzer::initTelescopeContexts()
+{
+    unsigned int iNThreads = fRunPar->fNThreads;
+    if( iNThreads > 1 )
+    {
+        string iReason = "";
+        if( fRunPar->frunmode != 0 || fRunPar->fdisplaymode )
         {
-            for( unsigned int i = 0; i < getDead().size(); i++ )
-            {
-                getDead()[i] = savedDead[i];
-                getGains()[i] = savedGains[i];
-                getDead( true )[i] = savedDeadLow[i];
-                getGains( true )[i] = savedGainsLow[i];
-            }
+            iReason = "analysis mode only";
         }
-        
-        ///////////////////////////////////////////////////////////////////////////////////////////
-        // image parameter calculation
-        fVImageParameterCalculation->calcParameters();
-        fVImageParameterCalculation->calcTimingParameters( true );
-        
-        ///////////////////////////////////////////////////////////////////////////////////////////
-        // do a log likelihood image fitting on events on the camera edge only
-        if( getImageParameters()->ntubes > fRunPar->fLogLikelihood_Ntubes_min[getTelID()]
-                && ( fRunPar->fForceLLImageFit ||
-                     ( getImageParameters()->loss > fRunPar->fLogLikelihoodLoss_min[getTelID()] &&
-                       getImageParameters()->loss < fRunPar->fLogLikelihoodLoss_max[getTelID()] ) ) ) // FORCELL
+        else if( fRunPar->fsourcetype == 1 || fRunPar->fsourcetype == 5 || fRunPar->fsourcetype == 6 )
         {
-            if( !isEqualSummationWindows() )
+            iReason = "not for GrIsu or PE files";
+        }
+        else if( fRunPar->fmuonmode || fRunPar->fhoughmuonmode )
+        {
+            iReason = "no muon analysis";
+        }
+        for( unsigned int i = 0; i < fRunPar->fTelToAnalyze.size() && iReason.size() == 0; i++ )
+        {
+            for( unsigned int p = 0; p < 2; p++ )
             {
-                fVImageParameterCalculation->setParametersLogL( getImageParameters() );
-                setLLEst( fVImageParameterCalculation->calcLL( true, true ) );
+                VImageCleaningRunParameter* iCleaningParameter = getImageCleaningParameter( ( p == 1 ), fRunPar->fTelToAnalyze[i] );
+                if( iCleaningParameter && iCleaningParameter->getImageCleaningMethod() == "TWOLEVELANDCORRELATION" )
+                {
+                    iReason = "no trace correlation cleaning";
+                }
             }
-            fVImageParameterCalculation->setParametersLogL( getImageParameters() );
-            setLLEst( fVImageParameterCalculation->calcLL( false, true, isEqualSummationWindows() ) );
         }
-        
+        if( iReason.size() > 0 )
+        {
+            cout << "VImageAnalyzer: parallel image analysis not possible (" << iReason << "); using one thread" << endl;
+            iNThreads = 1;
+        }
     }
     
-    ///////////////////////////////////////////////////////////////////////////////////////////
-    // log likelihood image analysis (not default)
-    // calculate image parameters (mainly for edge images)
-    if( fRunPar->fImageLL )
+    for( unsigned int i = 0; i < fNTel; i++ )
     {
-        // do this only if geometrical calculation found border/image channels
-        if( getImageParameters()->ntubes > 0 )
+        if( iNThreads > 1 )
         {
-            fVImageParameterCalculation->setParametersLogL( getImageParametersLogL() );
-            setLLEst( fVImageParameterCalculation->calcLL( true ) );
-            fVImageParameterCalculation->setParametersLogL( getImageParametersLogL() );
-            setLLEst( fVImageParameterCalculation->calcLL( false ) );
+            fTelescopeContext.push_back( new VTelescopeAnalysisContext( i, getData() ) );
         }
         else
         {
-            getImageParameters( fRunPar->fImageLL )->reset();
+            fTelescopeContext.push_back( new VTelescopeAnalysisContext( i, getData(), fVImageCleaning, fVImageParameterCalculation ) );
         }
     }
-    
-    ///////////////////////////////////////////////////////////////////////////////////////////
-    // fill results into output tree
-    fillOutputTree();
+    if( iNThreads > 1 )
+    {
+        ROOT::EnableThreadSafety();
+        fThreadPool = new VAnalysisThreadPool( iNThreads );
+        cout << "VImageAnalyzer: analysing telescopes with " << iNThreads << " threads" << endl;
+    }
 }
 
 
@@ -360,7 +715,10 @@ void VImageAnalyzer::fillOutputTree()
                                               0, 0, getFADCstopTZero(), getFADCstopSums() );
     }
     // fill (optionally) image/border tree lists
-    fVImageParameterCalculation->fillImageBorderPixelTree();
+    if( getTelescopeContext( getTelID() ) )
+    {
+        getTelescopeContext( getTelID() )->getImageParameterCalculation()->fillImageBorderPixelTree();
+    }
     
     // fill some basic run parameters
     getImageParameters()->fsumfirst = getSumFirst();
@@ -424,10 +782,14 @@ void VImageAnalyzer::initAnalysis()
     initTrees();
     
     // temporary vectors for dead pixel smoothing
-    savedDead.assign( getDead().size(), false );
-    savedDeadLow.assign( getDead( true ).size(), false );
-    savedGains.resize( getGains().size(), 1. );
-    savedGainsLow.resize( getGains( true ).size(), 1. );
+    VTelescopeAnalysisContext* iContext = getTelescopeContext( getTelID() );
+    if( iContext )
+    {
+        iContext->fSavedDead.assign( getDead().size(), false );
+        iContext->fSavedDeadLow.assign( getDead( true ).size(), false );
+        iContext->fSavedGains.resize( getGains().size(), 1. );
+        iContext->fSavedGainsLow.resize( getGains( true ).size(), 1. );
+    }
 }
 
 
@@ -762,7 +1124,7 @@ bool VImageAnalyzer::initEvent()
 This reduces the effect of dead tubes by assigning them charge and timing values
 derived by taking the average of the neighbouring tubes
 */
-void VImageAnalyzer::smoothDeadTubes()
+void VImageAnalyzer::smoothDeadTubes( VTelescopeAnalysisContext* iContext )
 {
     unsigned int i_nchannel = getNChannels();
     
@@ -770,17 +1132,17 @@ void VImageAnalyzer::smoothDeadTubes()
     for( unsigned int i = 0; i < getDead().size(); i++ )
     {
         getDeadRecovered()[i] = false;
-        savedDead[i] = getDead()[i];
-        savedGains[i] = getGains()[i];
-        savedDeadLow[i] = getDead( true )[i];
-        savedGainsLow = getGains( true )[i];
+        iContext->fSavedDead[i] = getDead()[i];
+        iContext->fSavedGains[i] = getGains()[i];
+        iContext->fSavedDeadLow[i] = getDead( true )[i];
+        iContext->fSavedGainsLow = getGains( true )[i];
     }
     
     // loop over all channels
     for( unsigned int i = 0; i < i_nchannel; i++ )
     {
         // select dead channels
-        if( getDetectorGeo()->getAnaPixel()[i] < 1 || !getDead()[i] )
+        if( getDetectorGeo()->getAnaPixel( getTelID() )[i] < 1 || !getDead()[i] )
         {
             continue;
         }
@@ -798,9 +1160,9 @@ void VImageAnalyzer::smoothDeadTubes()
         double ave_toffvars = 0.;
         double count = 0.;
         // loop over all neighbours of this dead pixel
-        for( unsigned int j = 0; j < getDetectorGeo()->getNeighbours()[i].size(); j++ )
+        for( unsigned int j = 0; j < getDetectorGeo()->getNeighbours( getTelID() )[i].size(); j++ )
         {
-            unsigned int k = getDetectorGeo()->getNeighbours()[i][j];
+            unsigned int k = getDetectorGeo()->getNeighbours( getTelID() )[i][j];
             
             if( getDead()[k] )
             {
@@ -948,11 +1310,11 @@ void VImageAnalyzer::setNTrigger()
     
     for( unsigned int i = 0; i < triggered_size; i++ )
     {
-        if( i < getDetectorGeo()->getNumChannels() && triggered[i] )
+        if( i < getDetectorGeo()->getNumChannels( getTelID() ) && triggered[i] )
         {
             //! find position of triggered tube
-            float xi = getDetectorGeo()->getX()[i];
-            float yi = getDetectorGeo()->getY()[i];
+            float xi = getDetectorGeo()->getX( getTelID() )[i];
+            float yi = getDetectorGeo()->getY( getTelID() )[i];
             unsigned short num_in_patch = 1;
             //! see how many other triggered tubes are within 0.3 degrees
             for( unsigned int j = 0; j < triggered_size; j++ )
@@ -971,8 +1333,8 @@ void VImageAnalyzer::setNTrigger()
                     {
                         continue;
                     }
-                    float xj = getDetectorGeo()->getX()[j];
-                    float yj = getDetectorGeo()->getY()[j];
+                    float xj = getDetectorGeo()->getX( getTelID() )[j];
+                    float yj = getDetectorGeo()->getY( getTelID() )[j];
                     if( ( xj - xi ) * ( xj - xi ) + ( yj - yi ) * ( yj - yi ) < 0.09 )
                     {
                         num_in_patch += 1;
@@ -997,12 +1359,13 @@ void VImageAnalyzer::setNTrigger()
  *           pointer to the image cleaning run parameters
  *
  */
-void VImageAnalyzer::imageCleaning( bool iDoublePassParameters )
+void VImageAnalyzer::imageCleaning( VTelescopeAnalysisContext* iContext, bool iDoublePassParameters )
 {
     if( !getImageCleaningParameter( iDoublePassParameters ) )
     {
         return;
     }
+    VImageCleaning* iImageCleaning = iContext->getImageCleaner();
     
     /////////////////////////////
     // fixed threshold cleaning
@@ -1011,22 +1374,22 @@ void VImageAnalyzer::imageCleaning( bool iDoublePassParameters )
         gainCorrect();
         if( getImageCleaningParameter( iDoublePassParameters )->getImageCleaningMethod() == "TIMECLUSTERCLEANING" )
         {
-            fVImageCleaning->cleanImageFixedWithTiming( getImageCleaningParameter( iDoublePassParameters ) );
+            iImageCleaning->cleanImageFixedWithTiming( getImageCleaningParameter( iDoublePassParameters ) );
         }
         // time-next-neighbour cleaning
         else if( getImageCleaningParameter( iDoublePassParameters )->getImageCleaningMethod() == "TIMENEXTNEIGHBOUR" )
         {
-            fVImageCleaning->cleanNNImageFixed( getImageCleaningParameter( iDoublePassParameters ) );
+            iImageCleaning->cleanNNImageFixed( getImageCleaningParameter( iDoublePassParameters ) );
         }
         //cluster cleaning
         else if( getImageCleaningParameter( iDoublePassParameters )->getImageCleaningMethod() == "CLUSTERCLEANING" )
         {
-            fVImageCleaning->cleanImageWithClusters( getImageCleaningParameter( iDoublePassParameters ), true );
+            iImageCleaning->cleanImageWithClusters( getImageCleaningParameter( iDoublePassParameters ), true );
         }
         // fixed cleaning levels (classic image/border)
         else
         {
-            fVImageCleaning->cleanImageFixed( getImageCleaningParameter( iDoublePassParameters ) );
+            iImageCleaning->cleanImageFixed( getImageCleaningParameter( iDoublePassParameters ) );
         }
     }
     /////////////////////////////
@@ -1035,57 +1398,59 @@ void VImageAnalyzer::imageCleaning( bool iDoublePassParameters )
     {
         if( getImageCleaningParameter( iDoublePassParameters )->getImageCleaningMethod() == "TIMECLUSTERCLEANING" )
         {
-            fVImageCleaning->cleanImagePedvarsWithTiming( getImageCleaningParameter( iDoublePassParameters ) );
+            iImageCleaning->cleanImagePedvarsWithTiming( getImageCleaningParameter( iDoublePassParameters ) );
         }
         else if( getImageCleaningParameter( iDoublePassParameters )->getImageCleaningMethod() == "TWOLEVELANDCORRELATION" )
         {
-            fVImageCleaning->cleanImageTraceCorrelate( getImageCleaningParameter( iDoublePassParameters ) );
+            iImageCleaning->cleanImageTraceCorrelate( getImageCleaningParameter( iDoublePassParameters ) );
         }
         // simple time two-level cleaning
         else if( getImageCleaningParameter( iDoublePassParameters )->getImageCleaningMethod() == "TIMETWOLEVEL" )
         {
-            fVImageCleaning->cleanImagePedvarsTimeDiff( getImageCleaningParameter( iDoublePassParameters ) );
+            iImageCleaning->cleanImagePedvarsTimeDiff( getImageCleaningParameter( iDoublePassParameters ) );
         }
         //cluster cleaning
         else if( getImageCleaningParameter( iDoublePassParameters )->getImageCleaningMethod() == "CLUSTERCLEANING" )
         {
-            fVImageCleaning->cleanImageWithClusters( getImageCleaningParameter( iDoublePassParameters ), false );
+            iImageCleaning->cleanImageWithClusters( getImageCleaningParameter( iDoublePassParameters ), false );
         }
         else
         {
-            fVImageCleaning->cleanImagePedvars( getImageCleaningParameter( iDoublePassParameters ) );
+            iImageCleaning->cleanImagePedvars( getImageCleaningParameter( iDoublePassParameters ) );
         }
         gainCorrect();
     }
 }
 
-void VImageAnalyzer::muonRingAnalysis()
+void VImageAnalyzer::muonRingAnalysis( VTelescopeAnalysisContext* iContext )
 {
-    fVImageParameterCalculation->muonRingFinder();
-    fVImageParameterCalculation->muonPixelDistribution();
-    fVImageParameterCalculation->sizeInMuonRing();
+    VImageParameterCalculation* iImageParameterCalculation = iContext->getImageParameterCalculation();
+    iImageParameterCalculation->muonRingFinder();
+    iImageParameterCalculation->muonPixelDistribution();
+    iImageParameterCalculation->sizeInMuonRing();
 }
 
-void VImageAnalyzer::houghMuonRingAnalysis()
+void VImageAnalyzer::houghMuonRingAnalysis( VTelescopeAnalysisContext* iContext )
 {
+    VImageParameterCalculation* iImageParameterCalculation = iContext->getImageParameterCalculation();
 
     // Iterative fit muon analysis
-    fVImageParameterCalculation->muonRingFinder();
+    iImageParameterCalculation->muonRingFinder();
     
     //Hough transform based muon parametrization algorithm invoked here
-    //fVImageParameterCalculation->houghMuonRingFinder();
+    //iImageParameterCalculation->houghMuonRingFinder();
     
     // Iterative fit muon analysis
-    fVImageParameterCalculation->muonPixelDistribution();
+    iImageParameterCalculation->muonPixelDistribution();
     
     //Hough transform muon ID technique
-    fVImageParameterCalculation->houghMuonPixelDistribution();
+    iImageParameterCalculation->houghMuonPixelDistribution();
     
     //Hough transform based size calculation algorithm
-    //fVImageParameterCalculation->houghSizeInMuonRing();
+    //iImageParameterCalculation->houghSizeInMuonRing();
     
     // Iterative fit muon analysis
-    fVImageParameterCalculation->sizeInMuonRing();
+    iImageParameterCalculation->sizeInMuonRing();
     
 }
 
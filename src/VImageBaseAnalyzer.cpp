@@ -136,6 +136,16 @@ void VImageBaseAnalyzer::calcSums( int iFirst, int iLast, bool iMakingPeds, bool
     {
         nhits = getDead( false ).size();
     }
+    // read samples of all channels
+    fTraceHandler->setSampleBlock( fReader, getNSamples() );
+    // fixed integration window: sums of all channels with vectorized kernels
+    bool bTraceBlock = false;
+    if( iTraceIntegrationMethod == 1 || ( iTraceIntegrationMethod == 9999 && getTraceIntegrationMethod() <= 1 ) )
+    {
+        bTraceBlock = initializeTraceBlock( iMakingPeds )
+                      && fTraceHandler->calculateTraceBlockSums_fixedWindow( iFirst, iLast, iMakingPeds );
+    }
+    double i_traceAverageTime = 0.;
     
     for( unsigned int i = 0; i < nhits; i++ )
     {
@@ -153,6 +163,13 @@ void VImageBaseAnalyzer::calcSums( int iFirst, int iLast, bool iMakingPeds, bool
                     && !getDead( i_channelHitID, getHiLo()[i_channelHitID] )
                     && iLast > iFirst )
             {
+                if( bTraceBlock )
+                {
+                    setSums( i_channelHitID, fTraceHandler->getTraceBlockSum( i, i_traceAverageTime )
+                             * getLowGainSumCorrection( iTraceIntegrationMethod, sw_original, iLast - iFirst, getHiLo()[i_channelHitID] ) );
+                    setTraceAverageTime( i_channelHitID, iFirst );
+                    continue;
+                }
                 fReader->selectHitChan( i );
                 initializeTrace( iMakingPeds, i_channelHitID, i, iTraceIntegrationMethod );
                 
@@ -181,6 +198,146 @@ void VImageBaseAnalyzer::calcSums( int iFirst, int iLast, bool iMakingPeds, bool
             continue;
         }
     }
+    fTraceHandler->resetSampleBlock();
+}
+
+/*
+
+   calculate integrated charges for all pixels and all summation windows
+   [iFirst, iFirst + w + 1), w = 0..iNWindows-1
+
+   (to be used for pedestal and IPR calculation; one pass over each trace
+    instead of one call of calcSums() per summation window)
+
+   sums are identical to calcSums( iFirst, iFirst + w + 1, ... ) and are
+   returned by getWindowSums( w )
+
+*/
+void VImageBaseAnalyzer::calcSumsAllWindows( int iFirst, unsigned int iNWindows, bool iMakingPeds, bool iLowGainOnly, unsigned int iTraceIntegrationMethod )
+{
+    if( getDebugFlag() )
+    {
+        cout << "VImageBaseAnalyzer::calcSumsAllWindows() " << iFirst << "\t" << iNWindows << endl;
+    }
+    if( fWindowSums.size() < iNWindows )
+    {
+        fWindowSums.resize( iNWindows );
+    }
+    
+    // sums from DST/QADC file: identical for all summation windows
+    if( ( getRunParameter()->frunmode != 1 && ( fReader->getDataFormatNum() == 4 || fReader->getDataFormatNum() == 6 ) )
+            || !hasFADCData() )
+    {
+        calcSums( iFirst, iFirst + 1, iMakingPeds, iLowGainOnly, iTraceIntegrationMethod );
+        for( unsigned int w = 0; w < iNWindows; w++ )
+        {
+            fWindowSums[w].resize( getSums().size() );
+            fWindowSums[w] = getSums();
+        }
+        return;
+    }
+    for( unsigned int w = 0; w < iNWindows; w++ )
+    {
+        if( fWindowSums[w].size() != getNChannels() )
+        {
+            fWindowSums[w].resize( getNChannels() );
+        }
+        fWindowSums[w] = 0.;
+    }
+    
+    // check integration range
+    // (summation windows are truncated to [0, getNSamples()) as in calcSums())
+    int iSumFirst = iFirst;
+    int iLastMax = iFirst + ( int )iNWindows;
+    if( iSumFirst < 0 )
+    {
+        iSumFirst = 0;
+    }
+    if( iLastMax > ( int )getNSamples() )
+    {
+        iLastMax = ( int )getNSamples();
+    }
+    if( iLastMax <= iSumFirst )
+    {
+        return;
+    }
+    // number of different (truncated) window lengths
+    unsigned int nWindowsInTrace = ( unsigned int )( iLastMax - iSumFirst );
+    
+    unsigned int nhits = fReader->getNumChannelsHit();
+    // exclude photodiode from this
+    if( nhits > getDead( false ).size() )
+    {
+        nhits = getDead( false ).size();
+    }
+    // read samples of all channels
+    fTraceHandler->setSampleBlock( fReader, getNSamples() );
+    // fixed integration window: sums of all channels and windows in one pass
+    bool bTraceBlock = false;
+    if( iTraceIntegrationMethod == 1 || ( iTraceIntegrationMethod == 9999 && getTraceIntegrationMethod() <= 1 ) )
+    {
+        bTraceBlock = initializeTraceBlock( iMakingPeds )
+                      && fTraceHandler->calculateTraceBlockSums_allWindows( iSumFirst, nWindowsInTrace, iMakingPeds );
+    }
+    
+    for( unsigned int i = 0; i < nhits; i++ )
+    {
+        unsigned int i_channelHitID = 0;
+        try
+        {
+            i_channelHitID = fReader->getHitID( i );
+            // for low gain pedestal calibration: ignore high gain channels
+            if( iLowGainOnly && i_channelHitID < getHiLo().size() && !getHiLo()[i_channelHitID] )
+            {
+                continue;
+            }
+            
+            if( i_channelHitID < getHiLo().size() && i_channelHitID < getDead( getHiLo()[i_channelHitID] ).size()
+                    && !getDead( i_channelHitID, getHiLo()[i_channelHitID] ) )
+            {
+                if( !bTraceBlock )
+                {
+                    fReader->selectHitChan( i );
+                    initializeTrace( iMakingPeds, i_channelHitID, i, iTraceIntegrationMethod );
+                    fTraceHandler->getTraceSums( iSumFirst, nWindowsInTrace, iMakingPeds, getSearchWindowLast(), fTraceWindowSums );
+                }
+                for( unsigned int w = 0; w < iNWindows; w++ )
+                {
+                    // length of truncated window
+                    int i_length = TMath::Min( iFirst + ( int )w + 1, iLastMax ) - iSumFirst;
+                    if( i_length <= 0 )
+                    {
+                        continue;
+                    }
+                    unsigned int w_trace = ( unsigned int )i_length - 1;
+                    double i_sum = 0.;
+                    if( bTraceBlock )
+                    {
+                        i_sum = fTraceHandler->getTraceBlockWindowSum( w_trace, i );
+                    }
+                    else
+                    {
+                        i_sum = fTraceWindowSums[w_trace];
+                    }
+                    fWindowSums[w][i_channelHitID] = i_sum
+                                                     * getLowGainSumCorrection( iTraceIntegrationMethod, w + 1, i_length, getHiLo()[i_channelHitID] );
+                }
+            }
+        }
+        catch( ... )
+        {
+            if( getDebugLevel() == 0 )
+            {
+                cout << "VImageBaseAnalyzer::calcSumsAllWindows(), index out of range (fReader->getHitID) ";
+                cout << i << ", i_channelHitID " << i_channelHitID << endl;
+                cout << "\t nhits: " << nhits << endl;
+                cout << "\t (Telescope " << getTelID() + 1 << ", event " << getEventNumber() << ")" << endl;
+                setDebugLevel( 1 );
+            }
+            continue;
+        }
+    }
+    fTraceHandler->resetSampleBlock();
 }
 
 
@@ -233,6 +390,8 @@ void VImageBaseAnalyzer::calcTZeros( int fFirst, int fLast )
     {
         nhits = getDead( false ).size();
     }
+    // read samples of all channels
+    fTraceHandler->setSampleBlock( fReader, getNSamples() );
     
     for( unsigned int i = 0; i < nhits; i++ )
     {
@@ -264,6 +423,7 @@ void VImageBaseAnalyzer::calcTZeros( int fFirst, int fLast )
             continue;
         }
     }
+    fTraceHandler->resetSampleBlock();
 }
 
 /*
@@ -495,6 +655,11 @@ void VImageBaseAnalyzer::calcTZerosSums( int iFirstSum, int iLastSum, unsigned i
     int corrfirst = 0;
     int corrlast = 0;
     
+    // read samples of all channels
+    fTraceHandler->setSampleBlock( fReader, getNSamples() );
+    // trace maxima of all channels with vectorized kernels
+    bool bTraceBlock = initializeTraceBlock( false ) && fTraceHandler->calculateTraceBlockMax();
+    
     //////////////////////////////////////////////////////////////////
     // loop over all channels (hits)
     //////////////////////////////////////////////////////////////////
@@ -608,7 +773,14 @@ void VImageBaseAnalyzer::calcTZerosSums( int iFirstSum, int iLastSum, unsigned i
             setTCorrectedSumLast( i_channelHitID, fTraceHandler->getTraceIntegrationLast() );
             
             // fill parameters characterizing the trace
-            i_tempTraceMax = fTraceHandler->getTraceMax( i_tempN255, i_tempTraceMaxPosition );
+            if( bTraceBlock )
+            {
+                i_tempTraceMax = fTraceHandler->getTraceBlockMax( i, i_tempN255, i_tempTraceMaxPosition );
+            }
+            else
+            {
+                i_tempTraceMax = fTraceHandler->getTraceMax( i_tempN255, i_tempTraceMaxPosition );
+            }
             setTraceMax( i_channelHitID, i_tempTraceMax );
             setTraceRawMax( i_channelHitID, i_tempTraceMax + getPeds( getHiLo()[i_channelHitID] )[i_channelHitID] );
             setTraceN255( i_channelHitID, i_tempN255 );
@@ -695,6 +867,7 @@ void VImageBaseAnalyzer::calcTZerosSums( int iFirstSum, int iLastSum, unsigned i
             }
         }
     }
+    fTraceHandler->resetSampleBlock();
     // fill tzero vector with uncorrected times
     setPulseTiming( getPulseTiming( true ), false );
 }
@@ -804,11 +977,11 @@ void VImageBaseAnalyzer::findDeadChans( bool iLowGain, bool iFirst )
             }
         }
         // getFullAnaVec()[i]: -1: dead channel, 0: channel does not exist, 1 channel o.k.
-        if( getNChannels() >= getDetectorGeometry()->getAnaPixel().size() )
+        if( getNChannels() >= getDetectorGeometry()->getAnaPixel( getTelID() ).size() )
         {
             for( unsigned int i = 0; i < getNChannels(); i++ )
             {
-                if( getDetectorGeometry()->getAnaPixel()[i] < 1 )
+                if( getDetectorGeometry()->getAnaPixel( getTelID() )[i] < 1 )
                 {
                     setDead( i, 12, iLowGain );
                 }
@@ -936,9 +1109,9 @@ void VImageBaseAnalyzer::findDeadChans( bool iLowGain, bool iFirst )
                     setDead( i, 12, iLowGain );
                 }
             }
-            else if( getNChannels() >= getDetectorGeometry()->getAnaPixel().size() )
+            else if( getNChannels() >= getDetectorGeometry()->getAnaPixel( getTelID() ).size() )
             {
-                if( getDetectorGeometry()->getAnaPixel()[i] < 1 )
+                if( getDetectorGeometry()->getAnaPixel( getTelID() )[i] < 1 )
                 {
                     setDead( i, 12, iLowGain );
                 }
@@ -1287,6 +1460,9 @@ void VImageBaseAnalyzer::calcSecondTZerosSums()
     float xtime = 0.;
     double corrfirst = 0;
     
+    // read samples of all channels
+    fTraceHandler->setSampleBlock( fReader, getNSamples() );
+    
     ///////////////////////////////////////////////////////////////////////////////////////////////////
     // loop over all hit channel
     ///////////////////////////////////////////////////////////////////////////////////////////////////
@@ -1313,8 +1489,8 @@ void VImageBaseAnalyzer::calcSecondTZerosSums()
                 // double pass method: use time gradient along the long-axis of the image to calculate expected T0
                 //////////////////////////////////////////////////////////////////////////////////////////////////
                 // position of the PMT in camera coordinates
-                xpmt = getDetectorGeo()->getX()[i_channelHitID] - getImageParameters()->cen_x;
-                ypmt = getDetectorGeo()->getY()[i_channelHitID] - getImageParameters()->cen_y;
+                xpmt = getDetectorGeo()->getX( getTelID() )[i_channelHitID] - getImageParameters()->cen_x;
+                ypmt = getDetectorGeo()->getY( getTelID() )[i_channelHitID] - getImageParameters()->cen_y;
                 // position along the major axis of the image
                 xpos = xpmt * getImageParameters()->cosphi + ypmt * getImageParameters()->sinphi;
                 // fit time along the major axis of the image (hardwired check of maximal time gradient))
@@ -1560,6 +1736,7 @@ void VImageBaseAnalyzer::calcSecondTZerosSums()
             continue;
         }
     }
+    fTraceHandler->resetSampleBlock();
 }
 
 /*
@@ -1630,7 +1807,9 @@ void VImageBaseAnalyzer::initializeTrace( bool iMakingPeds, unsigned int i_chann
     fTraceHandler->setDigitalFilterParameters( getDigitalFilterMethod(),
             getDigitalFilterUpSample(),
             getDigitalFilterPoleZero() );
-            
+    // sliding window method (running sum or prefix sums)
+    fTraceHandler->setSlidingWindowMethod( getSlidingWindowMethod() );
+    
     // set trace
     fTraceHandler->setTrace( fReader,
                              getNSamples(),
@@ -1655,3 +1834,42 @@ void VImageBaseAnalyzer::initializeTrace( bool iMakingPeds, unsigned int i_chann
     
 }
 
+/*
+ * set traces of all channels for the vectorized trace analysis
+ * (same pedestals and low-gain multipliers as in initializeTrace())
+ *
+ * requires a valid sample block (see VTraceHandler::setSampleBlock())
+ */
+bool VImageBaseAnalyzer::initializeTraceBlock( bool iMakingPeds )
+{
+    fTraceHandler->setDigitalFilterParameters( getDigitalFilterMethod(),
+            getDigitalFilterUpSample(),
+            getDigitalFilterPoleZero() );
+            
+    unsigned int nhits = fReader->getNumChannelsHit();
+    fTraceBlockPed.assign( nhits, 0. );
+    fTraceBlockLowGain.assign( nhits, 0. );
+    for( unsigned int i = 0; i < nhits; i++ )
+    {
+        unsigned int i_channelHitID = 0;
+        try
+        {
+            i_channelHitID = fReader->getHitID( i );
+        }
+        catch( ... )
+        {
+            continue;
+        }
+        if( i_channelHitID >= getHiLo().size() || i_channelHitID >= getPeds( getHiLo()[i_channelHitID] ).size() )
+        {
+            continue;
+        }
+        fTraceBlockPed[i] = getPeds( getHiLo()[i_channelHitID] )[i_channelHitID];
+        if( !iMakingPeds )
+        {
+            fTraceBlockLowGain[i] = getLowGainMultiplier_Trace() * getHiLo()[i_channelHitID];
+        }
+    }
+    return fTraceHandler->fillTraceBlock( fTraceBlockPed, fTraceBlockLowGain );
+}
+
@@ -35,12 +35,6 @@ VImageCleaning::VImageCleaning( VEvndispData* iData )
         fMinRate[i] = 0.;
         fifActiveNN.push_back( i_tempB );
     }
-    fIPR_save_mincharge = -99.;
-    fIPR_save_dT_from_probCurve = -99.;
-    fIPR_save_telid = 99;
-    fIPR_save_ProbCurve_par1 = -99.;
-    fIPR_save_ProbCurve_par2 = -99.;
-    
 }
 
 /*
@@ -84,37 +78,7 @@ void VImageCleaning::cleanImageFixed( double hithresh, double lothresh, double b
         printDataError( "VImageCleaning::cleanImageFixed" );
     }
     
-    fData->setImage( false );
-    fData->setBorder( false );
-    fData->setBrightNonImage( false );
-    fData->setImageBorderNeighbour( false );
-    unsigned int i_nchannel = fData->getNChannels();
-    
-    for( unsigned int i = 0; i < i_nchannel; i++ )
-    {
-        if( fData->getSums()[i] > hithresh )
-        {
-            if( fData->getDetectorGeo()->getAnaPixel()[i] > 0 && !fData->getDead( i, fData->getHiLo()[i] ) )
-            {
-                fData->setImage( i, true );
-                for( unsigned int j = 0; j < fData->getDetectorGeo()->getNeighbours()[i].size(); j++ )
-                {
-                    unsigned int k = fData->getDetectorGeo()->getNeighbours()[i][j];
-                    if( k < fData->getImage().size() && fData->getSums()[k] > lothresh && !fData->getImage()[k] )
-                    {
-                        fData->setBorder( k, true );
-                    }
-                }
-            }
-        }
-        if( fData->getSums()[i] > brightthresh )
-        {
-            if( fData->getDetectorGeo()->getAnaPixel()[i] > 0 && !fData->getDead( i, fData->getHiLo()[i] ) )
-            {
-                fData->setBrightNonImage( i, true );
-            }
-        }
-    }
+    cleanImageTailcut( hithresh, lothresh, brightthresh, false );
     
     // (preli) set the trigger vector in MC case (preli)
     // trigger vector are image/border tubes
@@ -166,60 +130,186 @@ void VImageCleaning::cleanImagePedvars( VImageCleaningRunParameter* iImageCleani
         cout << "VImageCleaning::cleanImagePedvars " << fData->getTelID() << endl;
     }
     
+    cleanImageTailcut( hithresh, lothresh, brightthresh, true );
+    
+    // (preli) set the trigger vector in MC case (preli)
+    // trigger vector are image/border tubes
+    if( fData->getReader() )
+    {
+        if( fData->getReader()->getDataFormatNum() == 1 || fData->getReader()->getDataFormatNum() == 4
+                || fData->getReader()->getDataFormatNum() == 6 )
+        {
+            fData->getReader()->setTrigger( fData->getImage(), fData->getBorder() );
+        }
+    }
+    // (end of preli)
+    
+    recoverImagePixelNearDeadPixel();
+    fillImageBorderNeighbours();
+}
+
+/*
+ * per-channel thresholds for tailcut cleaning of the current event
+ *
+ * bPedvars = true:  thresholds in units of pedestal variations
+ *                   (pedvars for the summation window and gain of each channel)
+ * bPedvars = false: fixed thresholds
+ */
+void VImageCleaning::fillTailcutThresholds( double hithresh, double lothresh, double brightthresh, bool bPedvars )
+{
+    unsigned int i_nchannel = fData->getNChannels();
+    fThreshImage.resize( i_nchannel );
+    fThreshBorder.resize( i_nchannel );
+    fThreshBright.resize( i_nchannel );
+    if( !bPedvars )
+    {
+        fThreshImage.assign( i_nchannel, hithresh );
+        fThreshBorder.assign( i_nchannel, lothresh );
+        fThreshBright.assign( i_nchannel, brightthresh );
+        return;
+    }
+    
+    // pedvars vector changes only with summation window or gain
+    valarray< double >* i_pedvars = 0;
+    unsigned int i_sw = 0;
+    bool i_hilo = false;
+    for( unsigned int i = 0; i < i_nchannel; i++ )
+    {
+        if( !i_pedvars || fData->getCurrentSumWindow()[i] != i_sw || fData->getHiLo()[i] != i_hilo )
+        {
+            i_sw = fData->getCurrentSumWindow()[i];
+            i_hilo = fData->getHiLo()[i];
+            i_pedvars = &fData->getPedvars( i_sw, i_hilo );
+        }
+        fThreshImage[i]  = hithresh * ( *i_pedvars )[i];
+        fThreshBorder[i] = lothresh * ( *i_pedvars )[i];
+        fThreshBright[i] = brightthresh * ( *i_pedvars )[i];
+    }
+}
+
+/*
+ * tailcut cleaning using channel bit masks
+ *
+ *  1. image, border candidate and bright pixel masks from per-channel thresholds
+ *  2. border pixels: neighbours of image pixels (flat neighbour table
+ *     of VDetectorGeometry) above the border threshold
+ *  3. set image/border/bright pixel flags in VEvndispData
+ *
+ * results are identical to the previous channel-by-channel loops:
+ *
+ * bPedvars = true (cleanImagePedvars): image pixels are never border pixels
+ * bPedvars = false (cleanImageFixed): a pixel is a border pixel if it has an image neighbour
+ *                                     with a smaller channel number or if it is not an image pixel
+ */
+void VImageCleaning::cleanImageTailcut( double hithresh, double lothresh, double brightthresh, bool bPedvars )
+{
     fData->setImage( false );
     fData->setBorder( false );
     fData->setBrightNonImage( false );
     fData->setImageBorderNeighbour( false );
     unsigned int i_nchannel = fData->getNChannels();
-    double i_pedvars_i = 0.;
-    double i_pedvars_k = 0.;
-    unsigned int k = 0;
+    unsigned int i_nwords = ( i_nchannel + 63 ) / 64;
+    
+    fillTailcutThresholds( hithresh, lothresh, brightthresh, bPedvars );
     
+    fMaskImage.assign( i_nwords, 0 );
+    fMaskBorderCandidate.assign( i_nwords, 0 );
+    fMaskBorder.assign( i_nwords, 0 );
+    fMaskBright.assign( i_nwords, 0 );
+    fMaskDilated.assign( i_nwords, 0 );
+    
+    ///////////////////////////////////////////////
+    // image, border candidates and bright pixels
+    valarray< double >& i_sums = fData->getSums();
+    vector< int >& i_anaPixel = fData->getDetectorGeo()->getAnaPixel( fData->getTelID() );
     for( unsigned int i = 0; i < i_nchannel; i++ )
     {
-        if( fData->getDetectorGeo()->getAnaPixel()[i] < 1 || fData->getDead( i, fData->getHiLo()[i] ) )
+        uint64_t i_bit = ( uint64_t )1 << ( i & 63 );
+        if( i_sums[i] > fThreshBorder[i] )
+        {
+            fMaskBorderCandidate[i >> 6] |= i_bit;
+        }
+        if( i_anaPixel[i] < 1 || fData->getDead( i, fData->getHiLo()[i] ) )
         {
             continue;
         }
-        i_pedvars_i = fData->getPedvars( fData->getCurrentSumWindow()[i], fData->getHiLo()[i] )[i];
-        
-        if( fData->getSums()[i] > hithresh * i_pedvars_i )
+        if( i_sums[i] > fThreshImage[i] )
         {
-            fData->setImage( i, true );
-            fData->setBorder( i, false );
-            for( unsigned int j = 0; j < fData->getDetectorGeo()->getNNeighbours()[i]; j++ )
+            fMaskImage[i >> 6] |= i_bit;
+        }
+        if( i_sums[i] > fThreshBright[i] )
+        {
+            fMaskBright[i >> 6] |= i_bit;
+        }
+    }
+    
+    ///////////////////////////////////////////////
+    // neighbours of image pixels
+    vector< unsigned int >& i_offset = fData->getDetectorGeo()->getNeighbourTableOffset( fData->getTelID() );
+    vector< unsigned int >& i_neighbour = fData->getDetectorGeo()->getNeighbourTable( fData->getTelID() );
+    for( unsigned int w = 0; w < i_nwords; w++ )
+    {
+        uint64_t i_word = fMaskImage[w];
+        while( i_word )
+        {
+            unsigned int i = w * 64 + __builtin_ctzll( i_word );
+            i_word &= i_word - 1;
+            if( i + 1 >= i_offset.size() )
+            {
+                continue;
+            }
+            for( unsigned int j = i_offset[i]; j < i_offset[i + 1]; j++ )
             {
-                k = fData->getDetectorGeo()->getNeighbours()[i][j];
-                if( k < i_nchannel )
+                unsigned int k = i_neighbour[j];
+                if( k >= i_nchannel )
                 {
-                    i_pedvars_k = fData->getPedvars( fData->getCurrentSumWindow()[k], fData->getHiLo()[k] )[k];
-                    if( !fData->getImage()[k] && fData->getSums()[k] > lothresh * i_pedvars_k )
-                    {
-                        fData->setBorder( k, true );
-                    }
+                    continue;
+                }
+                uint64_t k_bit = ( uint64_t )1 << ( k & 63 );
+                if( bPedvars )
+                {
+                    fMaskDilated[k >> 6] |= k_bit;
+                }
+                // fixed thresholds: image pixels with larger channel number
+                // were not yet image pixels when their neighbour i was tested
+                else if( ( fMaskBorderCandidate[k >> 6] & k_bit ) && ( !( fMaskImage[k >> 6] & k_bit ) || k > i ) )
+                {
+                    fMaskBorder[k >> 6] |= k_bit;
                 }
             }
         }
-        if( fData->getSums()[i] > brightthresh  * i_pedvars_i )
+    }
+    if( bPedvars )
+    {
+        for( unsigned int w = 0; w < i_nwords; w++ )
         {
-            fData->setBrightNonImage( i, true );
+            fMaskBorder[w] = fMaskDilated[w] & fMaskBorderCandidate[w] & ~fMaskImage[w];
         }
     }
     
-    // (preli) set the trigger vector in MC case (preli)
-    // trigger vector are image/border tubes
-    if( fData->getReader() )
+    ///////////////////////////////////////////////
+    // set pixel flags
+    for( unsigned int w = 0; w < i_nwords; w++ )
     {
-        if( fData->getReader()->getDataFormatNum() == 1 || fData->getReader()->getDataFormatNum() == 4
-                || fData->getReader()->getDataFormatNum() == 6 )
+        uint64_t i_word = fMaskImage[w];
+        while( i_word )
         {
-            fData->getReader()->setTrigger( fData->getImage(), fData->getBorder() );
+            fData->setImage( w * 64 + __builtin_ctzll( i_word ), true );
+            i_word &= i_word - 1;
+        }
+        i_word = fMaskBorder[w];
+        while( i_word )
+        {
+            fData->setBorder( w * 64 + __builtin_ctzll( i_word ), true );
+            i_word &= i_word - 1;
+        }
+        i_word = fMaskBright[w];
+        while( i_word )
+        {
+            fData->setBrightNonImage( w * 64 + __builtin_ctzll( i_word ), true );
+            i_word &= i_word - 1;
         }
     }
-    // (end of preli)
-    
-    recoverImagePixelNearDeadPixel();
-    fillImageBorderNeighbours();
 }
 
 /*!
@@ -265,7 +355,7 @@ void VImageCleaning::cleanImagePedvarsTimeDiff( VImageCleaningRunParameter* iIma
     for( unsigned int i = 0; i < i_nchannel; i++ )
     {
         // check if pixel is valid
-        if( fData->getDetectorGeo()->getAnaPixel()[i] < 1 || fData->getDead( fData->getHiLo()[i] )[i] )
+        if( fData->getDetectorGeo()->getAnaPixel( fData->getTelID() )[i] < 1 || fData->getDead( fData->getHiLo()[i] )[i] )
         {
             continue;
         }
@@ -276,9 +366,9 @@ void VImageCleaning::cleanImagePedvarsTimeDiff( VImageCleaningRunParameter* iIma
         if( fData->getSums()[i] > hithresh * i_pedvars_i )
         {
             // loop over all neighbours
-            for( unsigned int z = 0; z < fData->getDetectorGeo()->getNNeighbours()[i]; z++ )
+            for( unsigned int z = 0; z < fData->getDetectorGeo()->getNNeighbours( fData->getTelID() )[i]; z++ )
             {
-                l = fData->getDetectorGeo()->getNeighbours()[i][z];
+                l = fData->getDetectorGeo()->getNeighbours( fData->getTelID() )[i][z];
                 if( l < i_nchannel )
                 {
                     i_pedvars_l = fData->getPedvars( fData->getCurrentSumWindow()[l], fData->getHiLo()[l] )[l];
@@ -292,9 +382,9 @@ void VImageCleaning::cleanImagePedvarsTimeDiff( VImageCleaningRunParameter* iIma
                 }
                 // border pixel
                 fData->setBorder( i, false );
-                for( unsigned int j = 0; j < fData->getDetectorGeo()->getNNeighbours()[i]; j++ )
+                for( unsigned int j = 0; j < fData->getDetectorGeo()->getNNeighbours( fData->getTelID() )[i]; j++ )
                 {
-                    k = fData->getDetectorGeo()->getNeighbours()[i][j];
+                    k = fData->getDetectorGeo()->getNeighbours( fData->getTelID() )[i][j];
                     if( k < i_nchannel )
                     {
                         i_pedvars_k = fData->getPedvars( fData->getCurrentSumWindow()[k], fData->getHiLo()[k] )[k];
@@ -400,6 +490,13 @@ bool VImageCleaning::InitNNImageCleaning()
     fProb2plus1Curves = new TObjArray( types );
     fProb2nnCurves    = new TObjArray( types );
     fProbBoundCurves  = new TObjArray( types );
+    // tabulated rate contour curves
+    fProb4nnTables.resize( types );
+    fProb3nnrelTables.resize( types );
+    fProb2plus1Tables.resize( types );
+    fProb2nnTables.resize( types );
+    fProbBoundTables.resize( types );
+    fNNPreThresh.resize( types );
     
     // init IPR arrays
     // IPR[teltypes][IPRdim]
@@ -543,6 +640,18 @@ bool VImageCleaning::InitNNImgClnPerTelType( unsigned int teltype )
     fProb2nnCurves->AddAt( defineRateContourFunction( teltype, "ProbCurve2nn", fMinRate, 2, CombFactor[3], 0, ChargeMax ), ( int )teltype );
     fProbBoundCurves->AddAt( defineRateContourBoundFunction( teltype, "ProbCurveBound", fMinRate, 4.0, CombFactor[4], 0, ChargeMax ), ( int )teltype );
     
+    // tabulate rate contours (used in NN group search)
+    fProb4nnTables[teltype].fill( IPRgraph, ChargeMax, 4 );
+    fProb4nnTables[teltype].setParameters( fMinRate, CombFactor[0] );
+    fProb3nnrelTables[teltype].fill( IPRgraph, ChargeMax, 3 );
+    fProb3nnrelTables[teltype].setParameters( fMinRate, CombFactor[2] );
+    fProb2plus1Tables[teltype].fill( IPRgraph, ChargeMax, 3 );
+    fProb2plus1Tables[teltype].setParameters( fMinRate, CombFactor[1] );
+    fProb2nnTables[teltype].fill( IPRgraph, ChargeMax, 2 );
+    fProb2nnTables[teltype].setParameters( fMinRate, CombFactor[3] );
+    fProbBoundTables[teltype].fill( IPRgraph, ChargeMax, 2, true );
+    fProbBoundTables[teltype].setParameters( fMinRate, CombFactor[4], 4.0 );
+    
     cout << "Fake image probability: " << fFakeImageProb << " NgroupTypes: " << NgroupTypes;
     cout << " teltype " << teltype << " ChargeMax:" << ChargeMax << " Min rate: " << fMinRate;
     cout << std::endl;
@@ -639,6 +748,13 @@ void VImageCleaning::ScaleCombFactors( unsigned int type, float scale )
     f3nnrel->SetParameter( 2, CombFactor[2]*scale );
     f2plus1->SetParameter( 2, CombFactor[1]*scale );
     f2nn->SetParameter( 2, CombFactor[3]*scale );
+    if( type < fProb4nnTables.size() )
+    {
+        fProb4nnTables[type].setParameters( f4nn->GetParameter( 0 ), CombFactor[0]*scale );
+        fProb3nnrelTables[type].setParameters( f3nnrel->GetParameter( 0 ), CombFactor[2]*scale );
+        fProb2plus1Tables[type].setParameters( f2plus1->GetParameter( 0 ), CombFactor[1]*scale );
+        fProb2nnTables[type].setParameters( f2nn->GetParameter( 0 ), CombFactor[3]*scale );
+    }
 }
 
 /*
@@ -650,7 +766,7 @@ void VImageCleaning::ResetCombFactors( unsigned int type )
     ScaleCombFactors( type, fData->getNChannels() / 2400. ); // for this amount of pixels
 }
 
-bool VImageCleaning::BoundarySearch( unsigned int teltype, float thresh, TF1* fProbCurve, float refdT, int refvalidity, int idx )
+bool VImageCleaning::BoundarySearch( unsigned int teltype, float thresh, VNNProbabilityCurve* iProbCurve, float refdT, int refvalidity, int idx )
 {
     //idx - should be next neigbour of core!!!
     //skip core pix
@@ -660,19 +776,18 @@ bool VImageCleaning::BoundarySearch( unsigned int teltype, float thresh, TF1* fP
     }
     
     // check for valid pixel number
-    if( idx >= ( int )fData->getDetectorGeo()->getNeighbours().size() )
+    vector< unsigned int >& i_offset = fData->getDetectorGeo()->getNeighbourTableOffset( fData->getTelID() );
+    vector< unsigned int >& i_neighbour = fData->getDetectorGeo()->getNeighbourTable( fData->getTelID() );
+    if( idx + 1 >= ( int )i_offset.size() )
     {
         return false;
     }
     
-    // get IPR graph
-    TGraph* iIPR = ( TGraph* )fIPRgraphs->At( teltype );
-    if( !iIPR )
+    if( !iProbCurve || !iProbCurve->isFilled() )
     {
         cout << "VImageCleaning::BoundarySearch error, no IPR graph for telescope type " << teltype << endl;
         return 0;
     }
-    float iIPR_max = fIPRgraphs_xmax[teltype];
     
     //    float TimeForReSearch = 0.;
     bool iffound = false;
@@ -680,9 +795,9 @@ bool VImageCleaning::BoundarySearch( unsigned int teltype, float thresh, TF1* fP
     float time = 0.;
     
     // reftime from core pixels
-    for( unsigned int j = 0; j < fData->getDetectorGeo()->getNeighbours()[idx].size(); j++ )
+    for( unsigned int j = i_offset[idx]; j < i_offset[idx + 1]; j++ )
     {
-        const Int_t idx2 = fData->getDetectorGeo()->getNeighbours()[idx][j];
+        const Int_t idx2 = i_neighbour[j];
         Float_t t = TIMES[idx2];
         if( t > 0. && VALIDITYBUF[idx2] > 1.9 && VALIDITYBUF[idx2] < 5.1 )
         {
@@ -702,7 +817,7 @@ bool VImageCleaning::BoundarySearch( unsigned int teltype, float thresh, TF1* fP
         float mincharge = 0;
         LocMin( 2, charges, mincharge );
         
-        if( NNChargeAndTimeCut( iIPR, iIPR_max, fProbCurve, mincharge, maxtime, CoincWinLimit, true )
+        if( NNChargeAndTimeCut( iProbCurve, mincharge, maxtime, CoincWinLimit, true )
                 && VALIDITY[idx] > 0.5 )
         {
             if( VALIDITYBOUND[idx] != refvalidity )
@@ -712,9 +827,9 @@ bool VImageCleaning::BoundarySearch( unsigned int teltype, float thresh, TF1* fP
             iffound = true;
         }
         
-        for( unsigned int j = 0; j < fData->getDetectorGeo()->getNeighbours()[idx].size(); j++ )
+        for( unsigned int j = i_offset[idx]; j < i_offset[idx + 1]; j++ )
         {
-            const Int_t idx2 = fData->getDetectorGeo()->getNeighbours()[idx][j];
+            const Int_t idx2 = i_neighbour[j];
             if( ( TIMES[idx2] > 0. && VALIDITYBUF[idx2] > 1.9 && VALIDITYBUF[idx2] < 5.1 ) || VALIDITYBOUND[idx2] == refvalidity )
             {
                 continue;
@@ -726,7 +841,7 @@ bool VImageCleaning::BoundarySearch( unsigned int teltype, float thresh, TF1* fP
             charges[1] = INTENSITY[idx2];
             LocMin( 2, charges, mincharge );
             
-            if( NNChargeAndTimeCut( iIPR, iIPR_max, fProbCurve, mincharge, maxtime, CoincWinLimit, true )
+            if( NNChargeAndTimeCut( iProbCurve, mincharge, maxtime, CoincWinLimit, true )
                     && VALIDITY[idx2] > 0.5 )
             {
                 VALIDITYBOUND[idx2] = refvalidity;
@@ -743,30 +858,31 @@ bool VImageCleaning::BoundarySearch( unsigned int teltype, float thresh, TF1* fP
  * if Nfold = 3 it will search for 2nn+1, including sparse groups (with the empty pix in between)
  *
 */
-unsigned int VImageCleaning::NNGroupSearchProbCurve( unsigned int type, TF1* fProbCurve, float PreCut )
+unsigned int VImageCleaning::NNGroupSearchProbCurve( unsigned int type, VNNProbabilityCurve* iProbCurve, float PreCut )
 {
-    if( !fProbCurve )
+    if( !iProbCurve )
     {
         return 0;
     }
     
     // Nfold (e.g. 2 or 3)
-    int NN = ( int )fProbCurve->GetParameter( 1 );
+    int NN = ( int )iProbCurve->getNfold();
     
-    TGraph* iIPR = ( TGraph* )fIPRgraphs->At( type );
-    if( !iIPR )
+    if( !iProbCurve->isFilled() )
     {
         cout << "VImageCleaning::NNGroupSearchProbCurve error, no IPR graph for telescope type " << type << endl;
         return 0;
     }
-    float iIPR_max = fIPRgraphs_xmax[type];
+    // flat neighbour lists
+    vector< unsigned int >& i_offset = fData->getDetectorGeo()->getNeighbourTableOffset( fData->getTelID() );
+    vector< unsigned int >& i_neighbour = fData->getDetectorGeo()->getNeighbourTable( fData->getTelID() );
     
     // (GM) unclear why this is hardwired here
     int NSBpix = 5;
     
     //////////////////////////////
     // loop over all pixels
-    int numpix = fData->getDetectorGeo()->getNumChannels();
+    int numpix = fData->getDetectorGeo()->getNumChannels( fData->getTelID() );
     for( int PixNum = 0; PixNum < numpix; PixNum++ )
     {
         // check validity of a pixel and apply pre cut on charge
@@ -777,17 +893,13 @@ unsigned int VImageCleaning::NNGroupSearchProbCurve( unsigned int type, TF1* fPr
         }
         
         // access neighbour list and loop over all neighbours
-        if( PixNum >= ( int )fData->getDetectorGeo()->getNeighbours().size() )
+        if( PixNum + 1 >= ( int )i_offset.size() )
         {
             continue;
         }
-        for( unsigned int j = 0; j < fData->getDetectorGeo()->getNeighbours()[PixNum].size(); j++ )
+        for( unsigned int j = i_offset[PixNum]; j < i_offset[PixNum + 1]; j++ )
         {
-            const Int_t PixNum2 = fData->getDetectorGeo()->getNeighbours()[PixNum][j];
-            if( PixNum2 < 0 )
-            {
-                continue;
-            }
+            const Int_t PixNum2 = i_neighbour[j];
             // apply validity and pre-cut to neighbour pixel
             if( VALIDITY[PixNum2] < 0.5 || INTENSITY[PixNum2] < PreCut )
             {
@@ -803,7 +915,7 @@ unsigned int VImageCleaning::NNGroupSearchProbCurve( unsigned int type, TF1* fPr
             LocMin( 2, charges, mincharge );
             
             // apply charge and time cut
-            if( !NNChargeAndTimeCut( iIPR, iIPR_max, fProbCurve, mincharge, dT, CoincWinLimit ) )
+            if( !NNChargeAndTimeCut( iProbCurve, mincharge, dT, CoincWinLimit ) )
             {
                 continue;
             }
@@ -829,20 +941,20 @@ unsigned int VImageCleaning::NNGroupSearchProbCurve( unsigned int type, TF1* fPr
             if( VALIDITYBUF[PixNum2] == 2 && NN == 3 )
             {
                 bool iffound = false;
-                for( unsigned int k = 0; k < fData->getDetectorGeo()->getNeighbours()[PixNum].size(); k++ )
+                for( unsigned int k = i_offset[PixNum]; k < i_offset[PixNum + 1]; k++ )
                 {
-                    if( BoundarySearch( type, mincharge, fProbCurve, dT, 3, fData->getDetectorGeo()->getNeighbours()[PixNum][k] ) )
+                    if( BoundarySearch( type, mincharge, iProbCurve, dT, 3, i_neighbour[k] ) )
                     {
                         iffound = true;
                     }
                 }
-                if( PixNum2 >= ( int )fData->getDetectorGeo()->getNeighbours().size() )
+                if( PixNum2 + 1 >= ( int )i_offset.size() )
                 {
                     continue;
                 }
-                for( unsigned int k = 0; k < fData->getDetectorGeo()->getNeighbours()[PixNum2].size(); k++ )
+                for( unsigned int k = i_offset[PixNum2]; k < i_offset[PixNum2 + 1]; k++ )
                 {
-                    if( BoundarySearch( type, mincharge, fProbCurve, dT, 3, fData->getDetectorGeo()->getNeighbours()[PixNum2][k] ) )
+                    if( BoundarySearch( type, mincharge, iProbCurve, dT, 3, i_neighbour[k] ) )
                     {
                         iffound = true;
                     }
@@ -869,25 +981,21 @@ unsigned int VImageCleaning::NNGroupSearchProbCurve( unsigned int type, TF1* fPr
             // NN = 4 and beyond
             if( NSBpix > 2 )
             {
-                Double_t x = fData->getDetectorGeo()->getX()[PixNum2];
-                Double_t y = fData->getDetectorGeo()->getY()[PixNum2];
+                Double_t x = fData->getDetectorGeo()->getX( fData->getTelID() )[PixNum2];
+                Double_t y = fData->getDetectorGeo()->getY( fData->getTelID() )[PixNum2];
                 
                 Int_t idxm = -1;
                 Int_t idxp = -1;
                 Int_t nn = 0;
-                for( unsigned int kk = 0; kk < fData->getDetectorGeo()->getNeighbours()[PixNum].size(); kk++ )
+                for( unsigned int kk = i_offset[PixNum]; kk < i_offset[PixNum + 1]; kk++ )
                 {
-                    const Int_t k = fData->getDetectorGeo()->getNeighbours()[PixNum][kk];
-                    if( k < 0 )
-                    {
-                        continue;
-                    }
-                    Double_t xx = x - fData->getDetectorGeo()->getX()[k];
-                    Double_t yy = y - fData->getDetectorGeo()->getY()[k];
+                    const Int_t k = i_neighbour[kk];
+                    Double_t xx = x - fData->getDetectorGeo()->getX( fData->getTelID() )[k];
+                    Double_t yy = y - fData->getDetectorGeo()->getY( fData->getTelID() )[k];
                     
                     Double_t dist = sqrt( xx * xx + yy * yy );
                     // assume that all pixel have the same tube radius
-                    Double_t diam = 2.*fData->getDetectorGeo()->getTubeRadius()[1];
+                    Double_t diam = 2.*fData->getDetectorGeo()->getTubeRadius( fData->getTelID() )[1];
                     if( dist > 0.01 * diam && dist < 1.1 * diam )
                     {
                         if( nn )
@@ -918,7 +1026,7 @@ unsigned int VImageCleaning::NNGroupSearchProbCurve( unsigned int type, TF1* fPr
                 float maxtime = 1E6;
                 LocMax( 2, times2, maxtime );
                 // apply charge and time cut
-                if( !NNChargeAndTimeCut( iIPR, iIPR_max, fProbCurve, mincharge, maxtime, CoincWinLimit ) )
+                if( !NNChargeAndTimeCut( iProbCurve, mincharge, maxtime, CoincWinLimit ) )
                 {
                     continue;
                 }
@@ -959,7 +1067,7 @@ unsigned int VImageCleaning::NNGroupSearchProbCurve( unsigned int type, TF1* fPr
                     LocMax( 4, times3, maxtime );
                     
                     // apply charge and time cut
-                    if( !NNChargeAndTimeCut( iIPR, iIPR_max, fProbCurve, mincharge, maxtime, CoincWinLimit ) )
+                    if( !NNChargeAndTimeCut( iProbCurve, mincharge, maxtime, CoincWinLimit ) )
                     {
                         continue;
                     }
@@ -1023,41 +1131,18 @@ unsigned int VImageCleaning::NNGroupSearchProbCurve( unsigned int type, TF1* fPr
  *
  */
 bool VImageCleaning::NNChargeAndTimeCut(
-    TGraph* iIPR, float iIPR_max, TF1* fProbCurve,
+    VNNProbabilityCurve* iProbCurve,
     float mincharge, float dT,
     float iCoincWinLimit,
     bool bInvert )
 {
-    if( !iIPR || !fProbCurve )
+    if( !iProbCurve )
     {
         return false;
     }
-    float valDT = 0.;
-    // use previous result if charge and all other
-    // parameter are the same
-    if( fIPR_save_mincharge > -90.
-            && fIPR_save_telid == fData->getTelID()
-            && TMath::Abs( fIPR_save_ProbCurve_par1 - fProbCurve->GetParameter( 1 ) ) < 1.e-3
-            && TMath::Abs( fIPR_save_ProbCurve_par2 - fProbCurve->GetParameter( 2 ) ) < 1.e-3
-            && TMath::Abs( fIPR_save_mincharge - mincharge ) < 1.e-3 )
-    {
-        valDT = fIPR_save_dT_from_probCurve;
-    }
-    else
-    {
-        // get expected NSB frequency for this charge
-        float valIPR = iIPR->Eval( mincharge, 0, "" );
-        if( valIPR < 100. || mincharge > iIPR_max )
-        {
-            valIPR = 100.;   // Hz
-        }
-        valDT = fProbCurve->Eval( valIPR );
-        fIPR_save_dT_from_probCurve = valDT;
-        fIPR_save_mincharge = mincharge;
-        fIPR_save_telid = fData->getTelID();
-        fIPR_save_ProbCurve_par1 = fProbCurve->GetParameter( 1 );
-        fIPR_save_ProbCurve_par2 = fProbCurve->GetParameter( 2 );
-    }
+    // maximum time difference for this charge
+    // (from expected NSB frequency for this charge)
+    float valDT = iProbCurve->getDeltaT( mincharge );
     
     // apply cut in deltaT
     // (note cut on maximum coincidence limit (given in the cleaning parameter file))
@@ -1085,25 +1170,24 @@ bool VImageCleaning::NNChargeAndTimeCut(
  *
  * used for NN 3 and 4
  */
-unsigned int VImageCleaning::NNGroupSearchProbCurveRelaxed( unsigned int teltype, TF1* fProbCurve, float PreCut )
+unsigned int VImageCleaning::NNGroupSearchProbCurveRelaxed( unsigned int teltype, VNNProbabilityCurve* iProbCurve, float PreCut )
 {
-    if( !fProbCurve )
+    if( !iProbCurve )
     {
         return 0;
     }
     
     // Nfold (e.g. 2 or 3)
-    int NN = ( int )fProbCurve->GetParameter( 1 );
+    int NN = ( int )iProbCurve->getNfold();
     
-    TGraph* iIPR = ( TGraph* )fIPRgraphs->At( teltype );
-    if( !iIPR )
+    if( !iProbCurve->isFilled() )
     {
         cout << "VImageCleaning::NNGroupSearchProbCurveRelaxed error, no IPR graph for telescope type " << teltype << endl;
         return 0;
     }
-    float iIPR_max = fIPRgraphs_xmax[teltype];
-    fIPR_save_mincharge = -99.;
-    fIPR_save_dT_from_probCurve = -99.;
+    // flat neighbour lists
+    vector< unsigned int >& i_offset = fData->getDetectorGeo()->getNeighbourTableOffset( fData->getTelID() );
+    vector< unsigned int >& i_neighbour = fData->getDetectorGeo()->getNeighbourTable( fData->getTelID() );
     
     int NNcnt = 1;
     float dT = 0.;
@@ -1112,7 +1196,7 @@ unsigned int VImageCleaning::NNGroupSearchProbCurveRelaxed( unsigned int teltype
     
     ///////////////////////////////////
     // loop over all pixels
-    int numpix = fData->getDetectorGeo()->getNumChannels();
+    int numpix = fData->getDetectorGeo()->getNumChannels( fData->getTelID() );
     for( int PixNum = 0; PixNum < numpix; PixNum++ )
     {
         int nng3[3];
@@ -1123,17 +1207,13 @@ unsigned int VImageCleaning::NNGroupSearchProbCurveRelaxed( unsigned int teltype
         }
         NNcnt = 1;
         int pix1 = 0, pix2 = 0, pix3 = 0, pix4 = 0;
-        if( PixNum >= ( int )fData->getDetectorGeo()->getNeighbours().size() )
+        if( PixNum + 1 >= ( int )i_offset.size() )
         {
             continue;
         }
-        for( unsigned int j = 0; j < fData->getDetectorGeo()->getNeighbours()[PixNum].size(); j++ )
+        for( unsigned int j = i_offset[PixNum]; j < i_offset[PixNum + 1]; j++ )
         {
-            Int_t PixNum2 = fData->getDetectorGeo()->getNeighbours()[PixNum][j];
-            if( PixNum2 < 0 )
-            {
-                continue;
-            }
+            Int_t PixNum2 = i_neighbour[j];
             if( VALIDITY[PixNum2] < 0.5 || INTENSITY[PixNum2] < PreCut )
             {
                 continue;
@@ -1144,14 +1224,14 @@ unsigned int VImageCleaning::NNGroupSearchProbCurveRelaxed( unsigned int teltype
             LocMin( 2, charges, mincharge );
             
             // apply charge and time cut
-            if( !NNChargeAndTimeCut( iIPR, iIPR_max, fProbCurve, mincharge, dT, CoincWinLimit ) )
+            if( !NNChargeAndTimeCut( iProbCurve, mincharge, dT, CoincWinLimit ) )
             {
                 continue;
             }
             
             //////////////////////////////////////////
             float maxtime = 1E6;
-            if( NNChargeAndTimeCut( iIPR, iIPR_max, fProbCurve, mincharge, dT, 1.e6, true )
+            if( NNChargeAndTimeCut( iProbCurve, mincharge, dT, 1.e6, true )
                     && VALIDITY[PixNum2] > 0.5 && INTENSITY[PixNum2] > PreCut )
             {
                 pix1 = PixNum;
@@ -1170,7 +1250,7 @@ unsigned int VImageCleaning::NNGroupSearchProbCurveRelaxed( unsigned int teltype
                 float times2[3] = { dT, dt2, dt3};
                 LocMax( 3, times2, maxtime );
                 
-                if( NNChargeAndTimeCut( iIPR, iIPR_max, fProbCurve, mincharge, maxtime, 1.e6, true ) )
+                if( NNChargeAndTimeCut( iProbCurve, mincharge, maxtime, 1.e6, true ) )
                 {
                     NNcnt++;
                 }
@@ -1206,14 +1286,14 @@ unsigned int VImageCleaning::NNGroupSearchProbCurveRelaxed( unsigned int teltype
                 //4 connected pixels
                 for( int n = 0; n < 3; n++ )
                 {
-                    if( nng3[n] >= ( int )fData->getDetectorGeo()->getNeighbours().size() )
+                    if( nng3[n] + 1 >= ( int )i_offset.size() )
                     {
                         continue;
                     }
-                    for( unsigned int jj = 0; jj < fData->getDetectorGeo()->getNeighbours()[nng3[n]].size(); jj++ )
+                    for( unsigned int jj = i_offset[nng3[n]]; jj < i_offset[nng3[n] + 1]; jj++ )
                     {
-                        const Int_t testpixnum = fData->getDetectorGeo()->getNeighbours()[nng3[n]][jj];
-                        if( testpixnum < 0 || VALIDITYLOCAL[testpixnum] == 10 )
+                        const Int_t testpixnum = i_neighbour[jj];
+                        if( VALIDITYLOCAL[testpixnum] == 10 )
                         {
                             continue;
                         }
@@ -1233,7 +1313,7 @@ unsigned int VImageCleaning::NNGroupSearchProbCurveRelaxed( unsigned int teltype
                                           };
                         LocMax( 4, times3, maxtimeloc );
                         
-                        if( NNChargeAndTimeCut( iIPR, iIPR_max, fProbCurve, minchargeloc, maxtimeloc, CoincWinLimit, true ) )
+                        if( NNChargeAndTimeCut( iProbCurve, minchargeloc, maxtimeloc, CoincWinLimit, true ) )
                         {
                             NNcnt++;
                             pix4 = testpixnum;
@@ -1301,7 +1381,7 @@ unsigned int VImageCleaning::NNGroupSearchProbCurveRelaxed( unsigned int teltype
  */
 void VImageCleaning::DiscardIsolatedPixels()
 {
-    unsigned int numpix = fData->getDetectorGeo()->getNumChannels();
+    unsigned int numpix = fData->getDetectorGeo()->getNumChannels( fData->getTelID() );
     unsigned int NumOfNeighbor = 0;
     int PixNum2 = 0;
     
@@ -1312,13 +1392,13 @@ void VImageCleaning::DiscardIsolatedPixels()
             continue;
         }
         NumOfNeighbor = 0;
-        if( PixNum >= fData->getDetectorGeo()->getNeighbours().size() )
+        if( PixNum >= fData->getDetectorGeo()->getNeighbours( fData->getTelID() ).size() )
         {
             continue;
         }
-        for( unsigned int j = 0; j < fData->getDetectorGeo()->getNeighbours()[PixNum].size(); j++ )
+        for( unsigned int j = 0; j < fData->getDetectorGeo()->getNeighbours( fData->getTelID() )[PixNum].size(); j++ )
         {
-            PixNum2 = fData->getDetectorGeo()->getNeighbours()[PixNum][j];
+            PixNum2 = fData->getDetectorGeo()->getNeighbours( fData->getTelID() )[PixNum][j];
             if( PixNum2 >= 0 && VALIDITY[PixNum2] > 1.9 )
             {
                 NumOfNeighbor++;
@@ -1333,7 +1413,7 @@ void VImageCleaning::DiscardIsolatedPixels()
 
 void VImageCleaning::DiscardLocalTimeOutlayers( float NNthresh[6] )
 {
-    unsigned int numpix = fData->getDetectorGeo()->getNumChannels();
+    unsigned int numpix = fData->getDetectorGeo()->getNumChannels( fData->getTelID() );
     unsigned int nimagepix = 0;
     DiscardIsolatedPixels();
     for( unsigned int pixnum = 0; pixnum < numpix; pixnum++ )
@@ -1350,7 +1430,7 @@ void VImageCleaning::DiscardLocalTimeOutlayers( float NNthresh[6] )
         return;
     }
     // assume all pixels have same radius!
-    Double_t diam = 2.*fData->getDetectorGeo()->getTubeRadius()[1];
+    Double_t diam = 2.*fData->getDetectorGeo()->getTubeRadius( fData->getTelID() )[1];
     if( diam <= 0. )
     {
         return;
@@ -1370,8 +1450,8 @@ void VImageCleaning::DiscardLocalTimeOutlayers( float NNthresh[6] )
             continue;
         }
         
-        x = fData->getDetectorGeo()->getX()[pixnum] / diam; // coord in pixels units
-        y = fData->getDetectorGeo()->getY()[pixnum] / diam; // coord in pixels units
+        x = fData->getDetectorGeo()->getX( fData->getTelID() )[pixnum] / diam; // coord in pixels units
+        y = fData->getDetectorGeo()->getY( fData->getTelID() )[pixnum] / diam; // coord in pixels units
         pixcnt = 0;
         pixzerocnt = 0;
         // loop over vicinity of 2 rings around pixnum
@@ -1381,8 +1461,8 @@ void VImageCleaning::DiscardLocalTimeOutlayers( float NNthresh[6] )
             {
                 continue;
             }
-            xx = x - fData->getDetectorGeo()->getX()[pp] / diam; // coord in pixels units
-            yy = y - fData->getDetectorGeo()->getY()[pp] / diam; // coord in pixels units
+            xx = x - fData->getDetectorGeo()->getX( fData->getTelID() )[pp] / diam; // coord in pixels units
+            yy = y - fData->getDetectorGeo()->getY( fData->getTelID() )[pp] / diam; // coord in pixels units
             Double_t dist = sqrt( xx * xx + yy * yy );
             if( dist > 6.1 )
             {
@@ -1420,8 +1500,8 @@ void VImageCleaning::DiscardLocalTimeOutlayers( float NNthresh[6] )
         Tcnt = 0;
         sigmaT = 0.;
         meanT = 0.;
-        x = fData->getDetectorGeo()->getX()[pixnum] / diam; // coord in pixels units
-        y = fData->getDetectorGeo()->getY()[pixnum] / diam; // coord in pixels units
+        x = fData->getDetectorGeo()->getX( fData->getTelID() )[pixnum] / diam; // coord in pixels units
+        y = fData->getDetectorGeo()->getY( fData->getTelID() )[pixnum] / diam; // coord in pixels units
         
         // loop over vicinity of 2 rings around pixnum
         for( unsigned int pp = 0; pp < numpix; pp++ )
@@ -1430,8 +1510,8 @@ void VImageCleaning::DiscardLocalTimeOutlayers( float NNthresh[6] )
             {
                 continue;
             }
-            xx = x - fData->getDetectorGeo()->getX()[pp] / diam; // coord in pixels units
-            yy = y - fData->getDetectorGeo()->getY()[pp] / diam; // coord in pixels units
+            xx = x - fData->getDetectorGeo()->getX( fData->getTelID() )[pp] / diam; // coord in pixels units
+            yy = y - fData->getDetectorGeo()->getY( fData->getTelID() )[pp] / diam; // coord in pixels units
             if( xx * xx + yy * yy > 2.1 * 2.1 )
             {
                 continue;
@@ -1479,7 +1559,7 @@ void VImageCleaning::DiscardLocalTimeOutlayers( float NNthresh[6] )
 void  VImageCleaning::SetNeighborRings( unsigned short* VALIDITYBOUNDBUF, float* TIMESReSearch, float* REFTHRESH )
 {
     unsigned int nfirstringpix = 0;
-    unsigned int numpix = fData->getDetectorGeo()->getNumChannels();
+    unsigned int numpix = fData->getDetectorGeo()->getNumChannels( fData->getTelID() );
     
     //Define search region, driven by found core pixels
     for( unsigned int p = 0; p < numpix; p++ )
@@ -1510,13 +1590,13 @@ void  VImageCleaning::SetNeighborRings( unsigned short* VALIDITYBOUNDBUF, float*
             float time = 0.;
             float refthresh = 0.;
             int n = 0;
-            if( idx >= fData->getDetectorGeo()->getNeighbours().size() )
+            if( idx >= fData->getDetectorGeo()->getNeighbours( fData->getTelID() ).size() )
             {
                 continue;
             }
-            for( unsigned int j = 0; j < fData->getDetectorGeo()->getNeighbours()[idx].size(); j++ )
+            for( unsigned int j = 0; j < fData->getDetectorGeo()->getNeighbours( fData->getTelID() )[idx].size(); j++ )
             {
-                int idx2 = fData->getDetectorGeo()->getNeighbours()[idx][j];
+                int idx2 = fData->getDetectorGeo()->getNeighbours( fData->getTelID() )[idx][j];
                 if( idx2 < 0 || VALIDITYBOUNDBUF[idx2] < 1.9 )
                 {
                     continue;
@@ -1576,7 +1656,7 @@ void  VImageCleaning::SetNeighborRings( unsigned short* VALIDITYBOUNDBUF, float*
  */
 int VImageCleaning::ImageCleaningCharge( unsigned int teltype )
 {
-    unsigned int numpix = fData->getDetectorGeo()->getNumChannels();
+    unsigned int numpix = fData->getDetectorGeo()->getNumChannels( fData->getTelID() );
     
     // return value: number of groups
     int ngroups = 0;
@@ -1595,7 +1675,16 @@ int VImageCleaning::ImageCleaningCharge( unsigned int teltype )
                            4.0
                          }; // Bound RefCharge
                          
-    FillPreThresholds( ( TGraph* )fIPRgraphs->At( teltype ), PreThresh );
+    // (IPR graph does not change: fill only once per telescope type)
+    if( fNNPreThresh[teltype].size() != 6 )
+    {
+        FillPreThresholds( ( TGraph* )fIPRgraphs->At( teltype ), PreThresh );
+        fNNPreThresh[teltype].assign( PreThresh, PreThresh + 6 );
+    }
+    for( unsigned int i = 0; i < 6; i++ )
+    {
+        PreThresh[i] = fNNPreThresh[teltype][i];
+    }
     
     memset( VALIDITYBOUND, 0, sizeof( VALIDITYBOUND ) );
     memset( VALIDITY, 0, sizeof( VALIDITY ) );
@@ -1625,7 +1714,7 @@ int VImageCleaning::ImageCleaningCharge( unsigned int teltype )
     // 2NN
     if( teltype < fifActiveNN.size() &&  fifActiveNN[teltype][3] )
     {
-        ngroups = NNGroupSearchProbCurve( teltype, ( TF1* )fProb2nnCurves->At( teltype ), PreThresh[3] );
+        ngroups = NNGroupSearchProbCurve( teltype, &fProb2nnTables[teltype], PreThresh[3] );
         for( unsigned int p = 0; p < numpix; p++ )
         {
             if( VALIDITYBUF[p] == 2 )
@@ -1638,7 +1727,7 @@ int VImageCleaning::ImageCleaningCharge( unsigned int teltype )
     // 2NNplus1
     if( teltype < fifActiveNN.size() &&  fifActiveNN[teltype][1] )
     {
-        ngroups += NNGroupSearchProbCurve( teltype, ( TF1* )fProb2plus1Curves->At( teltype ), PreThresh[1] );
+        ngroups += NNGroupSearchProbCurve( teltype, &fProb2plus1Tables[teltype], PreThresh[1] );
         for( unsigned int p = 0; p < numpix; p++ )
         {
             if( VALIDITYBUF[p] == 3 || VALIDITYBOUND[p] == 3 )
@@ -1651,7 +1740,7 @@ int VImageCleaning::ImageCleaningCharge( unsigned int teltype )
     // 3NN (note: relaxed search)
     if( teltype < fifActiveNN.size() &&  fifActiveNN[teltype][2] )
     {
-        ngroups += NNGroupSearchProbCurveRelaxed( teltype, ( TF1* )fProb3nnrelCurves->At( teltype ), PreThresh[2] );
+        ngroups += NNGroupSearchProbCurveRelaxed( teltype, &fProb3nnrelTables[teltype], PreThresh[2] );
         for( unsigned int p = 0; p < numpix; p++ )
         {
             if( VALIDITYBUF[p] == 5 )
@@ -1664,7 +1753,7 @@ int VImageCleaning::ImageCleaningCharge( unsigned int teltype )
     // 4NN (note: relaxed search)
     if( teltype < fifActiveNN.size() &&  fifActiveNN[teltype][0] )
     {
-        ngroups += NNGroupSearchProbCurveRelaxed( teltype, ( TF1* )fProb4nnCurves->At( teltype ), PreThresh[0] );
+        ngroups += NNGroupSearchProbCurveRelaxed( teltype, &fProb4nnTables[teltype], PreThresh[0] );
         for( unsigned int p = 0; p < numpix; p++ )
         {
             if( VALIDITYBUF[p] == 6 )
@@ -1714,7 +1803,7 @@ int VImageCleaning::ImageCleaningCharge( unsigned int teltype )
         ScaleCombFactors( teltype, float( nboundsearchpix ) / ( numpix * 1.5 ) );
         if( teltype < fifActiveNN.size() &&  fifActiveNN[teltype][3] )
         {
-            NNGroupSearchProbCurve( teltype, ( TF1* )fProb2nnCurves->At( teltype ), 0.8 * PreThresh[3] );
+            NNGroupSearchProbCurve( teltype, &fProb2nnTables[teltype], 0.8 * PreThresh[3] );
             for( unsigned int p = 0; p < numpix; p++ )
             {
                 if( VALIDITY[p] > 1.9 )
@@ -1730,7 +1819,7 @@ int VImageCleaning::ImageCleaningCharge( unsigned int teltype )
         
         if( teltype < fifActiveNN.size() &&  fifActiveNN[teltype][1] )
         {
-            NNGroupSearchProbCurve( teltype, ( TF1* )fProb2plus1Curves->At( teltype ), 0.8 * PreThresh[1] );
+            NNGroupSearchProbCurve( teltype, &fProb2plus1Tables[teltype], 0.8 * PreThresh[1] );
             for( unsigned int p = 0; p < numpix; p++ )
             {
                 if( VALIDITY[p] > 1.9 )
@@ -1746,7 +1835,7 @@ int VImageCleaning::ImageCleaningCharge( unsigned int teltype )
         
         if( teltype < fifActiveNN.size() &&  fifActiveNN[teltype][2] )
         {
-            NNGroupSearchProbCurveRelaxed( teltype, ( TF1* )fProb3nnrelCurves->At( teltype ), 0.8 * PreThresh[2] );
+            NNGroupSearchProbCurveRelaxed( teltype, &fProb3nnrelTables[teltype], 0.8 * PreThresh[2] );
             for( unsigned int p = 0; p < numpix; p++ )
             {
                 if( VALIDITY[p] > 1.9 )
@@ -1762,7 +1851,7 @@ int VImageCleaning::ImageCleaningCharge( unsigned int teltype )
         
         if( teltype < fifActiveNN.size() &&  fifActiveNN[teltype][0] )
         {
-            NNGroupSearchProbCurveRelaxed( teltype, ( TF1* )fProb4nnCurves->At( teltype ), 0.9 * PreThresh[0] );
+            NNGroupSearchProbCurveRelaxed( teltype, &fProb4nnTables[teltype], 0.9 * PreThresh[0] );
             for( unsigned int p = 0; p < numpix; p++ )
             {
                 if( VALIDITY[p] > 1.9 )
@@ -1801,13 +1890,12 @@ int VImageCleaning::ImageCleaningCharge( unsigned int teltype )
     // BOUNDARY pixel search (usually very few pixels are found)
     // only first ring
     TF1* fProbCurveBound = ( TF1* )fProbBoundCurves->At( teltype );
-    TGraph* iIPR = ( TGraph* )fIPRgraphs->At( teltype );
-    if( !iIPR )
+    VNNProbabilityCurve* iProbCurveBound = &fProbBoundTables[teltype];
+    if( !fProbCurveBound || !iProbCurveBound->isFilled() )
     {
         cout << "VImageCleaning::ImageCleaningCharge error, no IPR graph for telescope type " << teltype << endl;
         return 0;
     }
-    float iIPR_max = fIPRgraphs_xmax[teltype];
     
     for( Int_t iRing = 0; iRing < 1; iRing++ )
     {
@@ -1825,13 +1913,13 @@ int VImageCleaning::ImageCleaningCharge( unsigned int teltype )
             float time = 0.;
             float charge = 0.;
             
-            if( idx >= fData->getDetectorGeo()->getNeighbours().size() )
+            if( idx >= fData->getDetectorGeo()->getNeighbours( fData->getTelID() ).size() )
             {
                 continue;
             }
-            for( unsigned int j = 0; j < fData->getDetectorGeo()->getNeighbours()[idx].size(); j++ )
+            for( unsigned int j = 0; j < fData->getDetectorGeo()->getNeighbours( fData->getTelID() )[idx].size(); j++ )
             {
-                const Int_t idx2 = fData->getDetectorGeo()->getNeighbours()[idx][j];
+                const Int_t idx2 = fData->getDetectorGeo()->getNeighbours( fData->getTelID() )[idx][j];
                 if( idx2 < 0 || VALIDITYBOUNDBUF[idx2] < 1.9 )
                 {
                     continue;
@@ -1903,16 +1991,12 @@ int VImageCleaning::ImageCleaningCharge( unsigned int teltype )
                 float charges[2] = {INTENSITY[idx], ( float )charge };
                 float refth = 0.;
                 LocMin( 2, charges, refth );
-                fProbCurveBound->SetParameter( 2, 2.*nfirstringpix );
-                
-                Double_t valIPRref = iIPR->Eval( charge, 0, "" );
-                if( valIPRref < 100. || charge >= iIPR_max )
-                {
-                    valIPRref = 100.;
-                }
-                fProbCurveBound->SetParameter( 1, valIPRref );
+                // combinatorial factor: 2 x number of pixels in first ring;
+                // reference rate: IPR at mean charge of neighbours
+                iProbCurveBound->setParameters( fProbCurveBound->GetParameter( 0 ), 2.*nfirstringpix,
+                                                iProbCurveBound->getIPR( charge ) );
                 
-                if( NNChargeAndTimeCut( iIPR, iIPR_max, fProbCurveBound, refth, dT, 0.6 * CoincWinLimit, true ) )
+                if( NNChargeAndTimeCut( iProbCurveBound, refth, dT, 0.6 * CoincWinLimit, true ) )
                 {
                     VALIDITY[idx] = iRing + 7;
                 }
@@ -2043,7 +2127,7 @@ void VImageCleaning::cleanNNImageFixed( VImageCleaningRunParameter* iImageCleani
         INTENSITY[i] = 0.;
         TIMES[i]     = -500.;
         VALIDITY[i]  = 0;
-        if( fData->getDetectorGeo()->getAnaPixel()[i] > 0
+        if( fData->getDetectorGeo()->getAnaPixel( fData->getTelID() )[i] > 0
                 && !fData->getDead( fData->getHiLo()[i] )[i] )
         {
             INTENSITY[i] = fData->getFADCtoPhe()[i] * fData->getSums()[i];
@@ -2079,7 +2163,7 @@ void VImageCleaning::cleanNNImageFixed( VImageCleaningRunParameter* iImageCleani
         {
             fData->setImage( i, false );
             fData->setBorder( i, false );
-            if( fData->getDetectorGeo()->getAnaPixel()[i] > 0
+            if( fData->getDetectorGeo()->getAnaPixel( fData->getTelID() )[i] > 0
                     && !fData->getDead( fData->getHiLo()[i] )[i] )
             {
                 if( VALIDITY[i] > 1.9 )
@@ -2186,7 +2270,7 @@ void VImageCleaning::FillIPR( unsigned int teltype ) //tel type
     //loop over pixels
     for( unsigned int i = 0; i < fData->getNChannels(); i++ )
     {
-        if( fData->getDetectorGeo()->getAnaPixel()[i] > 0 && !fData->getDead( fData->getHiLo()[i] )[i] )
+        if( fData->getDetectorGeo()->getAnaPixel( fData->getTelID() )[i] > 0 && !fData->getDead( fData->getHiLo()[i] )[i] )
         {
             if( VALIDITY[i] < 1.9 )
             {
@@ -2287,7 +2371,7 @@ void VImageCleaning::cleanImageWithClusters( VImageCleaningRunParameter* iImageC
     
     for( unsigned int i = 0; i < fData->getNChannels(); i++ )
     {
-        if( fData->getDetectorGeo()->getAnaPixel()[i] < 1 || fData->getDead( i, fData->getHiLo()[i] ) )
+        if( fData->getDetectorGeo()->getAnaPixel( fData->getTelID() )[i] < 1 || fData->getDead( i, fData->getHiLo()[i] ) )
         {
             continue;
         }
@@ -2383,9 +2467,9 @@ void VImageCleaning::cleanImageWithClusters( VImageCleaningRunParameter* iImageC
         int i_ID = fData->getClusterID()[i];
         if( fData->getImage()[i] && fData->getClusterID()[i] > 0 )
         {
-            for( unsigned int j = 0; j < fData->getDetectorGeo()->getNNeighbours()[i]; j++ )
+            for( unsigned int j = 0; j < fData->getDetectorGeo()->getNNeighbours( fData->getTelID() )[i]; j++ )
             {
-                unsigned int k = fData->getDetectorGeo()->getNeighbours()[i][j];
+                unsigned int k = fData->getDetectorGeo()->getNeighbours( fData->getTelID() )[i][j];
                 if( fData->getImage()[k] || fData->getBorder()[k] )
                 {
                     continue;
@@ -2438,9 +2522,9 @@ void VImageCleaning::addToCluster( unsigned int cID, unsigned int iChan )
         cout << "VImageCleaning::addToCluster warning: ClusterID " << cID << " not available in fNpixCluster vector (size " <<  fNpixCluster.size() << ")" << endl;
     }
     
-    for( unsigned int j = 0; j < fData->getDetectorGeo()->getNNeighbours()[iChan]; j++ )
+    for( unsigned int j = 0; j < fData->getDetectorGeo()->getNNeighbours( fData->getTelID() )[iChan]; j++ )
     {
-        unsigned int k = fData->getDetectorGeo()->getNeighbours()[iChan][j];
+        unsigned int k = fData->getDetectorGeo()->getNeighbours( fData->getTelID() )[iChan][j];
         if( fData->getImage()[k] && fData->getClusterID()[k] == 0 )
         {
             addToCluster( cID, k ) ;
@@ -2542,7 +2626,7 @@ void VImageCleaning::cleanImageWithTiming( VImageCleaningRunParameter* iImageCle
     {
         // select for dead channels
         // note: ignore all channels with highgain setting to 'dead'
-        if( fData->getDetectorGeo()->getAnaPixel()[i] < 1
+        if( fData->getDetectorGeo()->getAnaPixel( fData->getTelID() )[i] < 1
                 || fData->getDead( fData->getHiLo()[i] )[i]
                 || fData->getDead( false )[i] )
         {
@@ -2602,13 +2686,13 @@ void VImageCleaning::cleanImageWithTiming( VImageCleaningRunParameter* iImageCle
                      
             fData->setClusterID( i, c_id );
             
-            if( i >= fData->getDetectorGeo()->getNeighbours().size() )
+            if( i >= fData->getDetectorGeo()->getNeighbours( fData->getTelID() ).size() )
             {
                 continue;
             }
-            for( unsigned int j = 0; j < fData->getDetectorGeo()->getNNeighbours()[i]; j++ )
+            for( unsigned int j = 0; j < fData->getDetectorGeo()->getNNeighbours( fData->getTelID() )[i]; j++ )
             {
-                unsigned int k = fData->getDetectorGeo()->getNeighbours()[i][j];
+                unsigned int k = fData->getDetectorGeo()->getNeighbours( fData->getTelID() )[i][j];
                 if( fData->getImage()[k] && fData->getClusterID()[k] == 0 )
                 {
                     if( fabs( fData->getPulseTime()[i] - fData->getPulseTime()[k] ) < timeCutPixel )
@@ -2657,8 +2741,8 @@ void VImageCleaning::cleanImageWithTiming( VImageCleaningRunParameter* iImageCle
                 i_clustersize += fData->getSums()[i];
                 i_clustertime += ( fData->getSums()[i] * fData->getPulseTime()[i] );
                 
-                double xi = fData->getDetectorGeo()->getX()[i];
-                double yi = fData->getDetectorGeo()->getY()[i];
+                double xi = fData->getDetectorGeo()->getX( fData->getTelID() )[i];
+                double yi = fData->getDetectorGeo()->getY( fData->getTelID() )[i];
                 
                 i_cenx += ( fData->getSums()[i] * xi );
                 i_ceny += ( fData->getSums()[i] * yi );
@@ -2801,9 +2885,9 @@ void VImageCleaning::cleanImageWithTiming( VImageCleaningRunParameter* iImageCle
             i_ID = fData->getClusterID()[i];
             if( fData->getImage()[i] || fData->getBorder()[i] )
             {
-                for( unsigned int j = 0; j < fData->getDetectorGeo()->getNNeighbours()[i]; j++ )
+                for( unsigned int j = 0; j < fData->getDetectorGeo()->getNNeighbours( fData->getTelID() )[i]; j++ )
                 {
-                    unsigned int k = fData->getDetectorGeo()->getNeighbours()[i][j];
+                    unsigned int k = fData->getDetectorGeo()->getNeighbours( fData->getTelID() )[i][j];
                     
                     if( isFixed )
                     {
@@ -2966,11 +3050,11 @@ void VImageCleaning::mergeClusters()
         if( fData->getImage()[i] || fData->getBorder()[i] )
         {
             i_clusterID = fData->getClusterID()[i];
-            unsigned int i_neighbour_size = fData->getDetectorGeo()->getNNeighbours()[i];
+            unsigned int i_neighbour_size = fData->getDetectorGeo()->getNNeighbours( fData->getTelID() )[i];
             
             for( unsigned int j = 0; j < i_neighbour_size; j++ )
             {
-                unsigned int k = fData->getDetectorGeo()->getNeighbours()[i][j];
+                unsigned int k = fData->getDetectorGeo()->getNeighbours( fData->getTelID() )[i][j];
                 k_clusterID = fData->getClusterID()[k];
                 
                 if( ( fData->getImage()[k] || fData->getBorder()[k] ) && k_clusterID != 0 && ( unsigned int ) k_clusterID != fData->getClusterID()[i] )
@@ -3024,10 +3108,10 @@ void VImageCleaning::removeSmallClusters( int minPix )
         
         if( fData->getImage()[i] )
         {
-            unsigned int i_neighbour_size = fData->getDetectorGeo()->getNNeighbours()[i];
+            unsigned int i_neighbour_size = fData->getDetectorGeo()->getNNeighbours( fData->getTelID() )[i];
             for( unsigned int j = 0; j < i_neighbour_size; j++ )
             {
-                unsigned int k = fData->getDetectorGeo()->getNeighbours()[i][j];
+                unsigned int k = fData->getDetectorGeo()->getNeighbours( fData->getTelID() )[i][j];
                 if( fData->getImage()[k] )
                 {
                     dont_remove = true;
@@ -3041,7 +3125,7 @@ void VImageCleaning::removeSmallClusters( int minPix )
                 {
                     for( unsigned l = 0; l < i_neighbour_size; l++ )
                     {
-                        unsigned int m = fData->getDetectorGeo()->getNeighbours()[i][l];
+                        unsigned int m = fData->getDetectorGeo()->getNeighbours( fData->getTelID() )[i][l];
                         if( m != i && m < fData->getBorder().size() && ( fData->getBorder()[m] || fData->getImage()[m] ) )
                         {
                             c2++;
@@ -3063,17 +3147,17 @@ void VImageCleaning::removeSmallClusters( int minPix )
             fData->setClusterID( i, -99 );
             
             // remove the rest of the single core cluster (if it exists)
-            unsigned int i_neighbour_size = fData->getDetectorGeo()->getNNeighbours()[i];
+            unsigned int i_neighbour_size = fData->getDetectorGeo()->getNNeighbours( fData->getTelID() )[i];
             for( unsigned int j = 0; j < i_neighbour_size; j++ )
             {
-                unsigned int k = fData->getDetectorGeo()->getNeighbours()[i][j];
+                unsigned int k = fData->getDetectorGeo()->getNeighbours( fData->getTelID() )[i][j];
                 if( fData->getBorder()[k] )
                 {
                     fData->setBorder( k, false );
                     
-                    for( unsigned l = 0; l < fData->getDetectorGeo()->getNNeighbours()[k]; l++ )
+                    for( unsigned l = 0; l < fData->getDetectorGeo()->getNNeighbours( fData->getTelID() )[k]; l++ )
                     {
-                        unsigned int m = fData->getDetectorGeo()->getNeighbours()[k][l];
+                        unsigned int m = fData->getDetectorGeo()->getNeighbours( fData->getTelID() )[k][l];
                         if( fData->getBorder()[m] )
                         {
                             fData->setBorder( m, false );
@@ -3093,6 +3177,8 @@ void VImageCleaning::removeSmallClusters( int minPix )
 void VImageCleaning::fillImageBorderNeighbours()
 {
     fData->setImageBorderNeighbour( false );
+    vector< unsigned int >& i_offset = fData->getDetectorGeo()->getNeighbourTableOffset( fData->getTelID() );
+    vector< unsigned int >& i_neighbour = fData->getDetectorGeo()->getNeighbourTable( fData->getTelID() );
     for( unsigned int i = 0; i < fData->getNChannels(); i++ )
     {
         if( fData->getImage()[i] || fData->getBorder()[i] )
@@ -3100,10 +3186,13 @@ void VImageCleaning::fillImageBorderNeighbours()
             // a pixel is its own neighbour :-)
             fData->getImageBorderNeighbour()[i] = true;
             // loop over all neighbours
-            unsigned int i_neighbour_size = fData->getDetectorGeo()->getNNeighbours()[i];
-            for( unsigned int j = 0; j < i_neighbour_size; j++ )
+            if( i + 1 >= i_offset.size() )
+            {
+                continue;
+            }
+            for( unsigned int j = i_offset[i]; j < i_offset[i + 1]; j++ )
             {
-                unsigned int k = fData->getDetectorGeo()->getNeighbours()[i][j];
+                unsigned int k = i_neighbour[j];
                 if( k < fData->getImageBorderNeighbour().size() && !fData->getDead()[k] )
                 {
                     fData->getImageBorderNeighbour()[k] = true;
@@ -3128,10 +3217,10 @@ void VImageCleaning::recoverImagePixelNearDeadPixel()
         if( fData->getImage()[i] )
         {
             i_neigh = false;
-            i_neighbour_size = fData->getDetectorGeo()->getNNeighbours()[i];
+            i_neighbour_size = fData->getDetectorGeo()->getNNeighbours( fData->getTelID() )[i];
             for( unsigned int j = 0; j < i_neighbour_size; j++ )
             {
-                k = fData->getDetectorGeo()->getNeighbours()[i][j];
+                k = fData->getDetectorGeo()->getNeighbours( fData->getTelID() )[i][j];
                 if( k < fData->getBorder().size() && ( fData->getBorder()[k] || fData->getImage()[k] ) )
                 {
                     fData->setImage( i, true );
@@ -3142,7 +3231,7 @@ void VImageCleaning::recoverImagePixelNearDeadPixel()
                 {
                     for( unsigned l = 0; l < i_neighbour_size; l++ )
                     {
-                        unsigned int m = fData->getDetectorGeo()->getNeighbours()[i][l];
+                        unsigned int m = fData->getDetectorGeo()->getNeighbours( fData->getTelID() )[i][l];
                         if( m != i && m < fData->getBorder().size() && ( fData->getBorder()[m] || fData->getImage()[m] ) )
                         {
                             fData->setImage( i, true );
@@ -3359,11 +3448,11 @@ void VImageCleaning::cleanImageTraceCorrelate( VImageCleaningRunParameter* iImag
             {
                 unsigned int i = ImagePixelList[o];
                 //Get the neighbours of this image pixel
-                for( unsigned int j = 0; j < fData->getDetectorGeo()->getNNeighbours()[i]; j++ )
+                for( unsigned int j = 0; j < fData->getDetectorGeo()->getNNeighbours( fData->getTelID() )[i]; j++ )
                 {
                     //Check if it is already included in the neighbour list
                     bool have = false;
-                    k = fData->getDetectorGeo()->getNeighbours()[i][j];
+                    k = fData->getDetectorGeo()->getNeighbours( fData->getTelID() )[i][j];
                     for( unsigned int p = 0; p < NearbyPixelList.size(); p++ )
                     {
                         if( NearbyPixelList[p] == k )
@@ -86,8 +86,8 @@ void VImageParameterCalculation::calcTimingParameters( bool iIsSecondPass )
         // if( ( fData->getImage()[i] || fData->getBorder()[i] ) && fData->getPulseTime()[i] > 0. && !fData->getHiLo()[i] )
         if( ( fData->getImage()[i] || fData->getBorder()[i] ) && fData->getPulseTime()[i] > -998 && !fData->getHiLo()[i] )
         {
-            double xi = getDetectorGeometry()->getX()[i];
-            double yi = getDetectorGeometry()->getY()[i];
+            double xi = getDetectorGeometry()->getX( fData->getTelID() )[i];
+            double yi = getDetectorGeometry()->getY( fData->getTelID() )[i];
             // loop over image tubes
             double xpmt = xi - fParGeo->cen_x;
             double ypmt = yi - fParGeo->cen_y;
@@ -329,8 +329,8 @@ void VImageParameterCalculation::muonRingFinder()
         if( fData->getImage()[i] || fData->getBorder()[i] )
         {
             counter++;
-            xi = getDetectorGeometry()->getX()[i];
-            yi = getDetectorGeometry()->getY()[i];
+            xi = getDetectorGeometry()->getX( fData->getTelID() )[i];
+            yi = getDetectorGeometry()->getY( fData->getTelID() )[i];
             tmp = sqrt( pow( ( xi - x0[0] ), 2 ) + pow( ( yi - y0[0] ) , 2 ) );
             rTotal += tmp;
             rSquaredTotal += tmp * tmp;
@@ -375,8 +375,8 @@ void VImageParameterCalculation::muonRingFinder()
         {
             if( fData->getImage()[i] || fData->getBorder()[i] )
             {
-                xi = getDetectorGeometry()->getX()[i];
-                yi = getDetectorGeometry()->getY()[i];
+                xi = getDetectorGeometry()->getX( fData->getTelID() )[i];
+                yi = getDetectorGeometry()->getY( fData->getTelID() )[i];
                 tmp = sqrt( pow( ( xi - x0[1] ), 2 ) + pow( ( yi - y0[1] ) , 2 ) );
                 rTotal += tmp;
                 rSquaredTotal += tmp * tmp;
@@ -397,8 +397,8 @@ void VImageParameterCalculation::muonRingFinder()
             {
                 if( fData->getImage()[i] || fData->getBorder()[i] )
                 {
-                    xi = getDetectorGeometry()->getX()[i];
-                    yi = getDetectorGeometry()->getY()[i];
+                    xi = getDetectorGeometry()->getX( fData->getTelID() )[i];
+                    yi = getDetectorGeometry()->getY( fData->getTelID() )[i];
                     tmp = sqrt( pow( ( xi - x0[1] ), 2 ) + pow( ( yi - y0[1] ) , 2 ) );
                     rTotal += tmp;
                     rSquaredTotal += tmp * tmp;
@@ -437,8 +437,8 @@ void VImageParameterCalculation::muonRingFinder()
         {
             if( fData->getImage()[i] || fData->getBorder()[i] )
             {
-                xi = getDetectorGeometry()->getX()[i];
-                yi = getDetectorGeometry()->getY()[i];
+                xi = getDetectorGeometry()->getX( fData->getTelID() )[i];
+                yi = getDetectorGeometry()->getY( fData->getTelID() )[i];
                 tmp = sqrt( pow( ( xi - x0[1] ), 2 ) + pow( ( yi - y0[1] ) , 2 ) );
                 rTotal += tmp;
                 rSquaredTotal += tmp * tmp;
@@ -458,8 +458,8 @@ void VImageParameterCalculation::muonRingFinder()
             {
                 if( fData->getImage()[i] || fData->getBorder()[i] )
                 {
-                    xi = getDetectorGeometry()->getX()[i];
-                    yi = getDetectorGeometry()->getY()[i];
+                    xi = getDetectorGeometry()->getX( fData->getTelID() )[i];
+                    yi = getDetectorGeometry()->getY( fData->getTelID() )[i];
                     tmp = sqrt( pow( ( xi - x0[1] ), 2 ) + pow( ( yi - y0[1] ) , 2 ) );
                     rTotal += tmp;
                     rSquaredTotal += tmp * tmp;
@@ -550,8 +550,8 @@ void VImageParameterCalculation::sizeInMuonRing()
     
     for( i = 0; i < fData->getSums().size(); i++ )
     {
-        xi = getDetectorGeometry()->getX()[i];
-        yi = getDetectorGeometry()->getY()[i];
+        xi = getDetectorGeometry()->getX( fData->getTelID() )[i];
+        yi = getDetectorGeometry()->getY( fData->getTelID() )[i];
         double rp = sqrt( pow( xi - x0 , 2 ) + pow( yi - y0, 2 ) );
         
         if( rp > radius - 0.15 && rp < radius + 0.15 )
@@ -639,8 +639,8 @@ void VImageParameterCalculation::muonPixelDistribution()
         if( fData->getImage()[i] || fData->getBorder()[i] )
         {
             totalPixels++;
-            xi = getDetectorGeometry()->getX()[i];
-            yi = getDetectorGeometry()->getY()[i];
+            xi = getDetectorGeometry()->getX( fData->getTelID() )[i];
+            yi = getDetectorGeometry()->getY( fData->getTelID() )[i];
             rp = sqrt( pow( xi - x0 , 2 ) + pow( yi - y0, 2 ) );
             phi = 180.0 / TMath::Pi() * atan2( yi - y0 , xi - x0 ) + 180.;
             
@@ -857,8 +857,8 @@ void VImageParameterCalculation::calcTriggerParameters( vector<bool> fTrigger )
         {
             trig_tubes += 1;
             
-            double xi = getDetectorGeometry()->getX()[j];
-            double yi = getDetectorGeometry()->getY()[j];
+            double xi = getDetectorGeometry()->getX( fData->getTelID() )[j];
+            double yi = getDetectorGeometry()->getY( fData->getTelID() )[j];
             
             sumx_trig += xi;
             sumy_trig += yi;
@@ -884,6 +884,25 @@ void VImageParameterCalculation::calcTriggerParameters( vector<bool> fTrigger )
 }
 
 
+/*
+ * cache pixel positions of the current telescope as double arrays
+ * (input for the vectorized moment calculation)
+ */
+void VImageParameterCalculation::cacheCameraGeometry()
+{
+    unsigned int iTelID = fData->getTelID();
+    if( iTelID >= fPixelX.size() )
+    {
+        fPixelX.resize( iTelID + 1 );
+        fPixelY.resize( iTelID + 1 );
+    }
+    if( fPixelX[iTelID].size() != getDetectorGeometry()->getX( fData->getTelID() ).size() )
+    {
+        fPixelX[iTelID].assign( getDetectorGeometry()->getX( fData->getTelID() ).begin(), getDetectorGeometry()->getX( fData->getTelID() ).end() );
+        fPixelY[iTelID].assign( getDetectorGeometry()->getY( fData->getTelID() ).begin(), getDetectorGeometry()->getY( fData->getTelID() ).end() );
+    }
+}
+
 /*
  *   calculate image parameters
  *   (classic style)
@@ -921,17 +940,7 @@ void VImageParameterCalculation::calcParameters()
         exit( EXIT_FAILURE );
     }
     
-    double sumsig = 0;
     double sumsig_2 = 0.;
-    double sumxsig = 0;
-    double sumysig = 0;
-    double sumx2sig = 0;
-    double sumy2sig = 0;
-    double sumxysig = 0;
-    double sumx3sig = 0;
-    double sumy3sig = 0;
-    double sumx2ysig = 0;
-    double sumxy2sig = 0;
     int pntubes = 0;
     int pntubesBrightNoImage = 0;
     double sumOuterRing = 0.;                     // sum signal of image in outer ring
@@ -986,81 +995,85 @@ void VImageParameterCalculation::calcParameters()
     
     setImageBorderPixelPosition( fParGeo );
     
-    // loop over all pixels
-    for( unsigned int j = 0; j < fData->getSums().size(); j++ )
+    // image and border pixels
+    unsigned int i_npixel = fData->getSums().size();
+    fPixelMask.assign( i_npixel, 0 );
+    fImageBorderPixel.clear();
+    for( unsigned int j = 0; j < i_npixel; j++ )
     {
         if( fData->getBrightNonImage()[j] )
         {
             pntubesBrightNoImage++;
         }
-        
-        // loop over image tubes
-        // select image or border pixel
         if( fData->getImage()[j] || fData->getBorder()[j] )
         {
-            pntubes += 1;
-            
-            double xi = getDetectorGeometry()->getX()[j];
-            double yi = getDetectorGeometry()->getY()[j];
-            
-            double si = ( double )fData->getSums()[j]; // charge (dc)
-            double si2 = ( double )fData->getSums2()[j];
-            // image weighting with squared intensity
-            // (non standard from traditional image calculation!)
-            if( fData->getRunParameter() && fData->getRunParameter()->fSquaredImageCalculation )
-            {
-                si *= si;
-                si2 *= si2;
-            }
-            sumsig += si;
-            sumsig_2 += si2;
-            // sum in outer ring
-            if( getDetectorGeometry()->isEdgePixel()[j] )
-            {
-                sumOuterRing += si;
-            }
-            // sum around dead pixels
-            if( j < getDetectorGeometry()->getNeighbours().size() || getDetectorGeometry()->getNNeighbours()[j] < getDetectorGeometry()->getMaxNeighbour() )
+            fPixelMask[j] = 1;
+            fImageBorderPixel.push_back( j );
+        }
+    }
+    pntubes = fImageBorderPixel.size();
+    
+    // image weighting with squared intensity
+    // (non standard from traditional image calculation!)
+    bool iSquaredImageCalculation = ( fData->getRunParameter() && fData->getRunParameter()->fSquaredImageCalculation );
+    
+    // first to third order moments of the charge distribution (single sweep over all pixels)
+    cacheCameraGeometry();
+    double i_moments[10];
+    VTraceKernels::imageMoments( fPixelX[fData->getTelID()].data(), fPixelY[fData->getTelID()].data(),
+                                 &fData->getSums()[0], &fPixelMask[0],
+                                 TMath::Min( i_npixel, ( unsigned int )fPixelX[fData->getTelID()].size() ),
+                                 iSquaredImageCalculation, i_moments );
+    const double sumsig    = i_moments[0];
+    const double sumxsig   = i_moments[1];
+    const double sumysig   = i_moments[2];
+    const double sumx2sig  = i_moments[3];
+    const double sumy2sig  = i_moments[4];
+    const double sumxysig  = i_moments[5];
+    const double sumx3sig  = i_moments[6];
+    const double sumy3sig  = i_moments[7];
+    const double sumx2ysig = i_moments[8];
+    const double sumxy2sig = i_moments[9];
+    
+    // loop over image and border pixels
+    for( unsigned int p = 0; p < fImageBorderPixel.size(); p++ )
+    {
+        unsigned int j = fImageBorderPixel[p];
+        double si = ( double )fData->getSums()[j]; // charge (dc)
+        double si2 = ( double )fData->getSums2()[j];
+        if( iSquaredImageCalculation )
+        {
+            si *= si;
+            si2 *= si2;
+        }
+        sumsig_2 += si2;
+        // sum in outer ring
+        if( getDetectorGeometry()->isEdgePixel( fData->getTelID() )[j] )
+        {
+            sumOuterRing += si;
+        }
+        // sum around dead pixels
+        if( j < getDetectorGeometry()->getNeighbours( fData->getTelID() ).size() || getDetectorGeometry()->getNNeighbours( fData->getTelID() )[j] < getDetectorGeometry()->getMaxNeighbour( fData->getTelID() ) )
+        {
+            bool iDead = false;
+            for( unsigned int n = 0; n < getDetectorGeometry()->getNeighbours( fData->getTelID() )[j].size(); n++ )
             {
-                bool iDead = false;
-                for( unsigned int n = 0; n < getDetectorGeometry()->getNeighbours()[j].size(); n++ )
-                {
-                    unsigned int k = getDetectorGeometry()->getNeighbours()[j][n];
-                    if( k < fData->getDead().size() && fData->getDead( k, fData->getHiLo()[k] ) )
-                    {
-                        sumDeadRing += si;
-                        iDead = true;
-                        break;              // each pixel should only be added once
-                    }
-                }
-                if( !iDead && getDetectorGeometry()->getNNeighbours()[j] < getDetectorGeometry()->getMaxNeighbour() )
+                unsigned int k = getDetectorGeometry()->getNeighbours( fData->getTelID() )[j][n];
+                if( k < fData->getDead().size() && fData->getDead( k, fData->getHiLo()[k] ) )
                 {
                     sumDeadRing += si;
+                    iDead = true;
+                    break;              // each pixel should only be added once
                 }
             }
-            if( fData->getHiLo()[j] )
+            if( !iDead && getDetectorGeometry()->getNNeighbours( fData->getTelID() )[j] < getDetectorGeometry()->getMaxNeighbour( fData->getTelID() ) )
             {
-                sumLowGain += si2;
+                sumDeadRing += si;
             }
-            
-            const double sixi = si * xi;
-            const double siyi = si * yi;
-            
-            sumxsig += sixi;
-            sumysig += siyi;
-            
-            const double sixi2 = sixi * xi;
-            const double siyi2 = siyi * yi;
-            const double sixiyi = sixi * yi;
-            
-            sumx2sig += sixi2;
-            sumy2sig += siyi2;
-            sumxysig += sixiyi;
-            
-            sumx3sig += sixi2 * xi;
-            sumy3sig += siyi2 * yi;
-            sumx2ysig += sixi2 * yi;
-            sumxy2sig += siyi2 * xi;
+        }
+        if( fData->getHiLo()[j] )
+        {
+            sumLowGain += si2;
         }
     }
     if( fDebug )
@@ -1422,8 +1435,8 @@ double VImageParameterCalculation::getFractionOfImageBorderPixelUnderImage( doub
         for( unsigned int i = 0; i < fData->getImage().size(); i++ )
         {
             // pixel coordinates rotated into frame of image ellipse
-            double xi =     cosphi * ( getDetectorGeometry()->getX()[i] - cen_x ) + sinphi * ( getDetectorGeometry()->getY()[i] - cen_y );
-            double yi = -1.*sinphi * ( getDetectorGeometry()->getX()[i] - cen_x ) + cosphi * ( getDetectorGeometry()->getY()[i] - cen_y );
+            double xi =     cosphi * ( getDetectorGeometry()->getX( fData->getTelID() )[i] - cen_x ) + sinphi * ( getDetectorGeometry()->getY( fData->getTelID() )[i] - cen_y );
+            double yi = -1.*sinphi * ( getDetectorGeometry()->getX( fData->getTelID() )[i] - cen_x ) + cosphi * ( getDetectorGeometry()->getY( fData->getTelID() )[i] - cen_y );
             
             // check if these pixels are inside the image ellipse
             if( xi * xi / length / length / i_ImageCoverFactor / i_ImageCoverFactor + yi * yi / width / width / i_ImageCoverFactor / i_ImageCoverFactor < 1. )
@@ -1473,10 +1486,10 @@ void VImageParameterCalculation::setImageBorderPixelPosition( VImageParameter* i
         {
             if( fData->getImage()[i] || fData->getBorder()[i] )
             {
-                if( fData->getDetectorGeometry() && i < fData->getDetectorGeometry()->getX().size() && i < fData->getDetectorGeometry()->getY().size() )
+                if( fData->getDetectorGeometry() && i < fData->getDetectorGeometry()->getX( fData->getTelID() ).size() && i < fData->getDetectorGeometry()->getY( fData->getTelID() ).size() )
                 {
-                    i_x.push_back( fData->getDetectorGeometry()->getX()[i] );
-                    i_y.push_back( fData->getDetectorGeometry()->getY()[i] );
+                    i_x.push_back( fData->getDetectorGeometry()->getX( fData->getTelID() )[i] );
+                    i_y.push_back( fData->getDetectorGeometry()->getY( fData->getTelID() )[i] );
                 }
             }
         }
@@ -55,6 +55,14 @@ void VImageParameterFitter::initMinuit( int iVmode )
     {
         fLLDebug = true;
     }
+    fNormal2D = 0;
+    // rotated normal distribution: minimizer with analytic derivatives
+    // (no minuit needed)
+    if( bRotatedNormalDistributionFit )
+    {
+        fLLMinimizer.setDebug( fLLDebug );
+        return;
+    }
     unsigned int iFitParameter = 6;
     if( fData->getRunParameter()->fMinimizeTimeGradient )
     {
@@ -96,6 +104,10 @@ void VImageParameterFitter::initMinuit( int iVmode )
 
     FCN is get_LL_imageParameter_2DGauss()
 
+    The fit of the rotated normal distribution (default) uses VImageParameterLLMinimizer
+    (analytic gradient and Hessian, no global minuit object; starting values from the
+    geometrical analysis).
+
     Only signals in image/border pixels are taken into account, all other are set to zero.
 
     Signals are estimated for dead pixels.
@@ -132,6 +144,12 @@ vector<bool> VImageParameterFitter::calcLL( VImageParameter* iParGeo,
         cout << "VImageParameterCalculation::calcLL error: no image parameters given " << endl;
         return a;
     }
+    // minuit is shared between all fitters (one per telescope analysis context)
+    // (not used for the rotated normal distribution fit)
+    if( !bRotatedNormalDistributionFit && fLLFitter )
+    {
+        fLLFitter->SetObjectFit( this );
+    }
     fLLDebug = false;
     if( fLLDebug )
     {
@@ -153,17 +171,27 @@ vector<bool> VImageParameterFitter::calcLL( VImageParameter* iParGeo,
     defineFitParameters();
     
     // now do the minimization
-    fLLFitter->Command( "MIGRAD" );
-    
-    // fit statistics
-    getFitStatistics();
-    
-    // call HESSE in case error calculation failed
-    if( fParLL->Fitstat < 3 )
+    if( bRotatedNormalDistributionFit )
     {
-        fLLFitter->Command( "HESSE" );
+        // errors are calculated from the analytic Hessian
+        // (no separate HESSE step needed)
+        fLLMinimizer.minimize();
         getFitStatistics();
     }
+    else
+    {
+        fLLFitter->Command( "MIGRAD" );
+        
+        // fit statistics
+        getFitStatistics();
+        
+        // call HESSE in case error calculation failed
+        if( fParLL->Fitstat < 3 )
+        {
+            fLLFitter->Command( "HESSE" );
+            getFitStatistics();
+        }
+    }
     
     // fit results
     getFitResults();
@@ -185,8 +213,8 @@ double VImageParameterFitter::calculatePixelBrightness( unsigned int iChannel,
 {
     double f = 0;
     // get channel coordinates
-    double x = getDetectorGeometry()->getX()[iChannel];
-    double y = getDetectorGeometry()->getY()[iChannel];
+    double x = getDetectorGeometry()->getX( fData->getTelID() )[iChannel];
+    double y = getDetectorGeometry()->getY( fData->getTelID() )[iChannel];
     // calculate 2D-gauss
     if( bRotatedNormalDistributionFit )
     {
@@ -440,9 +468,9 @@ double VImageParameterFitter::getLL_paramameterlimits_cen( double dist_limit,
     {
         double camera_pixel_size = 0.1;
         // assume that zero pixel is a typical pixel
-        if( fData->getDetectorGeometry()->getTubeRadius().size() > 0 )
+        if( fData->getDetectorGeometry()->getTubeRadius( fData->getTelID() ).size() > 0 )
         {
-            camera_pixel_size = 5.*fData->getDetectorGeometry()->getTubeRadius()[0];
+            camera_pixel_size = 5.*fData->getDetectorGeometry()->getTubeRadius( fData->getTelID() )[0];
             if( camera_pixel_size < 0.1 )
             {
                 camera_pixel_size = 5.*0.1;
@@ -679,9 +707,9 @@ double VImageParameterFitter::fill_pixel_sums( bool iUseSums2 )
         if( j < fData->getImageBorderNeighbour().size() && fData->getImageBorderNeighbour()[j] )
         {
             // pixel position in the camera
-            double xi = getDetectorGeometry()->getX()[j];
-            double yi = getDetectorGeometry()->getY()[j];
-            double ri = fData->getDetectorGeo()->getTubeRadius()[j];
+            double xi = getDetectorGeometry()->getX( fData->getTelID() )[j];
+            double yi = getDetectorGeometry()->getY( fData->getTelID() )[j];
+            double ri = fData->getDetectorGeo()->getTubeRadius( fData->getTelID() )[j];
             fll_X.push_back( xi );
             fll_Y.push_back( yi );
             fll_R.push_back( ri );
@@ -791,35 +819,41 @@ void VImageParameterFitter::resetFitParameters()
 
 void VImageParameterFitter::defineFitParameters()
 {
+    // data for minimizer
+    if( bRotatedNormalDistributionFit )
+    {
+        fLLMinimizer.setData( &fll_X, &fll_Y, &fll_Sums, &fll_T, minimize_time_gradient_for_this_event() );
+    }
     // don't know if this step parameter is the best
+    // (minuit only)
     double step = 1.e-4;
-    fLLFitter->Release( 0 );
-    fLLFitter->Release( 1 );
-    fLLFitter->Release( 2 );
-    fLLFitter->Release( 3 );
-    fLLFitter->Release( 4 );
+    releaseFitParameter( 0 );
+    releaseFitParameter( 1 );
+    releaseFitParameter( 2 );
+    releaseFitParameter( 3 );
+    releaseFitParameter( 4 );
     if( bRotatedNormalDistributionFit )
     {
-        fLLFitter->DefineParameter( 0, "phi",
-                                    phi,
-                                    step,
-                                    -40.*M_PI,
-                                    40.*M_PI );
+        setFitParameter( 0, "phi",
+                         phi,
+                         step,
+                         -40.*M_PI,
+                         40.*M_PI );
     }
     else
     {
-        fLLFitter->DefineParameter( 0, "rho",
-                                    rho,
-                                    step,
-                                    getLL_paramameterlimits_rho( rho, -1. ),
-                                    getLL_paramameterlimits_rho( rho, 1. ) );
+        setFitParameter( 0, "rho",
+                         rho,
+                         step,
+                         getLL_paramameterlimits_rho( rho, -1. ),
+                         getLL_paramameterlimits_rho( rho, 1. ) );
     }
     // cen_x starting values
-    fLLFitter->DefineParameter( 1, "meanX",
-                                cen_x,
-                                step,
-                                getLL_paramameterlimits_cen( fdistXmin, cen_x, sigmaX, -1. ),
-                                getLL_paramameterlimits_cen( fdistXmin, cen_x, sigmaX, 1. ) );
+    setFitParameter( 1, "meanX",
+                     cen_x,
+                     step,
+                     getLL_paramameterlimits_cen( fdistXmin, cen_x, sigmaX, -1. ),
+                     getLL_paramameterlimits_cen( fdistXmin, cen_x, sigmaX, 1. ) );
     // sigma x starting values
     double sigma_x_L = sigmaX / 4.;
     double sigma_x_U = 2.*sigmaX + 1.;
@@ -828,17 +862,17 @@ void VImageParameterFitter::defineFitParameters()
         sigma_x_L = fParGeo->width * 0.5;
         sigma_x_U = fParGeo->length * 2.5;
     }
-    fLLFitter->DefineParameter( 2, "sigmaX",
-                                sigmaX,
-                                step,
-                                sigma_x_L,
-                                sigma_x_U );
+    setFitParameter( 2, "sigmaX",
+                     sigmaX,
+                     step,
+                     sigma_x_L,
+                     sigma_x_U );
     // cen_y starting values
-    fLLFitter->DefineParameter( 3, "meanY",
-                                cen_y,
-                                step,
-                                getLL_paramameterlimits_cen( fdistYmin, cen_y, sigmaY, -1. ),
-                                getLL_paramameterlimits_cen( fdistYmin, cen_y, sigmaY, 1. ) );
+    setFitParameter( 3, "meanY",
+                     cen_y,
+                     step,
+                     getLL_paramameterlimits_cen( fdistYmin, cen_y, sigmaY, -1. ),
+                     getLL_paramameterlimits_cen( fdistYmin, cen_y, sigmaY, 1. ) );
     // sigma x starting values
     double sigma_y_L = sigmaY / 4.;
     double sigma_y_U = 2.*sigmaY + 1.;
@@ -847,14 +881,14 @@ void VImageParameterFitter::defineFitParameters()
         sigma_y_L = fParGeo->width * 0.5;
         sigma_y_U = fParGeo->length * 2.5;
     }
-    fLLFitter->DefineParameter( 4, "sigmaY",
-                                sigmaY,
-                                step,
-                                sigma_y_L,
-                                sigma_y_U );
+    setFitParameter( 4, "sigmaY",
+                     sigmaY,
+                     step,
+                     sigma_y_L,
+                     sigma_y_U );
                                 
     // signal
-    fLLFitter->DefineParameter( 5, "signal", signal, step, 0., 1.e6 );
+    setFitParameter( 5, "signal", signal, step, 0., 1.e6 );
     // time gradient analysis
     if( fData->getRunParameter()->fMinimizeTimeGradient )
     {
@@ -863,20 +897,72 @@ void VImageParameterFitter::defineFitParameters()
         {
             toffset_start = fData->getXGraph( false )->Eval( 0. );
         }
-        fLLFitter->DefineParameter( 6, "toffset", toffset_start, step, toffset_start - 10., toffset_start + 10. );
-        fLLFitter->DefineParameter( 7, "tgrad", fParGeo->tgrad_x, step, -1.e3, 1.e3 );
-        fLLFitter->DefineParameter( 8, "tchi2", sqrt( fParGeo->tchisq_x ), step, 0.1, 2.*sqrt( fParGeo->tchisq_x ) );
+        setFitParameter( 6, "toffset", toffset_start, step, toffset_start - 10., toffset_start + 10. );
+        setFitParameter( 7, "tgrad", fParGeo->tgrad_x, step, -1.e3, 1.e3 );
+        setFitParameter( 8, "tchi2", sqrt( fParGeo->tchisq_x ), step, 0.1, 2.*sqrt( fParGeo->tchisq_x ) );
         if( minimize_time_gradient_for_this_event() )
         {
-            fLLFitter->Release( 6 );
-            fLLFitter->Release( 7 );
+            releaseFitParameter( 6 );
+            releaseFitParameter( 7 );
         }
         else
         {
-            fLLFitter->FixParameter( 6 );
-            fLLFitter->FixParameter( 7 );
+            fixFitParameter( 6 );
+            fixFitParameter( 7 );
         }
-        fLLFitter->FixParameter( 8 );
+        fixFitParameter( 8 );
+    }
+}
+
+/*
+   fit parameter definitions and results
+   (analytic minimizer for rotated normal distribution, minuit otherwise)
+*/
+void VImageParameterFitter::setFitParameter( unsigned int i, string iName, double iValue, double iStep, double iMin, double iMax )
+{
+    if( bRotatedNormalDistributionFit )
+    {
+        fLLMinimizer.setParameter( i, iName, iValue, iMin, iMax );
+    }
+    else
+    {
+        fLLFitter->DefineParameter( i, iName.c_str(), iValue, iStep, iMin, iMax );
+    }
+}
+
+void VImageParameterFitter::fixFitParameter( unsigned int i )
+{
+    if( bRotatedNormalDistributionFit )
+    {
+        fLLMinimizer.fixParameter( i );
+    }
+    else
+    {
+        fLLFitter->FixParameter( i );
+    }
+}
+
+void VImageParameterFitter::releaseFitParameter( unsigned int i )
+{
+    if( bRotatedNormalDistributionFit )
+    {
+        fLLMinimizer.releaseParameter( i );
+    }
+    else
+    {
+        fLLFitter->Release( i );
+    }
+}
+
+void VImageParameterFitter::getFitParameter( unsigned int i, double& iValue, double& iError )
+{
+    if( bRotatedNormalDistributionFit )
+    {
+        fLLMinimizer.getParameter( i, iValue, iError );
+    }
+    else
+    {
+        fLLFitter->GetParameter( i, iValue, iError );
     }
 }
 
@@ -888,7 +974,16 @@ void VImageParameterFitter::getFitStatistics()
     int nvpar = 0;
     int nparx = 0;
     int nstat = 0;
-    fLLFitter->mnstat( amin, edm, errdef, nvpar, nparx, nstat );
+    if( bRotatedNormalDistributionFit )
+    {
+        nstat = fLLMinimizer.getFitStatus();
+        amin = fLLMinimizer.getFmin();
+        edm = fLLMinimizer.getEDM();
+    }
+    else
+    {
+        fLLFitter->mnstat( amin, edm, errdef, nvpar, nparx, nstat );
+    }
     fParLL->Fitstat = nstat;
     fParLL->Fitmin = amin;
     fParLL->Fitedm = edm;
@@ -903,22 +998,22 @@ void VImageParameterFitter::getFitResults()
 {
     if( bRotatedNormalDistributionFit )
     {
-        fLLFitter->GetParameter( 0, phi, dphi );
+        getFitParameter( 0, phi, dphi );
     }
     else
     {
-        fLLFitter->GetParameter( 0, rho, drho );
+        getFitParameter( 0, rho, drho );
     }
-    fLLFitter->GetParameter( 1, cen_x, dcen_x );
-    fLLFitter->GetParameter( 2, sigmaX, dsigmaX );
-    fLLFitter->GetParameter( 3, cen_y, dcen_y );
-    fLLFitter->GetParameter( 4, sigmaY, dsigmaY );
-    fLLFitter->GetParameter( 5, signal, dsignal );
+    getFitParameter( 1, cen_x, dcen_x );
+    getFitParameter( 2, sigmaX, dsigmaX );
+    getFitParameter( 3, cen_y, dcen_y );
+    getFitParameter( 4, sigmaY, dsigmaY );
+    getFitParameter( 5, signal, dsignal );
     if( minimize_time_gradient_for_this_event() )
     {
-        fLLFitter->GetParameter( 6, toffset, dtoffset );
-        fLLFitter->GetParameter( 7, tgrad, dtgrad );
-        fLLFitter->GetParameter( 8, tchi2, dtchi2 );
+        getFitParameter( 6, toffset, dtoffset );
+        getFitParameter( 7, tgrad, dtgrad );
+        getFitParameter( 8, tchi2, dtchi2 );
     }
     if( fLLDebug )
     {
@@ -1064,34 +1159,34 @@ void VImageParameterFitter::calculate_image_size( bool iUseSums2,
     if( fParLL->Fitstat > 0 )
     {
         // assume that all pixel are of the same geometrical size
-        unsigned int iCentreTube = fData->getDetectorGeometry()->getCameraCentreTubeIndex();
+        unsigned int iCentreTube = fData->getDetectorGeometry()->getCameraCentreTubeIndex( fData->getTelID() );
         if( iCentreTube < 9999 )
         {
             // make sure that width is not close to zero (can happen when all pixels are on a line)
-            if( fData->getDetectorGeometry()->getTubeRadius().size() > iCentreTube
-                    && fData->getDetectorGeometry()->getTubeRadius()[iCentreTube] > 0. )
+            if( fData->getDetectorGeometry()->getTubeRadius( fData->getTelID() ).size() > iCentreTube
+                    && fData->getDetectorGeometry()->getTubeRadius( fData->getTelID() )[iCentreTube] > 0. )
             {
-                if( sigmaX < fData->getDetectorGeometry()->getTubeRadius()[iCentreTube] * 0.1 )
+                if( sigmaX < fData->getDetectorGeometry()->getTubeRadius( fData->getTelID() )[iCentreTube] * 0.1 )
                 {
-                    sigmaX = fData->getDetectorGeometry()->getTubeRadius()[iCentreTube] * 0.1;
+                    sigmaX = fData->getDetectorGeometry()->getTubeRadius( fData->getTelID() )[iCentreTube] * 0.1;
                     fWidthResetted = true;
                 }
-                if( sigmaY < fData->getDetectorGeometry()->getTubeRadius()[iCentreTube] * 0.1 )
+                if( sigmaY < fData->getDetectorGeometry()->getTubeRadius( fData->getTelID() )[iCentreTube] * 0.1 )
                 {
-                    sigmaY = fData->getDetectorGeometry()->getTubeRadius()[iCentreTube] * 0.1;
+                    sigmaY = fData->getDetectorGeometry()->getTubeRadius( fData->getTelID() )[iCentreTube] * 0.1;
                     fWidthResetted = true;
                 }
             }
             // recentre fitted image to camera centre
             double cen_x_recentered = 0.;
             double cen_y_recentered = 0.;
-            if( fData->getDetectorGeometry()->getTubeRadius().size() > iCentreTube
-                    && fData->getDetectorGeometry()->getTubeRadius()[iCentreTube] > 0. )
+            if( fData->getDetectorGeometry()->getTubeRadius( fData->getTelID() ).size() > iCentreTube
+                    && fData->getDetectorGeometry()->getTubeRadius( fData->getTelID() )[iCentreTube] > 0. )
             {
-                cen_x_recentered = cen_x - fData->getDetectorGeometry()->getTubeRadius()[iCentreTube] * 2.
-                                   * ( int )( cen_x / fData->getDetectorGeometry()->getTubeRadius()[iCentreTube] / 2. );
-                cen_y_recentered = cen_y - fData->getDetectorGeometry()->getTubeRadius()[iCentreTube] * 2.
-                                   * ( int )( cen_y / fData->getDetectorGeometry()->getTubeRadius()[iCentreTube] / 2. );
+                cen_x_recentered = cen_x - fData->getDetectorGeometry()->getTubeRadius( fData->getTelID() )[iCentreTube] * 2.
+                                   * ( int )( cen_x / fData->getDetectorGeometry()->getTubeRadius( fData->getTelID() )[iCentreTube] / 2. );
+                cen_y_recentered = cen_y - fData->getDetectorGeometry()->getTubeRadius( fData->getTelID() )[iCentreTube] * 2.
+                                   * ( int )( cen_y / fData->getDetectorGeometry()->getTubeRadius( fData->getTelID() )[iCentreTube] / 2. );
             }
             if( fLLDebug )
             {
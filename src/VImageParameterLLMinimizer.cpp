@@ -0,0 +1,634 @@
+/*! \class VImageParameterLLMinimizer
+    \brief log-likelihood fit of a rotated 2D Gaussian to camera images
+
+    Minimizer for the image model used in VImageParameterFitter
+    (see get_LL_imageParameter_2DGaussRotated()):
+
+    - Poisson log-likelihood of the pixel sums for a rotated 2D Gaussian
+      (probability density at the pixel centre)
+    - optional time gradient term (line along the rotated x-axis)
+
+    Gradient and Hessian of the negative log-likelihood are calculated
+    analytically. The minimization is a Newton iteration with
+    Levenberg-Marquardt damping; parameter limits are box constraints
+    (parameters at a limit with the gradient pointing outwards are kept fixed
+    for the step).
+
+    Errors are calculated from the inverse Hessian at the minimum
+    (negative log-likelihood, i.e. equivalent to UP=0.5 in Minuit).
+
+    Fit status (same meaning as the Minuit error matrix status):
+
+    - 0: no minimization done
+    - 1: no convergence (or error matrix not available)
+    - 2: Hessian not positive definite, forced to be positive definite
+    - 3: converged, full accurate error matrix
+
+    All data are members of the class (no global variables); one instance
+    per thread / telescope analysis context.
+
+*/
+
+#include "VImageParameterLLMinimizer.h"
+
+VImageParameterLLMinimizer::VImageParameterLLMinimizer()
+{
+    fDebug = false;
+    
+    fX = 0;
+    fY = 0;
+    fSums = 0;
+    fT = 0;
+    fTimeGradient = false;
+    
+    for( unsigned int i = 0; i < fNPar; i++ )
+    {
+        fPar[i] = 0.;
+        fParError[i] = 0.;
+        fParMin[i] = -1.e99;
+        fParMax[i] = 1.e99;
+        fParFixed[i] = false;
+    }
+    fParFixed[8] = true;
+    
+    fMaxIterations = 200;
+    fEDMTolerance = 1.e-6;
+    fFitStatus = 0;
+    fFmin = 0.;
+    fEDM = 0.;
+    fNIterations = 0;
+}
+
+void VImageParameterLLMinimizer::setData( const vector< double >* iX, const vector< double >* iY,
+        const vector< double >* iSums, const vector< double >* iT, bool iTimeGradient )
+{
+    fX = iX;
+    fY = iY;
+    fSums = iSums;
+    fT = iT;
+    fTimeGradient = iTimeGradient;
+}
+
+/*
+ * define a fit parameter
+ *
+ * no limits for iMin >= iMax
+ */
+void VImageParameterLLMinimizer::setParameter( unsigned int i, string iName, double iValue, double iMin, double iMax )
+{
+    if( i >= fNPar )
+    {
+        cout << "VImageParameterLLMinimizer::setParameter error: invalid parameter index " << i << endl;
+        return;
+    }
+    fParName[i] = iName;
+    fPar[i] = iValue;
+    fParError[i] = 0.;
+    if( iMin < iMax )
+    {
+        fParMin[i] = iMin;
+        fParMax[i] = iMax;
+    }
+    else
+    {
+        fParMin[i] = -1.e99;
+        fParMax[i] = 1.e99;
+    }
+}
+
+void VImageParameterLLMinimizer::fixParameter( unsigned int i )
+{
+    if( i < fNPar )
+    {
+        fParFixed[i] = true;
+    }
+}
+
+/*
+ * tchi2 (parameter 8) is always fixed
+ */
+void VImageParameterLLMinimizer::releaseParameter( unsigned int i )
+{
+    if( i < fNParDeriv )
+    {
+        fParFixed[i] = false;
+    }
+}
+
+void VImageParameterLLMinimizer::getParameter( unsigned int i, double& iValue, double& iError )
+{
+    if( i < fNPar )
+    {
+        iValue = fPar[i];
+        iError = fParError[i];
+    }
+    else
+    {
+        iValue = 0.;
+        iError = 0.;
+    }
+}
+
+/*
+ * negative log-likelihood (same definition as in get_LL_imageParameter_2DGaussRotated())
+ *
+ * optional: gradient (fNParDeriv) and Hessian (fNParDeriv x fNParDeriv)
+ *
+ * derivatives are calculated from the derivatives of the log of the pixel
+ * amplitude L = ln( mu ):
+ *
+ *   dF   = ( mu - n ) dL
+ *   d2F  = ( mu - n ) d2L + mu dL dL^T
+ *
+ * (n = 0 for pixels with n <= 0; these contribute mu only)
+ */
+double VImageParameterLLMinimizer::getLogLikelihood( const double* iPar, double* iGrad, double* iHess )
+{
+    const unsigned int np = fNParDeriv;
+    if( iGrad )
+    {
+        for( unsigned int i = 0; i < np; i++ )
+        {
+            iGrad[i] = 0.;
+        }
+    }
+    if( iHess )
+    {
+        for( unsigned int i = 0; i < np * np; i++ )
+        {
+            iHess[i] = 0.;
+        }
+    }
+    if( !fX || !fY || !fSums || iPar[2] <= 0. || iPar[4] <= 0. || iPar[5] <= 0. )
+    {
+        return 1.e99;
+    }
+    
+    const double c = cos( iPar[0] );
+    const double s = sin( iPar[0] );
+    const double a = iPar[2];
+    const double b = iPar[4];
+    const double al = 1. / ( a * a );
+    const double be = 1. / ( b * b );
+    const double i_norm = iPar[5] / ( 2. * M_PI * a * b );
+    
+    // time gradient
+    bool bTime = ( fTimeGradient && fT && fT->size() >= fSums->size() && iPar[8] > 0. );
+    double t_sig_term = 0.;
+    double w = 0.;
+    if( bTime )
+    {
+        t_sig_term = log( 1. / sqrt( 2. * M_PI * iPar[8] ) );
+        w = 1. / ( iPar[8] * iPar[8] );
+    }
+    
+    double dL[fNParDeriv];
+    double d2L[6][6];
+    double dr[fNParDeriv];
+    for( unsigned int k = 0; k < np; k++ )
+    {
+        dL[k] = 0.;
+        dr[k] = 0.;
+    }
+    
+    double F = 0.;
+    for( unsigned int i = 0; i < fSums->size(); i++ )
+    {
+        const double n = ( *fSums )[i];
+        if( n <= -999. )
+        {
+            continue;
+        }
+        const double dx = ( *fX )[i] - iPar[1];
+        const double dy = ( *fY )[i] - iPar[3];
+        const double u =  dx * c + dy * s;
+        const double v = -dx * s + dy * c;
+        const double mu = i_norm * exp( -0.5 * ( u * u * al + v * v * be ) );
+        
+        // Poisson fluctuations (neglecting background noise)
+        double ne = 0.;
+        if( n > 0. && mu > 0. )
+        {
+            F += mu - n * log( mu ) + n * log( n ) - n;
+            ne = n;
+        }
+        else
+        {
+            F += mu;
+        }
+        
+        if( iGrad )
+        {
+            dL[0] = u * v * ( be - al );
+            dL[1] = al * u * c - be * v * s;
+            dL[2] = -1. / a + u * u * al / a;
+            dL[3] = al * u * s + be * v * c;
+            dL[4] = -1. / b + v * v * be / b;
+            dL[5] = 1. / iPar[5];
+            const double r1 = mu - ne;
+            for( unsigned int k = 0; k < 6; k++ )
+            {
+                iGrad[k] += r1 * dL[k];
+            }
+            if( iHess )
+            {
+                d2L[0][0] = ( be - al ) * ( v * v - u * u );
+                d2L[0][1] = ( be - al ) * ( u * s - v * c );
+                d2L[0][2] = 2. * u * v * al / a;
+                d2L[0][3] = -1. * ( be - al ) * ( u * c + v * s );
+                d2L[0][4] = -2. * u * v * be / b;
+                d2L[0][5] = 0.;
+                d2L[1][1] = -1. * ( al * c * c + be * s * s );
+                d2L[1][2] = -2. * u * c * al / a;
+                d2L[1][3] = c * s * ( be - al );
+                d2L[1][4] = 2. * v * s * be / b;
+                d2L[1][5] = 0.;
+                d2L[2][2] = al - 3. * u * u * al * al;
+                d2L[2][3] = -2. * u * s * al / a;
+                d2L[2][4] = 0.;
+                d2L[2][5] = 0.;
+                d2L[3][3] = -1. * ( al * s * s + be * c * c );
+                d2L[3][4] = -2. * v * c * be / b;
+                d2L[3][5] = 0.;
+                d2L[4][4] = be - 3. * v * v * be * be;
+                d2L[4][5] = 0.;
+                d2L[5][5] = -1. / ( iPar[5] * iPar[5] );
+                for( unsigned int j = 0; j < 6; j++ )
+                {
+                    for( unsigned int k = j; k < 6; k++ )
+                    {
+                        iHess[j * np + k] += r1 * d2L[j][k] + mu * dL[j] * dL[k];
+                    }
+                }
+            }
+        }
+        
+        // time gradient analysis
+        // (line fit to time gradient along the rotated x-axis)
+        if( bTime && ( *fT )[i] > 0. )
+        {
+            const double r = ( *fT )[i] - iPar[6] - iPar[7] * u;
+            F += 0.5 * w * r * r;
+            if( iGrad )
+            {
+                dr[0] = -1. * iPar[7] * v;
+                dr[1] = iPar[7] * c;
+                dr[3] = iPar[7] * s;
+                dr[6] = -1.;
+                dr[7] = -1. * u;
+                for( unsigned int k = 0; k < np; k++ )
+                {
+                    iGrad[k] += w * r * dr[k];
+                }
+                if( iHess )
+                {
+                    for( unsigned int j = 0; j < np; j++ )
+                    {
+                        for( unsigned int k = j; k < np; k++ )
+                        {
+                            iHess[j * np + k] += w * dr[j] * dr[k];
+                        }
+                    }
+                    iHess[0 * np + 0] += w * r * iPar[7] * u;
+                    iHess[0 * np + 1] += w * r * ( -1. * iPar[7] * s );
+                    iHess[0 * np + 3] += w * r * iPar[7] * c;
+                    iHess[0 * np + 7] += w * r * ( -1. * v );
+                    iHess[1 * np + 7] += w * r * c;
+                    iHess[3 * np + 7] += w * r * s;
+                }
+            }
+        }
+    }
+    // symmetrize Hessian
+    if( iHess )
+    {
+        for( unsigned int j = 0; j < np; j++ )
+        {
+            for( unsigned int k = 0; k < j; k++ )
+            {
+                iHess[j * np + k] = iHess[k * np + j];
+            }
+        }
+    }
+    
+    return F - t_sig_term;
+}
+
+/*
+ * Cholesky decomposition of the symmetric matrix iA (n x n) in place
+ * (lower triangle; returns false if matrix is not positive definite)
+ */
+bool VImageParameterLLMinimizer::choleskyDecomposition( double* iA, unsigned int n )
+{
+    for( unsigned int j = 0; j < n; j++ )
+    {
+        double d = iA[j * n + j];
+        for( unsigned int k = 0; k < j; k++ )
+        {
+            d -= iA[j * n + k] * iA[j * n + k];
+        }
+        if( !( d > 0. ) )
+        {
+            return false;
+        }
+        d = sqrt( d );
+        iA[j * n + j] = d;
+        for( unsigned int i = j + 1; i < n; i++ )
+        {
+            double e = iA[i * n + j];
+            for( unsigned int k = 0; k < j; k++ )
+            {
+                e -= iA[i * n + k] * iA[j * n + k];
+            }
+            iA[i * n + j] = e / d;
+        }
+    }
+    return true;
+}
+
+/*
+ * solve L L^T x = b (b is overwritten by x)
+ */
+void VImageParameterLLMinimizer::choleskySolve( const double* iL, unsigned int n, double* iB )
+{
+    for( unsigned int i = 0; i < n; i++ )
+    {
+        for( unsigned int k = 0; k < i; k++ )
+        {
+            iB[i] -= iL[i * n + k] * iB[k];
+        }
+        iB[i] /= iL[i * n + i];
+    }
+    for( int i = ( int )n - 1; i >= 0; i-- )
+    {
+        for( unsigned int k = i + 1; k < n; k++ )
+        {
+            iB[i] -= iL[k * n + i] * iB[k];
+        }
+        iB[i] /= iL[i * n + i];
+    }
+}
+
+/*
+ * estimated distance to minimum: 0.5 * g^T H^-1 g
+ * (for the given list of parameters)
+ */
+double VImageParameterLLMinimizer::getEDM( const double* iGrad, const double* iHess,
+        const vector< unsigned int >& iPar, bool& bPosDef )
+{
+    const unsigned int n = iPar.size();
+    double M[fNParDeriv * fNParDeriv];
+    double y[fNParDeriv];
+    for( unsigned int j = 0; j < n; j++ )
+    {
+        y[j] = iGrad[iPar[j]];
+        for( unsigned int k = 0; k < n; k++ )
+        {
+            M[j * n + k] = iHess[iPar[j] * fNParDeriv + iPar[k]];
+        }
+    }
+    bPosDef = choleskyDecomposition( M, n );
+    if( !bPosDef )
+    {
+        return 1.e99;
+    }
+    choleskySolve( M, n, y );
+    double edm = 0.;
+    for( unsigned int j = 0; j < n; j++ )
+    {
+        edm += iGrad[iPar[j]] * y[j];
+    }
+    return 0.5 * edm;
+}
+
+/*
+ * parameter is at its limit and the gradient points outwards
+ */
+bool VImageParameterLLMinimizer::isAtLimit( unsigned int i, const double* iGrad )
+{
+    return ( ( fPar[i] <= fParMin[i] && iGrad[i] > 0. ) || ( fPar[i] >= fParMax[i] && iGrad[i] < 0. ) );
+}
+
+/*
+ * minimize negative log-likelihood
+ *
+ * returns true if minimization converged
+ */
+bool VImageParameterLLMinimizer::minimize()
+{
+    fFitStatus = 0;
+    fFmin = 0.;
+    fEDM = 0.;
+    fNIterations = 0;
+    for( unsigned int i = 0; i < fNPar; i++ )
+    {
+        fParError[i] = 0.;
+        if( fPar[i] < fParMin[i] )
+        {
+            fPar[i] = fParMin[i];
+        }
+        if( fPar[i] > fParMax[i] )
+        {
+            fPar[i] = fParMax[i];
+        }
+    }
+    if( !fX || !fY || !fSums )
+    {
+        return false;
+    }
+    // parameters with time gradient term only
+    if( !fTimeGradient )
+    {
+        fParFixed[6] = true;
+        fParFixed[7] = true;
+    }
+    vector< unsigned int > i_free;
+    for( unsigned int i = 0; i < fNParDeriv; i++ )
+    {
+        if( !fParFixed[i] )
+        {
+            i_free.push_back( i );
+        }
+    }
+    
+    double F = getLogLikelihood( fPar, fGrad, fHess );
+    if( i_free.size() == 0 )
+    {
+        fFmin = F;
+        fFitStatus = 3;
+        return true;
+    }
+    
+    double i_newPar[fNPar];
+    double i_newGrad[fNParDeriv];
+    double i_newHess[fNParDeriv * fNParDeriv];
+    double M[fNParDeriv * fNParDeriv];
+    double i_step[fNParDeriv];
+    vector< unsigned int > i_act;
+    double lambda = 1.e-3;
+    bool bConverged = false;
+    bool bPosDef = false;
+    
+    for( fNIterations = 0; fNIterations < fMaxIterations; fNIterations++ )
+    {
+        // active parameters (free and not pushed against their limits)
+        i_act.clear();
+        for( unsigned int j = 0; j < i_free.size(); j++ )
+        {
+            if( !isAtLimit( i_free[j], fGrad ) )
+            {
+                i_act.push_back( i_free[j] );
+            }
+        }
+        if( i_act.size() == 0 )
+        {
+            bConverged = true;
+            break;
+        }
+        fEDM = getEDM( fGrad, fHess, i_act, bPosDef );
+        if( bPosDef && fEDM < fEDMTolerance )
+        {
+            bConverged = true;
+            break;
+        }
+        const unsigned int n = i_act.size();
+        
+        // damped Newton step
+        bool bAccepted = false;
+        for( unsigned int t = 0; t < 40 && !bAccepted; t++ )
+        {
+            for( unsigned int j = 0; j < n; j++ )
+            {
+                for( unsigned int k = 0; k < n; k++ )
+                {
+                    M[j * n + k] = fHess[i_act[j] * fNParDeriv + i_act[k]];
+                }
+                double d = fabs( fHess[i_act[j] * fNParDeriv + i_act[j]] );
+                if( d < 1.e-10 )
+                {
+                    d = 1.;
+                }
+                M[j * n + j] += lambda * d;
+                i_step[j] = -1. * fGrad[i_act[j]];
+            }
+            if( !choleskyDecomposition( M, n ) )
+            {
+                lambda *= 10.;
+                continue;
+            }
+            choleskySolve( M, n, i_step );
+            for( unsigned int i = 0; i < fNPar; i++ )
+            {
+                i_newPar[i] = fPar[i];
+            }
+            for( unsigned int j = 0; j < n; j++ )
+            {
+                unsigned int i = i_act[j];
+                i_newPar[i] = fPar[i] + i_step[j];
+                if( i_newPar[i] < fParMin[i] )
+                {
+                    i_newPar[i] = fParMin[i];
+                }
+                if( i_newPar[i] > fParMax[i] )
+                {
+                    i_newPar[i] = fParMax[i];
+                }
+            }
+            double Fnew = getLogLikelihood( i_newPar, i_newGrad, i_newHess );
+            if( Fnew <= F )
+            {
+                bAccepted = true;
+                for( unsigned int i = 0; i < fNPar; i++ )
+                {
+                    fPar[i] = i_newPar[i];
+                }
+                for( unsigned int i = 0; i < fNParDeriv; i++ )
+                {
+                    fGrad[i] = i_newGrad[i];
+                }
+                for( unsigned int i = 0; i < fNParDeriv * fNParDeriv; i++ )
+                {
+                    fHess[i] = i_newHess[i];
+                }
+                F = Fnew;
+                if( lambda > 1.e-12 )
+                {
+                    lambda *= 0.1;
+                }
+            }
+            else
+            {
+                lambda *= 10.;
+            }
+        }
+        if( fDebug )
+        {
+            cout << "VImageParameterLLMinimizer iteration " << fNIterations << ": F = " << F;
+            cout << ", edm = " << fEDM << ", lambda = " << lambda << endl;
+        }
+        // no further improvement possible
+        if( !bAccepted )
+        {
+            break;
+        }
+    }
+    fFmin = F;
+    
+    // errors from inverse Hessian at the minimum (all free parameters)
+    const unsigned int n = i_free.size();
+    bool bHessPosDef = false;
+    double i_shift = 0.;
+    for( unsigned int t = 0; t < 20 && !bHessPosDef; t++ )
+    {
+        for( unsigned int j = 0; j < n; j++ )
+        {
+            for( unsigned int k = 0; k < n; k++ )
+            {
+                M[j * n + k] = fHess[i_free[j] * fNParDeriv + i_free[k]];
+            }
+            M[j * n + j] += i_shift * fabs( fHess[i_free[j] * fNParDeriv + i_free[j]] );
+        }
+        bHessPosDef = choleskyDecomposition( M, n );
+        // force matrix to be positive definite
+        if( !bHessPosDef )
+        {
+            i_shift = ( i_shift > 0. ? i_shift * 10. : 1.e-6 );
+        }
+    }
+    if( bHessPosDef )
+    {
+        fFitStatus = ( i_shift > 0. ? 2 : 3 );
+        for( unsigned int j = 0; j < n; j++ )
+        {
+            for( unsigned int k = 0; k < n; k++ )
+            {
+                i_step[k] = ( k == j ? 1. : 0. );
+            }
+            choleskySolve( M, n, i_step );
+            if( i_step[j] > 0. )
+            {
+                fParError[i_free[j]] = sqrt( i_step[j] );
+            }
+        }
+    }
+    else
+    {
+        fFitStatus = 1;
+    }
+    if( !bConverged )
+    {
+        fFitStatus = 1;
+    }
+    if( fDebug )
+    {
+        cout << "VImageParameterLLMinimizer: F = " << fFmin << ", edm = " << fEDM << ", status " << fFitStatus;
+        cout << " (" << fNIterations << " iterations)" << endl;
+        for( unsigned int i = 0; i < fNPar; i++ )
+        {
+            cout << "\t " << i << " " << fParName[i] << ": " << fPar[i] << " +- " << fParError[i];
+            cout << ( fParFixed[i] ? " (fixed)" : "" ) << endl;
+        }
+    }
+    
+    return bConverged;
+}
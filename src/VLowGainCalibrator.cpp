@@ -4,6 +4,9 @@ VLowGainCalibrator::VLowGainCalibrator( int run, int sw, bool isInnerHigh, bool
 {
 
     fIsOk = false;
+    fDST = 0;
+    fSumHiLo = 0;
+    fSumMonitor = 0;
     if( outdir == "" )
     {
         outdir = dir;
@@ -50,24 +53,26 @@ VLowGainCalibrator::VLowGainCalibrator( int run, int sw, bool isInnerHigh, bool
         return ;
     }
     
-    fDsttree->SetBranchAddress( "sumfirst", &sumfirst );
+    TTree* iTelConfig = ( TTree* )fInfile->Get( "telconfig" );
+    if( !iTelConfig )
+    {
+        cout << "ERROR: Input file " << iName << " does not contain a tree named telconfig, exiting immediately..." << endl;
+        return ;
+    }
+    // read DST tree (sparse and fixed-size array layouts)
+    fDST = new VDSTTree();
+    fDST->initDSTTree( fDsttree, iTelConfig );
     
     if( sw2monitor )
     {
-        fDsttree->SetBranchAddress( "sum", &sumHiLo );
-        fDsttree->SetBranchAddress( "sum2", &sumMonitor );
+        fSumHiLo = &fDST->fDSTsums;
+        fSumMonitor = &fDST->fDSTsums2;
     }
     else
     {
-        fDsttree->SetBranchAddress( "sum", &sumMonitor );
-        fDsttree->SetBranchAddress( "sum2", &sumHiLo );
+        fSumMonitor = &fDST->fDSTsums;
+        fSumHiLo = &fDST->fDSTsums2;
     }
-    fDsttree->SetBranchAddress( "HiLo", &HiLo );
-    fDsttree->SetBranchAddress( "sumwindow", &sumwindow );
-    fDsttree->SetBranchAddress( "eventNumber", &eventNumber );
-    fDsttree->SetBranchAddress( "dead", &dead );
-    fDsttree->SetBranchAddress( "RawMax", &RawMax );
-    fDsttree->SetBranchAddress( "pulsetiming", &pulsetiming );
     
     for( int tel = 0; tel < fNTel; tel++ )
     {
@@ -139,6 +144,10 @@ VLowGainCalibrator::~VLowGainCalibrator()
             fMonitorChargeHist[tel]->Delete();
         }
     }
+    if( fDST )
+    {
+        delete fDST;
+    }
     if( fDsttree )
     {
         fDsttree->Delete();
@@ -189,13 +198,13 @@ double VLowGainCalibrator::calcMeanMonitorCharge( int tel, int ientry )
 {
     if( ientry > -1 )
     {
-        fDsttree->GetEntry( ientry );
+        fDST->getEntry( ientry );
     }
     int nLive = 0;
     double mean = 0;
     for( int iChan = fChanMon_start; iChan < fChanMon_stop; iChan++ )
     {
-        if( dead[tel][iChan] || HiLo[tel][iChan] )
+        if( fDST->fDSTdead.get( tel, iChan ) || fDST->fDSTHiLo.get( tel, iChan ) )
         {
             continue;
         }
@@ -203,12 +212,12 @@ double VLowGainCalibrator::calcMeanMonitorCharge( int tel, int ientry )
         {
             continue;
         }
-        if( sumMonitor[tel][iChan] < fSumMonitor_min )
+        if( fSumMonitor->get( tel, iChan ) < fSumMonitor_min )
         {
             continue;
         }
         nLive++;
-        mean += sumMonitor[tel][iChan];
+        mean += fSumMonitor->get( tel, iChan );
     }
     
     if( nLive < 100 )
@@ -226,13 +235,13 @@ double VLowGainCalibrator::calcMedianMonitorCharge( int tel, int ientry )
 {
     if( ientry > -1 )
     {
-        fDsttree->GetEntry( ientry );
+        fDST->getEntry( ientry );
     }
     int nLive = 0;
     vector<double> Qmon;
     for( int iChan = fChanMon_start; iChan < fChanMon_stop; iChan++ )
     {
-        if( dead[tel][iChan] || HiLo[tel][iChan] )
+        if( fDST->fDSTdead.get( tel, iChan ) || fDST->fDSTHiLo.get( tel, iChan ) )
         {
             continue;
         }
@@ -240,12 +249,12 @@ double VLowGainCalibrator::calcMedianMonitorCharge( int tel, int ientry )
         {
             continue;
         }
-        if( sumMonitor[tel][iChan] < fSumMonitor_min )
+        if( fSumMonitor->get( tel, iChan ) < fSumMonitor_min )
         {
             continue;
         }
         nLive++;
-        Qmon.push_back( sumMonitor[tel][iChan] );
+        Qmon.push_back( fSumMonitor->get( tel, iChan ) );
     }
     
     if( nLive < 100 )
@@ -291,7 +300,7 @@ bool VLowGainCalibrator::makeMonitorChargeHists( )
     
     for( unsigned int iEntry = fMinDSTEvent; iEntry < fDsttree->GetEntries() && iEntry < fMaxDSTEvent; iEntry++ )
     {
-        fDsttree->GetEntry( iEntry );
+        fDST->getEntry( iEntry );
         
         for( int tel = 0; tel < 4; tel++ )
         {
@@ -703,7 +712,7 @@ bool VLowGainCalibrator::calculateMeanCharges()
     for( unsigned int ientry = fMinDSTEvent; ientry < fDsttree->GetEntries() && ientry < fMaxDSTEvent ; ientry++ )
     {
     
-        fDsttree->GetEntry( ientry );
+        fDST->getEntry( ientry );
         
         for( int tel = 0; tel < fNTel; tel++ )
         {
@@ -740,15 +749,15 @@ bool VLowGainCalibrator::calculateMeanCharges()
             for( int iChan = fChan_start; iChan < fChan_stop; iChan++ )
             {
             
-                if( dead[tel][iChan] )
+                if( fDST->fDSTdead.get( tel, iChan ) )
                 {
                     continue;
                 }
                 
-                N	[ HiLo[tel][iChan] ] ++;
+                N	[ fDST->fDSTHiLo.get( tel, iChan ) ] ++;
                 
-                start	[ HiLo[tel][iChan] ] += sumfirst[tel][iChan];
-                start2	[ HiLo[tel][iChan] ] += sumfirst[tel][iChan] * sumfirst[tel][iChan];
+                start	[ fDST->fDSTHiLo.get( tel, iChan ) ] += fDST->fDSTsumfirst.get( tel, iChan );
+                start2	[ fDST->fDSTHiLo.get( tel, iChan ) ] += fDST->fDSTsumfirst.get( tel, iChan ) * fDST->fDSTsumfirst.get( tel, iChan );
                 
             }//chan
             
@@ -766,29 +775,29 @@ bool VLowGainCalibrator::calculateMeanCharges()
             for( int iChan = fChan_start; iChan < fChan_stop; iChan++ )
             {
             
-                if( dead[tel][iChan] )
+                if( fDST->fDSTdead.get( tel, iChan ) )
                 {
                     continue;
                 }
-                //todo test this			if( fabs( sumfirst[tel][iChan] - start[ HiLo[tel][iChan] ] ) > 2*start2[ HiLo[tel][iChan] ] ) continue;
+                //todo test this			if( fabs( fDST->fDSTsumfirst.get( tel, iChan ) - start[ fDST->fDSTHiLo.get( tel, iChan ) ] ) > 2*start2[ fDST->fDSTHiLo.get( tel, iChan ) ] ) continue;
                 
                 if( level > -1 )
                 {
-                    fN   [tel][iChan][ HiLo[tel][iChan] ][level]++;
-                    fNSat[tel][iChan][ HiLo[tel][iChan] ][level] += ( RawMax[tel][iChan] == 255 ? 1 : 0 );
-                    fY   [tel][iChan][ HiLo[tel][iChan] ][level] += sumHiLo[tel][iChan] / ( HiLo[tel][iChan] ? fLMult[tel] : 1.0 );
-                    fY2  [tel][iChan][ HiLo[tel][iChan] ][level] += TMath::Power( sumHiLo[tel][iChan] / ( HiLo[tel][iChan] ? fLMult[tel] : 1.0 ) , 2 ) ;
+                    fN   [tel][iChan][ fDST->fDSTHiLo.get( tel, iChan ) ][level]++;
+                    fNSat[tel][iChan][ fDST->fDSTHiLo.get( tel, iChan ) ][level] += ( fDST->fDSTRawMax.get( tel, iChan ) == 255 ? 1 : 0 );
+                    fY   [tel][iChan][ fDST->fDSTHiLo.get( tel, iChan ) ][level] += fSumHiLo->get( tel, iChan ) / ( fDST->fDSTHiLo.get( tel, iChan ) ? fLMult[tel] : 1.0 );
+                    fY2  [tel][iChan][ fDST->fDSTHiLo.get( tel, iChan ) ][level] += TMath::Power( fSumHiLo->get( tel, iChan ) / ( fDST->fDSTHiLo.get( tel, iChan ) ? fLMult[tel] : 1.0 ) , 2 ) ;
                 }
                 if( isDebugChannel( iChan ) )
                 {
-                    fTree_eventNumber = eventNumber;
+                    fTree_eventNumber = fDST->getDSTEventNumber();
                     fTree_Channel = iChan;
                     fTree_level = level;
-                    fTree_hilo = HiLo[tel][iChan];
-                    fTree_Q = sumHiLo[tel][iChan] / ( HiLo[tel][iChan] ? fLMult[tel] : 1.0 ) ;
+                    fTree_hilo = fDST->fDSTHiLo.get( tel, iChan );
+                    fTree_Q = fSumHiLo->get( tel, iChan ) / ( fDST->fDSTHiLo.get( tel, iChan ) ? fLMult[tel] : 1.0 ) ;
                     fTree_QMon = qmon;
-                    fTree_RawMax = RawMax[tel][iChan];
-                    fTree_TZero = pulsetiming[tel][0][iChan];
+                    fTree_RawMax = fDST->fDSTRawMax.get( tel, iChan );
+                    fTree_TZero = fDST->fDSTpulsetiming.get( tel, iChan, 0 );
                     if( level > -1 )
                     {
                         fTree_QMonMean = fLightLevelMean[tel][level];
@@ -0,0 +1,186 @@
+/*! \class VNNProbabilityCurve
+    \brief tabulated rate contour (probability) curve for NN image cleaning
+
+    Maximum time difference of pixels in a next-neighbour group as function
+    of the (minimum) charge in the group.
+
+    Replaces the evaluation of IPR graph and rate contour function
+    (see VImageCleaning::defineRateContourFunction()) in the NN group search:
+
+       dT = 1.e9 * ( Rate / ( CombFactor * IPR( charge )^Nfold ) )^( 1 / ( Nfold - 1 ) )
+
+    and for boundary pixels:
+
+       dT = 1.e9 * Rate / ( CombFactor * IPR( charge ) * IPR( reference charge ) )
+
+    IPR( charge )^exponent is tabulated once per telescope type in
+    fine charge bins (linear interpolation); rate and combinatorial factor enter only
+    through a normalisation factor, which can be changed at any time
+    (see setParameters()).
+
+    IPR rates are limited to >= 100 Hz; charges above the maximum charge of the
+    IPR graph are assigned 100 Hz (as in VImageCleaning::NNChargeAndTimeCut()).
+
+    Tables start at the lowest charge of the IPR graph (at 0 p.e. if all
+    points of the graph are at positive charges) and end at the maximum
+    charge; the graph is evaluated only for charges below the table.
+
+    Accuracy (16384 bins): the relative difference to the direct evaluation
+    of the IPR graph and rate contour is typically 1e-6 and below 2e-3 in
+    the bins containing a point of the IPR graph or the 100 Hz limit
+    (see testNNProbabilityCurve).
+
+*/
+
+#include "VNNProbabilityCurve.h"
+
+VNNProbabilityCurve::VNNProbabilityCurve()
+{
+    fIPR = 0;
+    fNfold = 2.;
+    fBoundary = false;
+    fExponent = -2.;
+    fNorm = 0.;
+    fChargeMin = 0.;
+    fChargeMax = 0.;
+    fChargeBinWidth_inv = 0.;
+    fContour_overflow = 0.;
+}
+
+/*
+ * fill tables of IPR rates and IPR rates^exponent
+ *
+ * iNfold:     multiplicity of NN group (exponent -Nfold/(Nfold-1))
+ * iBoundary:  rate contour for boundary pixels (exponent -1)
+ *
+ */
+bool VNNProbabilityCurve::fill( TGraph* iIPR, float iChargeMax, float iNfold, bool iBoundary, unsigned int iNBins )
+{
+    fIPRTable.clear();
+    fContourTable.clear();
+    fIPR = iIPR;
+    if( !fIPR || iNBins == 0 || iChargeMax <= 0. || ( !iBoundary && iNfold < 1.5 ) )
+    {
+        fIPR = 0;
+        return false;
+    }
+    fNfold = iNfold;
+    fBoundary = iBoundary;
+    if( fBoundary )
+    {
+        fExponent = -1.;
+    }
+    else
+    {
+        fExponent = -1. * fNfold / ( fNfold - 1. );
+    }
+    // low-charge range (e.g. negative charges) is tabulated down to the first point of the graph
+    fChargeMin = 0.;
+    if( fIPR->GetN() > 0 && TMath::MinElement( fIPR->GetN(), fIPR->GetX() ) < fChargeMin )
+    {
+        fChargeMin = TMath::MinElement( fIPR->GetN(), fIPR->GetX() );
+    }
+    fChargeMax = iChargeMax;
+    if( fChargeMax <= fChargeMin )
+    {
+        fIPR = 0;
+        return false;
+    }
+    fChargeBinWidth_inv = ( float )iNBins / ( fChargeMax - fChargeMin );
+    
+    fIPRTable.resize( iNBins + 1, 100. );
+    fContourTable.resize( iNBins + 1, 0. );
+    for( unsigned int i = 0; i <= iNBins; i++ )
+    {
+        fIPRTable[i] = getIPR_fromGraph( fChargeMin + ( float )i / fChargeBinWidth_inv );
+        fContourTable[i] = TMath::Power( ( double )fIPRTable[i], fExponent );
+    }
+    fContour_overflow = TMath::Power( 100., fExponent );
+    
+    return true;
+}
+
+/*
+ * IPR rate from graph (limited to >= 100 Hz)
+ */
+double VNNProbabilityCurve::getIPR_fromGraph( float iCharge )
+{
+    if( !fIPR || iCharge > fChargeMax )
+    {
+        return 100.;
+    }
+    double i_ipr = fIPR->Eval( iCharge, 0, "" );
+    if( i_ipr < 100. )
+    {
+        i_ipr = 100.;
+    }
+    return i_ipr;
+}
+
+/*
+ * set rate and combinatorial factor
+ * (iRefIPR: IPR rate at reference charge; boundary curves only)
+ */
+void VNNProbabilityCurve::setParameters( double iRate, double iCombFactor, double iRefIPR )
+{
+    if( iCombFactor <= 0. || iRefIPR <= 0. )
+    {
+        fNorm = 0.;
+        return;
+    }
+    if( fBoundary )
+    {
+        fNorm = 1.e9 * iRate / ( iCombFactor * iRefIPR );
+    }
+    else
+    {
+        fNorm = 1.e9 * TMath::Power( iRate / iCombFactor, 1. / ( fNfold - 1. ) );
+    }
+}
+
+/*
+ * IPR rate at this charge (limited to >= 100 Hz)
+ */
+float VNNProbabilityCurve::getIPR( float iCharge )
+{
+    if( iCharge >= fChargeMax )
+    {
+        return 100.;
+    }
+    if( !( iCharge >= fChargeMin ) || fIPRTable.size() < 2 )
+    {
+        return getIPR_fromGraph( iCharge );
+    }
+    float t = ( iCharge - fChargeMin ) * fChargeBinWidth_inv;
+    unsigned int i = ( unsigned int )t;
+    if( i + 1 >= fIPRTable.size() )
+    {
+        return fIPRTable.back();
+    }
+    t -= ( float )i;
+    return fIPRTable[i] + t * ( fIPRTable[i + 1] - fIPRTable[i] );
+}
+
+/*
+ * maximum time difference [ns] for a NN group with this (minimum) charge
+ */
+float VNNProbabilityCurve::getDeltaT( float iCharge )
+{
+    if( iCharge > fChargeMax )
+    {
+        return fNorm * fContour_overflow;
+    }
+    // charges below table (or no table)
+    if( !( iCharge >= fChargeMin ) || fContourTable.size() < 2 )
+    {
+        return fNorm * TMath::Power( getIPR_fromGraph( iCharge ), fExponent );
+    }
+    float t = ( iCharge - fChargeMin ) * fChargeBinWidth_inv;
+    unsigned int i = ( unsigned int )t;
+    if( i + 1 >= fContourTable.size() )
+    {
+        return fNorm * fContourTable.back();
+    }
+    t -= ( float )i;
+    return fNorm * ( fContourTable[i] + t * ( fContourTable[i + 1] - fContourTable[i] ) );
+}
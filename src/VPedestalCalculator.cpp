@@ -305,11 +305,13 @@ void VPedestalCalculator::doAnalysis( bool iLowGain )
                         {
                             iTempSW = getRunParameter()->fCalibrationSumWindow;
                         }
+                        // calculate trace sums for all summation windows (one pass over the trace)
+                        fTraceHandler->setTraceIntegrationmethod( 1 );
+                        fTraceHandler->getTraceSums( fSumFirst, iTempSW, true, 9999, fTraceWindowSums );
                         // w = 0 --> summation window 1
                         for( unsigned int w = 0; w < iTempSW; w++ )
                         {
-                            // calculate trace sum
-                            i_tr_sum = fTraceHandler->getTraceSum( fSumFirst, fSumFirst + ( w + 1 ), true, 1 );
+                            i_tr_sum = fTraceWindowSums[w];
                             if( i_tr_sum > 0. && i_tr_sum < 50.*( w + 1 ) )
                             {
                                 if( chanID < fpedcal_n[telID].size() && w < fpedcal_n[telID][chanID].size() )
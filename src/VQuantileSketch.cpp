@@ -0,0 +1,229 @@
+/*! \class VQuantileSketch
+    \brief mergeable streaming quantile sketch for weighted values (merging t-digest)
+
+    Values are collected in a small buffer and merged into a sorted list of
+    centroids (mean, weight). The maximum weight of a centroid depends on its
+    position in the distribution (scale function k(q) = delta/(2 pi) asin(2q-1)),
+    i.e. centroids are small in the tails and larger around the median.
+    The number of centroids is of the order of the compression delta, independent
+    of the number of filled values. The quantile error decreases with increasing
+    compression (rank error around the median ~1/delta); distributions with less
+    than ~delta/2 values are kept exactly.
+
+    Sketches are mergeable (merge(), addCentroids()), the list of centroids
+    (getCentroids()) is the serialised form of a sketch.
+
+    Reference: T. Dunning, O. Ertl, Computing extremely accurate quantiles using t-digests, arXiv:1902.04023
+
+*/
+
+#include "VQuantileSketch.h"
+
+VQuantileSketch::VQuantileSketch( double iCompression )
+{
+    fCompression = ( iCompression > 10. ? iCompression : 10. );
+    fBufferSize = ( unsigned int )fCompression;
+    reset();
+}
+
+void VQuantileSketch::reset()
+{
+    fCentroids.clear();
+    fNMerged = 0;
+    fSumW = 0.;
+    fSumWX = 0.;
+    fEntries = 0;
+    fMin = 0.;
+    fMax = 0.;
+}
+
+double VQuantileSketch::kScale( double q )
+{
+    return fCompression / ( 2. * TMath::Pi() ) * TMath::ASin( 2. * q - 1. );
+}
+
+double VQuantileSketch::kScaleInverse( double k )
+{
+    double i_x = k * 2. * TMath::Pi() / fCompression;
+    if( i_x > 0.5 * TMath::Pi() )
+    {
+        return 1.;
+    }
+    return 0.5 * ( TMath::Sin( i_x ) + 1. );
+}
+
+/*
+ * merge all buffered values into the list of centroids
+ */
+void VQuantileSketch::compress()
+{
+    if( fCentroids.size() == fNMerged )
+    {
+        return;
+    }
+    sort( fCentroids.begin(), fCentroids.end() );
+    
+    // total weight of all centroids (fSumW includes values outside of the float precision)
+    double i_total = 0.;
+    for( unsigned int i = 0; i < fCentroids.size(); i++ )
+    {
+        i_total += fCentroids[i].fWeight;
+    }
+    unsigned int n = 0;
+    double i_weightSoFar = 0.;
+    double i_weightLimit = i_total * kScaleInverse( kScale( 0. ) + 1. );
+    double i_mean = fCentroids[0].fMean;
+    double i_weight = fCentroids[0].fWeight;
+    for( unsigned int i = 1; i < fCentroids.size(); i++ )
+    {
+        if( i_weightSoFar + i_weight + fCentroids[i].fWeight <= i_weightLimit )
+        {
+            i_weight += fCentroids[i].fWeight;
+            i_mean += ( fCentroids[i].fMean - i_mean ) * fCentroids[i].fWeight / i_weight;
+        }
+        else
+        {
+            fCentroids[n].fMean = ( float )i_mean;
+            fCentroids[n].fWeight = ( float )i_weight;
+            n++;
+            i_weightSoFar += i_weight;
+            i_weightLimit = i_total * kScaleInverse( kScale( i_weightSoFar / i_total ) + 1. );
+            i_mean = fCentroids[i].fMean;
+            i_weight = fCentroids[i].fWeight;
+        }
+    }
+    fCentroids[n].fMean = ( float )i_mean;
+    fCentroids[n].fWeight = ( float )i_weight;
+    fCentroids.resize( n + 1 );
+    fNMerged = n + 1;
+}
+
+/*
+ * quantile for probability iProb
+ *
+ * linear interpolation of the cumulative distribution between the centroid
+ * means (placed at the centre of their weight), the minimum and the maximum value
+ */
+double VQuantileSketch::getQuantile( double iProb )
+{
+    compress();
+    if( fNMerged == 0 )
+    {
+        return 0.;
+    }
+    if( fNMerged == 1 )
+    {
+        return fCentroids[0].fMean;
+    }
+    double i_total = 0.;
+    for( unsigned int i = 0; i < fNMerged; i++ )
+    {
+        i_total += fCentroids[i].fWeight;
+    }
+    double t = iProb * i_total;
+    
+    double i_c_prev = 0.5 * fCentroids[0].fWeight;
+    if( t <= i_c_prev )
+    {
+        return fMin + ( fCentroids[0].fMean - fMin ) * t / i_c_prev;
+    }
+    for( unsigned int i = 1; i < fNMerged; i++ )
+    {
+        double i_c = i_c_prev + 0.5 * ( fCentroids[i - 1].fWeight + fCentroids[i].fWeight );
+        if( t <= i_c )
+        {
+            return fCentroids[i - 1].fMean + ( fCentroids[i].fMean - fCentroids[i - 1].fMean ) * ( t - i_c_prev ) / ( i_c - i_c_prev );
+        }
+        i_c_prev = i_c;
+    }
+    if( i_total > i_c_prev )
+    {
+        return fCentroids[fNMerged - 1].fMean + ( fMax - fCentroids[fNMerged - 1].fMean ) * ( t - i_c_prev ) / ( i_total - i_c_prev );
+    }
+    return fMax;
+}
+
+void VQuantileSketch::getQuantiles( int iN, double* iQuantiles, const double* iProb )
+{
+    for( int i = 0; i < iN; i++ )
+    {
+        iQuantiles[i] = getQuantile( iProb[i] );
+    }
+}
+
+/*
+ * add all centroids of another sketch
+ */
+void VQuantileSketch::merge( const VQuantileSketch& iS )
+{
+    if( iS.fEntries == 0 )
+    {
+        return;
+    }
+    if( fEntries == 0 || iS.fMin < fMin )
+    {
+        fMin = iS.fMin;
+    }
+    if( fEntries == 0 || iS.fMax > fMax )
+    {
+        fMax = iS.fMax;
+    }
+    fCentroids.insert( fCentroids.end(), iS.fCentroids.begin(), iS.fCentroids.end() );
+    fSumW += iS.fSumW;
+    fSumWX += iS.fSumWX;
+    fEntries += iS.fEntries;
+    compress();
+}
+
+/*
+ * add centroids of a serialised sketch (see getCentroids())
+ */
+void VQuantileSketch::addCentroids( unsigned int iEntries, float iMin, float iMax,
+                                    unsigned int iN, const float* iMean, const float* iWeight )
+{
+    if( iEntries == 0 || iN == 0 || !iMean || !iWeight )
+    {
+        return;
+    }
+    if( fEntries == 0 || iMin < fMin )
+    {
+        fMin = iMin;
+    }
+    if( fEntries == 0 || iMax > fMax )
+    {
+        fMax = iMax;
+    }
+    for( unsigned int i = 0; i < iN; i++ )
+    {
+        if( iWeight[i] <= 0. )
+        {
+            continue;
+        }
+        sQuantileSketchCentroid c;
+        c.fMean = iMean[i];
+        c.fWeight = iWeight[i];
+        fCentroids.push_back( c );
+        fSumW += iWeight[i];
+        fSumWX += ( double )iWeight[i] * iMean[i];
+    }
+    fEntries += iEntries;
+    compress();
+}
+
+/*
+ * serialised sketch: list of centroids (sorted by mean)
+ *
+ * (together with getEntries(), getMin() and getMax())
+ */
+unsigned int VQuantileSketch::getCentroids( vector< float >& iMean, vector< float >& iWeight )
+{
+    compress();
+    iMean.resize( fNMerged );
+    iWeight.resize( fNMerged );
+    for( unsigned int i = 0; i < fNMerged; i++ )
+    {
+        iMean[i] = fCentroids[i].fMean;
+        iWeight[i] = fCentroids[i].fWeight;
+    }
+    return fNMerged;
+}
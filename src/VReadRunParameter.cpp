@@ -660,6 +660,24 @@ bool VReadRunParameter::readCommandline( int argc, char* argv[] )
         {
             fRunPara->fTimeCutsMin_max = atoi( iTemp.substr( iTemp.rfind( "=" ) + 1, iTemp.size() ).c_str() );
         }
+        // number of threads for the image analysis
+        else if( iTemp.find( "nthreads" ) < iTemp.size() )
+        {
+            int i_nthreads = atoi( iTemp.substr( iTemp.rfind( "=" ) + 1, iTemp.size() ).c_str() );
+            if( i_nthreads > 0 )
+            {
+                fRunPara->fNThreads = ( unsigned int )i_nthreads;
+            }
+        }
+        // number of raw data packets read ahead by the reader thread
+        else if( iTemp.find( "prefetch" ) < iTemp.size() )
+        {
+            int i_nprefetch = atoi( iTemp.substr( iTemp.rfind( "=" ) + 1, iTemp.size() ).c_str() );
+            if( i_nprefetch > 0 )
+            {
+                fRunPara->fNPrefetchPackets = ( unsigned int )i_nprefetch;
+            }
+        }
         
         // check if the user wants to print the list of dead pixels for this run
         else if( iTemp.rfind( "printdeadpixelinfo" ) < iTemp.size() ) // DEADCHAN
@@ -1438,6 +1456,7 @@ void VReadRunParameter::test_and_adjustParams()
             fRunPara->fDF_DigitalFilter.push_back( fRunPara->fDF_DigitalFilter[0] );
             fRunPara->fDF_UpSample.push_back( fRunPara->fDF_UpSample[0] );
             fRunPara->fDF_PoleZero.push_back( fRunPara->fDF_PoleZero[0] );
+            fRunPara->fSlidingWindowMethod.push_back( fRunPara->fSlidingWindowMethod[0] );
             fRunPara->fLogLikelihoodLoss_min.push_back( fRunPara->fLogLikelihoodLoss_min[0] );
             fRunPara->fLogLikelihoodLoss_max.push_back( fRunPara->fLogLikelihoodLoss_max[0] );
             fRunPara->fLogLikelihood_Ntubes_min.push_back( fRunPara->fLogLikelihood_Ntubes_min[0] );
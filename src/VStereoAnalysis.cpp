@@ -414,6 +414,7 @@ double VStereoAnalysis::fillHistograms( int icounter, int irun, double iAzMin, d
     fMap->setNoSkyPlots( fNoSkyPlots );
     fMap->setRegionToExclude( fRunPara->getExclusionRegions( fHisCounter ) );
     fMap->setHistograms( fHisto[fHisCounter]->hmap_stereo, fHisto[fHisCounter]->hmap_alpha, fHisto[fHisCounter]->hmap_MeanSignalBackgroundAreaRatio );
+    fMap->setRingKernelIntegration( fRunPara->fRingKernelIntegration );
     
     fMapUC->setData( fDataRun );
     fMapUC->setRunList( fRunPara->fRunList[fHisCounter] );
@@ -421,6 +422,7 @@ double VStereoAnalysis::fillHistograms( int icounter, int irun, double iAzMin, d
     fMapUC->setNoSkyPlots( fNoSkyPlots );
     fMapUC->setRegionToExclude( fRunPara->getExclusionRegions( fHisCounter ) );
     fMapUC->setHistograms( fHisto[fHisCounter]->hmap_stereoUC, fHisto[fHisCounter]->hmap_alphaUC, 0 );
+    fMapUC->setRingKernelIntegration( fRunPara->fRingKernelIntegration );
     
     // initialize gamma/hadron cuts
     fCuts->setDataTree( fDataRun );
@@ -442,6 +444,9 @@ double VStereoAnalysis::fillHistograms( int icounter, int irun, double iAzMin, d
                                       fRunPara->fEffectiveAreaVsEnergyMC,
                                       fRunPara->fLikelihoodAnalysis,
                                       fIsOn );
+    fEnergy.setEffectiveAreaCache( fRunPara->fEnergyEffectiveAreaCache_dZe, fRunPara->fEnergyEffectiveAreaCache_dWoff,
+                                   fRunPara->fEnergyEffectiveAreaCache_dPedVar );
+    fEnergy.setResponseMatrixEventWeighting( fRunPara->fLikelihoodResponseMatrixEventWeighted );
     double iEnergyWeighting = 1.;
     double iErec = 0.;
     double iErecChi2 = 0.;
@@ -464,6 +469,28 @@ double VStereoAnalysis::fillHistograms( int icounter, int irun, double iAzMin, d
     fNMeanElevation = 0.;
     double iDirectionOffset = 0.;
     
+    // MVA values for TMVA gamma/hadron cuts are calculated in batches of
+    // entries and cached (see VTMVAEvaluator::evaluateBatch())
+    const int i_TMVABatchSize = 1000;
+    fCuts->setTMVAResultCaching( true );
+    
+    // read only those branches of the data tree used in the event loop
+    // (validation mode: read all branches)
+    registerUsedBranches( fDataRun );
+    if( fRunPara->fValidateUsedBranches )
+    {
+        if( !validateUsedBranches( icounter, irun, i_TMVABatchSize ) )
+        {
+            cout << "VStereoAnalysis::fillHistograms error: incomplete list of used data tree branches";
+            cout << " (see VStereoAnalysis::registerUsedBranches())" << endl;
+            exit( EXIT_FAILURE );
+        }
+    }
+    else
+    {
+        fDataRun->activateUsedBranches();
+    }
+    
     // get number of entries from data tree
     Int_t nentries = Int_t( fDataRun->fChain->GetEntries() );
     if( fDebug )
@@ -479,6 +506,10 @@ double VStereoAnalysis::fillHistograms( int icounter, int irun, double iAzMin, d
     // loop over all entries/events in the data tree
     for( int i = 0; i < nentries; i++ )
     {
+        if( i % i_TMVABatchSize == 0 )
+        {
+            fCuts->evaluateTMVABatch( i, i_TMVABatchSize );
+        }
         fDataRun->GetEntry( i );
         
         if( fDebugCuts )
@@ -2099,6 +2130,190 @@ void VStereoAnalysis::getDerotatedCoordinates( unsigned int icounter, CData* iDa
         x_derot, y_derot );
 }
 
+/*
+ * register all data tree branches used in the event loop of fillHistograms()
+ * (histograms, sky maps, gamma/hadron cuts, tree with selected events and DL3 tree)
+ *
+ * branches of the TMVA training variables are taken from the weight files
+ * (see VTMVAEvaluator::registerUsedBranches()); the lists can be checked with
+ * the run parameter VALIDATEUSEDBRANCHES (see validateUsedBranches())
+ *
+ */
+void VStereoAnalysis::registerUsedBranches( CData* c )
+{
+    if( !c )
+    {
+        return;
+    }
+    c->useBranch( "runNumber" );
+    c->useBranch( "eventNumber" );
+    c->useBranch( "MJD" );
+    c->useBranch( "Time" );
+    c->useBranch( "LTrig" );
+    c->useBranch( "NImages" );
+    c->useBranch( "ImgSel" );
+    c->useBranch( "Ze" );
+    c->useBranch( "Az" );
+    c->useBranch( "ArrayPointing_Elevation" );
+    c->useBranch( "ArrayPointing_Azimuth" );
+    c->useBranch( "meanPedvar_Image" );
+    c->useBranch( "MSCW" );
+    c->useBranch( "MSCL" );
+    c->useBranch( "MWR" );
+    c->useBranch( "MLR" );
+    c->useBranch( "EmissionHeight" );
+    c->useBranch( "EmissionHeightChi2" );
+    c->useBranch( "SizeSecondMax" );
+    c->useEnergyBranches();
+    c->useDirectionBranches();
+    c->useCoreBranches();
+    
+    if( fMap )
+    {
+        fMap->registerUsedBranches( c );
+    }
+    if( fMapUC )
+    {
+        fMapUC->registerUsedBranches( c );
+    }
+    if( fCuts )
+    {
+        fCuts->registerUsedBranches( c );
+    }
+}
+
+/*
+ * validate the list of used branches (see registerUsedBranches())
+ *
+ * event selection and event-wise results (see getEventSelection()) are
+ * calculated for all entries twice: reading all branches and reading the
+ * registered branches only. Entries are processed in batches of iBatchSize
+ * entries, MVA values are calculated with VTMVAEvaluator::evaluateBatch()
+ * as in the event loop.
+ * Columns of the tree with selected events and of the DL3 tree are not compared.
+ *
+ * all branches are active after calling this function
+ *
+ * returns false if results differ for any entry
+ */
+bool VStereoAnalysis::validateUsedBranches( int icounter, int irun, int iBatchSize )
+{
+    if( !fDataRun || !fDataRun->fChain || !fCuts || iBatchSize <= 0 )
+    {
+        return false;
+    }
+    Long64_t nentries = fDataRun->fChain->GetEntries();
+    cout << "\t validating list of used data tree branches (" << nentries << " entries)" << endl;
+    
+    vector< vector< double > > i_resultsAllBranches( iBatchSize );
+    vector< double > i_results;
+    Long64_t i_ndiff = 0;
+    for( Long64_t i_min = 0; i_min < nentries; i_min += iBatchSize )
+    {
+        Long64_t i_max = TMath::Min( i_min + ( Long64_t )iBatchSize, nentries );
+        // all branches
+        fDataRun->activateAllBranches();
+        fCuts->evaluateTMVABatch( i_min, iBatchSize );
+        for( Long64_t i = i_min; i < i_max; i++ )
+        {
+            fDataRun->GetEntry( i );
+            getEventSelection( icounter, irun, i, i_resultsAllBranches[i - i_min] );
+        }
+        // registered branches only
+        fDataRun->activateUsedBranches( 0, false );
+        fCuts->evaluateTMVABatch( i_min, iBatchSize );
+        for( Long64_t i = i_min; i < i_max; i++ )
+        {
+            fDataRun->GetEntry( i );
+            getEventSelection( icounter, irun, i, i_results );
+            vector< double >& i_ref = i_resultsAllBranches[i - i_min];
+            unsigned int v = 0;
+            while( v < i_results.size() && v < i_ref.size()
+                    && ( i_results[v] == i_ref[v] || ( TMath::IsNaN( i_results[v] ) && TMath::IsNaN( i_ref[v] ) ) ) )
+            {
+                v++;
+            }
+            if( v < i_results.size() || v < i_ref.size() )
+            {
+                if( i_ndiff < 10 )
+                {
+                    cout << "\t validateUsedBranches: different results for entry " << i << " (value " << v;
+                    if( v < i_results.size() && v < i_ref.size() )
+                    {
+                        cout << ": " << i_ref[v] << " (all branches), " << i_results[v] << " (used branches)";
+                    }
+                    cout << ")" << endl;
+                }
+                i_ndiff++;
+            }
+        }
+    }
+    fDataRun->activateAllBranches();
+    cout << "\t validation of used data tree branches: " << i_ndiff << " entries with different results" << endl;
+    
+    return ( i_ndiff == 0 );
+}
+
+/*
+ * event-wise results of the event loop in fillHistograms()
+ * (for validateUsedBranches(); cuts are applied without counting,
+ *  no histograms are filled)
+ *
+ * iR: run and event number, time, cut results, MVA value, energy, direction and
+ *     all other variables used for histograms, sky maps and effective areas
+ */
+void VStereoAnalysis::getEventSelection( int icounter, int irun, Long64_t iEntry, vector< double >& iR )
+{
+    iR.clear();
+    iR.push_back( fDataRun->runNumber );
+    if( fDataRun->runNumber != irun )
+    {
+        return;
+    }
+    iR.push_back( fDataRun->eventNumber );
+    iR.push_back( fDataRun->MJD );
+    iR.push_back( fDataRun->Time );
+    if( !fCuts->applyInsideFiducialAreaCut() )
+    {
+        iR.push_back( 0. );
+        return;
+    }
+    if( !fCuts->applyStereoQualityCuts( fRunPara->fEnergyReconstructionMethod, false, iEntry, fIsOn ) )
+    {
+        iR.push_back( 1. );
+        return;
+    }
+    iR.push_back( 2. );
+    double i_xderot = -99.;
+    double i_yderot = -99.;
+    getDerotatedCoordinates( icounter, fDataRun, i_xderot, i_yderot );
+    iR.push_back( i_xderot );
+    iR.push_back( i_yderot );
+    iR.push_back( fCuts->isGamma( iEntry, false, fIsOn ) && fCuts->applyEnergyReconstructionQualityCuts( fRunPara->fEnergyReconstructionMethod ) );
+    iR.push_back( fCuts->getTMVA_EvaluationResult() );
+    iR.push_back( fCuts->getProbabilityCut_Selector() );
+    iR.push_back( fCuts->getTheta2Cut_max( fDataRun->getEnergy_TeV() ) );
+    iR.push_back( fCuts->getMeanImageWidth() );
+    iR.push_back( fCuts->getMeanImageLength() );
+    iR.push_back( fCuts->getMeanImageDistance() );
+    iR.push_back( fDataRun->getEnergy_TeV() );
+    iR.push_back( fDataRun->getEnergyChi2() );
+    iR.push_back( fDataRun->getXoff() );
+    iR.push_back( fDataRun->getYoff() );
+    iR.push_back( fDataRun->getXcore_M() );
+    iR.push_back( fDataRun->getYcore_M() );
+    iR.push_back( fDataRun->getZe() );
+    iR.push_back( fDataRun->meanPedvar_Image );
+    iR.push_back( fDataRun->LTrig );
+    iR.push_back( fDataRun->getImgSel() );
+    iR.push_back( fDataRun->MSCW );
+    iR.push_back( fDataRun->MSCL );
+    iR.push_back( fDataRun->EmissionHeight );
+    iR.push_back( fDataRun->EmissionHeightChi2 );
+    iR.push_back( fDataRun->ArrayPointing_Elevation );
+    iR.push_back( fDataRun->ArrayPointing_Azimuth );
+}
+
 double VStereoAnalysis::getWobbleNorth()
 {
     if( fRunPara && fHisCounter >= 0 && fHisCounter < ( int )fRunPara->fRunList.size() )
@@ -33,10 +33,13 @@ VStereoMaps::VStereoMaps( bool iuc, int iRandomSeed, bool iTMPL_RE_nMaxoffsource
     fNoSkyPlots = false;
     
     fRM_file = 0;
+    fRM_RingKernel = false;
     fInitRun = 0;
     
     fRandom = new TRandom3( iRandomSeed );
     
+    fCorrelatedMapsFromEventList = true;
+    
     fAcceptance = 0;
     
     fTMPL_RE_nMaxoffsource = iTMPL_RE_nMaxoffsource;
@@ -44,6 +47,7 @@ VStereoMaps::VStereoMaps( bool iuc, int iRandomSeed, bool iTMPL_RE_nMaxoffsource
     hmap_stereo = 0;
     hmap_alpha = 0;
     hmap_ratio = 0;
+    hRE_regions = 0;
     
     // diagnostic histograms for reflected region analysis
     hAuxHisList = 0;
@@ -345,6 +349,24 @@ void VStereoMaps::makeTwoDStereo_BoxSmooth( double i_xderot, double i_yderot, do
     ///////////////////////////////////
     // fill correlated maps
     
+    // collect events; maps are filled in finalize()
+    if( fCorrelatedMapsFromEventList )
+    {
+        pair< double, pair< double, double > > iKey( thetaCutMax, pair< double, double >( i_weight, i_MeanSignalBackgroundAreaRatio ) );
+        map< pair< double, pair< double, double > >, unsigned int >::iterator iL = fCorrelatedMapLayerIndex.find( iKey );
+        if( iL == fCorrelatedMapLayerIndex.end() )
+        {
+            fCorrelatedMapLayer.push_back( sCorrelatedMapLayer() );
+            fCorrelatedMapLayer.back().fThetaCutMax = thetaCutMax;
+            fCorrelatedMapLayer.back().fWeight = i_weight;
+            fCorrelatedMapLayer.back().fMeanSignalBackgroundAreaRatio = i_MeanSignalBackgroundAreaRatio;
+            iL = fCorrelatedMapLayerIndex.insert( make_pair( iKey, ( unsigned int )fCorrelatedMapLayer.size() - 1 ) ).first;
+        }
+        fCorrelatedMapLayer[iL->second].fX.push_back( i_xderot );
+        fCorrelatedMapLayer[iL->second].fY.push_back( i_yderot );
+        return;
+    }
+    
     // Constructs a 2D skymap of reconstructed source location on the camera plane
     // smoothed by a box (i.e accept all events within a given radius)
     // thetaCutMax is the radius of the smoothing box
@@ -413,6 +435,354 @@ void VStereoMaps::makeTwoDStereo_BoxSmooth( double i_xderot, double i_yderot, do
 }
 
 
+/*
+ * fill correlated sky maps from the events collected in makeTwoDStereo_BoxSmooth()
+ *
+ * Bin contents, errors (sum of squared weights) and statistics are the same
+ * as for filling each event with makeTwoDStereo_BoxSmooth() (up to the order
+ * of floating point additions):
+ * events are grouped by smoothing radius (theta cut). For each group, the
+ * offsets between event bin and map bin are classified once into
+ *  - inside: bin centre is inside the smoothing radius for any event position in the event bin
+ *  - outside: bin centre is outside the smoothing radius for any event position in the event bin
+ *  - boundary: depends on the event position inside the bin (tested for each event)
+ * Inside offsets are added by convolving the map of event counts with the disc
+ * kernel (row-wise prefix sums, one interval per kernel row), or event by event
+ * for groups with few events. The field-of-view mask is applied once per bin.
+ *
+ * n fills of a bin are added at once (n*w to the content, n*w^2 to the sum of
+ * squared weights, see addFillsToBin()); the histogram statistics are updated
+ * as for n fills at the bin centre.
+ *
+ */
+void VStereoMaps::fillCorrelatedMaps()
+{
+    if( !hmap_stereo || !hmap_alpha || fCorrelatedMapLayer.size() == 0 )
+    {
+        fCorrelatedMapLayer.clear();
+        fCorrelatedMapLayerIndex.clear();
+        return;
+    }
+    const int nx = hmap_stereo->GetNbinsX();
+    const int ny = hmap_stereo->GetNbinsY();
+    const double wx = hmap_stereo->GetXaxis()->GetBinWidth( 2 );
+    const double wy = hmap_stereo->GetYaxis()->GetBinWidth( 2 );
+    
+    // bin centres and field-of-view mask (bins beyond maximum accepted distance from camera center)
+    vector< double > i_xbin( nx, 0. );
+    vector< double > i_ybin( ny, 0. );
+    for( int i = 0; i < nx; i++ )
+    {
+        i_xbin[i] = hmap_stereo->GetXaxis()->GetBinCenter( i + 1 );
+    }
+    for( int j = 0; j < ny; j++ )
+    {
+        i_ybin[j] = hmap_stereo->GetYaxis()->GetBinCenter( j + 1 );
+    }
+    vector< char > i_mask( nx * ny, 0 );
+    for( int j = 0; j < ny; j++ )
+    {
+        for( int i = 0; i < nx; i++ )
+        {
+            if( !( sqrt( ( i_xbin[i] + fRunList.fWobbleWestMod ) * ( i_xbin[i] + fRunList.fWobbleWestMod ) +
+                         ( i_ybin[j] + fRunList.fWobbleNorthMod ) * ( i_ybin[j] + fRunList.fWobbleNorthMod ) ) > fRunList.fmaxradius ) )
+            {
+                i_mask[i + j * nx] = 1;
+            }
+        }
+    }
+    
+    // sum of all layers (stereo and alpha maps)
+    vector< double > i_stereo( nx * ny, 0. );
+    vector< double > i_alpha( nx * ny, 0. );
+    vector< double > i_alpha_w2( nx * ny, 0. );
+    // one layer
+    vector< double > i_layer( nx * ny, 0. );
+    vector< double > i_counts( nx * ny, 0. );
+    vector< double > i_prefix( ( nx + 1 ) * ny, 0. );
+    double i_nfills = 0.;
+    bool i_weighted = false;
+    
+    for( unsigned int l = 0; l < fCorrelatedMapLayer.size(); l++ )
+    {
+        const sCorrelatedMapLayer& iLayer = fCorrelatedMapLayer[l];
+        const double R = iLayer.fThetaCutMax;
+        // window around event bin (as in makeTwoDStereo_BoxSmooth)
+        const int fn_r0X = int( R / wx ) + 2;
+        const int fn_r0Y = int( R / wy ) + 2;
+        // safety margins for floating point precision
+        const double i_eps = 1.e-9 * ( R + wx + wy );
+        const double i_delta = 1.e-6;
+        
+        // classify offsets: inside interval per kernel row and boundary offsets
+        vector< int > i_row_dy;
+        vector< int > i_row_dxmin;
+        vector< int > i_row_dxmax;
+        vector< int > i_bound_dx;
+        vector< int > i_bound_dy;
+        unsigned int i_ninside = 0;
+        for( int dy = -fn_r0Y + 1; dy <= fn_r0Y; dy++ )
+        {
+            int i_dxmin = 1;
+            int i_dxmax = 0;
+            double i_dymax = ( abs( dy ) + 0.5 + i_delta ) * wy;
+            double i_dymin = ( abs( dy ) - 0.5 - i_delta > 0. ? ( abs( dy ) - 0.5 - i_delta ) * wy : 0. );
+            for( int dx = -fn_r0X + 1; dx <= fn_r0X; dx++ )
+            {
+                double i_dxmax_d = ( abs( dx ) + 0.5 + i_delta ) * wx;
+                double i_dxmin_d = ( abs( dx ) - 0.5 - i_delta > 0. ? ( abs( dx ) - 0.5 - i_delta ) * wx : 0. );
+                if( R - i_eps > 0. && i_dxmax_d * i_dxmax_d + i_dymax * i_dymax <= ( R - i_eps ) * ( R - i_eps ) )
+                {
+                    if( i_dxmin > i_dxmax )
+                    {
+                        i_dxmin = dx;
+                    }
+                    i_dxmax = dx;
+                    i_ninside++;
+                }
+                else if( !( i_dxmin_d * i_dxmin_d + i_dymin * i_dymin > ( R + i_eps ) * ( R + i_eps ) ) )
+                {
+                    i_bound_dx.push_back( dx );
+                    i_bound_dy.push_back( dy );
+                }
+            }
+            if( i_dxmin <= i_dxmax )
+            {
+                i_row_dy.push_back( dy );
+                i_row_dxmin.push_back( i_dxmin );
+                i_row_dxmax.push_back( i_dxmax );
+            }
+        }
+        
+        // event bins
+        vector< int > i_evx( iLayer.fX.size(), 0 );
+        vector< int > i_evy( iLayer.fX.size(), 0 );
+        unsigned int i_nevents_inside = 0;
+        for( unsigned int e = 0; e < iLayer.fX.size(); e++ )
+        {
+            i_evx[e] = hmap_stereo->GetXaxis()->FindBin( iLayer.fX[e] );
+            i_evy[e] = hmap_stereo->GetYaxis()->FindBin( iLayer.fY[e] );
+            if( i_evx[e] >= 1 && i_evx[e] <= nx && i_evy[e] >= 1 && i_evy[e] <= ny )
+            {
+                i_nevents_inside++;
+            }
+        }
+        
+        i_layer.assign( nx * ny, 0. );
+        // inside offsets: convolution of event counts with the disc kernel
+        if( ( double )i_nevents_inside * ( double )i_ninside > ( double )nx * ( double )ny * ( double )i_row_dy.size() )
+        {
+            i_counts.assign( nx * ny, 0. );
+            for( unsigned int e = 0; e < iLayer.fX.size(); e++ )
+            {
+                if( i_evx[e] >= 1 && i_evx[e] <= nx && i_evy[e] >= 1 && i_evy[e] <= ny )
+                {
+                    i_counts[( i_evx[e] - 1 ) + ( i_evy[e] - 1 ) * nx] += 1.;
+                }
+            }
+            for( int j = 0; j < ny; j++ )
+            {
+                i_prefix[j * ( nx + 1 )] = 0.;
+                for( int i = 0; i < nx; i++ )
+                {
+                    i_prefix[i + 1 + j * ( nx + 1 )] = i_prefix[i + j * ( nx + 1 )] + i_counts[i + j * nx];
+                }
+            }
+            for( unsigned int r = 0; r < i_row_dy.size(); r++ )
+            {
+                for( int j = 0; j < ny; j++ )
+                {
+                    int js = j - i_row_dy[r];
+                    if( js < 0 || js >= ny )
+                    {
+                        continue;
+                    }
+                    const double* p = &i_prefix[js * ( nx + 1 )];
+                    for( int i = 0; i < nx; i++ )
+                    {
+                        int i_low = ( i - i_row_dxmax[r] > 0 ? i - i_row_dxmax[r] : 0 );
+                        int i_up  = ( i - i_row_dxmin[r] + 1 < nx ? i - i_row_dxmin[r] + 1 : nx );
+                        if( i_up > i_low )
+                        {
+                            i_layer[i + j * nx] += p[i_up] - p[i_low];
+                        }
+                    }
+                }
+            }
+        }
+        // inside offsets: event by event
+        else
+        {
+            for( unsigned int e = 0; e < iLayer.fX.size(); e++ )
+            {
+                if( i_evx[e] < 1 || i_evx[e] > nx || i_evy[e] < 1 || i_evy[e] > ny )
+                {
+                    continue;
+                }
+                for( unsigned int r = 0; r < i_row_dy.size(); r++ )
+                {
+                    int j = i_evy[e] - 1 + i_row_dy[r];
+                    if( j < 0 || j >= ny )
+                    {
+                        continue;
+                    }
+                    int i_low = ( i_evx[e] - 1 + i_row_dxmin[r] > 0 ? i_evx[e] - 1 + i_row_dxmin[r] : 0 );
+                    int i_up  = ( i_evx[e] - 1 + i_row_dxmax[r] < nx - 1 ? i_evx[e] - 1 + i_row_dxmax[r] : nx - 1 );
+                    for( int i = i_low; i <= i_up; i++ )
+                    {
+                        i_layer[i + j * nx] += 1.;
+                    }
+                }
+            }
+        }
+        
+        // boundary offsets (and events outside of the map): test each event
+        for( unsigned int e = 0; e < iLayer.fX.size(); e++ )
+        {
+            const double x = iLayer.fX[e];
+            const double y = iLayer.fY[e];
+            if( i_evx[e] >= 1 && i_evx[e] <= nx && i_evy[e] >= 1 && i_evy[e] <= ny )
+            {
+                for( unsigned int b = 0; b < i_bound_dx.size(); b++ )
+                {
+                    int i = i_evx[e] - 1 + i_bound_dx[b];
+                    int j = i_evy[e] - 1 + i_bound_dy[b];
+                    if( i < 0 || i >= nx || j < 0 || j >= ny )
+                    {
+                        continue;
+                    }
+                    if( sqrt( ( x - i_xbin[i] ) * ( x - i_xbin[i] ) + ( y - i_ybin[j] ) * ( y - i_ybin[j] ) ) <= R )
+                    {
+                        i_layer[i + j * nx] += 1.;
+                    }
+                }
+            }
+            else
+            {
+                int ix_start = ( i_evx[e] - fn_r0X > 0 ? i_evx[e] - fn_r0X : 0 );
+                int ix_stopp = ( i_evx[e] + fn_r0X < nx ? i_evx[e] + fn_r0X : nx );
+                int iy_start = ( i_evy[e] - fn_r0Y > 0 ? i_evy[e] - fn_r0Y : 0 );
+                int iy_stopp = ( i_evy[e] + fn_r0Y < ny ? i_evy[e] + fn_r0Y : ny );
+                for( int i = ix_start; i < ix_stopp; i++ )
+                {
+                    for( int j = iy_start; j < iy_stopp; j++ )
+                    {
+                        if( sqrt( ( x - i_xbin[i] ) * ( x - i_xbin[i] ) + ( y - i_ybin[j] ) * ( y - i_ybin[j] ) ) <= R )
+                        {
+                            i_layer[i + j * nx] += 1.;
+                        }
+                    }
+                }
+            }
+        }
+        
+        // apply field-of-view mask and add to maps
+        double i_nfills_layer = 0.;
+        for( int k = 0; k < nx * ny; k++ )
+        {
+            if( i_mask[k] && i_layer[k] > 0. )
+            {
+                i_stereo[k] += i_layer[k];
+                i_alpha[k] += i_layer[k] * iLayer.fWeight;
+                i_alpha_w2[k] += i_layer[k] * iLayer.fWeight * iLayer.fWeight;
+                i_nfills_layer += i_layer[k];
+            }
+        }
+        if( i_nfills_layer > 0. && iLayer.fWeight != 1. )
+        {
+            i_weighted = true;
+        }
+        // area ratio histogram (n fills with unit weight)
+        if( hmap_ratio && i_nfills_layer > 0. )
+        {
+            double i_entries = hmap_ratio->GetEntries();
+            double i_stats[TH1::kNstat];
+            hmap_ratio->GetStats( i_stats );
+            int i_bin = hmap_ratio->FindBin( iLayer.fMeanSignalBackgroundAreaRatio );
+            addFillsToBin( hmap_ratio, i_bin, i_nfills_layer, i_nfills_layer );
+            if( i_bin >= 1 && i_bin <= hmap_ratio->GetNbinsX() )
+            {
+                const double x = iLayer.fMeanSignalBackgroundAreaRatio;
+                i_stats[0] += i_nfills_layer;
+                i_stats[1] += i_nfills_layer;
+                i_stats[2] += i_nfills_layer * x;
+                i_stats[3] += i_nfills_layer * x * x;
+            }
+            hmap_ratio->PutStats( i_stats );
+            hmap_ratio->SetEntries( i_entries + i_nfills_layer );
+        }
+        i_nfills += i_nfills_layer;
+    }
+    
+    // fill maps (entries and statistics as for one fill per event and bin)
+    double i_entries_stereo = hmap_stereo->GetEntries();
+    double i_entries_alpha = hmap_alpha->GetEntries();
+    // weighted fills switch on the sum of squared weights (as TH1::Fill())
+    if( i_weighted && hmap_alpha->GetSumw2N() == 0 )
+    {
+        hmap_alpha->Sumw2();
+    }
+    double i_stats_stereo[TH1::kNstat];
+    double i_stats_alpha[TH1::kNstat];
+    hmap_stereo->GetStats( i_stats_stereo );
+    hmap_alpha->GetStats( i_stats_alpha );
+    for( int j = 0; j < ny; j++ )
+    {
+        for( int i = 0; i < nx; i++ )
+        {
+            const int k = i + j * nx;
+            if( i_stereo[k] > 0. )
+            {
+                const double x = i_xbin[i];
+                const double y = i_ybin[j];
+                addFillsToBin( hmap_stereo, hmap_stereo->GetBin( i + 1, j + 1 ), i_stereo[k], i_stereo[k] );
+                addFillsToBin( hmap_alpha, hmap_alpha->GetBin( i + 1, j + 1 ), i_alpha[k], i_alpha_w2[k] );
+                // statistics: sum w, w^2, w*x, w*x^2, w*y, w*y^2, w*x*y
+                i_stats_stereo[0] += i_stereo[k];
+                i_stats_stereo[1] += i_stereo[k];
+                i_stats_stereo[2] += i_stereo[k] * x;
+                i_stats_stereo[3] += i_stereo[k] * x * x;
+                i_stats_stereo[4] += i_stereo[k] * y;
+                i_stats_stereo[5] += i_stereo[k] * y * y;
+                i_stats_stereo[6] += i_stereo[k] * x * y;
+                i_stats_alpha[0] += i_alpha[k];
+                i_stats_alpha[1] += i_alpha_w2[k];
+                i_stats_alpha[2] += i_alpha[k] * x;
+                i_stats_alpha[3] += i_alpha[k] * x * x;
+                i_stats_alpha[4] += i_alpha[k] * y;
+                i_stats_alpha[5] += i_alpha[k] * y * y;
+                i_stats_alpha[6] += i_alpha[k] * x * y;
+            }
+        }
+    }
+    hmap_stereo->PutStats( i_stats_stereo );
+    hmap_alpha->PutStats( i_stats_alpha );
+    hmap_stereo->SetEntries( i_entries_stereo + i_nfills );
+    hmap_alpha->SetEntries( i_entries_alpha + i_nfills );
+    
+    fCorrelatedMapLayer.clear();
+    fCorrelatedMapLayerIndex.clear();
+}
+
+/*
+ * add n fills to a bin with sum of weights iSumW and sum of squared weights iSumW2
+ *
+ * (statistics are not updated here)
+ */
+void VStereoMaps::addFillsToBin( TH1* h, int iBin, double iSumW, double iSumW2 )
+{
+    if( !h )
+    {
+        return;
+    }
+    h->AddBinContent( iBin, iSumW );
+    if( h->GetSumw2N() > 0 )
+    {
+        h->GetSumw2()->fArray[iBin] += iSumW2;
+    }
+}
+
+
 /*!
  *
  * return weighting for target bin
@@ -420,6 +790,9 @@ void VStereoMaps::makeTwoDStereo_BoxSmooth( double i_xderot, double i_yderot, do
  */
 void VStereoMaps::finalize( bool iIsOn, double OnOff_Alpha )
 {
+    // correlated maps
+    fillCorrelatedMaps();
+    
     //  if there is one run in on/off, assume that for all runs
     
     ///////////////////////////////////////////
@@ -536,6 +909,12 @@ void VStereoMaps::RM_getAlpha( bool iIsOn )
         iNB_expected = 1.;
     }
     
+    if( fRM_RingKernel )
+    {
+        RM_getAlpha_RingKernel( iIsOn, i_rS, i_rL, i_rU, iNB_expected );
+        return;
+    }
+    
     double i_acc = 0.;
     
     // all calculations are with camera center at (0,0), but alpha histograms are
@@ -678,6 +1057,285 @@ void VStereoMaps::RM_getAlpha( bool iIsOn )
 }
 
 
+/*!
+
+   ring model alpha maps from precomputed ring kernels
+
+   Same integration as in RM_getAlpha(), but without random sampling of the test
+   source and ring positions:
+
+   - acceptance x (1 - exclusion) is calculated once per bin (at the bin centre)
+   - the kernel is the probability that a ring bin at offset (dx,dy) from the
+     test source bin is inside the source region (on) or inside the ring (off)
+     for uniformly distributed positions in both bins (i.e. the expectation value
+     of the random sampling in RM_getAlpha())
+   - kernel offsets which are always inside are integrated with summed-area tables
+     (row-wise prefix sums; one or two intervals per kernel row), kernel offsets
+     at the ring edges are added directly with their fractional weight
+
+   Number of operations per test source is ~ number of kernel rows + number of
+   ring edge offsets (instead of number of bins in the square enclosing the ring)
+
+   Differences to RM_getAlpha() (see testRingKernel):
+   - acceptance, exclusion regions and the fiducial area cut of the test source
+     are evaluated at bin centres instead of random positions (differences in
+     bins crossing the edges of exclusion regions)
+   - no random numbers are drawn, i.e. all later uses of fRandom in this
+     instance (e.g. random removal of off regions) see a different random sequence
+
+   Used for RINGKERNELINTEGRATION 1 in the anasum run parameter file
+   (default: RM_getAlpha() with random sampling)
+
+*/
+void VStereoMaps::RM_getAlpha_RingKernel( bool iIsOn, double i_rS, double i_rL, double i_rU, double iNB_expected )
+{
+    const int nx = hmap_alpha->GetNbinsX();
+    const int ny = hmap_alpha->GetNbinsY();
+    const double x_w = hmap_stereo->GetXaxis()->GetBinWidth( 2 );
+    const double y_w = hmap_stereo->GetYaxis()->GetBinWidth( 2 );
+    
+    // all calculations are with camera center at (0,0), but alpha histograms are
+    // filled relative to source center at (0,0)
+    int i_xoff = TMath::Nint( fRunList.fWobbleWestMod / x_w );
+    int j_yoff = TMath::Nint( fRunList.fWobbleNorthMod / y_w );
+    
+    // region: i_r2L < r2 < i_r2U
+    double i_r2L = -1.;
+    double i_r2U = i_rS * i_rS;
+    if( !iIsOn )
+    {
+        i_r2L = i_rL * i_rL;
+        i_r2U = i_rU * i_rU;
+    }
+    
+    // acceptance x (1 - exclusion) map
+    vector< double > i_xC( nx, 0. );
+    vector< double > i_yC( ny, 0. );
+    for( int i = 0; i < nx; i++ )
+    {
+        i_xC[i] = hmap_alpha->GetXaxis()->GetBinCenter( i + 1 );
+    }
+    for( int j = 0; j < ny; j++ )
+    {
+        i_yC[j] = hmap_alpha->GetYaxis()->GetBinCenter( j + 1 );
+    }
+    vector< double > i_acc( nx * ny, 0. );
+    for( int j = 0; j < ny; j++ )
+    {
+        for( int i = 0; i < nx; i++ )
+        {
+            if( iIsOn && fAcceptance->isExcludedfromSource( i_xC[i], i_yC[j] ) )
+            {
+                continue;
+            }
+            if( !iIsOn && fAcceptance->isExcludedfromBackground( i_xC[i], i_yC[j] ) )
+            {
+                continue;
+            }
+            i_acc[i + j * nx] = fAcceptance->getAcceptance( i_xC[i], i_yC[j] );
+        }
+    }
+    // row-wise prefix sums (summed-area table along x)
+    vector< double > i_accSum( ( nx + 1 ) * ny, 0. );
+    for( int j = 0; j < ny; j++ )
+    {
+        for( int i = 0; i < nx; i++ )
+        {
+            i_accSum[i + 1 + j * ( nx + 1 )] = i_accSum[i + j * ( nx + 1 )] + i_acc[i + j * nx];
+        }
+    }
+    
+    // ring kernel
+    // (square enclosing the ring as in RM_getAlpha())
+    const int i_kX = ( int )( i_rU / x_w + 1 );
+    const int i_kY = ( int )( i_rU / y_w + 1 );
+    // kernel rows: intervals with weight 1
+    vector< int > i_row_dy;
+    vector< int > i_row_dxmin;
+    vector< int > i_row_dxmax;
+    // kernel offsets with fractional weight
+    vector< int > i_edge_dx;
+    vector< int > i_edge_dy;
+    vector< double > i_edge_w;
+    // sampling of position differences inside bins along x
+    // (triangular distribution between -1 and 1 bin widths;
+    //  integrated analytically along y, see RM_getTriangularCDF())
+    const int i_nSample = 64;
+    vector< double > i_t( i_nSample, 0. );
+    vector< double > i_tw( i_nSample, 0. );
+    double i_twSum = 0.;
+    for( int k = 0; k < i_nSample; k++ )
+    {
+        i_t[k] = -1. + ( k + 0.5 ) * 2. / ( double )i_nSample;
+        i_tw[k] = 1. - fabs( i_t[k] );
+        i_twSum += i_tw[k];
+    }
+    for( int dy = -i_kY; dy <= i_kY; dy++ )
+    {
+        // uncorrelated on maps: test source bin only
+        if( iIsOn && bUncorrelatedSkyMaps )
+        {
+            if( dy == 0 )
+            {
+                i_row_dy.push_back( 0 );
+                i_row_dxmin.push_back( 0 );
+                i_row_dxmax.push_back( 0 );
+            }
+            continue;
+        }
+        double i_y2min = ( abs( dy ) > 1 ? ( abs( dy ) - 1 ) * y_w * ( abs( dy ) - 1 ) * y_w : 0. );
+        double i_y2max = ( abs( dy ) + 1 ) * y_w * ( abs( dy ) + 1 ) * y_w;
+        int i_dxmin = 1;
+        int i_dxmax = 0;
+        for( int dx = -i_kX; dx <= i_kX; dx++ )
+        {
+            double i_r2min = i_y2min + ( abs( dx ) > 1 ? ( abs( dx ) - 1 ) * x_w * ( abs( dx ) - 1 ) * x_w : 0. );
+            double i_r2max = i_y2max + ( abs( dx ) + 1 ) * x_w * ( abs( dx ) + 1 ) * x_w;
+            // always outside
+            if( i_r2min >= i_r2U || i_r2max <= i_r2L )
+            {
+                continue;
+            }
+            // always inside
+            if( i_r2min > i_r2L && i_r2max < i_r2U )
+            {
+                // close interval of previous inside offsets if not contiguous
+                if( i_dxmin <= i_dxmax && dx != i_dxmax + 1 )
+                {
+                    i_row_dy.push_back( dy );
+                    i_row_dxmin.push_back( i_dxmin );
+                    i_row_dxmax.push_back( i_dxmax );
+                    i_dxmin = 1;
+                    i_dxmax = 0;
+                }
+                if( i_dxmin > i_dxmax )
+                {
+                    i_dxmin = dx;
+                }
+                i_dxmax = dx;
+                continue;
+            }
+            // ring edges: fraction of position pairs inside region
+            double i_w = 0.;
+            for( int kx = 0; kx < i_nSample; kx++ )
+            {
+                double cx = ( dx + i_t[kx] ) * x_w;
+                if( i_r2U - cx * cx <= 0. )
+                {
+                    continue;
+                }
+                // inside region for i_yL < |cy| < i_yU (in bin widths)
+                double i_yU = sqrt( i_r2U - cx * cx ) / y_w;
+                double i_yL = ( i_r2L - cx * cx > 0. ? sqrt( i_r2L - cx * cx ) / y_w : 0. );
+                double i_fy = RM_getTriangularCDF( i_yU - dy ) - RM_getTriangularCDF( i_yL - dy );
+                i_fy += RM_getTriangularCDF( -i_yL - dy ) - RM_getTriangularCDF( -i_yU - dy );
+                i_w += i_tw[kx] * i_fy;
+            }
+            i_w /= i_twSum;
+            if( i_w > 0. )
+            {
+                i_edge_dx.push_back( dx );
+                i_edge_dy.push_back( dy );
+                i_edge_w.push_back( i_w );
+            }
+        }
+        if( i_dxmin <= i_dxmax )
+        {
+            i_row_dy.push_back( dy );
+            i_row_dxmin.push_back( i_dxmin );
+            i_row_dxmax.push_back( i_dxmax );
+        }
+    }
+    
+    int i_nbinsXstart = 1;
+    int i_nbinsXstopp = nx;
+    int i_nbinsYstart = 1;
+    int i_nbinsYstopp = ny;
+    if( fNoSkyPlots )
+    {
+        i_nbinsXstart = hmap_stereo->GetXaxis()->FindBin( fRunList.fWobbleWestMod );
+        i_nbinsXstopp = hmap_stereo->GetXaxis()->FindBin( fRunList.fWobbleWestMod );
+        i_nbinsYstart = hmap_stereo->GetYaxis()->FindBin( fRunList.fWobbleNorthMod );
+        i_nbinsYstopp = hmap_stereo->GetYaxis()->FindBin( fRunList.fWobbleNorthMod );
+    }
+    
+    // i,j is the position of the test source
+    for( int i = i_nbinsXstart; i <= i_nbinsXstopp; i++ )
+    {
+        for( int j = i_nbinsYstart; j <= i_nbinsYstopp; j++ )
+        {
+            double x = hmap_alpha->GetXaxis()->GetBinCenter( i );
+            double y = hmap_alpha->GetYaxis()->GetBinCenter( j );
+            // check if test source is in fiducial area
+            if( sqrt( x * x + y * y ) > fRunList.fmaxradius )
+            {
+                hmap_alpha->SetBinContent( i - i_xoff, j - j_yoff, 0. );
+                continue;
+            }
+            double i_sum = 0.;
+            // kernel rows (weight 1)
+            for( unsigned int r = 0; r < i_row_dy.size(); r++ )
+            {
+                int cj = j - 1 + i_row_dy[r];
+                if( cj < 0 || cj >= ny )
+                {
+                    continue;
+                }
+                int ci_low = i - 1 + i_row_dxmin[r];
+                if( ci_low < 0 )
+                {
+                    ci_low = 0;
+                }
+                int ci_up = i + i_row_dxmax[r];
+                if( ci_up > nx )
+                {
+                    ci_up = nx;
+                }
+                if( ci_up > ci_low )
+                {
+                    i_sum += i_accSum[ci_up + cj * ( nx + 1 )] - i_accSum[ci_low + cj * ( nx + 1 )];
+                }
+            }
+            // ring edges
+            for( unsigned int e = 0; e < i_edge_dx.size(); e++ )
+            {
+                int ci = i - 1 + i_edge_dx[e];
+                int cj = j - 1 + i_edge_dy[e];
+                if( ci < 0 || ci >= nx || cj < 0 || cj >= ny )
+                {
+                    continue;
+                }
+                i_sum += i_edge_w[e] * i_acc[ci + cj * nx];
+            }
+            // fill the alpha map (scaled to acceptance 1)
+            hmap_alpha->SetBinContent( i - i_xoff, j - j_yoff, i_sum / iNB_expected );
+        }
+    }
+}
+
+
+/*
+ * cumulative distribution of the difference of two uniformly distributed
+ * positions in bins of width 1 (triangular distribution between -1 and 1)
+ */
+double VStereoMaps::RM_getTriangularCDF( double t )
+{
+    if( t <= -1. )
+    {
+        return 0.;
+    }
+    if( t >= 1. )
+    {
+        return 1.;
+    }
+    if( t < 0. )
+    {
+        return 0.5 * ( 1. + t ) * ( 1. + t );
+    }
+    return 1. - 0.5 * ( 1. - t ) * ( 1. - t );
+}
+
+
 /*!
 
   normalization map for reflected region model
@@ -54,6 +54,8 @@ VTMVADispAnalyzer::VTMVADispAnalyzer( string iFile, vector<ULong64_t> iTelTypeLi
 
     // list of telescope types: required to selected correct BDT weight file
     fTelescopeTypeList = iTelTypeList;
+    fCachedTelType = 0;
+    fCachedTelTypeIndex = fTelescopeTypeList.size();
 
     if( fTelescopeTypeList.size() == 0 )
     {
@@ -126,64 +128,104 @@ VTMVADispAnalyzer::VTMVADispAnalyzer( string iFile, vector<ULong64_t> iTelTypeLi
             cout << "\t multi-telescope disp analysis" << endl;
         }
 
-        fTMVAReader[fTelescopeTypeList[i]] = new TMVA::Reader( "!Color:!Silent" );
-        fTMVAReader[fTelescopeTypeList[i]]->AddVariable( "log10(width)", &fWidth );
-        fTMVAReader[fTelescopeTypeList[i]]->AddVariable( "log10(length)", &fLength );
-        fTMVAReader[fTelescopeTypeList[i]]->AddVariable( "wol", &fWoL );
-        fTMVAReader[fTelescopeTypeList[i]]->AddVariable( "log10(size)", &fSize );
-        fTMVAReader[fTelescopeTypeList[i]]->AddVariable( "log10(ntubes)", &fNtubes );
+        // list of variables (order as in training)
+        vector< string > iVarName;
+        fTMVAVariables.push_back( vector< float* >() );
+        iVarName.push_back( "log10(width)" );
+        fTMVAVariables.back().push_back( &fWidth );
+        iVarName.push_back( "log10(length)" );
+        fTMVAVariables.back().push_back( &fLength );
+        iVarName.push_back( "wol" );
+        fTMVAVariables.back().push_back( &fWoL );
+        iVarName.push_back( "log10(size)" );
+        fTMVAVariables.back().push_back( &fSize );
+        iVarName.push_back( "log10(ntubes)" );
+        fTMVAVariables.back().push_back( &fNtubes );
         // ASTRI telescopes are without timing information
         // tgrad_x is therefore ignored
         if( fTelescopeTypeList[i] != 201511619 )
         {
-            fTMVAReader[fTelescopeTypeList[i]]->AddVariable( "log10(tgrad_x*tgrad_x)", &fTGrad );
+            iVarName.push_back( "log10(tgrad_x*tgrad_x)" );
+            fTMVAVariables.back().push_back( &fTGrad );
         }
         // cross variable should be on this spot
         if( !iSingleTelescopeAnalysis )
         {
-            fTMVAReader[fTelescopeTypeList[i]]->AddVariable( "log10(cross)", &fcross );
+            iVarName.push_back( "log10(cross)" );
+            fTMVAVariables.back().push_back( &fcross );
         }
-        fTMVAReader[fTelescopeTypeList[i]]->AddVariable( "asym", &fAsymm );
-        fTMVAReader[fTelescopeTypeList[i]]->AddVariable( "loss", &fLoss );
-        fTMVAReader[fTelescopeTypeList[i]]->AddVariable( "dist", &fDist );
-        fTMVAReader[fTelescopeTypeList[i]]->AddVariable( "fui", &fFui );
+        iVarName.push_back( "asym" );
+        fTMVAVariables.back().push_back( &fAsymm );
+        iVarName.push_back( "loss" );
+        fTMVAVariables.back().push_back( &fLoss );
+        iVarName.push_back( "dist" );
+        fTMVAVariables.back().push_back( &fDist );
+        iVarName.push_back( "fui" );
+        fTMVAVariables.back().push_back( &fFui );
         if( fDispType == "BDTDispEnergy" && !iSingleTelescopeAnalysis )
         {
-            fTMVAReader[fTelescopeTypeList[i]]->AddVariable( "EHeight", &fEHeight );
-            fTMVAReader[fTelescopeTypeList[i]]->AddVariable( "Rcore", &fRcore );
+            iVarName.push_back( "EHeight" );
+            fTMVAVariables.back().push_back( &fEHeight );
+            iVarName.push_back( "Rcore" );
+            fTMVAVariables.back().push_back( &fRcore );
+        }
+
+        // compiled forest (same results as TMVA reader; faster)
+        fTMVAForest.push_back( new VTMVAForest() );
+        bool bForest = fTMVAForest.back()->initialize( iFileName.str() )
+                       && fTMVAForest.back()->getNVariables() == iVarName.size();
+        for( unsigned int v = 0; v < iVarName.size() && bForest; v++ )
+        {
+            bForest = ( fTMVAForest.back()->getVariableExpression( v ) == iVarName[v] );
+        }
+        if( bForest )
+        {
+            cout << "\t compiled BDT forest with " << fTMVAForest.back()->getNTrees() << " trees" << endl;
+            fTMVAReader.push_back( 0 );
+            continue;
+        }
+        delete fTMVAForest.back();
+        fTMVAForest.back() = 0;
+
+        // TMVA reader
+        cout << "\t using TMVA reader" << endl;
+        fTMVAReader.push_back( new TMVA::Reader( "!Color:!Silent" ) );
+        for( unsigned int v = 0; v < iVarName.size(); v++ )
+        {
+            fTMVAReader.back()->AddVariable( iVarName[v].c_str(), fTMVAVariables.back()[v] );
         }
         // spectators
-        fTMVAReader[fTelescopeTypeList[i]]->AddSpectator( "cen_x", &cen_x );
-        fTMVAReader[fTelescopeTypeList[i]]->AddSpectator( "cen_y", &cen_y );
-        fTMVAReader[fTelescopeTypeList[i]]->AddSpectator( "cosphi", &cosphi );
-        fTMVAReader[fTelescopeTypeList[i]]->AddSpectator( "sinphi", &sinphi );
-        fTMVAReader[fTelescopeTypeList[i]]->AddSpectator( "MCe0", &iMCe0 );
-        fTMVAReader[fTelescopeTypeList[i]]->AddSpectator( "MCxoff", &iMCxoff );
-        fTMVAReader[fTelescopeTypeList[i]]->AddSpectator( "MCyoff", &iMCyoff );
-        fTMVAReader[fTelescopeTypeList[i]]->AddSpectator( "MCxcore", &iMCxcore );
-        fTMVAReader[fTelescopeTypeList[i]]->AddSpectator( "MCycore", &iMCycore );
-        fTMVAReader[fTelescopeTypeList[i]]->AddSpectator( "MCrcore", &iMCrcore );
-        fTMVAReader[fTelescopeTypeList[i]]->AddSpectator( "NImages", &iNImages );
+        fTMVAReader.back()->AddSpectator( "cen_x", &cen_x );
+        fTMVAReader.back()->AddSpectator( "cen_y", &cen_y );
+        fTMVAReader.back()->AddSpectator( "cosphi", &cosphi );
+        fTMVAReader.back()->AddSpectator( "sinphi", &sinphi );
+        fTMVAReader.back()->AddSpectator( "MCe0", &iMCe0 );
+        fTMVAReader.back()->AddSpectator( "MCxoff", &iMCxoff );
+        fTMVAReader.back()->AddSpectator( "MCyoff", &iMCyoff );
+        fTMVAReader.back()->AddSpectator( "MCxcore", &iMCxcore );
+        fTMVAReader.back()->AddSpectator( "MCycore", &iMCycore );
+        fTMVAReader.back()->AddSpectator( "MCrcore", &iMCrcore );
+        fTMVAReader.back()->AddSpectator( "NImages", &iNImages );
         if( fDispType == "BDTDisp" )
         {
-            fTMVAReader[fTelescopeTypeList[i]]->AddSpectator( "dispError", &temp2 );
-            fTMVAReader[fTelescopeTypeList[i]]->AddSpectator( "dispPhi", &temp1 );
-            fTMVAReader[fTelescopeTypeList[i]]->AddSpectator( "dispSign", &temp3 );
+            fTMVAReader.back()->AddSpectator( "dispError", &temp2 );
+            fTMVAReader.back()->AddSpectator( "dispPhi", &temp1 );
+            fTMVAReader.back()->AddSpectator( "dispSign", &temp3 );
         }
         else if( fDispType == "BDTDispError" )
         {
-            fTMVAReader[fTelescopeTypeList[i]]->AddSpectator( "disp", &temp2 );
-            fTMVAReader[fTelescopeTypeList[i]]->AddSpectator( "dispPhi", &temp1 );
-            fTMVAReader[fTelescopeTypeList[i]]->AddSpectator( "dispSign", &temp3 );
+            fTMVAReader.back()->AddSpectator( "disp", &temp2 );
+            fTMVAReader.back()->AddSpectator( "dispPhi", &temp1 );
+            fTMVAReader.back()->AddSpectator( "dispSign", &temp3 );
         }
         else if( fDispType == "BDTDispSign" )
         {
-            fTMVAReader[fTelescopeTypeList[i]]->AddSpectator( "disp", &temp2 );
-            fTMVAReader[fTelescopeTypeList[i]]->AddSpectator( "dispPhi", &temp1 );
-            fTMVAReader[fTelescopeTypeList[i]]->AddSpectator( "dispError", &temp3 );
+            fTMVAReader.back()->AddSpectator( "disp", &temp2 );
+            fTMVAReader.back()->AddSpectator( "dispPhi", &temp1 );
+            fTMVAReader.back()->AddSpectator( "dispError", &temp3 );
         }
 
-        if( !fTMVAReader[fTelescopeTypeList[i]]->BookMVA( "BDTDisp", iFileName.str().c_str() ) )
+        if( !fTMVAReader.back()->BookMVA( "BDTDisp", iFileName.str().c_str() ) )
         {
             cout << "VTMVADispAnalyzer initializion error: xml weight file not found:" << endl;
             cout << "\t" << iFileName.str() << endl;
@@ -194,13 +236,49 @@ VTMVADispAnalyzer::VTMVADispAnalyzer( string iFile, vector<ULong64_t> iTelTypeLi
     bZombie = false;
 }
 
+VTMVADispAnalyzer::~VTMVADispAnalyzer()
+{
+    for( unsigned int i = 0; i < fTMVAReader.size(); i++ )
+    {
+        delete fTMVAReader[i];
+    }
+    for( unsigned int i = 0; i < fTMVAForest.size(); i++ )
+    {
+        delete fTMVAForest[i];
+    }
+}
+
 /*
- * calculate disp using the TMVA BDTs
+ * return index of telescope type in fTelescopeTypeList
+ * (fTelescopeTypeList.size() for unknown types)
  *
+ */
+unsigned int VTMVADispAnalyzer::getTelescopeTypeIndex( ULong64_t iTelType )
+{
+    if( iTelType == fCachedTelType && fCachedTelTypeIndex < fTelescopeTypeList.size() )
+    {
+        return fCachedTelTypeIndex;
+    }
+    for( unsigned int i = 0; i < fTelescopeTypeList.size(); i++ )
+    {
+        if( fTelescopeTypeList[i] == iTelType )
+        {
+            fCachedTelType = iTelType;
+            fCachedTelTypeIndex = i;
+            return i;
+        }
+    }
+    return fTelescopeTypeList.size();
+}
+
+/*
+ * fill TMVA input variables from image parameters
+ *
+ * returns false for images which cannot be evaluated
 */
-float VTMVADispAnalyzer::evaluate( float iWidth, float iLength, float iSize, float iAsymm, float iLoss, float iTGrad,
-                                   float icen_x, float icen_y, float xoff_4, float yoff_4, ULong64_t iTelType,
-                                   float iZe, float iAz, float iRcore, float iEHeight, float iDist, float iFui, float iNtubes )
+bool VTMVADispAnalyzer::setVariables( float iWidth, float iLength, float iSize, float iAsymm, float iLoss, float iTGrad,
+                                      float icen_x, float icen_y, float xoff_4, float yoff_4,
+                                      float iZe, float iAz, float iRcore, float iEHeight, float iDist, float iFui, float iNtubes )
 {
     if( iWidth > 0. )
     {
@@ -226,7 +304,7 @@ float VTMVADispAnalyzer::evaluate( float iWidth, float iLength, float iSize, flo
     }
     else
     {
-        return -99.;
+        return false;
     }
     if( iNtubes > 0. )
     {
@@ -234,7 +312,7 @@ float VTMVADispAnalyzer::evaluate( float iWidth, float iLength, float iSize, flo
     }
     else
     {
-        return -99.;
+        return false;
     }
     fTGrad = iTGrad * iTGrad;
     if( fTGrad > 0. )
@@ -265,14 +343,135 @@ float VTMVADispAnalyzer::evaluate( float iWidth, float iLength, float iSize, flo
     fDist = iDist;
     fFui  = iFui;
 
-    if( fTMVAReader.find( iTelType ) != fTMVAReader.end() && fTMVAReader[iTelType] )
+    return true;
+}
+
+/*
+ * evaluate BDT for the current values of the input variables
+ *
+ */
+float VTMVADispAnalyzer::evaluateVariables( unsigned int iTelTypeIndex )
+{
+    if( iTelTypeIndex >= fTelescopeTypeList.size() )
     {
-        return ( fTMVAReader[iTelType]->EvaluateRegression( "BDTDisp" ) )[0];
+        return -99.;
+    }
+    if( fTMVAForest[iTelTypeIndex] )
+    {
+        fBatch_TypeVariables.resize( fTMVAVariables[iTelTypeIndex].size() );
+        for( unsigned int v = 0; v < fTMVAVariables[iTelTypeIndex].size(); v++ )
+        {
+            fBatch_TypeVariables[v] = *fTMVAVariables[iTelTypeIndex][v];
+        }
+        return fTMVAForest[iTelTypeIndex]->evaluate( &fBatch_TypeVariables[0] );
+    }
+    if( fTMVAReader[iTelTypeIndex] )
+    {
+        return ( fTMVAReader[iTelTypeIndex]->EvaluateRegression( "BDTDisp" ) )[0];
     }
-
     return -99.;
 }
 
+/*
+ * calculate disp using the TMVA BDTs
+ *
+*/
+float VTMVADispAnalyzer::evaluate( float iWidth, float iLength, float iSize, float iAsymm, float iLoss, float iTGrad,
+                                   float icen_x, float icen_y, float xoff_4, float yoff_4, ULong64_t iTelType,
+                                   float iZe, float iAz, float iRcore, float iEHeight, float iDist, float iFui, float iNtubes )
+{
+    if( !setVariables( iWidth, iLength, iSize, iAsymm, iLoss, iTGrad, icen_x, icen_y, xoff_4, yoff_4,
+                       iZe, iAz, iRcore, iEHeight, iDist, iFui, iNtubes ) )
+    {
+        return -99.;
+    }
+    return evaluateVariables( getTelescopeTypeIndex( iTelType ) );
+}
+
+/*
+ * add an image to the list of images to be evaluated by evaluateImages()
+ *
+ * (parameters as for evaluate())
+*/
+void VTMVADispAnalyzer::addImage( float iWidth, float iLength, float iSize, float iAsymm, float iLoss, float iTGrad,
+                                  float icen_x, float icen_y, float xoff_4, float yoff_4, ULong64_t iTelType,
+                                  float iZe, float iAz, float iRcore, float iEHeight, float iDist, float iFui, float iNtubes )
+{
+    unsigned int iTelTypeIndex = fTelescopeTypeList.size();
+    if( setVariables( iWidth, iLength, iSize, iAsymm, iLoss, iTGrad, icen_x, icen_y, xoff_4, yoff_4,
+                      iZe, iAz, iRcore, iEHeight, iDist, iFui, iNtubes ) )
+    {
+        iTelTypeIndex = getTelescopeTypeIndex( iTelType );
+    }
+    fBatch_TelTypeIndex.push_back( iTelTypeIndex );
+    fBatch_Offset.push_back( fBatch_Variables.size() );
+    if( iTelTypeIndex < fTelescopeTypeList.size() )
+    {
+        for( unsigned int v = 0; v < fTMVAVariables[iTelTypeIndex].size(); v++ )
+        {
+            fBatch_Variables.push_back( *fTMVAVariables[iTelTypeIndex][v] );
+        }
+    }
+}
+
+/*
+ * evaluate BDTs for all images added with addImage()
+ * (one call of the compiled forest per telescope type)
+ *
+ * returns disp per image (in the order of the addImage() calls;
+ * -99. for images which cannot be evaluated)
+ *
+*/
+const vector< float >& VTMVADispAnalyzer::evaluateImages()
+{
+    fBatch_Result.assign( fBatch_TelTypeIndex.size(), -99. );
+    for( unsigned int t = 0; t < fTelescopeTypeList.size(); t++ )
+    {
+        const unsigned int iNVar = fTMVAVariables[t].size();
+        fBatch_List.clear();
+        fBatch_TypeVariables.clear();
+        for( unsigned int i = 0; i < fBatch_TelTypeIndex.size(); i++ )
+        {
+            if( fBatch_TelTypeIndex[i] == t )
+            {
+                fBatch_List.push_back( i );
+                fBatch_TypeVariables.insert( fBatch_TypeVariables.end(),
+                                             fBatch_Variables.begin() + fBatch_Offset[i],
+                                             fBatch_Variables.begin() + fBatch_Offset[i] + iNVar );
+            }
+        }
+        if( fBatch_List.size() == 0 )
+        {
+            continue;
+        }
+        if( fTMVAForest[t] )
+        {
+            fBatch_TypeResult.resize( fBatch_List.size() );
+            fTMVAForest[t]->evaluate( fBatch_List.size(), &fBatch_TypeVariables[0], &fBatch_TypeResult[0] );
+            for( unsigned int i = 0; i < fBatch_List.size(); i++ )
+            {
+                fBatch_Result[fBatch_List[i]] = fBatch_TypeResult[i];
+            }
+        }
+        else if( fTMVAReader[t] )
+        {
+            for( unsigned int i = 0; i < fBatch_List.size(); i++ )
+            {
+                for( unsigned int v = 0; v < iNVar; v++ )
+                {
+                    *fTMVAVariables[t][v] = fBatch_TypeVariables[i * iNVar + v];
+                }
+                fBatch_Result[fBatch_List[i]] = ( fTMVAReader[t]->EvaluateRegression( "BDTDisp" ) )[0];
+            }
+        }
+    }
+    fBatch_TelTypeIndex.clear();
+    fBatch_Offset.clear();
+    fBatch_Variables.clear();
+
+    return fBatch_Result;
+}
+
 void VTMVADispAnalyzer::terminate()
 {
     return;
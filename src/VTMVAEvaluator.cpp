@@ -13,6 +13,8 @@ VTMVAEvaluator::VTMVAEvaluator()
     
     fData = 0;
     fTMVAEvaluatorResults = 0;
+    fTMVAForest = 0;
+    fTMVAResultCaching = false;
     
     reset();
 }
@@ -23,6 +25,10 @@ VTMVAEvaluator::~VTMVAEvaluator()
     {
         delete fTMVACutValueFile;
     }
+    if( fTMVAForest )
+    {
+        delete fTMVAForest;
+    }
 }
 
 void VTMVAEvaluator::reset()
@@ -151,6 +157,24 @@ vector< string > VTMVAEvaluator::getTrainingVariables( string iXMLFile, vector<
     return iVar;
 }
 
+/*
+ * add an input variable to the TMVA reader of a data bin
+ *
+ * (compiled BDTs are used only if the variable lists agree)
+ */
+void VTMVAEvaluator::addVariable( unsigned int iDataBin, string iVarName, float* iVar )
+{
+    fTMVAData[iDataBin]->fTMVAReader->AddVariable( iVarName.c_str(), iVar );
+    
+    fTMVAVariables[iDataBin].push_back( iVar );
+    fTMVAVariableExpressions.insert( iVarName );
+    if( fTMVAForestID[iDataBin] >= 0
+            && fTMVAForest->getVariableExpression( fTMVAVariables[iDataBin].size() - 1, fTMVAForestID[iDataBin] ) != iVarName )
+    {
+        fTMVAForestID[iDataBin] = -1;
+    }
+}
+
 /*
 
     initialize TMVA readers
@@ -445,6 +469,19 @@ bool VTMVAEvaluator::initializeWeightFiles( string iWeightFileName,
         fTMVAData[i]->print();
     }
     
+    // compiled BDTs: one node array for all bins
+    if( fTMVAForest )
+    {
+        delete fTMVAForest;
+    }
+    fTMVAForest = new VTMVAForest();
+    fTMVAForest->setDebug( fDebug );
+    fTMVAForestID.assign( fTMVAData.size(), -1 );
+    fTMVAVariables.assign( fTMVAData.size(), vector< float* >() );
+    fTMVAVariableExpressions.clear();
+    fTMVAResultCache_MVA.clear();
+    fTMVAResultCache_Key.clear();
+    
     //////////////////////////////////////////////////////////////////////////////////////
     // create and initialize TMVA readers
     // loop over all  energy bins: open one weight (XML) file per energy bin
@@ -481,6 +518,8 @@ bool VTMVAEvaluator::initializeWeightFiles( string iWeightFileName,
             cout << "reading TMVA XML weight file: " << fTMVAData[b]->fTMVAFileNameXML << endl;
         }
         
+        fTMVAForestID[b] = fTMVAForest->addForest( fTMVAData[b]->fTMVAFileNameXML );
+        
         // get list of training variables
         vector< bool > iVariableIsASpectator;
         vector< string > iTrainingVariables = getTrainingVariables( fTMVAData[b]->fTMVAFileNameXML, iVariableIsASpectator );
@@ -490,101 +529,101 @@ bool VTMVAEvaluator::initializeWeightFiles( string iWeightFileName,
         {
             if( iTrainingVariables[t] == "MSCW" && !iVariableIsASpectator[t] )
             {
-                fTMVAData[b]->fTMVAReader->AddVariable( "MSCW", &fMSCW );
+                addVariable( b, "MSCW", &fMSCW );
             }
             else if( iTrainingVariables[t] == "MSCL" && !iVariableIsASpectator[t] )
             {
-                fTMVAData[b]->fTMVAReader->AddVariable( "MSCL", &fMSCL );
+                addVariable( b, "MSCL", &fMSCL );
             }
             else if( iTrainingVariables[t] == "EmissionHeight" && !iVariableIsASpectator[t] )
             {
-                fTMVAData[b]->fTMVAReader->AddVariable( "EmissionHeight", &fEmissionHeight );
+                addVariable( b, "EmissionHeight", &fEmissionHeight );
             }
             else if( iTrainingVariables[t] == "log10(EmissionHeightChi2)" && !iVariableIsASpectator[t] )
             {
-                fTMVAData[b]->fTMVAReader->AddVariable( "log10(EmissionHeightChi2)", &fEmissionHeightChi2_log10 );
+                addVariable( b, "log10(EmissionHeightChi2)", &fEmissionHeightChi2_log10 );
             }
             else if( iTrainingVariables[t] == "NImages" && !iVariableIsASpectator[t] )
             {
-                fTMVAData[b]->fTMVAReader->AddVariable( "NImages", &fNImages );
+                addVariable( b, "NImages", &fNImages );
             }
             else if( iTrainingVariables[t] == "dE" && !iVariableIsASpectator[t] )
             {
-                fTMVAData[b]->fTMVAReader->AddVariable( "dE", &fdES );
+                addVariable( b, "dE", &fdES );
             }
             else if( iTrainingVariables[t] == "EChi2" && !iVariableIsASpectator[t] )
             {
-                fTMVAData[b]->fTMVAReader->AddVariable( "EChi2", &fEChi2S );
+                addVariable( b, "EChi2", &fEChi2S );
                 fEnergyReconstructionMethod = 0;
             }
             else if( iTrainingVariables[t] == "log10(EChi2)" && !iVariableIsASpectator[t] )
             {
-                fTMVAData[b]->fTMVAReader->AddVariable( "log10(EChi2)", &fEChi2S_log10 );
+                addVariable( b, "log10(EChi2)", &fEChi2S_log10 );
             }
             else if( iTrainingVariables[t] == "dES" && !iVariableIsASpectator[t] )
             {
-                fTMVAData[b]->fTMVAReader->AddVariable( "dES", &fdES );
+                addVariable( b, "dES", &fdES );
             }
             else if( iTrainingVariables[t] == "log10(SizeSecondMax)" && !iVariableIsASpectator[t] )
             {
-                fTMVAData[b]->fTMVAReader->AddVariable( "log10(SizeSecondMax)", &fSizeSecondMax_log10 );
+                addVariable( b, "log10(SizeSecondMax)", &fSizeSecondMax_log10 );
             }
             else if( iTrainingVariables[t] == "EChi2S" && !iVariableIsASpectator[t] )
             {
-                fTMVAData[b]->fTMVAReader->AddVariable( "EChi2S", &fEChi2S );
+                addVariable( b, "EChi2S", &fEChi2S );
                 fEnergyReconstructionMethod = 1;
             }
             else if( iTrainingVariables[t] == "log10((EChi2S&lt;0)+(EChi2S&gt;0)*EChi2S)" && !iVariableIsASpectator[t] )
             {
-                fTMVAData[b]->fTMVAReader->AddVariable( "log10((EChi2S<0)+(EChi2S>0)*EChi2S)", &fEChi2S_gt0 );
+                addVariable( b, "log10((EChi2S<0)+(EChi2S>0)*EChi2S)", &fEChi2S_gt0 );
                 fEnergyReconstructionMethod = 1;
             }
             else if( iTrainingVariables[t] == "(EChi2S&lt;=0)" && !iVariableIsASpectator[t] )
             {
-                fTMVAData[b]->fTMVAReader->AddVariable( "(EChi2S<=0)", &fEChi2S_gt0_bool );
+                addVariable( b, "(EChi2S<=0)", &fEChi2S_gt0_bool );
             }
             else if( iTrainingVariables[t] == "log10(EChi2S)" && !iVariableIsASpectator[t] )
             {
-                fTMVAData[b]->fTMVAReader->AddVariable( "log10(EChi2S)", &fEChi2S_log10 );
+                addVariable( b, "log10(EChi2S)", &fEChi2S_log10 );
             }
             else if( iTrainingVariables[t] == "(Xoff*Xoff+Yoff*Yoff)" && !iVariableIsASpectator[t] )
             {
-                fTMVAData[b]->fTMVAReader->AddVariable( "(Xoff*Xoff+Yoff*Yoff)", &fTheta2 );
+                addVariable( b, "(Xoff*Xoff+Yoff*Yoff)", &fTheta2 );
                 setTMVAThetaCutVariable( true );
             }
             else if( iTrainingVariables[t] == "sqrt(Xcore*Xcore+Ycore*Ycore)" && !iVariableIsASpectator[t] )
             {
-                fTMVAData[b]->fTMVAReader->AddVariable( "sqrt(Xcore*Xcore+Ycore*Ycore)", &fCoreDist );
+                addVariable( b, "sqrt(Xcore*Xcore+Ycore*Ycore)", &fCoreDist );
             }
             // disp below
             else if( iTrainingVariables[t] == "log10(DispDiff)" && !iVariableIsASpectator[t] )
             {
-                fTMVAData[b]->fTMVAReader->AddVariable( "log10(DispDiff)", &fDispDiff_log10 );
+                addVariable( b, "log10(DispDiff)", &fDispDiff_log10 );
             }
             else if( iTrainingVariables[t] == "log10((DispDiff&lt;=0)+(DispDiff&gt;0.)*DispDiff)" && !iVariableIsASpectator[t] )
             {
-                fTMVAData[b]->fTMVAReader->AddVariable( "log10((DispDiff<=0)+(DispDiff>0.)*DispDiff)", &fDispDiff_gt0 );
+                addVariable( b, "log10((DispDiff<=0)+(DispDiff>0.)*DispDiff)", &fDispDiff_gt0 );
             }
             else if( iTrainingVariables[t] == "(DispDiff&lt;=0)" && !iVariableIsASpectator[t] )
             {
-                fTMVAData[b]->fTMVAReader->AddVariable( "(DispDiff<=0)", &fDispDiff_gt0_bool );
+                addVariable( b, "(DispDiff<=0)", &fDispDiff_gt0_bool );
             }
             else if( iTrainingVariables[t] == "DispAbsSumWeigth" && !iVariableIsASpectator[t] )
             {
-                fTMVAData[b]->fTMVAReader->AddVariable( "DispAbsSumWeigth", &fDispAbsSumWeigth );
+                addVariable( b, "DispAbsSumWeigth", &fDispAbsSumWeigth );
             }
             // Note: assume not more then 3 different telescope types
             else if( iTrainingVariables[t] == "NImages_Ttype[0]" && !iVariableIsASpectator[t] )
             {
-                fTMVAData[b]->fTMVAReader->AddVariable( "NImages_Ttype[0]", &fImages_Ttype[0] );
+                addVariable( b, "NImages_Ttype[0]", &fImages_Ttype[0] );
             }
             else if( iTrainingVariables[t] == "NImages_Ttype[1]" && !iVariableIsASpectator[t] )
             {
-                fTMVAData[b]->fTMVAReader->AddVariable( "NImages_Ttype[1]", &fImages_Ttype[1] );
+                addVariable( b, "NImages_Ttype[1]", &fImages_Ttype[1] );
             }
             else if( iTrainingVariables[t] == "NImages_Ttype[2]" && !iVariableIsASpectator[t] )
             {
-                fTMVAData[b]->fTMVAReader->AddVariable( "NImages_Ttype[2]", &fImages_Ttype[2] );
+                addVariable( b, "NImages_Ttype[2]", &fImages_Ttype[2] );
             }
             else if( iVariableIsASpectator[t] )
             {
@@ -612,6 +651,16 @@ bool VTMVAEvaluator::initializeWeightFiles( string iWeightFileName,
             fIsZombie = true;
             return false;
         }
+        // compiled BDT requires the same input variables as the reader
+        if( fTMVAForestID[b] >= 0
+                && fTMVAForest->getNVariables( fTMVAForestID[b] ) != fTMVAVariables[b].size() )
+        {
+            fTMVAForestID[b] = -1;
+        }
+        if( fDebug && fTMVAForestID[b] >= 0 )
+        {
+            cout << "\t compiled BDT with " << fTMVAForest->getNTrees( fTMVAForestID[b] ) << " trees" << endl;
+        }
         /////////////////////////////////////////////////////////
         // get optimal signal efficiency (from maximum signal/noise ratio)
         /////////////////////////////////////////////////////////
@@ -825,18 +874,12 @@ bool VTMVAEvaluator::getValuesFromEfficiencyHistograms( unsigned int b )
     return true;
 }
 
-/*!
-
-    evaluate this event using the MVA and return passed/not passed
-
-*/
-bool VTMVAEvaluator::evaluate()
+/*
+ * copy gamma/hadron separation variables of the current event
+ * (returns false if no data tree is set)
+ */
+bool VTMVAEvaluator::fillEventVariables()
 {
-    if( fDebug )
-    {
-        cout << "VTMVAEvaluator::evaluate (" << fData << ")" << endl;
-    }
-    // copy event data
     if( fData )
     {
         fNImages        = ( float )fData->getNImages();
@@ -914,6 +957,29 @@ bool VTMVAEvaluator::evaluate()
         return false;
     }
     
+    return true;
+}
+
+/*!
+
+    evaluate this event using the MVA and return passed/not passed
+
+    iEntry: entry number of this event in the data tree (used for caching
+            of MVA values; see setResultCaching())
+
+*/
+bool VTMVAEvaluator::evaluate( Long64_t iEntry )
+{
+    if( fDebug )
+    {
+        cout << "VTMVAEvaluator::evaluate (" << fData << ")" << endl;
+    }
+    // copy event data
+    if( !fillEventVariables() )
+    {
+        return false;
+    }
+    
     // valid energy is required for TMVA evaluation
     if( fData->getEnergy_TeV() < 0 )
     {
@@ -936,7 +1002,7 @@ bool VTMVAEvaluator::evaluate()
         }
         
         // evaluate MVA for this event
-        fTMVA_EvaluationResult = fTMVAData[iDataBin]->fTMVAReader->EvaluateMVA( fTMVAData[iDataBin]->fTMVAMethodTag_2 );
+        fTMVA_EvaluationResult = evaluateMVA( iDataBin, iEntry );
         
         // evaluate interpolate MVA for this event
         // fTMVA_EvaluationResult = evaluateInterPolateMVA( fData->getEnergy_Log10(), fData->getZe(), iDataBin );
@@ -971,6 +1037,164 @@ bool VTMVAEvaluator::evaluate()
     return false;
 }
 
+/*
+ * calculate MVA value of the current event for a given data bin
+ *
+ * uses the compiled BDT if available (identical results to TMVA reader)
+ *
+ * MVA values are cached per entry if result caching is switched on
+ * (e.g. for the repeated loops over the same events in makeEffectiveArea);
+ * cached values are used only if the entry was evaluated before with
+ * identical input variables in the same data bin (see also evaluateBatch())
+ */
+double VTMVAEvaluator::evaluateMVA( unsigned int iDataBin, Long64_t iEntry )
+{
+    fillVariableValues( iDataBin );
+    
+    ULong64_t i_key = 0;
+    bool bCache = ( fTMVAResultCaching && iEntry >= 0 );
+    if( bCache )
+    {
+        i_key = getEventKey( iDataBin );
+        if( iEntry < ( Long64_t )fTMVAResultCache_Key.size() && fTMVAResultCache_Key[iEntry] == i_key )
+        {
+            return fTMVAResultCache_MVA[iEntry];
+        }
+    }
+    
+    double i_mva = -99.;
+    if( fTMVAForestID[iDataBin] >= 0 )
+    {
+        i_mva = fTMVAForest->evaluate( fTMVAForestID[iDataBin], &fTMVAVariableValues[0] );
+    }
+    else
+    {
+        i_mva = fTMVAData[iDataBin]->fTMVAReader->EvaluateMVA( fTMVAData[iDataBin]->fTMVAMethodTag_2 );
+    }
+    
+    if( bCache )
+    {
+        if( iEntry >= ( Long64_t )fTMVAResultCache_Key.size() )
+        {
+            fTMVAResultCache_Key.resize( iEntry + 1, 0 );
+            fTMVAResultCache_MVA.resize( iEntry + 1, -99. );
+        }
+        fTMVAResultCache_Key[iEntry] = i_key;
+        fTMVAResultCache_MVA[iEntry] = i_mva;
+    }
+    return i_mva;
+}
+
+/*
+ * copy input variables of a data bin (order of weight file) into fTMVAVariableValues
+ */
+void VTMVAEvaluator::fillVariableValues( unsigned int iDataBin )
+{
+    fTMVAVariableValues.resize( fTMVAVariables[iDataBin].size() );
+    for( unsigned int v = 0; v < fTMVAVariables[iDataBin].size(); v++ )
+    {
+        fTMVAVariableValues[v] = *fTMVAVariables[iDataBin][v];
+    }
+}
+
+/*
+ * event key for the MVA result cache: hash (FNV-1a) of data bin and
+ * input variables (see fillVariableValues())
+ *
+ * (0 is reserved for entries without cached value)
+ */
+ULong64_t VTMVAEvaluator::getEventKey( unsigned int iDataBin )
+{
+    ULong64_t i_key = 14695981039346656037ULL;
+    i_key = ( i_key ^ ( ULong64_t )iDataBin ) * 1099511628211ULL;
+    for( unsigned int v = 0; v < fTMVAVariableValues.size(); v++ )
+    {
+        unsigned int i_bits = 0;
+        memcpy( &i_bits, &fTMVAVariableValues[v], sizeof( float ) );
+        i_key = ( i_key ^ ( ULong64_t )i_bits ) * 1099511628211ULL;
+    }
+    if( i_key == 0 )
+    {
+        i_key = 1;
+    }
+    return i_key;
+}
+
+/*
+ * calculate MVA values for the tree entries [iEntry_min, iEntry_min + iNEntries)
+ * and fill them into the result cache (requires result caching; see setResultCaching())
+ *
+ * events are grouped by data bin and scored with the batch interface of the
+ * compiled BDTs; evaluate( iEntry ) then takes the MVA values from the cache.
+ * Events in data bins without compiled BDT are evaluated in evaluate().
+ *
+ * Note: entries are read from the data tree; the current entry has to be
+ *       read again by the caller. Only branches activated for the data
+ *       tree are read (see CData::activateUsedBranches()), the input variables
+ *       are therefore correct only if all their branches are registered
+ *       (see registerUsedBranches())
+ */
+void VTMVAEvaluator::evaluateBatch( Long64_t iEntry_min, Long64_t iNEntries )
+{
+    if( !fData || !fTMVAForest || !fTMVAResultCaching || iEntry_min < 0 || iNEntries <= 0 )
+    {
+        return;
+    }
+    fBatchEntry.resize( fTMVAData.size() );
+    fBatchKey.resize( fTMVAData.size() );
+    fBatchVariables.resize( fTMVAData.size() );
+    for( unsigned int b = 0; b < fTMVAData.size(); b++ )
+    {
+        fBatchEntry[b].clear();
+        fBatchKey[b].clear();
+        fBatchVariables[b].clear();
+    }
+    
+    // collect input variables of all events (per data bin)
+    for( Long64_t i = iEntry_min; i < iEntry_min + iNEntries; i++ )
+    {
+        if( fData->GetEntry( i ) <= 0 )
+        {
+            break;
+        }
+        if( !fillEventVariables() || fData->getEnergy_TeV() < 0 )
+        {
+            continue;
+        }
+        unsigned int iDataBin = getDataBin( fData->getEnergy_Log10(), fData->getZe() );
+        if( iDataBin >= fTMVAData.size() || fTMVAForestID[iDataBin] < 0 )
+        {
+            continue;
+        }
+        fillVariableValues( iDataBin );
+        fBatchEntry[iDataBin].push_back( i );
+        fBatchKey[iDataBin].push_back( getEventKey( iDataBin ) );
+        fBatchVariables[iDataBin].insert( fBatchVariables[iDataBin].end(), fTMVAVariableValues.begin(), fTMVAVariableValues.end() );
+    }
+    
+    // score all events of a data bin in one batch
+    for( unsigned int b = 0; b < fTMVAData.size(); b++ )
+    {
+        unsigned int n = fBatchEntry[b].size();
+        if( n == 0 )
+        {
+            continue;
+        }
+        fBatchMVA.resize( n );
+        fTMVAForest->evaluate( fTMVAForestID[b], n, &fBatchVariables[b][0], &fBatchMVA[0] );
+        if( fBatchEntry[b].back() >= ( Long64_t )fTMVAResultCache_Key.size() )
+        {
+            fTMVAResultCache_Key.resize( iEntry_min + iNEntries, 0 );
+            fTMVAResultCache_MVA.resize( iEntry_min + iNEntries, -99. );
+        }
+        for( unsigned int e = 0; e < n; e++ )
+        {
+            fTMVAResultCache_Key[fBatchEntry[b][e]] = fBatchKey[b][e];
+            fTMVAResultCache_MVA[fBatchEntry[b][e]] = fBatchMVA[e];
+        }
+    }
+}
+
 /*
  * calculate MVA for a given event
  *
@@ -988,7 +1212,7 @@ double VTMVAEvaluator::evaluateInterPolateMVA( double iErec_log10TeV, double iZe
     // for the TMVAs
     if( fWeightFileIndex_Emax - fWeightFileIndex_Emin == 1 )
     {
-        return fTMVAData[iDataBin]->fTMVAReader->EvaluateMVA( fTMVAData[iDataBin]->fTMVAMethodTag_2 );
+        return evaluateMVA( iDataBin );
     }
     
     for( unsigned int w = 0; w < iW.size(); w++ )
@@ -997,7 +1221,7 @@ double VTMVAEvaluator::evaluateInterPolateMVA( double iErec_log10TeV, double iZe
         if( w < fTMVAData.size() && iW[w] > 0.001
                 && fTMVAData[w]->fTMVAReader )
         {
-            double t = fTMVAData[w]->fTMVAReader->EvaluateMVA( fTMVAData[w]->fTMVAMethodTag_2 );
+            double t = evaluateMVA( w );
             iMVA += iW[w] * t;
             iMVA_tot += iW[w];
         }
@@ -1167,6 +1391,29 @@ bool VTMVAEvaluator::initializeDataStrutures( CData* iC )
     return true;
 }
 
+/*
+ * register data tree branches used in evaluate() and evaluateBatch()
+ * (see CData::activateUsedBranches())
+ *
+ * branches of the training variables are taken from the variable
+ * expressions of the TMVA weight files (see initializeWeightFiles());
+ * energy and zenith angle are needed for the choice of the data bin
+ *
+ */
+void VTMVAEvaluator::registerUsedBranches( CData* iC )
+{
+    if( !iC )
+    {
+        return;
+    }
+    iC->useEnergyBranches();
+    iC->useBranch( "Ze" );
+    for( set< string >::iterator it = fTMVAVariableExpressions.begin(); it != fTMVAVariableExpressions.end(); ++it )
+    {
+        iC->useExpressionBranches( *it );
+    }
+}
+
 /*
 
    get energy dependent theta2 cut
@@ -0,0 +1,546 @@
+/*! \class VTMVAForest
+    \brief TMVA BDT weight files compiled into a flat node array
+
+    Reads the decision trees of one or several TMVA BDT weight files (xml) once
+    and stores all nodes of all trees of all forests in one contiguous array
+    (variable index, cut value, child indices, leaf value). Events are evaluated
+    one by one or in batches (tree by tree for all events of a batch; transformed
+    variables stored variable by variable).
+
+    Evaluation reproduces TMVA::Reader::EvaluateRegression() and
+    TMVA::Reader::EvaluateMVA() for BDTs:
+    - same variable transformation (none or Normalize, float arithmetic as in
+      TMVA::VariableNormalizeTransform)
+    - same decisions in each node (x >= cut; inverted for cut type 0)
+    - same leaf values (response for regression trees; node type or purity
+      for classification trees, depending on UseYesNoLeaf)
+    - same summation of tree responses (see TMVA::MethodBDT::GetRegressionValues()
+      and TMVA::MethodBDT::PrivateGetMvaValue())
+    - same inverse transformation of the target (regression) and
+      MVA value -999 for events with NaN input variables (classification)
+
+    Not implemented (forest is not added; use TMVA::Reader instead):
+    multiclass BDTs, AdaBoostR2 (regression), boost types other than AdaBoost and
+    Grad (classification), Fisher cuts, and transformations other than Normalize.
+
+*/
+
+#include "VTMVAForest.h"
+
+VTMVAForest::VTMVAForest()
+{
+    fDebug = false;
+    bZombie = true;
+}
+
+/*
+ * read decision trees from a single TMVA weight file
+ * (removes all previously added forests)
+ *
+ */
+bool VTMVAForest::initialize( string iXMLFile )
+{
+    fForest.clear();
+    fNode.clear();
+    fTreeRoot.clear();
+    fBoostWeight.clear();
+
+    bZombie = ( addForest( iXMLFile ) < 0 );
+    return !bZombie;
+}
+
+/*
+ * read decision trees from TMVA weight file and add them to the node array
+ *
+ * returns forest index (-1 for files which cannot be compiled)
+ */
+int VTMVAForest::addForest( string iXMLFile )
+{
+    sForest f;
+    f.fFileName = iXMLFile;
+    f.fRegression = false;
+    f.fGrad = false;
+    f.fTree_min = fTreeRoot.size();
+    f.fNTrees = 0;
+
+    TXMLEngine iXML;
+    XMLDocPointer_t iDoc = iXML.ParseFile( iXMLFile.c_str(), 10000000 );
+    if( !iDoc )
+    {
+        cout << "VTMVAForest::addForest error: cannot read TMVA weight file " << iXMLFile << endl;
+        return -1;
+    }
+    XMLNodePointer_t iRoot = iXML.DocGetRootElement( iDoc );
+    string iMethod = ( iXML.GetAttr( iRoot, "Method" ) ? iXML.GetAttr( iRoot, "Method" ) : "" );
+    string iAnalysisType = "";
+    string iBoostType = "";
+    bool   bUseYesNoLeaf = true;
+    XMLNodePointer_t iTransformations = 0;
+    XMLNodePointer_t iWeights = 0;
+    for( XMLNodePointer_t n = iXML.GetChild( iRoot ); n; n = iXML.GetNext( n ) )
+    {
+        string iName = iXML.GetNodeName( n );
+        if( iName == "GeneralInfo" )
+        {
+            for( XMLNodePointer_t i = iXML.GetChild( n ); i; i = iXML.GetNext( i ) )
+            {
+                if( iXML.GetAttr( i, "name" ) && string( iXML.GetAttr( i, "name" ) ) == "AnalysisType"
+                        && iXML.GetAttr( i, "value" ) )
+                {
+                    iAnalysisType = iXML.GetAttr( i, "value" );
+                }
+            }
+        }
+        else if( iName == "Options" )
+        {
+            for( XMLNodePointer_t o = iXML.GetChild( n ); o; o = iXML.GetNext( o ) )
+            {
+                if( !iXML.GetAttr( o, "name" ) || !iXML.GetNodeContent( o ) )
+                {
+                    continue;
+                }
+                string iOption = iXML.GetAttr( o, "name" );
+                if( iOption == "BoostType" )
+                {
+                    iBoostType = iXML.GetNodeContent( o );
+                }
+                else if( iOption == "UseYesNoLeaf" )
+                {
+                    bUseYesNoLeaf = ( string( iXML.GetNodeContent( o ) ) == "True" );
+                }
+            }
+        }
+        else if( iName == "Variables" )
+        {
+            for( XMLNodePointer_t v = iXML.GetChild( n ); v; v = iXML.GetNext( v ) )
+            {
+                f.fVariableExpression.push_back( iXML.GetAttr( v, "Expression" ) ? iXML.GetAttr( v, "Expression" ) : "" );
+            }
+        }
+        else if( iName == "Transformations" )
+        {
+            iTransformations = n;
+        }
+        else if( iName == "Weights" )
+        {
+            iWeights = n;
+        }
+    }
+    f.fRegression = ( iAnalysisType == "Regression" );
+    f.fGrad = ( iBoostType == "Grad" );
+
+    // leaf values (see TMVA::DecisionTree::CheckEvent()):
+    // 0: response (regression trees); 1: node type; 2: purity
+    int iLeafValue = 0;
+    string iError = "";
+    if( iMethod.find( "BDT" ) != 0 )
+    {
+        iError = "no BDT";
+    }
+    else if( !iWeights || !iXML.GetAttr( iWeights, "AnalysisType" ) )
+    {
+        iError = "no decision trees";
+    }
+    else if( f.fRegression && iBoostType == "AdaBoostR2" )
+    {
+        iError = "boost type AdaBoostR2 not implemented";
+    }
+    else if( !f.fRegression && ( iAnalysisType != "Classification" || ( !f.fGrad && iBoostType != "AdaBoost" ) ) )
+    {
+        iError = "analysis type " + iAnalysisType + " with boost type " + iBoostType + " not implemented";
+    }
+    else if( !readTransformation( iXML, iTransformations, f ) )
+    {
+        iError = "variable transformation not implemented";
+    }
+    else
+    {
+        // trees are regression trees for regression and gradient boosting
+        if( atoi( iXML.GetAttr( iWeights, "AnalysisType" ) ) != 1 )
+        {
+            iLeafValue = ( bUseYesNoLeaf ? 1 : 2 );
+        }
+        if( ( f.fRegression || f.fGrad ) && iLeafValue != 0 )
+        {
+            iError = "unexpected decision tree type";
+        }
+        else if( !readTrees( iXML, iWeights, f, iLeafValue ) )
+        {
+            iError = "unsupported decision tree structure";
+        }
+    }
+    iXML.FreeDoc( iDoc );
+
+    if( iError.size() > 0 )
+    {
+        if( fDebug )
+        {
+            cout << "VTMVAForest::addForest: " << iError << " (" << iXMLFile << ")" << endl;
+        }
+        // remove trees of this forest
+        if( f.fTree_min < fTreeRoot.size() )
+        {
+            fNode.resize( fTreeRoot[f.fTree_min] );
+            fTreeRoot.resize( f.fTree_min );
+            fBoostWeight.resize( f.fTree_min );
+        }
+        return -1;
+    }
+    f.fNTrees = fTreeRoot.size() - f.fTree_min;
+    fForest.push_back( f );
+    if( fDebug )
+    {
+        cout << "VTMVAForest::addForest: " << f.fNTrees << " trees, ";
+        cout << fNode.size() << " nodes in total (" << iXMLFile << ")" << endl;
+    }
+    bZombie = false;
+    return ( int )fForest.size() - 1;
+}
+
+/*
+ * read variable transformation (none or Normalize)
+ *
+ */
+bool VTMVAForest::readTransformation( TXMLEngine& iXML, XMLNodePointer_t iNode, sForest& iForest )
+{
+    const unsigned int iNVar = iForest.fVariableExpression.size();
+    iForest.fVarNormalise.assign( iNVar, 0 );
+    iForest.fVarOffset.assign( iNVar, 0. );
+    iForest.fVarScale.assign( iNVar, 1. );
+    iForest.fTargetNormalise = false;
+    iForest.fTargetOffset = 0.;
+    iForest.fTargetScale = 1.;
+
+    if( !iNode || !iXML.GetChild( iNode ) )
+    {
+        return true;
+    }
+    XMLNodePointer_t iTransform = iXML.GetChild( iNode );
+    if( iXML.GetNext( iTransform )
+            || !iXML.GetAttr( iTransform, "Name" )
+            || string( iXML.GetAttr( iTransform, "Name" ) ) != "Normalize" )
+    {
+        return false;
+    }
+    // list of transformed variables and targets
+    // (variable index; -1 for target; -2 for others)
+    vector< int > iInput;
+    XMLNodePointer_t iClass = 0;
+    for( XMLNodePointer_t n = iXML.GetChild( iTransform ); n; n = iXML.GetNext( n ) )
+    {
+        string iName = iXML.GetNodeName( n );
+        if( iName == "Selection" )
+        {
+            for( XMLNodePointer_t s = iXML.GetChild( n ); s; s = iXML.GetNext( s ) )
+            {
+                if( string( iXML.GetNodeName( s ) ) != "Input" )
+                {
+                    continue;
+                }
+                for( XMLNodePointer_t i = iXML.GetChild( s ); i; i = iXML.GetNext( i ) )
+                {
+                    string iType = ( iXML.GetAttr( i, "Type" ) ? iXML.GetAttr( i, "Type" ) : "" );
+                    string iExpression = ( iXML.GetAttr( i, "Expression" ) ? iXML.GetAttr( i, "Expression" ) : "" );
+                    int iIndex = -2;
+                    if( iType == "Variable" )
+                    {
+                        for( unsigned int v = 0; v < iNVar; v++ )
+                        {
+                            if( iForest.fVariableExpression[v] == iExpression )
+                            {
+                                iIndex = ( int )v;
+                                break;
+                            }
+                        }
+                    }
+                    else if( iType == "Target" )
+                    {
+                        iIndex = -1;
+                    }
+                    iInput.push_back( iIndex );
+                }
+            }
+        }
+        // ranges of all classes combined are given for the last class
+        else if( iName == "Class" )
+        {
+            iClass = n;
+        }
+    }
+    if( !iClass || iInput.size() == 0 )
+    {
+        return false;
+    }
+    for( XMLNodePointer_t r = iXML.GetChild( iClass ); r; r = iXML.GetNext( r ) )
+    {
+        if( string( iXML.GetNodeName( r ) ) != "Ranges" )
+        {
+            continue;
+        }
+        for( XMLNodePointer_t i = iXML.GetChild( r ); i; i = iXML.GetNext( i ) )
+        {
+            if( !iXML.GetAttr( i, "Index" ) || !iXML.GetAttr( i, "Min" ) || !iXML.GetAttr( i, "Max" ) )
+            {
+                return false;
+            }
+            unsigned int iIndex = atoi( iXML.GetAttr( i, "Index" ) );
+            float i_min = strtof( iXML.GetAttr( i, "Min" ), 0 );
+            float i_max = strtof( iXML.GetAttr( i, "Max" ), 0 );
+            // see TMVA::VariableNormalizeTransform::Transform()
+            float i_scale = 1.0 / ( i_max - i_min );
+            if( iIndex >= iInput.size() )
+            {
+                return false;
+            }
+            if( iInput[iIndex] >= 0 )
+            {
+                iForest.fVarNormalise[iInput[iIndex]] = 1;
+                iForest.fVarOffset[iInput[iIndex]] = i_min;
+                iForest.fVarScale[iInput[iIndex]] = i_scale;
+            }
+            else if( iInput[iIndex] == -1 )
+            {
+                iForest.fTargetNormalise = true;
+                iForest.fTargetOffset = i_min;
+                iForest.fTargetScale = i_scale;
+            }
+        }
+    }
+    return true;
+}
+
+/*
+ * read all decision trees
+ *
+ */
+bool VTMVAForest::readTrees( TXMLEngine& iXML, XMLNodePointer_t iNode, sForest& iForest, int iLeafValue )
+{
+    for( XMLNodePointer_t t = iXML.GetChild( iNode ); t; t = iXML.GetNext( t ) )
+    {
+        if( string( iXML.GetNodeName( t ) ) != "BinaryTree" )
+        {
+            continue;
+        }
+        XMLNodePointer_t iRootNode = iXML.GetChild( t );
+        if( !iRootNode || !iXML.GetAttr( t, "boostWeight" ) )
+        {
+            return false;
+        }
+        // keep root index valid for clean up of incomplete trees
+        fTreeRoot.push_back( fNode.size() );
+        fBoostWeight.push_back( strtod( iXML.GetAttr( t, "boostWeight" ), 0 ) );
+        if( addNode( iXML, iRootNode, iForest, iLeafValue ) < 0 )
+        {
+            return false;
+        }
+    }
+    return ( fTreeRoot.size() > iForest.fTree_min );
+}
+
+/*
+ * add a node and all its daughter nodes
+ *
+ * returns node index (-1 for unsupported nodes)
+ */
+int VTMVAForest::addNode( TXMLEngine& iXML, XMLNodePointer_t iNode, sForest& iForest, int iLeafValue )
+{
+    // Fisher cuts not implemented
+    if( iXML.GetAttr( iNode, "NCoef" ) && atoi( iXML.GetAttr( iNode, "NCoef" ) ) > 0 )
+    {
+        return -1;
+    }
+    const char* iLeafAttribute[] = { "res", "nType", "purity" };
+    if( !iXML.GetAttr( iNode, "nType" ) || !iXML.GetAttr( iNode, iLeafAttribute[iLeafValue] ) )
+    {
+        return -1;
+    }
+    sNode n;
+    n.fVar = -1;
+    n.fCut = 0.;
+    n.fChild[0] = 0;
+    n.fChild[1] = 0;
+    n.fResponse = strtof( iXML.GetAttr( iNode, iLeafAttribute[iLeafValue] ), 0 );
+
+    unsigned int iIndex = fNode.size();
+    fNode.push_back( n );
+
+    // intermediate node (see TMVA::DecisionTree::CheckEvent())
+    if( atoi( iXML.GetAttr( iNode, "nType" ) ) == 0 )
+    {
+        XMLNodePointer_t iLeft = 0;
+        XMLNodePointer_t iRight = 0;
+        for( XMLNodePointer_t c = iXML.GetChild( iNode ); c; c = iXML.GetNext( c ) )
+        {
+            if( !iXML.GetAttr( c, "pos" ) )
+            {
+                continue;
+            }
+            if( string( iXML.GetAttr( c, "pos" ) ) == "l" )
+            {
+                iLeft = c;
+            }
+            else if( string( iXML.GetAttr( c, "pos" ) ) == "r" )
+            {
+                iRight = c;
+            }
+        }
+        if( !iLeft || !iRight
+                || !iXML.GetAttr( iNode, "IVar" ) || !iXML.GetAttr( iNode, "Cut" ) || !iXML.GetAttr( iNode, "cType" ) )
+        {
+            return -1;
+        }
+        n.fVar = atoi( iXML.GetAttr( iNode, "IVar" ) );
+        n.fCut = strtof( iXML.GetAttr( iNode, "Cut" ), 0 );
+        if( n.fVar < 0 || n.fVar >= ( int )iForest.fVariableExpression.size() )
+        {
+            return -1;
+        }
+        int l = addNode( iXML, iLeft, iForest, iLeafValue );
+        int r = addNode( iXML, iRight, iForest, iLeafValue );
+        if( l < 0 || r < 0 )
+        {
+            return -1;
+        }
+        // TMVA::DecisionTreeNode::GoesRight(): ( x >= cut ) for cut type 1, !( x >= cut ) otherwise
+        if( atoi( iXML.GetAttr( iNode, "cType" ) ) == 1 )
+        {
+            n.fChild[0] = l;
+            n.fChild[1] = r;
+        }
+        else
+        {
+            n.fChild[0] = r;
+            n.fChild[1] = l;
+        }
+        fNode[iIndex] = n;
+    }
+    return iIndex;
+}
+
+/*
+ * forest response from sum of tree responses
+ *
+ * (see TMVA::MethodBDT::GetRegressionValues() (targets are stored
+ *  as float in TMVA events), TMVA::MethodBDT::PrivateGetMvaValue() and
+ *  TMVA::MethodBDT::GetGradBoostMVA())
+ */
+double VTMVAForest::getResponse( const sForest& iForest, double iSum, double iNorm )
+{
+    double i_mva = 0.;
+    if( iForest.fGrad && iForest.fRegression )
+    {
+        i_mva = iSum + fBoostWeight[iForest.fTree_min];
+    }
+    else if( iForest.fGrad )
+    {
+        return 2.0 / ( 1.0 + exp( -2.0 * iSum ) ) - 1;
+    }
+    else
+    {
+        i_mva = ( iNorm > numeric_limits<double>::epsilon() ? iSum / iNorm : 0. );
+    }
+    if( !iForest.fRegression )
+    {
+        return i_mva;
+    }
+    float i_target = i_mva;
+    if( iForest.fTargetNormalise )
+    {
+        i_target = iForest.fTargetOffset + ( ( i_target + 1 ) / ( iForest.fTargetScale * 2 ) );
+    }
+    return i_target;
+}
+
+/*
+ * evaluate a forest for one event
+ *
+ * iVar: variables (in the order of the weight file)
+ */
+double VTMVAForest::evaluate( unsigned int iForest, const float* iVar )
+{
+    double i_result = -99.;
+    evaluate( iForest, 1, iVar, &i_result );
+    return i_result;
+}
+
+/*
+ * evaluate a forest for a batch of events
+ *
+ * iVar:    variables (iNEvents x getNVariables(), event by event)
+ * iResult: forest responses (iNEvents)
+ */
+void VTMVAForest::evaluate( unsigned int iForest, unsigned int iNEvents, const float* iVar, double* iResult )
+{
+    if( iForest >= fForest.size() || iNEvents == 0 )
+    {
+        return;
+    }
+    const sForest& f = fForest[iForest];
+    const unsigned int iNVar = f.fVariableExpression.size();
+
+    // variable transformation (see TMVA::VariableNormalizeTransform::Transform())
+    // (stored variable by variable)
+    if( fTransformed.size() < iNEvents * iNVar + 1 )
+    {
+        fTransformed.resize( iNEvents * iNVar + 1 );
+    }
+    fNaN.assign( iNEvents, 0 );
+    for( unsigned int v = 0; v < iNVar; v++ )
+    {
+        float* x = &fTransformed[v * iNEvents];
+        for( unsigned int e = 0; e < iNEvents; e++ )
+        {
+            if( f.fVarNormalise[v] )
+            {
+                x[e] = ( iVar[e * iNVar + v] - f.fVarOffset[v] ) * f.fVarScale[v] * 2 - 1;
+            }
+            else
+            {
+                x[e] = iVar[e * iNVar + v];
+            }
+            if( std::isnan( x[e] ) )
+            {
+                fNaN[e] = 1;
+            }
+        }
+    }
+    fSum.assign( iNEvents, 0. );
+
+    // unweighted sum of tree responses for gradient boosting
+    double i_norm = 0.;
+    const float* x = &fTransformed[0];
+    const sNode* i_node = &fNode[0];
+    for( unsigned int t = f.fTree_min; t < f.fTree_min + f.fNTrees; t++ )
+    {
+        const double i_w = fBoostWeight[t];
+        for( unsigned int e = 0; e < iNEvents; e++ )
+        {
+            unsigned int n = fTreeRoot[t];
+            while( i_node[n].fVar >= 0 )
+            {
+                n = i_node[n].fChild[x[i_node[n].fVar * iNEvents + e] >= i_node[n].fCut];
+            }
+            if( f.fGrad )
+            {
+                fSum[e] += i_node[n].fResponse;
+            }
+            else
+            {
+                fSum[e] += i_w * i_node[n].fResponse;
+            }
+        }
+        i_norm += i_w;
+    }
+    for( unsigned int e = 0; e < iNEvents; e++ )
+    {
+        // see TMVA::Reader::EvaluateMVA()
+        if( !f.fRegression && fNaN[e] )
+        {
+            iResult[e] = -999.;
+        }
+        else
+        {
+            iResult[e] = getResponse( f, fSum[e], i_norm );
+        }
+    }
+}
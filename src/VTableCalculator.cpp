@@ -14,6 +14,12 @@ VTableCalculator::VTableCalculator( int intel, bool iEnergy, bool iPE )
     setNormalizeTableValues();
     
     setConstants( iPE );
+    fPE = iPE;
+    fQuantileSketchCompression = 100.;
+    fQuantileSketchDir = 0;
+    
+    fTableValueMedian = 0;
+    fTableValueSigma = 0;
     
     if( intel == 0 )
     {
@@ -62,16 +68,19 @@ VTableCalculator::VTableCalculator( string fpara, string hname_add,
     // initialize variables for table value normalization
     setNormalizeTableValues();
     
-    // use 1D histograms to calculate medians (more precise, but needs much more memory and is slower)
+    // medians are calculated from quantile sketches; write 1D histograms of all bins
     fWrite1DHistograms = true;
-    // use median approximation (faster)
-    fFillMedianApproximations = false;
+    fQuantileSketchCompression = 100.;
+    fQuantileSketchDir = 0;
     
     setConstants( iPE );
+    fPE = iPE;
     // using lookup tables to calculate energies
     fEnergy = iEnergy;
     fUseMedianEnergy = iUseMedianEnergy;
     fReadHistogramsFromFile = false;
+    fTableValueMedian = 0;
+    fTableValueSigma = 0;
     
     setEventSelectionCut();
     
@@ -97,8 +106,6 @@ VTableCalculator::VTableCalculator( string fpara, string hname_add,
     }
     fWriteTables = iWriteTables;
     
-    int i = 0;
-    int j = 0;
     char hname[1000];
     
     ////////////////////////////////////////////////////////////////////////////////////////////////////////////
@@ -146,19 +153,9 @@ VTableCalculator::VTableCalculator( string fpara, string hname_add,
             sprintf( htitle, "%s (mean) [TeV]", fpara.c_str() );
         }
         hMean->SetZTitle( htitle );
-        // 1d histograms for variable distribution
-        for( i = 0; i < NumSize; i++ )
-        {
-            vector< TH1F* > iH1;
-            vector< VMedianCalculator* > iM1;
-            for( j = 0; j < NumDist; j++ )
-            {
-                iH1.push_back( 0 );
-                iM1.push_back( 0 );
-            }
-            Oh.push_back( iH1 );
-            OMedian.push_back( iM1 );
-        }
+        // distributions of the variable per size and distance bin
+        // (quantile sketches are created for filled bins only)
+        fQuantileSketch.assign( NumSize, vector< VQuantileSketch* >( NumDist, ( VQuantileSketch* )0 ) );
     }
     /////////////////////////////////////////
     // table reading
@@ -262,11 +259,11 @@ void VTableCalculator::setBinning()
     
 }
 
-bool VTableCalculator::createMedianApprox( int i, int j )
+bool VTableCalculator::createQuantileSketch( int i, int j )
 {
-    if( i >= 0 && j >= 0 && i < ( int )OMedian.size() && j < ( int )OMedian[i].size() && !OMedian[i][j] )
+    if( i >= 0 && j >= 0 && i < ( int )fQuantileSketch.size() && j < ( int )fQuantileSketch[i].size() && !fQuantileSketch[i][j] )
     {
-        OMedian[i][j] = new VMedianCalculator();
+        fQuantileSketch[i][j] = new VQuantileSketch( fQuantileSketchCompression );
     }
     else
     {
@@ -275,13 +272,26 @@ bool VTableCalculator::createMedianApprox( int i, int j )
     return true;
 }
 
-bool VTableCalculator::create1DHistogram( int i, int j )
+/*
+ * 1D histogram of the distribution in size bin i and distance bin j
+ * (filled from the centroids of the quantile sketch)
+ *
+ * The weight of each centroid is spread uniformly between the midpoints to
+ * its neighbouring centroids (sketch minimum/maximum at the edges).
+ * Bin errors are set as for a histogram filled event by event with the mean
+ * event weight (error^2 = content x sum of weights / number of entries),
+ * histogram statistics are those of the centroids.
+ *
+ * (to be deleted by the caller)
+ */
+TH1F* VTableCalculator::create1DHistogram( int i, int j )
 {
-    if( i >= 0 && j >= 0 && i < ( int )Oh.size() && j < ( int )Oh[i].size() && !Oh[i][j] )
+    TH1F* h = 0;
+    if( i >= 0 && j >= 0 && i < ( int )fQuantileSketch.size() && j < ( int )fQuantileSketch[i].size() && fQuantileSketch[i][j] )
     {
         if( !fOutDir->cd() )
         {
-            return false;
+            return 0;
         }
         char hisname[200];
         char histitle[200];
@@ -294,15 +304,188 @@ bool VTableCalculator::create1DHistogram( int i, int j )
         double id2 = hMedian->GetYaxis()->GetBinLowEdge( j + 1 ) + hMedian->GetYaxis()->GetBinWidth( j + 1 );
         sprintf( histitle, "%.2f < log10 size < %.2f, %.1f < r < %.1f (%s)", is1, is2, id1, id2, fHName_Add.c_str() );
         
-        Oh[i][j] = new TH1F( hisname, histitle, fBinning1DxbinsN, fBinning1Dxbins );
-        Oh[i][j]->SetXTitle( fName.c_str() );
+        h = new TH1F( hisname, histitle, fBinning1DxbinsN, fBinning1Dxbins );
+        h->SetXTitle( fName.c_str() );
         // allow automatic rebinning
-        Oh[i][j]->GetXaxis()->SetCanExtend( true );
+        h->GetXaxis()->SetCanExtend( true );
+        
+        vector< float > i_mean;
+        vector< float > i_weight;
+        unsigned int n = fQuantileSketch[i][j]->getCentroids( i_mean, i_weight );
+        if( n == 0 )
+        {
+            return h;
+        }
+        // number of fills per centroid
+        const unsigned int i_nsteps = 20;
+        double i_stats[TH1::kNstat];
+        for( int s = 0; s < TH1::kNstat; s++ )
+        {
+            i_stats[s] = 0.;
+        }
+        for( unsigned int c = 0; c < n; c++ )
+        {
+            double x_low  = ( c > 0 ? 0.5 * ( i_mean[c - 1] + i_mean[c] ) : fQuantileSketch[i][j]->getMin() );
+            double x_high = ( c + 1 < n ? 0.5 * ( i_mean[c] + i_mean[c + 1] ) : fQuantileSketch[i][j]->getMax() );
+            x_low  = TMath::Min( x_low, ( double )i_mean[c] );
+            x_high = TMath::Max( x_high, ( double )i_mean[c] );
+            for( unsigned int k = 0; k < i_nsteps; k++ )
+            {
+                h->Fill( x_low + ( x_high - x_low ) * ( k + 0.5 ) / ( double )i_nsteps, i_weight[c] / ( double )i_nsteps );
+            }
+            i_stats[0] += i_weight[c];
+            i_stats[2] += i_weight[c] * i_mean[c];
+            i_stats[3] += i_weight[c] * i_mean[c] * i_mean[c];
+        }
+        // bin errors on the scale of single events
+        double i_meanWeight = i_stats[0] / ( double )TMath::Max( fQuantileSketch[i][j]->getEntries(), ( unsigned int )1 );
+        for( int b = 0; b <= h->GetNbinsX() + 1; b++ )
+        {
+            h->SetBinError( b, sqrt( TMath::Max( h->GetBinContent( b ), 0. ) * i_meanWeight ) );
+        }
+        i_stats[1] = i_stats[0] * i_meanWeight;
+        h->PutStats( i_stats );
+        h->SetEntries( fQuantileSketch[i][j]->getEntries() );
     }
-    else
+    return h;
+}
+
+/*
+ * write quantile sketches of all filled bins into a tree
+ * (allows to merge tables filled in independent jobs, see combineLookupTables)
+ *
+ */
+void VTableCalculator::writeQuantileSketches()
+{
+    TDirectory* iDir = ( fQuantileSketchDir ? fQuantileSketchDir : fOutDir );
+    if( !iDir || !iDir->cd() )
+    {
+        return;
+    }
+    char hname[1000];
+    char htitle[1000];
+    sprintf( hname, "%s_sketch_%s", fName.c_str(), fHName_Add.c_str() );
+    sprintf( htitle, "%s vs. dist. vs. log10 size (quantile sketches)", fName.c_str() );
+    
+    bool i_energy = fEnergy;
+    bool i_pe = fPE;
+    float i_minShowerPerBin = fMinShowerPerBin;
+    float i_compression = ( float )fQuantileSketchCompression;
+    int i_sizebin = 0;
+    int i_distbin = 0;
+    unsigned int i_entries = 0;
+    float i_min = 0.;
+    float i_max = 0.;
+    unsigned int n = 0;
+    vector< float > i_mean;
+    vector< float > i_weight;
+    // maximum number of centroids per sketch
+    unsigned int i_nmax = 1;
+    for( unsigned int i = 0; i < fQuantileSketch.size(); i++ )
+    {
+        for( unsigned int j = 0; j < fQuantileSketch[i].size(); j++ )
+        {
+            if( fQuantileSketch[i][j] )
+            {
+                i_nmax = TMath::Max( i_nmax, fQuantileSketch[i][j]->getCentroids( i_mean, i_weight ) );
+            }
+        }
+    }
+    vector< float > i_meanBuffer( i_nmax, 0. );
+    vector< float > i_weightBuffer( i_nmax, 0. );
+    
+    TTree* t = new TTree( hname, htitle );
+    t->Branch( "energy", &i_energy, "energy/O" );
+    t->Branch( "pe", &i_pe, "pe/O" );
+    t->Branch( "minshowerperbin", &i_minShowerPerBin, "minshowerperbin/F" );
+    t->Branch( "compression", &i_compression, "compression/F" );
+    t->Branch( "sizebin", &i_sizebin, "sizebin/I" );
+    t->Branch( "distbin", &i_distbin, "distbin/I" );
+    t->Branch( "entries", &i_entries, "entries/i" );
+    t->Branch( "min", &i_min, "min/F" );
+    t->Branch( "max", &i_max, "max/F" );
+    t->Branch( "n", &n, "n/i" );
+    t->Branch( "mean", &i_meanBuffer[0], "mean[n]/F" );
+    t->Branch( "weight", &i_weightBuffer[0], "weight[n]/F" );
+    for( unsigned int i = 0; i < fQuantileSketch.size(); i++ )
+    {
+        for( unsigned int j = 0; j < fQuantileSketch[i].size(); j++ )
+        {
+            if( !fQuantileSketch[i][j] || fQuantileSketch[i][j]->getEntries() == 0 )
+            {
+                continue;
+            }
+            i_sizebin = ( int )i;
+            i_distbin = ( int )j;
+            i_entries = fQuantileSketch[i][j]->getEntries();
+            i_min = fQuantileSketch[i][j]->getMin();
+            i_max = fQuantileSketch[i][j]->getMax();
+            n = fQuantileSketch[i][j]->getCentroids( i_mean, i_weight );
+            for( unsigned int c = 0; c < n; c++ )
+            {
+                i_meanBuffer[c] = i_mean[c];
+                i_weightBuffer[c] = i_weight[c];
+            }
+            t->Fill();
+        }
+    }
+    if( t->GetEntries() > 0 )
+    {
+        t->Write();
+    }
+    delete t;
+}
+
+/*
+ * add quantile sketches from a tree (see writeQuantileSketches())
+ *
+ * mean values are filled from the centroids of the sketches
+ *
+ */
+bool VTableCalculator::readQuantileSketches( TTree* t )
+{
+    if( !t || !fWriteTables || !hMean )
     {
         return false;
     }
+    int i_sizebin = 0;
+    int i_distbin = 0;
+    unsigned int i_entries = 0;
+    float i_min = 0.;
+    float i_max = 0.;
+    unsigned int n = 0;
+    unsigned int i_nmax = ( unsigned int )t->GetMaximum( "n" ) + 1;
+    vector< float > i_mean( i_nmax, 0. );
+    vector< float > i_weight( i_nmax, 0. );
+    t->SetBranchAddress( "sizebin", &i_sizebin );
+    t->SetBranchAddress( "distbin", &i_distbin );
+    t->SetBranchAddress( "entries", &i_entries );
+    t->SetBranchAddress( "min", &i_min );
+    t->SetBranchAddress( "max", &i_max );
+    t->SetBranchAddress( "n", &n );
+    t->SetBranchAddress( "mean", &i_mean[0] );
+    t->SetBranchAddress( "weight", &i_weight[0] );
+    for( Long64_t e = 0; e < t->GetEntries(); e++ )
+    {
+        t->GetEntry( e );
+        if( n > i_nmax || i_sizebin < 0 || i_sizebin >= ( int )fQuantileSketch.size()
+                || i_distbin < 0 || i_distbin >= ( int )fQuantileSketch[i_sizebin].size() )
+        {
+            continue;
+        }
+        if( !fQuantileSketch[i_sizebin][i_distbin] && !createQuantileSketch( i_sizebin, i_distbin ) )
+        {
+            continue;
+        }
+        fQuantileSketch[i_sizebin][i_distbin]->addCentroids( i_entries, i_min, i_max, n, &i_mean[0], &i_weight[0] );
+        for( unsigned int c = 0; c < n; c++ )
+        {
+            hMean->Fill( hMedian->GetXaxis()->GetBinCenter( i_sizebin + 1 ),
+                         hMedian->GetYaxis()->GetBinCenter( i_distbin + 1 ),
+                         i_mean[c], i_weight[c] );
+        }
+    }
+    t->ResetBranchAddresses();
     return true;
 }
 
@@ -353,10 +536,12 @@ void VTableCalculator::terminate( TDirectory* iOut, char* xtitle )
     {
         TDirectory* iDir1D = 0;
         // make output directory for 1D histograms
-        if( fOutDir )
+        if( fOutDir && fWrite1DHistograms )
         {
             iDir1D = fOutDir->mkdir( "histos1D" );
         }
+        // quantile sketches (for merging of tables)
+        writeQuantileSketches();
         
         ///////////////////////////////////
         // 2D histograms
@@ -419,18 +604,18 @@ void VTableCalculator::terminate( TDirectory* iOut, char* xtitle )
         {
             for( int j = 0; j < NumDist; j++ )
             {
-                // use 1D histograms for median calculation
-                if( fWrite1DHistograms && Oh[i][j] &&  Oh[i][j]->GetEntries() > fMinShowerPerBin )
+                VQuantileSketch* iS = 0;
+                if( i < ( int )fQuantileSketch.size() && j < ( int )fQuantileSketch[i].size() )
                 {
-                    Oh[i][j]->GetQuantiles( 3, i_b, i_a );
-                    med     = i_b[1];
-                    sigma   = i_b[2] - i_b[0];
-                    nevents = Oh[i][j]->GetEntries();
+                    iS = fQuantileSketch[i][j];
                 }
-                // use approx median calculation
-                else if( fFillMedianApproximations && OMedian[i][j] && OMedian[i][j]->getN() > fMinShowerPerBin )
+                // median and 16-84% width from quantile sketch
+                if( iS && iS->getEntries() > fMinShowerPerBin )
                 {
-                    med     = OMedian[i][j]->getMedian( sigma, nevents );
+                    iS->getQuantiles( 3, i_b, i_a );
+                    med     = i_b[1];
+                    sigma   = i_b[2] - i_b[0];
+                    nevents = iS->getEntries();
                 }
                 else
                 {
@@ -449,25 +634,32 @@ void VTableCalculator::terminate( TDirectory* iOut, char* xtitle )
                 {
                     hMean->SetBinContent( i + 1, j + 1, 0. );
                 }
-                if( fEnergy && fWrite1DHistograms )
+                // 1D histograms (from quantile sketches) for mpv calculation and writing
+                TH1F* h1D = 0;
+                if( iS && ( fEnergy || fWrite1DHistograms ) )
+                {
+                    h1D = create1DHistogram( i, j );
+                }
+                if( fEnergy )
                 {
-                    fillMPV( hMPV, i + 1, j + 1, Oh[i][j], med, sigma );
+                    fillMPV( hMPV, i + 1, j + 1, h1D, med, sigma );
                     hMPV->SetBinError( i + 1, j + 1, sigma );
                 }
                 // write 1D histograms to file
-                if( fWrite1DHistograms && Oh[i][j] )
+                if( fWrite1DHistograms && h1D && iDir1D && h1D->GetEntries() > 0 )
                 {
-                    if( fOutDir && Oh[i][j]->GetEntries() > 0 )
-                    {
-                        fOutDir->cd();
-                        iDir1D->cd();
-                        Oh[i][j]->Write();
-                    }
-                    delete Oh[i][j];
+                    fOutDir->cd();
+                    iDir1D->cd();
+                    h1D->Write();
                 }
-                else if( fFillMedianApproximations && OMedian[i][j] )
+                if( h1D )
                 {
-                    delete OMedian[i][j];
+                    delete h1D;
+                }
+                if( iS )
+                {
+                    delete iS;
+                    fQuantileSketch[i][j] = 0;
                 }
             }
         }
@@ -626,7 +818,9 @@ double VTableCalculator::calc( int ntel, double* r, double* s, double* l, double
     // should not be used for energy calculation
     // (need to copy the value, otherwise the normalized value will be filled
     //  into the output tree)
-    vector< double > w_fill( ntel, 0. );
+    // (scratch buffer: reallocated only if ntel exceeds the largest ntel seen so far)
+    fCalc_w_fill.resize( ntel );
+    double* w_fill = ( ntel > 0 ? &fCalc_w_fill[0] : 0 );
     for( int i = 0; i < ntel; i++ )
     {
         if( w )
@@ -668,15 +862,7 @@ double VTableCalculator::calc( int ntel, double* r, double* s, double* l, double
         double i_logs = 0.;
         int ir = 0;
         int is = 0.;
-        int i_Oh_size = 0;
-        if( fWrite1DHistograms )
-        {
-            i_Oh_size = ( int )Oh.size();
-        }
-        else
-        {
-            i_Oh_size = ( int )OMedian.size();
-        }
+        int i_nSizeBins = ( int )fQuantileSketch.size();
         // loop over all telescopes
         for( tel = 0; tel < ntel; tel++ )
         {
@@ -698,37 +884,17 @@ double VTableCalculator::calc( int ntel, double* r, double* s, double* l, double
                     continue;
                 }
                 // reject showers in the first size bin
-                if( ir >= 0 && is >= 0 && is < i_Oh_size )
+                if( ir >= 0 && is >= 0 && is < i_nSizeBins )
                 {
-                    if( fWrite1DHistograms && ir < ( int )Oh[is].size() )
+                    if( ir < ( int )fQuantileSketch[is].size() )
                     {
-                        if( !Oh[is][ir] && !create1DHistogram( is, ir ) )
+                        if( !fQuantileSketch[is][ir] && !createQuantileSketch( is, ir ) )
                         {
                             continue;
                         }
-                        // fill width/length/energy into a 1D and 2D histogram
+                        // fill width/length/energy into the distribution of this bin
                         // (chi2 is here an external weight (from e.g. spectral weighting))
-                        Oh[is][ir]->Fill( w_fill[tel], chi2 );
-                        if( fEnergy )
-                        {
-                            if( w_fill[tel] < Oh[is][ir]->GetXaxis()->GetXmin() || w_fill[tel] > Oh[is][ir]->GetXaxis()->GetXmax() )
-                            {
-                                cout << "Energy table filling: value (" << w_fill[tel] << ") out of range:";
-                                cout << Oh[is][ir]->GetXaxis()->GetXmin() << "\t" << Oh[is][ir]->GetXaxis()->GetXmax() << endl;
-                            }
-                        }
-                    }
-                    if( fFillMedianApproximations && ir < ( int )OMedian.size() )
-                    {
-                        if( !OMedian[is][ir] )
-                        {
-                            // weight is ignored in the approx median calculation
-                            if( !createMedianApprox( is, ir ) )
-                            {
-                                continue;
-                            }
-                        }
-                        OMedian[is][ir]->fill( w_fill[tel] );
+                        fQuantileSketch[is][ir]->fill( w_fill[tel], chi2 );
                     }
                     hMean->Fill( i_logs, r[tel], w_fill[tel], chi2 );
                 }
@@ -766,12 +932,19 @@ double VTableCalculator::calc( int ntel, double* r, double* s, double* l, double
         double sigma = 0.;
         double value = 0.;
         double weight = 0.;
+        double i_logs = 0.;
         // energy per telescope
-        vector< double > energy_tel;
-        vector< double > sigma2_tel;
-        vector< double > sigma2_tel_noRadiusWeigth;
-        vector< double > sigma_tel;
-        vector< bool > good_image;
+        // (scratch buffers: capacity is kept between calls)
+        vector< double >& energy_tel = fCalc_energy_tel;
+        vector< double >& sigma2_tel = fCalc_sigma2_tel;
+        vector< double >& sigma2_tel_noRadiusWeigth = fCalc_sigma2_tel_noRadiusWeigth;
+        vector< double >& sigma_tel = fCalc_sigma_tel;
+        vector< bool >& good_image = fCalc_good_image;
+        energy_tel.clear();
+        sigma2_tel.clear();
+        sigma2_tel_noRadiusWeigth.clear();
+        sigma_tel.clear();
+        good_image.clear();
         
         // reset everything
         for( tel = 0; tel < ntel; tel++ )
@@ -793,15 +966,22 @@ double VTableCalculator::calc( int ntel, double* r, double* s, double* l, double
                     && d[tel] < fEventSelectionCut_distanceCutMax )
             {
                 // get expected value and sigma of expected value
-                if( hMedian )
+                if( fTableValueMedian && fTableValueSigma )
+                {
+                    med   = fTableValueMedian[tel];
+                    sigma = fTableValueSigma[tel];
+                }
+                else if( hMedian )
                 {
-                    med   = interpolate( hMedian, log10( s[tel] ), r[tel], false );
-                    sigma = interpolate( hMedian, log10( s[tel] ), r[tel], true );
+                    i_logs = log10( s[tel] );
+                    med   = interpolate( hMedian, i_logs, r[tel], false );
+                    sigma = interpolate( hMedian, i_logs, r[tel], true );
                 }
                 else if( hVMedian.size() == ( unsigned int )ntel && hVMedian[tel] )
                 {
-                    med   = interpolate( hVMedian[tel], log10( s[tel] ), r[tel], false );
-                    sigma = interpolate( hVMedian[tel], log10( s[tel] ), r[tel], true );
+                    i_logs = log10( s[tel] );
+                    med   = interpolate( hVMedian[tel], i_logs, r[tel], false );
+                    sigma = interpolate( hVMedian[tel], i_logs, r[tel], true );
                     if( fDebug && fEnergy )
                     {
                         cout << "\t  double VTableCalculator::calc() getting energy from table for tel " << tel;
@@ -1116,6 +1296,23 @@ double VTableCalculator::getWeightMeanBinContent( TH2F* h, int ix0, int iy0, dou
 void VTableCalculator::setVHistograms( vector< TH2F* >& hM )
 {
     hVMedian = hM;
+    fTableValueMedian = 0;
+    fTableValueSigma = 0;
+    
+    fReadHistogramsFromFile = true;
+}
+
+
+/*
+ * expected values and their sigmas per telescope interpolated externally
+ * (e.g. from compiled lookup tables, see VTableLookupCompiled)
+ *
+ * replaces the histogram interpolation in calc()
+ */
+void VTableCalculator::setTableValues( double* iMedian, double* iSigma )
+{
+    fTableValueMedian = iMedian;
+    fTableValueSigma = iSigma;
     
     fReadHistogramsFromFile = true;
 }
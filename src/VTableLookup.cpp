@@ -19,8 +19,10 @@ VTableLookup::VTableLookup( VTableLookupRunParameter* iTLRunParameter )
         exit( EXIT_FAILURE );
     }
     
+    bOwnRunParameter = false;
     // total number of telescopes
     fNTel = 0;
+    fWorkerID = 0;
     // look up table file
     fLookupTableFile = 0;
     
@@ -73,10 +75,101 @@ VTableLookup::VTableLookup( VTableLookupRunParameter* iTLRunParameter )
     s_N = 0;
     
     fTableCalculator = 0;
+    fCompiledTables = false;
     fData = 0;
     
 }
 
+/*
+ * table reader for the entry range [iFirstEntry, iLastEntry) of the input data
+ * (used for parallel table reading, see readLookupTable_parallel())
+ *
+ * lookup tables are shared (read-only) with iLookup; run parameters,
+ * data handler, table calculator and output file are independent
+ * (run parameters are modified during the event loop, e.g. ze for MC)
+ */
+VTableLookup::VTableLookup( VTableLookup* iLookup, unsigned int iWorkerID, Long64_t iFirstEntry, Long64_t iLastEntry )
+{
+    fTLRunParameter = new VTableLookupRunParameter( *iLookup->fTLRunParameter );
+    bOwnRunParameter = true;
+    fWorkerID = iWorkerID;
+    
+    fNTel = 0;
+    fLookupTableFile = iLookup->fLookupTableFile;
+    fNumberOfIgnoredEvents = 0;
+    fNNoiseLevelWarnings = 0;
+    fMeanNoiseLevel = 0.;
+    
+    // lookup table parameter space and tables
+    fTableAzLowEdge = iLookup->fTableAzLowEdge;
+    fTableAzUpEdge = iLookup->fTableAzUpEdge;
+    fTableTelTypes = iLookup->fTableTelTypes;
+    fTableNoiseLevel = iLookup->fTableNoiseLevel;
+    fTableZe = iLookup->fTableZe;
+    fTableDirectionOffset = iLookup->fTableDirectionOffset;
+    fTableData = iLookup->fTableData;
+    fCompiledTables = iLookup->fCompiledTables;
+    
+    s_NupZupWup = 0;
+    s_NupZupWlow = 0;
+    s_NupZup = 0;
+    s_NupZlowWup = 0;
+    s_NupZlowWlow = 0;
+    s_NupZlow = 0;
+    s_Nup = 0;
+    s_NlowZupWup = 0;
+    s_NlowZupWlow = 0;
+    s_NlowZup = 0;
+    s_NlowZlowWup = 0;
+    s_NlowZlowWlow = 0;
+    s_NlowZlow = 0;
+    s_Nlow = 0;
+    s_N = 0;
+    
+    // data handler for this entry range
+    fData = new VTableLookupDataHandler( false, fTLRunParameter );
+    fData->setfillTables( false );
+    setInputFiles( fTLRunParameter->inputfile );
+    
+    char iOutputFile[2000];
+    sprintf( iOutputFile, "%s.range%u.root", fTLRunParameter->outputfile.c_str(), fWorkerID );
+    fData->setOutputFile( iOutputFile, "recreate", fTLRunParameter->tablefile );
+    fData->setEventRange( iFirstEntry, iLastEntry );
+    if( fTLRunParameter->isMC )
+    {
+        fData->setSpectralIndex( TMath::Abs( fTLRunParameter->fSpectralIndex ) );
+    }
+}
+
+/*
+ * lookup tables are not deleted (shared between the readers of
+ * parallel table reading)
+ */
+VTableLookup::~VTableLookup()
+{
+    delete fData;
+    delete fTableCalculator;
+    delete s_NupZupWup;
+    delete s_NupZupWlow;
+    delete s_NupZup;
+    delete s_NupZlowWup;
+    delete s_NupZlowWlow;
+    delete s_NupZlow;
+    delete s_Nup;
+    delete s_NlowZupWup;
+    delete s_NlowZupWlow;
+    delete s_NlowZup;
+    delete s_NlowZlowWup;
+    delete s_NlowZlowWlow;
+    delete s_NlowZlow;
+    delete s_Nlow;
+    delete s_N;
+    if( bOwnRunParameter )
+    {
+        delete fTLRunParameter;
+    }
+}
+
 
 /*!
       \param ifile output file name
@@ -350,6 +443,7 @@ void VTableLookup::setMCTableFiles_forTableWriting( string itablefile, double iz
                                                               iTableData->fValueNormalizationRange_max );
                         i_LT.back()->setWrite1DHistograms( fTLRunParameter->fWrite1DHistograms );
                         i_LT.back()->setMinRequiredShowerPerBin( fTLRunParameter->fMinRequiredShowerPerBin );
+                        i_LT.back()->setQuantileSketchCompression( fTLRunParameter->fQuantileSketchCompression );
                         // event selection cut is only set for energy lookup tables
                         if( iTableData->fEnergy )
                         {
@@ -719,6 +813,10 @@ void VTableLookup::loop()
     {
         fillLookupTable();
     }
+    else if( fTLRunParameter->fNThreads > 1 )
+    {
+        readLookupTable_parallel();
+    }
     else
     {
         readLookupTable();
@@ -735,7 +833,7 @@ void VTableLookup::fillLookupTable()
     double idummy1[fData->getMaxNbrTel()];
     double iEventWeight = 0.;
     double idummy3 = 0.;
-    int fevent = 0;
+    Long64_t fevent = 0;
     // telescope types
     map<ULong64_t, unsigned int> i_list_of_Tel_type = fData->getList_of_Tel_type();
     map<ULong64_t, unsigned int>::iterator iter_i_list_of_Tel_type;
@@ -867,7 +965,7 @@ void VTableLookup::readLookupTable()
     int i_az = 0;
     double ze = 0.;
     double woff = 0.;
-    int fevent = 0;
+    Long64_t fevent = 0;
     double imr = 0.;
     double inr = 0.;
     
@@ -1416,6 +1514,96 @@ void VTableLookup::readLookupTable()
 }
 
 
+/*
+ * read lookup tables with several threads
+ *
+ * the input data is split into consecutive entry ranges, one table
+ * reader (data handler, TMVA readers, output file) per range.
+ * Lookup tables are shared between all threads (read-only).
+ *
+ * Output trees are merged in the order of the entry ranges, i.e.
+ * the order of events in the output file is the same as for
+ * the serial table reading.
+ */
+void VTableLookup::readLookupTable_parallel()
+{
+    // entry ranges are not independent for random event selection and time limits
+    if( fTLRunParameter->fSelectRandom > 0. || fData->getMaxTotalTime() < 1.e8 )
+    {
+        cout << "VTableLookup::readLookupTable_parallel: random event selection or maximum run time requested";
+        cout << " (using one thread)" << endl;
+        readLookupTable();
+        return;
+    }
+    // histograms are read on demand from the table file if tables are not compiled
+    if( !fCompiledTables )
+    {
+        cout << "VTableLookup::readLookupTable_parallel: no compiled lookup tables (using one thread)" << endl;
+        readLookupTable();
+        return;
+    }
+    Long64_t iNEntries = fData->getNEvents();
+    if( fData->getNEntries() < iNEntries )
+    {
+        iNEntries = fData->getNEntries();
+    }
+    unsigned int iNThreads = fTLRunParameter->fNThreads;
+    if( iNEntries < ( Long64_t )iNThreads )
+    {
+        iNThreads = ( unsigned int )iNEntries;
+    }
+    if( iNThreads < 2 )
+    {
+        readLookupTable();
+        return;
+    }
+    cout << "reading lookup tables with " << iNThreads << " threads (" << iNEntries << " entries)" << endl;
+    ROOT::EnableThreadSafety();
+    
+    // table readers (one per entry range)
+    // (MC histograms of the readers are not attached to any directory)
+    bool iAddDirectory = TH1::AddDirectoryStatus();
+    TH1::AddDirectory( kFALSE );
+    vector< VTableLookup* > iLookup;
+    for( unsigned int i = 0; i < iNThreads; i++ )
+    {
+        iLookup.push_back( new VTableLookup( this, i,
+                                             iNEntries * i / iNThreads,
+                                             iNEntries * ( i + 1 ) / iNThreads ) );
+    }
+    TH1::AddDirectory( iAddDirectory );
+    
+    VAnalysisThreadPool iThreadPool( iNThreads );
+    iThreadPool.run( iLookup.size(), [&iLookup]( unsigned int iJob, unsigned int )
+    {
+        iLookup[iJob]->readLookupTable();
+    } );
+    
+    // MC: ze and wobble offset from the first valid event (i.e. from the first
+    // entry range with a valid event; each reader sets them in its own run parameters)
+    if( fTLRunParameter->isMC && fTLRunParameter->ze < 0. )
+    {
+        for( unsigned int i = 0; i < iLookup.size(); i++ )
+        {
+            if( iLookup[i]->fTLRunParameter->ze >= 0. )
+            {
+                fTLRunParameter->ze = iLookup[i]->fTLRunParameter->ze;
+                fTLRunParameter->fWobbleOffset = iLookup[i]->fTLRunParameter->fWobbleOffset;
+                break;
+            }
+        }
+    }
+    
+    // merge results in order of entry ranges
+    for( unsigned int i = 0; i < iLookup.size(); i++ )
+    {
+        fData->merge( iLookup[i]->fData );
+        fNumberOfIgnoredEvents += iLookup[i]->fNumberOfIgnoredEvents;
+        delete iLookup[i];
+    }
+}
+
+
 /*
 
     interpolate between two lookup tables
@@ -1820,7 +2008,14 @@ void VTableLookup::getTables( unsigned int inoise, unsigned int ize,
             continue;
         }
         
-        s->hMedian[t][tel] = iTableData->fTable[telX][inoise][ize][iwoff][iaz]->getHistoMedian();
+        if( fCompiledTables )
+        {
+            s->table_index[t][tel] = iTableData->fCompiledTableID[telX][inoise][ize][iwoff][iaz];
+        }
+        else
+        {
+            s->hMedian[t][tel] = iTableData->fTable[telX][inoise][ize][iwoff][iaz]->getHistoMedian();
+        }
         t++;
     }
 }
@@ -1844,6 +2039,12 @@ void VTableLookup::calculateMSFromTables( VTablesToRead* s )
     }
     double i_dummy = 0.;
     
+    // expected values from compiled tables
+    if( fCompiledTables )
+    {
+        fillTableValues( s );
+    }
+    
     // size2 vector
     double* i_s2 = fData->getSize2( 1., fTLRunParameter->fUseSelectedImagesOnly );
     // loss vector
@@ -1857,7 +2058,7 @@ void VTableLookup::calculateMSFromTables( VTablesToRead* s )
     fTableCalculator->setNormalizeTableValues( fTableData[E_MSCW]->fValueNormalizationRange_min,
             fTableData[E_MSCW]->fValueNormalizationRange_max );
     fTableCalculator->setEventSelectionCut();
-    fTableCalculator->setVHistograms( s->hMedian[E_MSCW] );
+    setTableCalculatorTables( s, E_MSCW );
     
     s->value[E_MSCW] = fTableCalculator->calc( ( int )fData->getNTel(), fData->getDistanceToCore(),
                        i_s2, i_l, i_d, fData->getWidth(),
@@ -1871,7 +2072,7 @@ void VTableLookup::calculateMSFromTables( VTablesToRead* s )
     fTableCalculator->setNormalizeTableValues( fTableData[E_MSCL]->fValueNormalizationRange_min,
             fTableData[E_MSCL]->fValueNormalizationRange_max );
     fTableCalculator->setEventSelectionCut();
-    fTableCalculator->setVHistograms( s->hMedian[E_MSCL] );
+    setTableCalculatorTables( s, E_MSCL );
     
     s->value[E_MSCL] = fTableCalculator->calc( ( int )fData->getNTel(), fData->getDistanceToCore(),
                        i_s2, i_l, i_d, fData->getLength(),
@@ -1886,7 +2087,7 @@ void VTableLookup::calculateMSFromTables( VTablesToRead* s )
             fTableData[E_EREC]->fValueNormalizationRange_max );
     fTableCalculator->setEventSelectionCut( fTLRunParameter->fEventSelectionCut_lossCutMax,
                                             fTLRunParameter->fEventSelectionCut_distanceCutMax );
-    fTableCalculator->setVHistograms( s->hMedian[E_EREC] );
+    setTableCalculatorTables( s, E_EREC );
     s->value[E_EREC] = fTableCalculator->calc( ( int )fData->getNTel(), fData->getDistanceToCore(),
                        i_s2, i_l, i_d, 0,
                        s->value_T[E_EREC],
@@ -1902,7 +2103,7 @@ void VTableLookup::calculateMSFromTables( VTablesToRead* s )
         fTableCalculator->setNormalizeTableValues( fTableData[E_TGRA]->fValueNormalizationRange_min,
                 fTableData[E_TGRA]->fValueNormalizationRange_max );
         fTableCalculator->setEventSelectionCut();
-        fTableCalculator->setVHistograms( s->hMedian[E_TGRA] );
+        setTableCalculatorTables( s, E_TGRA );
         
         s->value[E_TGRA] = fTableCalculator->calc( ( int )fData->getNTel(), fData->getDistanceToCore(),
                            i_s2, i_l, i_d, fData->getTimeGradient(),
@@ -1913,6 +2114,91 @@ void VTableLookup::calculateMSFromTables( VTablesToRead* s )
 }
 
 
+/*
+ * set tables or expected values (compiled tables) for the table calculator
+ */
+void VTableLookup::setTableCalculatorTables( VTablesToRead* s, unsigned int iTableType )
+{
+    if( fCompiledTables )
+    {
+        fTableCalculator->setTableValues( s->table_median[iTableType], s->table_sigma[iTableType] );
+    }
+    else
+    {
+        fTableCalculator->setVHistograms( s->hMedian[iTableType] );
+    }
+}
+
+/*
+ * interpolate expected values and their sigmas for all telescopes and
+ * all lookup table types from the compiled tables
+ *
+ * (one pass over all telescopes; replaces the histogram interpolation in
+ *  VTableCalculator::calc())
+ */
+void VTableLookup::fillTableValues( VTablesToRead* s )
+{
+    double* i_s2 = fData->getSize2( 1., fTLRunParameter->fUseSelectedImagesOnly );
+    double* i_r  = fData->getDistanceToCore();
+    
+    // lookup tables (same order as in getTables())
+    vector< VTableCalculatorData* > i_TableData;
+    map< unsigned int, VTableCalculatorData* >::iterator iter_iLT_Data;
+    for( iter_iLT_Data = fTableData.begin(); iter_iLT_Data != fTableData.end(); ++iter_iLT_Data )
+    {
+        if( ( *iter_iLT_Data ).second )
+        {
+            i_TableData.push_back( ( *iter_iLT_Data ).second );
+        }
+    }
+    
+    for( unsigned int tel = 0; tel < s->fNTel; tel++ )
+    {
+        bool bValid = ( i_s2 && i_r && i_r[tel] >= 0. && i_s2[tel] > 0. );
+        double i_logs = 0.;
+        if( bValid )
+        {
+            i_logs = log10( i_s2[tel] );
+        }
+        for( unsigned int t = 0; t < i_TableData.size(); t++ )
+        {
+            if( bValid && i_TableData[t]->fCompiledTable )
+            {
+                i_TableData[t]->fCompiledTable->interpolate( s->table_index[t][tel], i_logs, i_r[tel],
+                        s->table_median[t][tel], s->table_sigma[t][tel] );
+            }
+            else
+            {
+                s->table_median[t][tel] = 0.;
+                s->table_sigma[t][tel] = 0.;
+            }
+        }
+    }
+}
+
+/*
+ * copy all lookup tables into contiguous arrays
+ *
+ * returns false if tables can not be compiled (e.g. variable bin widths);
+ * histogram interpolation is used in this case
+ */
+bool VTableLookup::compileLookupTables()
+{
+    cout << "compiling lookup tables" << endl;
+    map< unsigned int, VTableCalculatorData* >::iterator iter_iLT_Data;
+    for( iter_iLT_Data = fTableData.begin(); iter_iLT_Data != fTableData.end(); ++iter_iLT_Data )
+    {
+        if( ( *iter_iLT_Data ).second && !( *iter_iLT_Data ).second->compile() )
+        {
+            cout << "VTableLookup::compileLookupTables: failed compiling ";
+            cout << ( *iter_iLT_Data ).second->fDirectoryName << " tables; using histogram interpolation" << endl;
+            return false;
+        }
+    }
+    return true;
+}
+
+
 bool VTableLookup::initialize()
 {
     if( fTLRunParameter->fDebug > 0 )
@@ -1977,6 +2263,9 @@ bool VTableLookup::initialize()
         readNoiseLevel( true );
         // read tables from disk
         setMCTableFiles_forTableReading( fTLRunParameter->tablefile, "tb" );
+        // copy all tables into contiguous arrays
+        // (read once; fast interpolation)
+        fCompiledTables = compileLookupTables();
         // set output files
         setOutputFile( fTLRunParameter->outputfile, fTLRunParameter->writeoption, fTLRunParameter->tablefile );
     }
@@ -2042,6 +2331,56 @@ VTableCalculatorData::VTableCalculatorData()
     
     fValueNormalizationRange_min = -9999.;
     fValueNormalizationRange_max = -9999.;
+    
+    fCompiledTable = 0;
+}
+
+/*
+ * copy all tables of this type into contiguous arrays
+ * (see VTableLookupCompiled)
+ *
+ */
+bool VTableCalculatorData::compile()
+{
+    if( fCompiledTable )
+    {
+        delete fCompiledTable;
+    }
+    fCompiledTable = new VTableLookupCompiled();
+    fCompiledTableID.clear();
+    fCompiledTableID.resize( fTable.size() );
+    for( unsigned int i = 0; i < fTable.size(); i++ )
+    {
+        fCompiledTableID[i].resize( fTable[i].size() );
+        for( unsigned int t = 0; t < fTable[i].size(); t++ )
+        {
+            fCompiledTableID[i][t].resize( fTable[i][t].size() );
+            for( unsigned int u = 0; u < fTable[i][t].size(); u++ )
+            {
+                fCompiledTableID[i][t][u].resize( fTable[i][t][u].size() );
+                for( unsigned int v = 0; v < fTable[i][t][u].size(); v++ )
+                {
+                    fCompiledTableID[i][t][u][v].assign( fTable[i][t][u][v].size(), -1 );
+                    for( unsigned w = 0; w < fTable[i][t][u][v].size(); w++ )
+                    {
+                        if( !fTable[i][t][u][v][w] )
+                        {
+                            continue;
+                        }
+                        fCompiledTableID[i][t][u][v][w] = fCompiledTable->addTable( fTable[i][t][u][v][w]->getHistoMedian() );
+                        if( fCompiledTableID[i][t][u][v][w] < -1 )
+                        {
+                            return false;
+                        }
+                    }
+                }
+            }
+        }
+    }
+    cout << "	 " << fDirectoryName << ": " << fCompiledTable->getNTables() << " tables, ";
+    cout << fCompiledTable->getSize() << " bins" << endl;
+    
+    return true;
 }
 
 /*
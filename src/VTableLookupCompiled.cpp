@@ -0,0 +1,133 @@
+/*! \class VTableLookupCompiled
+    \brief lookup tables of one type (e.g. mscw) compiled into contiguous arrays
+
+    All tables (telescope type, noise, zenith, wobble offset, azimuth) of one
+    lookup table type are copied once into one contiguous float array for the
+    medians and one for the sigmas (bin errors), together with the axis definitions.
+
+    interpolate() returns median and sigma for a given log10 size and distance
+    in one step and reproduces VTableCalculator::interpolate() (same bin finding,
+    same treatment of edge bins and same interpolation using VStatistics::interpolate()).
+    Sigmas are stored as float (relative precision ~1.e-7).
+
+*/
+
+#include "VTableLookupCompiled.h"
+
+/*
+ * copy a table into the contiguous arrays
+ *
+ * returns table index (-1 for no table; -2 for tables with variable bin widths)
+ */
+int VTableLookupCompiled::addTable( TH2F* h )
+{
+    if( !h )
+    {
+        return -1;
+    }
+    if( h->GetXaxis()->GetXbins()->GetSize() > 0 || h->GetYaxis()->GetXbins()->GetSize() > 0 )
+    {
+        return -2;
+    }
+    sTableAxes a;
+    a.fNX = h->GetNbinsX();
+    a.fXmin = h->GetXaxis()->GetXmin();
+    a.fXmax = h->GetXaxis()->GetXmax();
+    a.fXBinWidth = ( a.fXmax - a.fXmin ) / ( double )a.fNX;
+    a.fNY = h->GetNbinsY();
+    a.fYmin = h->GetYaxis()->GetXmin();
+    a.fYmax = h->GetYaxis()->GetXmax();
+    a.fYBinWidth = ( a.fYmax - a.fYmin ) / ( double )a.fNY;
+    a.fOffset = fMedian.size();
+    
+    // bins are stored as in TH2 (including under/overflows): bin = ix + ( nx + 2 ) * iy
+    for( int j = 0; j <= a.fNY + 1; j++ )
+    {
+        for( int i = 0; i <= a.fNX + 1; i++ )
+        {
+            fMedian.push_back( h->GetBinContent( i, j ) );
+            fSigma.push_back( h->GetBinError( i, j ) );
+        }
+    }
+    fAxes.push_back( a );
+    
+    return ( int )fAxes.size() - 1;
+}
+
+/*
+ * interpolate median and sigma in log10 size (x) and distance (y)
+ *
+ * (see VTableCalculator::interpolate(); median = sigma = 0 for missing tables)
+ */
+void VTableLookupCompiled::interpolate( int iTable, double x, double y, double& iMedian, double& iSigma )
+{
+    if( iTable < 0 || iTable >= ( int )fAxes.size() )
+    {
+        iMedian = 0.;
+        iSigma = 0.;
+        return;
+    }
+    const sTableAxes& a = fAxes[iTable];
+    const float* i_median = &fMedian[a.fOffset];
+    const float* i_sigma = &fSigma[a.fOffset];
+    const int nxb = a.fNX + 2;
+    
+    int i_x = findBin( x, a.fNX, a.fXmin, a.fXmax );
+    int i_y = findBin( y, a.fNY, a.fYmin, a.fYmax );
+    // handle under and overflows
+    if( i_x == 0 || i_y == 0 || i_x == a.fNX || i_y == a.fNY )
+    {
+        iMedian = i_median[i_x + nxb * i_y];
+        iSigma = i_sigma[i_x + nxb * i_y];
+        return;
+    }
+    // bin centres
+    if( x < a.fXmin + ( i_x - 1 ) * a.fXBinWidth + 0.5 * a.fXBinWidth )
+    {
+        i_x--;
+    }
+    if( y < a.fYmin + ( i_y - 1 ) * a.fYBinWidth + 0.5 * a.fYBinWidth )
+    {
+        i_y--;
+    }
+    const double x0 = a.fXmin + ( i_x - 1 ) * a.fXBinWidth + 0.5 * a.fXBinWidth;
+    const double x1 = a.fXmin + i_x * a.fXBinWidth + 0.5 * a.fXBinWidth;
+    const double y0 = a.fYmin + ( i_y - 1 ) * a.fYBinWidth + 0.5 * a.fYBinWidth;
+    const double y1 = a.fYmin + i_y * a.fYBinWidth + 0.5 * a.fYBinWidth;
+    // bin numbers (overflow bins for bins beyond the axis range, as in TH2::GetBin())
+    const int ix0 = i_x;
+    const int ix1 = ( i_x + 1 > a.fNX + 1 ? a.fNX + 1 : i_x + 1 );
+    const int iy0 = i_y;
+    const int iy1 = ( i_y + 1 > a.fNY + 1 ? a.fNY + 1 : i_y + 1 );
+    const int b00 = ix0 + nxb * iy0;
+    const int b01 = ix0 + nxb * iy1;
+    const int b10 = ix1 + nxb * iy0;
+    const int b11 = ix1 + nxb * iy1;
+    
+    // first interpolate on distance axis, then on size axis
+    double e1 = VStatistics::interpolate( i_median[b00], y0, i_median[b01], y1, y, false, 0.5, 1.e-5 );
+    double e2 = VStatistics::interpolate( i_median[b10], y0, i_median[b11], y1, y, false, 0.5, 1.e-5 );
+    iMedian = VStatistics::interpolate( e1, x0, e2, x1, x, false, 0.5, 1.e-5 );
+    // final check on consistency of results
+    // (don't expect to reconstruct anything below 1 GeV)
+    if( e1 > 1.e-3 && e2 < 1.e-3 )
+    {
+        iMedian = e1;
+    }
+    else if( e1 < 1.e-3 && e2 > 1.e-3 )
+    {
+        iMedian = e2;
+    }
+    
+    e1 = VStatistics::interpolate( i_sigma[b00], y0, i_sigma[b01], y1, y, false, 0.5, 1.e-5 );
+    e2 = VStatistics::interpolate( i_sigma[b10], y0, i_sigma[b11], y1, y, false, 0.5, 1.e-5 );
+    iSigma = VStatistics::interpolate( e1, x0, e2, x1, x, false, 0.5, 1.e-5 );
+    if( e1 > 1.e-3 && e2 < 1.e-3 )
+    {
+        iSigma = e1;
+    }
+    else if( e1 < 1.e-3 && e2 > 1.e-3 )
+    {
+        iSigma = e2;
+    }
+}
@@ -149,6 +149,65 @@ VTableLookupDataHandler::VTableLookupDataHandler( bool iwrite, VTableLookupRunPa
     fDispAnalyzerCore      = 0;
 }
 
+/*
+ * (tree readers are detached from their chains before deletion,
+ *  as the chains own the input files)
+ */
+VTableLookupDataHandler::~VTableLookupDataHandler()
+{
+    delete fDispAnalyzerDirection;
+    delete fDispAnalyzerDirectionError;
+    delete fDispAnalyzerDirectionSign;
+    delete fDispAnalyzerEnergy;
+    delete fDispAnalyzerCore;
+    delete fEmissionHeightCalculator;
+    delete fRandom;
+
+    // input trees
+    if( fshowerpars )
+    {
+        fshowerpars->fChain = 0;
+        delete fshowerpars;
+    }
+    for( unsigned int i = 0; i < ftpars.size(); i++ )
+    {
+        if( ftpars[i] )
+        {
+            ftpars[i]->fChain = 0;
+            delete ftpars[i];
+        }
+    }
+    for( unsigned int i = 0; i < fpointingCorrections.size(); i++ )
+    {
+        delete fpointingCorrections[i];
+    }
+    for( unsigned int i = 0; i < fTtpars.size(); i++ )
+    {
+        delete fTtpars[i];
+    }
+    for( unsigned int i = 0; i < fTpointingCorrections.size(); i++ )
+    {
+        delete fTpointingCorrections[i];
+    }
+    delete fTshowerpars;
+    delete fTshowerpars_QCCut;
+    delete fDeepLearnerpars;
+    delete fTtelconfig;
+
+    // MC histograms
+    if( hisList )
+    {
+        hisList->Delete();
+        delete hisList;
+    }
+    // output file (trees are deleted with the file)
+    if( fOutFile )
+    {
+        fOutFile->Close();
+        delete fOutFile;
+    }
+}
+
 /*
  * fill results of analysis into output tree
  * (called data in the mscw file)
@@ -897,6 +956,7 @@ void VTableLookupDataHandler::doStereoReconstruction()
         // use weighting calculated from disp error
         fDispAnalyzerDirection->setDispErrorWeighting( fDispAnalyzerDirectionError != 0,
                 fTLRunParameter->fDispError_BDTWeight );
+        fDispAnalyzerDirection->setHeadTailSearch_NImages_max( fTLRunParameter->fRerunStereoReconstruction_HeadTailNImages_max );
         fDispAnalyzerDirection->setQualityCuts( fSSR_NImages_min, fSSR_AxesAngles_min,
                                                 fTLRunParameter->fmaxdist,
                                                 fTLRunParameter->fmaxloss,
@@ -1347,10 +1407,47 @@ bool VTableLookupDataHandler::setInputFile( vector< string > iInput )
         fEventDisplayFileFormat = 1;
     }
     // initialize quality cut chain
+    // (read only the branches needed for the quick quality assessment)
+    fTshowerpars_QCCut->SetBranchStatus( "*", 0 );
+    fTshowerpars_QCCut->SetBranchStatus( "NMethods", 1 );
+    fTshowerpars_QCCut->SetBranchStatus( "NImages", 1 );
+    fTshowerpars_QCCut->SetBranchStatus( "Chi2", 1 );
     fTshowerpars_QCCut->SetBranchAddress( "NMethods", &fNMethods );
     fTshowerpars_QCCut->SetBranchAddress( "NImages", fNImages_QCTree );
     fTshowerpars_QCCut->SetBranchAddress( "Chi2", fchi2_QCTree );
 
+    // tpars branches not used for table filling and reading
+    // (all other branches without branch address are disabled as well)
+    vector< string > i_tpars_unusedBranches;
+    i_tpars_unusedBranches.push_back( "eventNumber" );
+    i_tpars_unusedBranches.push_back( "meanPed_Image" );
+    i_tpars_unusedBranches.push_back( "ntubesBNI" );
+    i_tpars_unusedBranches.push_back( "phi" );
+    i_tpars_unusedBranches.push_back( "muonX0" );
+    i_tpars_unusedBranches.push_back( "muonY0" );
+    i_tpars_unusedBranches.push_back( "muonRadius" );
+    i_tpars_unusedBranches.push_back( "muonRSigma" );
+    i_tpars_unusedBranches.push_back( "muonSize" );
+    i_tpars_unusedBranches.push_back( "muonIPCorrectedSize" );
+    i_tpars_unusedBranches.push_back( "muonValid" );
+    i_tpars_unusedBranches.push_back( "houghMuonValid" );
+    if( !fTLRunParameter->fWritePixelLists )
+    {
+        i_tpars_unusedBranches.push_back( "PixelListN" );
+        i_tpars_unusedBranches.push_back( "PixelID" );
+        i_tpars_unusedBranches.push_back( "PixelType" );
+        i_tpars_unusedBranches.push_back( "PixelIntensity" );
+        i_tpars_unusedBranches.push_back( "PixelTimingT0" );
+        i_tpars_unusedBranches.push_back( "PixelPE" );
+    }
+    // image axis parameters are needed for pointing corrections only (no pointing corrections for MC)
+    if( fIsMC )
+    {
+        i_tpars_unusedBranches.push_back( "f_d" );
+        i_tpars_unusedBranches.push_back( "f_s" );
+        i_tpars_unusedBranches.push_back( "f_sdevxy" );
+    }
+
     // get individual image parameter trees
     for( unsigned int i = 0; i < fNTel; i++ )
     {
@@ -1392,12 +1489,15 @@ bool VTableLookupDataHandler::setInputFile( vector< string > iInput )
                     }
                 }
                 ftpars.push_back( new Ctpars( iT, fIsMC, bShort ) );
+                ftpars.back()->disableUnusedBranches( i_tpars_unusedBranches );
             }
         }
         else
         {
             ftpars.push_back( 0 );
         }
+        fTtpars.push_back( iT );
+        fTpointingCorrections.push_back( iPC );
         fpointingCorrections.push_back( new VPointingCorrectionsTreeReader( iPC ) );
         gErrorIgnoreLevel = 0;
     }
@@ -2065,6 +2165,82 @@ void VTableLookupDataHandler::printCutStatistics()
     cout << "---------------------------------------------------------------------------------------------------" << endl;
 }
 
+/*
+ * restrict event loop to the entry range [iFirstEntry, iLastEntry)
+ * (used for parallel processing of entry ranges)
+ */
+void VTableLookupDataHandler::setEventRange( Long64_t iFirstEntry, Long64_t iLastEntry )
+{
+    fEventCounter = iFirstEntry;
+    fNEntries = iLastEntry;
+}
+
+/*
+ * merge results from a data handler which analysed a different
+ * entry range of the same input files
+ *
+ * - events in the output tree are appended (call in order of entry ranges
+ *   to keep the original event order)
+ * - cut statistics and MC histograms are added
+ *
+ * the output file of iD is closed and removed
+ */
+bool VTableLookupDataHandler::merge( VTableLookupDataHandler* iD )
+{
+    if( !iD || iD == this )
+    {
+        return false;
+    }
+
+    // cut statistics
+    fNStats_All          += iD->fNStats_All;
+    fNStats_Rec          += iD->fNStats_Rec;
+    fNStats_NImagesCut   += iD->fNStats_NImagesCut;
+    fNStats_Chi2Cut      += iD->fNStats_Chi2Cut;
+    fNStats_CoreErrorCut += iD->fNStats_CoreErrorCut;
+    fNStats_WobbleCut    += iD->fNStats_WobbleCut;
+    fNStats_WobbleMinCut += iD->fNStats_WobbleMinCut;
+    fNStats_WobbleMaxCut += iD->fNStats_WobbleMaxCut;
+
+    // MC histograms (same list of histograms for all data handlers)
+    if( hisList && iD->hisList && hisList->GetSize() == iD->hisList->GetSize() )
+    {
+        TIter next( hisList );
+        TIter next_iD( iD->hisList );
+        TH1* h = 0;
+        while( ( h = ( TH1* )next() ) )
+        {
+            TH1* h_iD = ( TH1* )next_iD();
+            if( h_iD )
+            {
+                h->Add( h_iD );
+            }
+        }
+    }
+
+    // output tree
+    if( fOTree && iD->fOTree && iD->fOutFile )
+    {
+        iD->fOutFile->cd();
+        iD->fOTree->Write( "", TObject::kOverwrite );
+        if( fOutFile )
+        {
+            fOutFile->cd();
+        }
+        if( fOTree->CopyEntries( iD->fOTree, -1, "fast" ) < 0 )
+        {
+            cout << "VTableLookupDataHandler::merge error copying events from " << iD->foutputfile << endl;
+            exit( EXIT_FAILURE );
+        }
+        iD->fOutFile->Close();
+        gSystem->Unlink( iD->foutputfile.c_str() );
+        iD->fOutFile = 0;
+        iD->fOTree = 0;
+    }
+
+    return true;
+}
+
 /*!
   write everything to disk
 */
@@ -28,6 +28,7 @@ VTableLookupRunParameter::VTableLookupRunParameter()
     bWriteMCPars = false;
     rec_method = 0;
     fWrite1DHistograms = false;
+    fQuantileSketchCompression = 100.;
     fSpectralIndex = 2.0;
     fWobbleOffset = 500;     // integer of wobble offset * 100
     fNoiseLevel = 250;
@@ -44,6 +45,7 @@ VTableLookupRunParameter::VTableLookupRunParameter()
     fRerunStereoReconstruction = false;
     fRerunStereoReconstruction_minAngle = -1.;
     fRerunStereoReconstruction_BDTNImages_max = 4;
+    fRerunStereoReconstruction_HeadTailNImages_max = 5;
     fRerunStereoReconstruction_BDTFileName = "";
     fEnergyReconstruction_BDTFileName = "";
     fCoreReconstruction_BDTFileName = "";
@@ -65,6 +67,7 @@ VTableLookupRunParameter::VTableLookupRunParameter()
 
     fNentries = TChain::kBigNumber;
     fMaxRunTime = 1.e9;
+    fNThreads = 1;
 
     printpara = "";
 
@@ -148,6 +151,10 @@ bool VTableLookupRunParameter::fillParameters( int argc, char* argv[] )
         {
             fMinRequiredShowerPerBin = atof( iTemp.substr( iTemp.rfind( "=" ) + 1, iTemp.size() ).c_str() );
         }
+        else if( iTemp.find( "quantilesketchcompression" ) < iTemp.size() )
+        {
+            fQuantileSketchCompression = atof( iTemp.substr( iTemp.rfind( "=" ) + 1, iTemp.size() ).c_str() );
+        }
         else if( iTemp.find( "woff" ) < iTemp.size() )
         {
             fWobbleOffset = atoi( iTemp.substr( iTemp.rfind( "=" ) + 1, iTemp.size() ).c_str() );
@@ -214,6 +221,12 @@ bool VTableLookupRunParameter::fillParameters( int argc, char* argv[] )
                 exit( EXIT_FAILURE );
             }
         }
+        // disp head/tail signs are searched for images with up to this multiplicity
+        // (intersection point is used for larger multiplicities)
+        else if( iTemp.find( "-disp_headtail_nimages_max" ) < iTemp.size() )
+        {
+            fRerunStereoReconstruction_HeadTailNImages_max = ( unsigned int )( atoi( iTemp.substr( iTemp.rfind( "=" ) + 1, iTemp.size() ).c_str() ) );
+        }
         // BDT directory and file name for disp stereo reconstruction (energy)
         else if( iTemp.find( "-tmva_filename_energy_reconstruction" ) < iTemp.size() )
         {
@@ -444,6 +457,14 @@ bool VTableLookupRunParameter::fillParameters( int argc, char* argv[] )
         {
             fMaxRunTime = atof( iTemp.substr( iTemp.rfind( "=" ) + 1, iTemp.size() ).c_str() );
         }
+        else if( iTemp.find( "-nthreads" ) < iTemp.size() )
+        {
+            fNThreads = ( unsigned int )atoi( iTemp.substr( iTemp.rfind( "=" ) + 1, iTemp.size() ).c_str() );
+            if( fNThreads < 1 )
+            {
+                fNThreads = 1;
+            }
+        }
         else if( iTemp.find( "-limitEnergyReconstruction" ) < iTemp.size() )
         {
             cout << "obsolete run parameter -limitEnergyReconstruction; ignored" << endl;
@@ -972,6 +993,8 @@ void VTableLookupRunParameter::print( int iP )
             cout << "\t reading BDT TMVA files from " << fRerunStereoReconstruction_BDTFileName << endl;
             cout << "\t BDT TMVA stereo reconstruction is applied for events with <= ";
             cout << fRerunStereoReconstruction_BDTNImages_max << " images" << endl;
+            cout << "\t disp head/tail sign search for events with <= ";
+            cout << fRerunStereoReconstruction_HeadTailNImages_max << " images" << endl;
             if( fmaxdist < 1.e3 )
             {
                 cout << "\t BDT TMVA stereo reconstruction distance cut < " << fmaxdist << endl;
@@ -1001,6 +1024,10 @@ void VTableLookupRunParameter::print( int iP )
     {
         cout << "random event selection: " << fSelectRandom << ", seed:" << fSelectRandomSeed << endl;
     }
+    if( fNThreads > 1 && !fWriteTables )
+    {
+        cout << "\t number of threads for table reading: " << fNThreads << endl;
+    }
     if( fUseSelectedImagesOnly )
     {
         cout << "\t use evndisp image selection" << endl;
@@ -1012,6 +1039,7 @@ void VTableLookupRunParameter::print( int iP )
     if( fWriteTables )
     {
         cout << "minimum number of showers required per lookup table bin: " << fMinRequiredShowerPerBin << endl;
+        cout << "compression of quantile sketches per lookup table bin: " << fQuantileSketchCompression << endl;
     }
     if( fUseMedianEnergy == 1 )
     {
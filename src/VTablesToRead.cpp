@@ -20,9 +20,17 @@ VTablesToRead::VTablesToRead( unsigned int n_tabletypes, int iNTel )
         }
         hMedian[t] = i_hnull;
         hSigma[t]  = i_hnull;
+        table_index[t].assign( fNTel, -1 );
         
         value_T[t]       = new double[fNTel];
         value_T_sigma[t] = new double[fNTel];
+        table_median[t]  = new double[fNTel];
+        table_sigma[t]   = new double[fNTel];
+        for( unsigned int i = 0; i < fNTel; i++ )
+        {
+            table_median[t][i] = 0.;
+            table_sigma[t][i] = 0.;
+        }
         
         value[t] = -99.;
         value_Chi2[t] = -99.;
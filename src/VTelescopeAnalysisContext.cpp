@@ -0,0 +1,64 @@
+/*! \class VTelescopeAnalysisContext
+    \brief per-telescope state for the image analysis
+
+    Holds image cleaner, image parameter calculator and temporary
+    vectors of one telescope. Contexts owning their cleaner and
+    calculator can be used concurrently for different telescopes
+    of the same event (see VImageAnalyzer::doAnalysis( vector< unsigned int > ) ).
+
+    bind() sets the current telescope for the calling thread; all
+    telescope dependent getters of VEvndispData then point to this telescope.
+
+*/
+
+#include "VTelescopeAnalysisContext.h"
+
+/*
+ * context with its own image cleaner and parameter calculator
+ * (required for parallel analysis)
+ */
+VTelescopeAnalysisContext::VTelescopeAnalysisContext( unsigned int iTelID, VEvndispData* iData )
+{
+    fTelID = iTelID;
+    fOwner = true;
+    fData = iData;
+    fImageCleaning = new VImageCleaning( fData );
+    fImageParameterCalculation = new VImageParameterCalculation( fData->getRunParameter()->fShortTree, fData );
+    fImageParameterCalculation->setDebug( fData->getDebugFlag() );
+    fImageParameterCalculation->setDetectorGeometry( fData->getDetectorGeometry() );
+}
+
+/*
+ * context sharing the image cleaner and parameter calculator
+ * of the image analyzer (serial analysis)
+ */
+VTelescopeAnalysisContext::VTelescopeAnalysisContext( unsigned int iTelID, VEvndispData* iData,
+        VImageCleaning* iImageCleaning,
+        VImageParameterCalculation* iImageParameterCalculation )
+{
+    fTelID = iTelID;
+    fOwner = false;
+    fData = iData;
+    fImageCleaning = iImageCleaning;
+    fImageParameterCalculation = iImageParameterCalculation;
+}
+
+VTelescopeAnalysisContext::~VTelescopeAnalysisContext()
+{
+    if( fOwner )
+    {
+        delete fImageCleaning;
+        delete fImageParameterCalculation;
+    }
+}
+
+/*
+ * make this telescope the current telescope of the calling thread
+ */
+void VTelescopeAnalysisContext::bind()
+{
+    if( fData )
+    {
+        fData->setThreadTelID( fTelID );
+    }
+}
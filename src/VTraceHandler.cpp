@@ -24,9 +24,16 @@ VTraceHandler::VTraceHandler()
     
     fTraceIntegrationMethod = 1;
     kIPRmeasure  = false;
+    fSlidingWindowMethod = 0;
     
     setDigitalFilterParameters();
     fDF_tracemax = 0.;
+    
+    fSampleBlockNChannels = 0;
+    fSampleBlockNSamples = 0;
+    fSampleBlockValid = false;
+    fTraceBlockValid = false;
+    fTraceBlockNWindows = 0;
 }
 
 void VTraceHandler::reset()
@@ -55,6 +62,40 @@ void VTraceHandler::setTrace( VVirtualDataReader* iReader, unsigned int iNSample
         return;
     }
     
+    ///////////////////////////////////////
+    // copy trace from sample block of this telescope
+    // (hi-lo gain ratio applied in the same pass)
+    if( fSampleBlockValid && iNSamples == fSampleBlockNSamples && iHitID < fSampleBlockNChannels )
+    {
+        if( iNSamples != fpTrace.size() )
+        {
+            fpTrace.resize( iNSamples );
+        }
+        fpTrazeSize = iNSamples;
+        const uint16_t* i_samples = &fSampleBlock[iHitID * iNSamples];
+        if( iHiLo > 0. )
+        {
+            for( unsigned int i = 0; i < iNSamples; i++ )
+            {
+                fpTrace[i]  = ( ( double )i_samples[i] - fPed ) * iHiLo;
+                fpTrace[i] += fPed;
+            }
+            fHiLo = true;
+        }
+        else
+        {
+            for( unsigned int i = 0; i < iNSamples; i++ )
+            {
+                fpTrace[i] = ( double )i_samples[i];
+            }
+        }
+        if( fDF_method > 0 )
+        {
+            apply_digitalFilter();
+        }
+        return;
+    }
+    
     ///////////////////////////////////////
     // copy trace from raw data reader
     if( iNSamples != fpTrace.size() )
@@ -85,6 +126,240 @@ void VTraceHandler::setTrace( VVirtualDataReader* iReader, unsigned int iNSample
     }
 }
 
+/*
+ * read samples of all hit channels of the current telescope in one call
+ *
+ * setTrace( VVirtualDataReader*, ... ) takes traces from this block until
+ * resetSampleBlock() is called (call once per telescope and event, before
+ * the loop over all channels)
+ *
+ * returns false if the reader does not provide sample blocks
+ * (traces are then read sample by sample)
+ */
+bool VTraceHandler::setSampleBlock( VVirtualDataReader* iReader, unsigned int iNSamples )
+{
+    fSampleBlockValid = false;
+    fTraceBlockValid = false;
+    if( !iReader || iNSamples == 0 )
+    {
+        return false;
+    }
+    fSampleBlockNChannels = iReader->getNumChannelsHit();
+    fSampleBlockNSamples = iNSamples;
+    fSampleBlockValid = iReader->getSampleBlock( fSampleBlock, iNSamples, fMC_FADCTraceStart );
+    
+    return fSampleBlockValid;
+}
+
+/*
+ * fill traces of all channels of the sample block into a sample-major
+ * array for the vectorized kernels (VTraceKernels)
+ *
+ * iPed and iLowGainMultiplier are indexed by hit ID (same values as in
+ * setTrace(); iLowGainMultiplier <= 0 for high-gain channels)
+ *
+ * not available for digitally filtered traces
+ */
+bool VTraceHandler::fillTraceBlock( vector< double >& iPed, vector< double >& iLowGainMultiplier )
+{
+    fTraceBlockValid = false;
+    if( !fSampleBlockValid || fDF_method > 0 || fSampleBlockNChannels == 0 )
+    {
+        return false;
+    }
+    if( iPed.size() < fSampleBlockNChannels || iLowGainMultiplier.size() < fSampleBlockNChannels )
+    {
+        return false;
+    }
+    unsigned int nch = fSampleBlockNChannels;
+    unsigned int ns = fSampleBlockNSamples;
+    if( fTraceBlock.size() < nch * ns )
+    {
+        fTraceBlock.resize( nch * ns );
+    }
+    if( fTraceBlockPed.size() < nch )
+    {
+        fTraceBlockPed.resize( nch );
+        fTraceBlockSum.resize( nch );
+        fTraceBlockTCharge.resize( nch );
+        fTraceBlockMax.resize( nch );
+        fTraceBlockMaxPos.resize( nch );
+    }
+    for( unsigned int c = 0; c < nch; c++ )
+    {
+        fTraceBlockPed[c] = iPed[c];
+        const uint16_t* i_samples = &fSampleBlock[c * ns];
+        if( iLowGainMultiplier[c] > 0. )
+        {
+            for( unsigned int i = 0; i < ns; i++ )
+            {
+                double t = ( ( double )i_samples[i] - iPed[c] ) * iLowGainMultiplier[c];
+                t += iPed[c];
+                fTraceBlock[i * nch + c] = t;
+            }
+        }
+        else
+        {
+            for( unsigned int i = 0; i < ns; i++ )
+            {
+                fTraceBlock[i * nch + c] = ( double )i_samples[i];
+            }
+        }
+    }
+    fTraceBlockValid = true;
+    
+    return true;
+}
+
+/*
+ * trace sums in [iFirst, iLast) for all channels of the trace block
+ * (method 1; results are identical to calculateTraceSum_fixedWindow())
+ */
+bool VTraceHandler::calculateTraceBlockSums_fixedWindow( unsigned int iFirst, unsigned int iLast, bool iRaw )
+{
+    if( !fTraceBlockValid )
+    {
+        return false;
+    }
+    fSumWindowFirst = iFirst;
+    fSumWindowLast  = iLast;
+    if( iLast > fSampleBlockNSamples )
+    {
+        iLast = fSampleBlockNSamples;
+    }
+    VTraceKernels::fixedWindowSums( &fTraceBlock[0], fSampleBlockNChannels, fSampleBlockNChannels,
+                                    iFirst, iLast, &fTraceBlockPed[0], iRaw,
+                                    &fTraceBlockSum[0], &fTraceBlockTCharge[0] );
+    return true;
+}
+
+/*
+ * return trace sum and average time of channel iHitID
+ * (call calculateTraceBlockSums_fixedWindow() first)
+ */
+double VTraceHandler::getTraceBlockSum( unsigned int iHitID, double& iAverageTime )
+{
+    iAverageTime = 0.;
+    if( !fTraceBlockValid || iHitID >= fSampleBlockNChannels )
+    {
+        return 0.;
+    }
+    double sum = fTraceBlockSum[iHitID];
+    if( TMath::IsNaN( sum ) )
+    {
+        sum = 0.;
+    }
+    if( TMath::Abs( sum ) < 1.e-10 )
+    {
+        sum = 0.;
+    }
+    else
+    {
+        iAverageTime = fTraceBlockTCharge[iHitID] / sum;
+    }
+    return sum;
+}
+
+/*
+ * trace sums in [iFirst, iFirst + w + 1), w = 0..iNWindows-1, for all channels
+ * of the trace block (method 1, e.g. for pedestal calculation)
+ *
+ * one pass over the samples: the sum of window w is the running sum up to sample
+ * iFirst + w (results are identical to calculateTraceBlockSums_fixedWindow())
+ */
+bool VTraceHandler::calculateTraceBlockSums_allWindows( unsigned int iFirst, unsigned int iNWindows, bool iRaw )
+{
+    if( !fTraceBlockValid )
+    {
+        return false;
+    }
+    unsigned int nch = fSampleBlockNChannels;
+    if( fTraceBlockWindowSum.size() < iNWindows * nch )
+    {
+        fTraceBlockWindowSum.resize( iNWindows * nch );
+    }
+    fTraceBlockNWindows = iNWindows;
+    for( unsigned int w = 0; w < iNWindows; w++ )
+    {
+        double* i_sum = &fTraceBlockWindowSum[w * nch];
+        for( unsigned int c = 0; c < nch; c++ )
+        {
+            i_sum[c] = ( w > 0 ? fTraceBlockWindowSum[( w - 1 ) * nch + c] : 0. );
+        }
+        unsigned int i = iFirst + w;
+        if( i >= fSampleBlockNSamples )
+        {
+            continue;
+        }
+        const double* i_trace = &fTraceBlock[i * nch];
+        for( unsigned int c = 0; c < nch; c++ )
+        {
+            // require that trace is >0. (as in calculateTraceSum_fixedWindow())
+            if( i_trace[c] > 0. )
+            {
+                if( !iRaw )
+                {
+                    i_sum[c] += i_trace[c] - fTraceBlockPed[c];
+                }
+                else
+                {
+                    i_sum[c] += i_trace[c];
+                }
+            }
+        }
+    }
+    return true;
+}
+
+/*
+ * return trace sum of channel iHitID in summation window iWindow
+ * (call calculateTraceBlockSums_allWindows() first)
+ */
+double VTraceHandler::getTraceBlockWindowSum( unsigned int iWindow, unsigned int iHitID )
+{
+    if( !fTraceBlockValid || iHitID >= fSampleBlockNChannels || iWindow >= fTraceBlockNWindows )
+    {
+        return 0.;
+    }
+    double sum = fTraceBlockWindowSum[iWindow * fSampleBlockNChannels + iHitID];
+    if( TMath::IsNaN( sum ) || TMath::Abs( sum ) < 1.e-10 )
+    {
+        return 0.;
+    }
+    return sum;
+}
+
+/*
+ * trace maximum over the full trace for all channels of the trace block
+ * (results are identical to getTraceMax( n255, maxpos ))
+ */
+bool VTraceHandler::calculateTraceBlockMax()
+{
+    if( !fTraceBlockValid )
+    {
+        return false;
+    }
+    VTraceKernels::traceMax( &fTraceBlock[0], fSampleBlockNChannels, fSampleBlockNChannels,
+                             0, fSampleBlockNSamples, &fTraceBlockMax[0], &fTraceBlockMaxPos[0] );
+    return true;
+}
+
+/*
+ * return pedestal subtracted trace maximum of channel iHitID
+ * (call calculateTraceBlockMax() first)
+ */
+double VTraceHandler::getTraceBlockMax( unsigned int iHitID, unsigned int& n255, unsigned int& maxpos )
+{
+    n255 = 0;
+    maxpos = 99999;
+    if( !fTraceBlockValid || iHitID >= fSampleBlockNChannels )
+    {
+        return -10000.;
+    }
+    maxpos = fTraceBlockMaxPos[iHitID];
+    return fTraceBlockMax[iHitID] - fTraceBlockPed[iHitID];
+}
+
 /*
  *  used only for time jitter calibration
  *
@@ -595,6 +870,114 @@ double VTraceHandler::getTraceSum( unsigned int iSumWindowFirst, unsigned int iS
 }
 
 
+/*
+ * trace sums of the current trace for the summation windows
+ * [iSumWindowFirst, iSumWindowFirst + w + 1), w = 0..iNSumWindows-1
+ * (e.g. for pedestal and IPR calculation)
+ *
+ * - method 1: one pass over the trace (running sum)
+ * - method 2, raw sums: one value for all windows (see calculateTraceSum_slidingWindow())
+ * - method 2 with prefix sums: prefix sums are calculated once for all windows
+ * - all other methods: getTraceSum() for each window
+ *
+ * results are identical to getTraceSum( iSumWindowFirst, iSumWindowFirst + w + 1, iRaw, 9999, true, iSlidingWindowLast )
+ *
+ */
+void VTraceHandler::getTraceSums( unsigned int iSumWindowFirst, unsigned int iNSumWindows, bool iRaw,
+                                  unsigned int iSlidingWindowLast, vector< double >& iSums )
+{
+    if( iSums.size() < iNSumWindows )
+    {
+        iSums.resize( iNSumWindows );
+    }
+    if( iNSumWindows == 0 )
+    {
+        return;
+    }
+    // fixed window
+    if( fTraceIntegrationMethod == 1 )
+    {
+        double sum = 0.;
+        for( unsigned int w = 0; w < iNSumWindows; w++ )
+        {
+            unsigned int i = iSumWindowFirst + w;
+            // require that trace is >0. (as in calculateTraceSum_fixedWindow())
+            if( i < fpTrace.size() && fpTrace[i] > 0. )
+            {
+                if( !iRaw )
+                {
+                    sum += fpTrace[i] - fPed;
+                }
+                else
+                {
+                    sum += fpTrace[i];
+                }
+            }
+            if( TMath::IsNaN( sum ) || TMath::Abs( sum ) < 1.e-10 )
+            {
+                iSums[w] = 0.;
+            }
+            else
+            {
+                iSums[w] = sum;
+            }
+        }
+        fSumWindowFirst = iSumWindowFirst;
+        fSumWindowLast  = iSumWindowFirst + iNSumWindows;
+        return;
+    }
+    // sliding window, raw sums (pedestal calculation)
+    // (same value for all windows as in the raw case of calculateTraceSum_slidingWindow())
+    else if( fTraceIntegrationMethod == 2 && iRaw && fpTrace.size() > 1 && iNSumWindows <= fpTrace.size() )
+    {
+        unsigned int n = fpTrace.size();
+        float ped = fPed;
+        if( kIPRmeasure )
+        {
+            ped = 0.;
+        }
+        float i_sum = ( float )fpTrace[1] - ped;
+        for( unsigned int w = 0; w < iNSumWindows; w++ )
+        {
+            iSums[w] = i_sum;
+        }
+        fTraceAverageTime = n - 0.5;
+        fSumWindowFirst = n - iNSumWindows;
+        fSumWindowLast  = n;
+        return;
+    }
+    // sliding window with prefix sums
+    // (search range as in getTraceSum() with iForceWindowStart = true)
+    else if( fTraceIntegrationMethod == 2 && fSlidingWindowMethod == 1 && fpTrace.size() > 0 )
+    {
+        unsigned int n = fpTrace.size();
+        unsigned int i_searchStart = iSumWindowFirst;
+        unsigned int i_searchEnd = iSlidingWindowLast;
+        if( kIPRmeasure )
+        {
+            i_searchStart = 0.5 * fpTrace.size();
+            i_searchEnd = n;
+        }
+        else if( i_searchEnd >= n )
+        {
+            i_searchEnd = n;
+        }
+        if( i_searchStart < n )
+        {
+            fillPrefixSums( i_searchStart, n - i_searchStart, ( kIPRmeasure ? 0. : fPed ) );
+        }
+        for( unsigned int w = 0; w < iNSumWindows; w++ )
+        {
+            iSums[w] = calculateTraceSum_slidingWindow_prefixSum( i_searchStart, i_searchEnd, w + 1, true );
+        }
+        return;
+    }
+    for( unsigned int w = 0; w < iNSumWindows; w++ )
+    {
+        iSums[w] = getTraceSum( iSumWindowFirst, iSumWindowFirst + w + 1, iRaw, 9999, true, iSlidingWindowLast );
+    }
+}
+
 /*
  *
  * get maximum trace sum
@@ -606,6 +989,11 @@ double VTraceHandler::calculateTraceSum_slidingWindow( unsigned int iSearchStart
         int iIntegrationWindow,
         bool fRaw )
 {
+    // prefix sum method (selected per telescope type)
+    if( fSlidingWindowMethod == 1 && !fRaw && fpTrace.size() > 0 && iIntegrationWindow > 0 )
+    {
+        return calculateTraceSum_slidingWindow_prefixSum( iSearchStart, iSearchEnd, ( unsigned int )iIntegrationWindow );
+    }
     unsigned int n = fpTrace.size();
     unsigned int window = iIntegrationWindow;
     unsigned int SearchEnd = iSearchEnd;
@@ -704,6 +1092,107 @@ double VTraceHandler::calculateTraceSum_slidingWindow( unsigned int iSearchStart
     return charge;
 }
 
+/*
+ *
+ * get maximum trace sum using prefix sums
+ * (sliding window, search along trace for maximum sum)
+ *
+ * same search as calculateTraceSum_slidingWindow(), but
+ * - window sums are differences of prefix sums (double precision)
+ * - average time from prefix sums of the time weighted trace
+ *   (no second loop over the integration window)
+ *
+ * O(n) for any window length and search range
+ *
+*/
+double VTraceHandler::calculateTraceSum_slidingWindow_prefixSum( unsigned int iSearchStart,
+        unsigned int iSearchEnd,
+        unsigned int iIntegrationWindow,
+        bool iReusePrefixSums )
+{
+    unsigned int n = fpTrace.size();
+    unsigned int window = iIntegrationWindow;
+    if( window > n )
+    {
+        window = n;
+    }
+    unsigned int SearchEnd = iSearchEnd;
+    if( ( n - window ) <= SearchEnd )
+    {
+        SearchEnd = n - window + 1;
+    }
+    double ped = fPed;
+    if( kIPRmeasure )
+    {
+        ped = 0.;
+    }
+    unsigned int lolimit = 0;
+    unsigned int uplimit = 0;
+    double charge = 0.;
+    
+    if( iSearchStart < SearchEnd )
+    {
+        // prefix sums over [iSearchStart, SearchEnd + window - 1)
+        // (reuse prefix sums calculated up to the end of the trace, see getTraceSums())
+        if( !iReusePrefixSums )
+        {
+            fillPrefixSums( iSearchStart, SearchEnd + window - 1 - iSearchStart, ped );
+        }
+        // search for maximum window sum
+        double xmax = 0.;
+        for( unsigned int i = iSearchStart; i < SearchEnd; i++ )
+        {
+            xmax = fPrefixSum[i - iSearchStart + window] - fPrefixSum[i - iSearchStart];
+            if( charge < xmax )
+            {
+                charge = xmax;
+                lolimit = i;
+                uplimit = i + window;
+            }
+        }
+        // arrival time
+        if( charge != 0. )
+        {
+            fTraceAverageTime = ( fPrefixTCharge[uplimit - iSearchStart] - fPrefixTCharge[lolimit - iSearchStart] ) / charge;
+        }
+    }
+    
+    if( fTraceAverageTime < iSearchStart )
+    {
+        fTraceAverageTime = 0.;
+    }
+    if( fTraceAverageTime > ( ( int )SearchEnd + ( int )window - 1 ) )
+    {
+        fTraceAverageTime = ( ( int )SearchEnd + ( int )window - 1 );
+    }
+    
+    fSumWindowFirst = lolimit;
+    fSumWindowLast  = uplimit;
+    
+    return charge;
+}
+
+/*
+ * prefix sums of the trace and of the time weighted trace for iN samples starting at iSearchStart
+ * (index k: sum of samples iSearchStart..iSearchStart+k-1)
+ */
+void VTraceHandler::fillPrefixSums( unsigned int iSearchStart, unsigned int iN, double ped )
+{
+    if( fPrefixSum.size() < iN + 1 )
+    {
+        fPrefixSum.resize( iN + 1 );
+        fPrefixTCharge.resize( iN + 1 );
+    }
+    fPrefixSum[0] = 0.;
+    fPrefixTCharge[0] = 0.;
+    for( unsigned int k = 0; k < iN; k++ )
+    {
+        double i_fadc = fpTrace[iSearchStart + k] - ped;
+        fPrefixSum[k + 1] = fPrefixSum[k] + i_fadc;
+        fPrefixTCharge[k + 1] = fPrefixTCharge[k] + ( iSearchStart + k + 0.5 ) * i_fadc;
+    }
+}
+
 /////////////////////////////////////////////////////////////////////
 ////////////////////////////////////////////////////////////////////
 
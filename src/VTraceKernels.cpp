@@ -0,0 +1,492 @@
+/*! \class VTraceKernels
+    \brief vectorized trace analysis for all channels of a telescope
+
+    Kernels for trace sums in a fixed window and for the trace maximum
+    (forward search), processing 4 (AVX2) or 2 (SSE2) channels in parallel.
+    The instruction set is selected at runtime (see getInstructionSet()).
+
+    Kernel for the moments of the charge distribution of an image
+    (Hillas parameters, see imageMoments()).
+
+    Input traces are sample-major: iTrace[sample * iStride + channel]
+
+    The kernels reproduce the per-channel code in
+    VTraceHandler::calculateTraceSum_fixedWindow() and
+    VTraceHandler::getTraceMax() exactly (same order of additions
+    per channel; masked lanes add zero).
+
+    The image moments are summed in the same order for all instruction sets
+    (four partial sums); results are identical on all CPUs.
+
+    see testTraceKernels for a comparison with the per-channel code
+
+*/
+
+#include "VTraceKernels.h"
+
+#if defined( __x86_64__ ) || defined( __i386__ )
+#include <immintrin.h>
+#endif
+
+unsigned int VTraceKernels::fInstructionSet = 9999;
+
+/*
+ * best instruction set available on this CPU
+ */
+unsigned int VTraceKernels::detectInstructionSet()
+{
+    unsigned int iSet = SCALAR;
+#if defined( __x86_64__ ) || defined( __i386__ )
+    __builtin_cpu_init();
+    if( __builtin_cpu_supports( "avx2" ) )
+    {
+        iSet = AVX2;
+    }
+    else if( __builtin_cpu_supports( "sse2" ) )
+    {
+        iSet = SSE2;
+    }
+#endif
+    return iSet;
+}
+
+/*
+ * best instruction set available on this CPU
+ *
+ * (determined once at first call; initialization of the function-local static
+ *  is thread safe, traces are analysed by several threads in parallel)
+ */
+unsigned int VTraceKernels::getBestInstructionSet()
+{
+    static const unsigned int i_bestSet = detectInstructionSet();
+    return i_bestSet;
+}
+
+/*
+ * instruction set used by the kernels: best instruction set available on
+ * this CPU or the one set with setInstructionSet()
+ */
+unsigned int VTraceKernels::getInstructionSet()
+{
+    if( fInstructionSet != 9999 )
+    {
+        return fInstructionSet;
+    }
+    return getBestInstructionSet();
+}
+
+string VTraceKernels::getInstructionSetName( unsigned int iSet )
+{
+    if( iSet == 9999 )
+    {
+        iSet = getInstructionSet();
+    }
+    if( iSet == AVX2 )
+    {
+        return "AVX2";
+    }
+    else if( iSet == SSE2 )
+    {
+        return "SSE2";
+    }
+    return "scalar";
+}
+
+/*
+ * force a certain instruction set (e.g. for testing)
+ *
+ * returns false if the instruction set is not available on this CPU
+ */
+bool VTraceKernels::setInstructionSet( unsigned int iSet )
+{
+    if( iSet > getBestInstructionSet() )
+    {
+        return false;
+    }
+    fInstructionSet = iSet;
+    return true;
+}
+
+/*
+ * sum of pedestal subtracted (iRaw = false) or raw traces in [iFirst, iLast)
+ * and charge weighted sum of sample times
+ *
+ * samples with trace value <= 0 are ignored
+ * (as in VTraceHandler::calculateTraceSum_fixedWindow())
+ */
+void VTraceKernels::fixedWindowSums( const double* iTrace, unsigned int iStride, unsigned int iNChannels,
+                                     unsigned int iFirst, unsigned int iLast, const double* iPed, bool iRaw,
+                                     double* iSum, double* iTCharge )
+{
+#if defined( __x86_64__ ) || defined( __i386__ )
+    if( getInstructionSet() == AVX2 )
+    {
+        fixedWindowSums_avx2( iTrace, iStride, iNChannels, iFirst, iLast, iPed, iRaw, iSum, iTCharge );
+        return;
+    }
+    else if( getInstructionSet() == SSE2 )
+    {
+        fixedWindowSums_sse2( iTrace, iStride, iNChannels, iFirst, iLast, iPed, iRaw, iSum, iTCharge );
+        return;
+    }
+#endif
+    fixedWindowSums_scalar( iTrace, iStride, 0, iNChannels, iFirst, iLast, iPed, iRaw, iSum, iTCharge );
+}
+
+/*
+ * maximum trace value (not pedestal subtracted) and its position in [iFirst, iLast)
+ *
+ * (forward search as in VTraceHandler::getTraceMax() for high-gain channels;
+ *  iMax = -10000 and iMaxPos = 99999 if no sample is above -10000)
+ */
+void VTraceKernels::traceMax( const double* iTrace, unsigned int iStride, unsigned int iNChannels,
+                              unsigned int iFirst, unsigned int iLast, double* iMax, unsigned int* iMaxPos )
+{
+#if defined( __x86_64__ ) || defined( __i386__ )
+    if( getInstructionSet() == AVX2 )
+    {
+        traceMax_avx2( iTrace, iStride, iNChannels, iFirst, iLast, iMax, iMaxPos );
+        return;
+    }
+    else if( getInstructionSet() == SSE2 )
+    {
+        traceMax_sse2( iTrace, iStride, iNChannels, iFirst, iLast, iMax, iMaxPos );
+        return;
+    }
+#endif
+    traceMax_scalar( iTrace, iStride, 0, iNChannels, iFirst, iLast, iMax, iMaxPos );
+}
+
+/*
+ * first to third order moments of the charge distribution of all pixels with iMask[i] != 0
+ *
+ *   iMoments = { S, Sx, Sy, Sxx, Syy, Sxy, Sxxx, Syyy, Sxxy, Sxyy }
+ *
+ * one sweep over all pixels (no branches on image/border flags);
+ * signals are squared for iSquared = true (squared image calculation)
+ *
+ * fixed order of summation for all instruction sets: pixel i of the first
+ * 4*(iN/4) pixels is added to partial sum i%4, the partial sums are added
+ * as (s0 + s1) + (s2 + s3), followed by the remaining pixels
+ */
+void VTraceKernels::imageMoments( const double* iX, const double* iY, const double* iSignal, const unsigned char* iMask,
+                                  unsigned int iN, bool iSquared, double* iMoments )
+{
+#if defined( __x86_64__ ) || defined( __i386__ )
+    if( getInstructionSet() == AVX2 )
+    {
+        imageMoments_avx2( iX, iY, iSignal, iMask, iN, iSquared, iMoments );
+        return;
+    }
+#endif
+    imageMoments_scalar( iX, iY, iSignal, iMask, iN, iSquared, iMoments );
+}
+
+//////////////////////////////////////////////////////////////////////////////
+// scalar kernels (also used for the remaining channels of the SIMD kernels)
+
+void VTraceKernels::fixedWindowSums_scalar( const double* iTrace, unsigned int iStride, unsigned int iChannelFirst, unsigned int iNChannels,
+        unsigned int iFirst, unsigned int iLast, const double* iPed, bool iRaw,
+        double* iSum, double* iTCharge )
+{
+    for( unsigned int c = iChannelFirst; c < iNChannels; c++ )
+    {
+        double sum = 0.;
+        double tcharge = 0.;
+        for( unsigned int i = iFirst; i < iLast; i++ )
+        {
+            double t = iTrace[i * iStride + c];
+            if( t > 0. )
+            {
+                if( !iRaw )
+                {
+                    sum += t - iPed[c];
+                    tcharge += ( i + 0.5 ) * ( t - iPed[c] );
+                }
+                else
+                {
+                    sum += t;
+                    tcharge += ( i + 0.5 ) * t;
+                }
+            }
+        }
+        iSum[c] = sum;
+        iTCharge[c] = tcharge;
+    }
+}
+
+void VTraceKernels::traceMax_scalar( const double* iTrace, unsigned int iStride, unsigned int iChannelFirst, unsigned int iNChannels,
+                                     unsigned int iFirst, unsigned int iLast, double* iMax, unsigned int* iMaxPos )
+{
+    for( unsigned int c = iChannelFirst; c < iNChannels; c++ )
+    {
+        double tmax = -10000.;
+        unsigned int maxpos = 99999;
+        for( unsigned int i = iFirst; i < iLast; i++ )
+        {
+            if( iTrace[i * iStride + c] > tmax )
+            {
+                tmax = iTrace[i * iStride + c];
+                maxpos = i;
+            }
+        }
+        iMax[c] = tmax;
+        iMaxPos[c] = maxpos;
+    }
+}
+
+/*
+ * add moments of pixel j to iMoments
+ */
+void VTraceKernels::addPixelMoments( const double* iX, const double* iY, const double* iSignal,
+                                     unsigned int j, bool iSquared, double* iMoments )
+{
+    const double xi = iX[j];
+    const double yi = iY[j];
+    double si = iSignal[j];
+    if( iSquared )
+    {
+        si *= si;
+    }
+    const double sixi = si * xi;
+    const double siyi = si * yi;
+    const double sixi2 = sixi * xi;
+    const double siyi2 = siyi * yi;
+    iMoments[0] += si;
+    iMoments[1] += sixi;
+    iMoments[2] += siyi;
+    iMoments[3] += sixi2;
+    iMoments[4] += siyi2;
+    iMoments[5] += sixi * yi;
+    iMoments[6] += sixi2 * xi;
+    iMoments[7] += siyi2 * yi;
+    iMoments[8] += sixi2 * yi;
+    iMoments[9] += siyi2 * xi;
+}
+
+/*
+ * image moments: four partial sums (same order of additions as the AVX2 kernel)
+ */
+void VTraceKernels::imageMoments_scalar( const double* iX, const double* iY, const double* iSignal, const unsigned char* iMask,
+        unsigned int iN, bool iSquared, double* iMoments )
+{
+    double i_sum[4][10];
+    for( unsigned int l = 0; l < 4; l++ )
+    {
+        for( unsigned int m = 0; m < 10; m++ )
+        {
+            i_sum[l][m] = 0.;
+        }
+    }
+    const unsigned int iN4 = iN - iN % 4;
+    unsigned int j = 0;
+    for( ; j < iN4; j++ )
+    {
+        if( iMask[j] )
+        {
+            addPixelMoments( iX, iY, iSignal, j, iSquared, i_sum[j % 4] );
+        }
+    }
+    for( unsigned int m = 0; m < 10; m++ )
+    {
+        iMoments[m] = ( i_sum[0][m] + i_sum[1][m] ) + ( i_sum[2][m] + i_sum[3][m] );
+    }
+    // remaining pixels
+    for( ; j < iN; j++ )
+    {
+        if( iMask[j] )
+        {
+            addPixelMoments( iX, iY, iSignal, j, iSquared, iMoments );
+        }
+    }
+}
+
+#if defined( __x86_64__ ) || defined( __i386__ )
+
+//////////////////////////////////////////////////////////////////////////////
+// SSE2 kernels (2 channels per register)
+
+void VTraceKernels::fixedWindowSums_sse2( const double* iTrace, unsigned int iStride, unsigned int iNChannels,
+        unsigned int iFirst, unsigned int iLast, const double* iPed, bool iRaw,
+        double* iSum, double* iTCharge )
+{
+    const __m128d i_zero = _mm_setzero_pd();
+    unsigned int c = 0;
+    for( ; c + 2 <= iNChannels; c += 2 )
+    {
+        __m128d sum = _mm_setzero_pd();
+        __m128d tcharge = _mm_setzero_pd();
+        __m128d ped = i_zero;
+        if( !iRaw )
+        {
+            ped = _mm_loadu_pd( iPed + c );
+        }
+        for( unsigned int i = iFirst; i < iLast; i++ )
+        {
+            __m128d t = _mm_loadu_pd( iTrace + i * iStride + c );
+            __m128d mask = _mm_cmpgt_pd( t, i_zero );
+            __m128d d = t;
+            if( !iRaw )
+            {
+                d = _mm_sub_pd( t, ped );
+            }
+            sum = _mm_add_pd( sum, _mm_and_pd( mask, d ) );
+            tcharge = _mm_add_pd( tcharge, _mm_and_pd( mask, _mm_mul_pd( _mm_set1_pd( i + 0.5 ), d ) ) );
+        }
+        _mm_storeu_pd( iSum + c, sum );
+        _mm_storeu_pd( iTCharge + c, tcharge );
+    }
+    fixedWindowSums_scalar( iTrace, iStride, c, iNChannels, iFirst, iLast, iPed, iRaw, iSum, iTCharge );
+}
+
+void VTraceKernels::traceMax_sse2( const double* iTrace, unsigned int iStride, unsigned int iNChannels,
+                                   unsigned int iFirst, unsigned int iLast, double* iMax, unsigned int* iMaxPos )
+{
+    double i_pos[2];
+    unsigned int c = 0;
+    for( ; c + 2 <= iNChannels; c += 2 )
+    {
+        __m128d tmax = _mm_set1_pd( -10000. );
+        __m128d maxpos = _mm_set1_pd( 99999. );
+        for( unsigned int i = iFirst; i < iLast; i++ )
+        {
+            __m128d t = _mm_loadu_pd( iTrace + i * iStride + c );
+            __m128d mask = _mm_cmpgt_pd( t, tmax );
+            tmax = _mm_or_pd( _mm_and_pd( mask, t ), _mm_andnot_pd( mask, tmax ) );
+            maxpos = _mm_or_pd( _mm_and_pd( mask, _mm_set1_pd( ( double )i ) ), _mm_andnot_pd( mask, maxpos ) );
+        }
+        _mm_storeu_pd( iMax + c, tmax );
+        _mm_storeu_pd( i_pos, maxpos );
+        iMaxPos[c] = ( unsigned int )i_pos[0];
+        iMaxPos[c + 1] = ( unsigned int )i_pos[1];
+    }
+    traceMax_scalar( iTrace, iStride, c, iNChannels, iFirst, iLast, iMax, iMaxPos );
+}
+
+//////////////////////////////////////////////////////////////////////////////
+// AVX2 kernels (4 channels per register)
+
+__attribute__( ( target( "avx2" ) ) )
+void VTraceKernels::fixedWindowSums_avx2( const double* iTrace, unsigned int iStride, unsigned int iNChannels,
+        unsigned int iFirst, unsigned int iLast, const double* iPed, bool iRaw,
+        double* iSum, double* iTCharge )
+{
+    const __m256d i_zero = _mm256_setzero_pd();
+    unsigned int c = 0;
+    for( ; c + 4 <= iNChannels; c += 4 )
+    {
+        __m256d sum = _mm256_setzero_pd();
+        __m256d tcharge = _mm256_setzero_pd();
+        __m256d ped = i_zero;
+        if( !iRaw )
+        {
+            ped = _mm256_loadu_pd( iPed + c );
+        }
+        for( unsigned int i = iFirst; i < iLast; i++ )
+        {
+            __m256d t = _mm256_loadu_pd( iTrace + i * iStride + c );
+            __m256d mask = _mm256_cmp_pd( t, i_zero, _CMP_GT_OQ );
+            __m256d d = t;
+            if( !iRaw )
+            {
+                d = _mm256_sub_pd( t, ped );
+            }
+            sum = _mm256_add_pd( sum, _mm256_and_pd( mask, d ) );
+            tcharge = _mm256_add_pd( tcharge, _mm256_and_pd( mask, _mm256_mul_pd( _mm256_set1_pd( i + 0.5 ), d ) ) );
+        }
+        _mm256_storeu_pd( iSum + c, sum );
+        _mm256_storeu_pd( iTCharge + c, tcharge );
+    }
+    fixedWindowSums_scalar( iTrace, iStride, c, iNChannels, iFirst, iLast, iPed, iRaw, iSum, iTCharge );
+}
+
+__attribute__( ( target( "avx2" ) ) )
+void VTraceKernels::traceMax_avx2( const double* iTrace, unsigned int iStride, unsigned int iNChannels,
+                                   unsigned int iFirst, unsigned int iLast, double* iMax, unsigned int* iMaxPos )
+{
+    double i_pos[4];
+    unsigned int c = 0;
+    for( ; c + 4 <= iNChannels; c += 4 )
+    {
+        __m256d tmax = _mm256_set1_pd( -10000. );
+        __m256d maxpos = _mm256_set1_pd( 99999. );
+        for( unsigned int i = iFirst; i < iLast; i++ )
+        {
+            __m256d t = _mm256_loadu_pd( iTrace + i * iStride + c );
+            __m256d mask = _mm256_cmp_pd( t, tmax, _CMP_GT_OQ );
+            tmax = _mm256_blendv_pd( tmax, t, mask );
+            maxpos = _mm256_blendv_pd( maxpos, _mm256_set1_pd( ( double )i ), mask );
+        }
+        _mm256_storeu_pd( iMax + c, tmax );
+        _mm256_storeu_pd( i_pos, maxpos );
+        for( unsigned int j = 0; j < 4; j++ )
+        {
+            iMaxPos[c + j] = ( unsigned int )i_pos[j];
+        }
+    }
+    traceMax_scalar( iTrace, iStride, c, iNChannels, iFirst, iLast, iMax, iMaxPos );
+}
+
+/*
+ * image moments (4 pixels per register; masked pixels contribute zero)
+ */
+__attribute__( ( target( "avx2" ) ) )
+void VTraceKernels::imageMoments_avx2( const double* iX, const double* iY, const double* iSignal, const unsigned char* iMask,
+        unsigned int iN, bool iSquared, double* iMoments )
+{
+    __m256d i_sum[10];
+    for( unsigned int m = 0; m < 10; m++ )
+    {
+        i_sum[m] = _mm256_setzero_pd();
+    }
+    const __m256d i_zero = _mm256_setzero_pd();
+    unsigned int j = 0;
+    for( ; j + 4 <= iN; j += 4 )
+    {
+        int32_t i_mask4 = 0;
+        memcpy( &i_mask4, iMask + j, 4 );
+        if( i_mask4 == 0 )
+        {
+            continue;
+        }
+        __m256d mask = _mm256_cmp_pd( _mm256_cvtepi32_pd( _mm_cvtepu8_epi32( _mm_cvtsi32_si128( i_mask4 ) ) ), i_zero, _CMP_NEQ_OQ );
+        __m256d si = _mm256_loadu_pd( iSignal + j );
+        if( iSquared )
+        {
+            si = _mm256_mul_pd( si, si );
+        }
+        si = _mm256_and_pd( mask, si );
+        __m256d xi = _mm256_loadu_pd( iX + j );
+        __m256d yi = _mm256_loadu_pd( iY + j );
+        __m256d sixi = _mm256_mul_pd( si, xi );
+        __m256d siyi = _mm256_mul_pd( si, yi );
+        __m256d sixi2 = _mm256_mul_pd( sixi, xi );
+        __m256d siyi2 = _mm256_mul_pd( siyi, yi );
+        i_sum[0] = _mm256_add_pd( i_sum[0], si );
+        i_sum[1] = _mm256_add_pd( i_sum[1], sixi );
+        i_sum[2] = _mm256_add_pd( i_sum[2], siyi );
+        i_sum[3] = _mm256_add_pd( i_sum[3], sixi2 );
+        i_sum[4] = _mm256_add_pd( i_sum[4], siyi2 );
+        i_sum[5] = _mm256_add_pd( i_sum[5], _mm256_mul_pd( sixi, yi ) );
+        i_sum[6] = _mm256_add_pd( i_sum[6], _mm256_mul_pd( sixi2, xi ) );
+        i_sum[7] = _mm256_add_pd( i_sum[7], _mm256_mul_pd( siyi2, yi ) );
+        i_sum[8] = _mm256_add_pd( i_sum[8], _mm256_mul_pd( sixi2, yi ) );
+        i_sum[9] = _mm256_add_pd( i_sum[9], _mm256_mul_pd( siyi2, xi ) );
+    }
+    double i_lane[4];
+    for( unsigned int m = 0; m < 10; m++ )
+    {
+        _mm256_storeu_pd( i_lane, i_sum[m] );
+        iMoments[m] = ( i_lane[0] + i_lane[1] ) + ( i_lane[2] + i_lane[3] );
+    }
+    // remaining pixels
+    for( ; j < iN; j++ )
+    {
+        if( iMask[j] )
+        {
+            addPixelMoments( iX, iY, iSignal, j, iSquared, iMoments );
+        }
+    }
+}
+
+#endif
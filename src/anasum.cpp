@@ -7,12 +7,19 @@
 #include "VGlobalRunParameter.h"
 
 #include <getopt.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include <cstdio>
 #include <iostream>
+#include <map>
 #include <string>
 
 using namespace std;
 
-int parseOptions( int argc, char* argv[] );
+int  parseOptions( int argc, char* argv[] );
+void doParallelAnalysis();
+int  getRunRandomSeed( int iRunOn );
 
 //////////////////////////////////////////////////////////////////////////////////////////////////////////
 // parameters read in from command line
@@ -32,6 +39,8 @@ string datadir = "";
 string fRunParameterfile = "ANASUM.runparameter";
 // for usage of random generators: see VStereoMaps.cpp
 int fRandomSeed = 17;
+// number of runs analysed in parallel (run type 0 only)
+unsigned int fNParallel = 1;
 //////////////////////////////////////////////////////////////////////////////////////////////////////////
 
 /*
@@ -86,6 +95,14 @@ int main( int argc, char* argv[] )
         exit( EXIT_FAILURE );
     }
     
+    // parallel analysis of all runs, followed by combined analysis
+    if( runType == 0 && fNParallel > 1 )
+    {
+        doParallelAnalysis();
+        cout << endl << "analysis results written to " << outfile << endl;
+        return 0;
+    }
+    
     // initialize analysis
     VAnaSum* anasum = new VAnaSum( datadir );
     anasum->initialize( listfilename, runType, outfile, fRandomSeed, fRunParameterfile );
@@ -102,6 +119,160 @@ int main( int argc, char* argv[] )
     return 0;
 }
 
+/*
+ * analyse runs in parallel
+ *
+ * each run of the run list is analysed in a separate worker process
+ * (own VAnaSum, VStereoAnalysis, VStereoMaps and VGammaHadronCuts instances)
+ * and written to its own anasum file <run>.anasum.root in the directory
+ * <outfile>.runs (log files: <run>.anasum.log).
+ * Run-wise results are then combined in run list order as in run type 1.
+ *
+ * Runs are identified by run number (as in run type 1); run lists with
+ * duplicate runs are therefore rejected.
+ *
+ * Each worker uses its own random seed (see getRunRandomSeed()). The serial
+ * analysis uses one random generator for all runs, therefore the results
+ * of randomised steps (e.g. the acceptance integration or the removal of
+ * off regions in VStereoMaps) differ between serial and parallel analysis.
+ *
+ */
+void doParallelAnalysis()
+{
+    // read list of runs (run numbers only)
+    VAnaSumRunParameter iRunPara;
+    unsigned int iNRuns = ( unsigned int )iRunPara.loadLongFileList( listfilename, true );
+    if( iNRuns == 0 || iNRuns != iRunPara.fRunList.size() )
+    {
+        cout << "error: no runs found in run list " << listfilename << endl;
+        exit( EXIT_FAILURE );
+    }
+    for( unsigned int i = 0; i < iNRuns; i++ )
+    {
+        for( unsigned int j = i + 1; j < iNRuns; j++ )
+        {
+            if( iRunPara.fRunList[i].fRunOn == iRunPara.fRunList[j].fRunOn )
+            {
+                cout << "error: run " << iRunPara.fRunList[i].fRunOn << " appears more than once in run list " << listfilename << endl;
+                cout << "(not allowed for parallel analysis)" << endl;
+                exit( EXIT_FAILURE );
+            }
+        }
+    }
+    string iRunDir = outfile + ".runs";
+    gSystem->mkdir( iRunDir.c_str(), true );
+    if( gSystem->AccessPathName( iRunDir.c_str() ) )
+    {
+        cout << "error: cannot create directory for run-wise results: " << iRunDir << endl;
+        exit( EXIT_FAILURE );
+    }
+    cout << "analysing " << iNRuns << " runs with " << fNParallel << " parallel processes" << endl;
+    cout << "(run-wise results and log files in " << iRunDir << ")" << endl;
+    
+    map< pid_t, unsigned int > iWorker;
+    unsigned int iNextRun = 0;
+    bool bFailed = false;
+    while( iWorker.size() > 0 || ( !bFailed && iNextRun < iNRuns ) )
+    {
+        // start new workers
+        while( !bFailed && iNextRun < iNRuns && iWorker.size() < fNParallel )
+        {
+            int iRunOn = iRunPara.fRunList[iNextRun].fRunOn;
+            cout.flush();
+            pid_t iPID = fork();
+            if( iPID < 0 )
+            {
+                cout << "error: failed to start analysis process for run " << iRunOn << endl;
+                bFailed = true;
+                break;
+            }
+            // worker process: analyse a single run
+            if( iPID == 0 )
+            {
+                char i_temp[2000];
+                sprintf( i_temp, "%s/%d.anasum.log", iRunDir.c_str(), iRunOn );
+                if( !freopen( i_temp, "w", stdout ) )
+                {
+                    exit( EXIT_FAILURE );
+                }
+                sprintf( i_temp, "%s/%d.anasum.root", iRunDir.c_str(), iRunOn );
+                VAnaSum* anasum = new VAnaSum( datadir );
+                anasum->initialize( listfilename, 0, i_temp, getRunRandomSeed( iRunOn ), fRunParameterfile, iNextRun );
+                anasum->doStereoAnalysis();
+                anasum->terminate();
+                cout.flush();
+                exit( EXIT_SUCCESS );
+            }
+            cout << "\t starting analysis of run " << iRunOn << " (" << iNextRun + 1 << " out of " << iNRuns << " runs)" << endl;
+            iWorker[iPID] = iNextRun;
+            iNextRun++;
+        }
+        if( iWorker.size() == 0 )
+        {
+            break;
+        }
+        // wait for any worker to finish
+        int iStatus = 0;
+        pid_t iPID = waitpid( -1, &iStatus, 0 );
+        if( iPID < 0 )
+        {
+            cout << "error: waiting for analysis processes failed" << endl;
+            exit( EXIT_FAILURE );
+        }
+        if( iWorker.find( iPID ) == iWorker.end() )
+        {
+            continue;
+        }
+        int iRunOn = iRunPara.fRunList[iWorker[iPID]].fRunOn;
+        if( !WIFEXITED( iStatus ) || WEXITSTATUS( iStatus ) != EXIT_SUCCESS )
+        {
+            cout << "error: analysis of run " << iRunOn << " failed (see " << iRunDir << "/" << iRunOn << ".anasum.log)" << endl;
+            bFailed = true;
+        }
+        else
+        {
+            cout << "\t finished analysis of run " << iRunOn << endl;
+        }
+        iWorker.erase( iPID );
+    }
+    if( bFailed )
+    {
+        cout << "exiting..." << endl;
+        exit( EXIT_FAILURE );
+    }
+    
+    // combined analysis of all runs (in order of the run list)
+    cout << endl;
+    VAnaSum* anasum = new VAnaSum( iRunDir );
+    anasum->initialize( listfilename, 1, outfile, fRandomSeed, fRunParameterfile );
+    cout << endl;
+    anasum->doStereoAnalysis();
+    anasum->terminate();
+}
+
+/*
+ * random seed for the analysis of a single run in parallel mode
+ *
+ * seed = fRandomSeed + run number, i.e. independent of the position of
+ * the run in the run list and of the number of parallel processes.
+ * A seed of 0 (TRandom3: seed from the machine clock) is kept.
+ *
+ */
+int getRunRandomSeed( int iRunOn )
+{
+    if( fRandomSeed == 0 )
+    {
+        return 0;
+    }
+    int iSeed = fRandomSeed + iRunOn;
+    // avoid accidental seed 0
+    if( iSeed == 0 )
+    {
+        iSeed = 1;
+    }
+    return iSeed;
+}
+
 /*
  * read command line options
  */
@@ -118,10 +289,11 @@ int parseOptions( int argc, char* argv[] )
             {"randomseed", required_argument, 0, 'r'},
             {"runType", required_argument, 0, 'i'},
             {"parameterfile",  required_argument, 0, 'f'},
+            {"parallel", required_argument, 0, 'p'},
             {0, 0, 0, 0}
         };
         int option_index = 0;
-        int c = getopt_long( argc, argv, "h:l:k:m:o:d:s:r:i:u:f:g", long_options, &option_index );
+        int c = getopt_long( argc, argv, "h:l:k:m:o:d:s:r:i:u:f:p:g", long_options, &option_index );
         if( optopt != 0 )
         {
             cout << "error: unknown option" << endl;
@@ -182,6 +354,12 @@ int parseOptions( int argc, char* argv[] )
             case 'f':
                 fRunParameterfile = optarg;
                 break;
+            case 'p':
+                if( atoi( optarg ) > 0 )
+                {
+                    fNParallel = ( unsigned int )atoi( optarg );
+                }
+                break;
             case '?':
                 break;
             default:
@@ -15,6 +15,7 @@
 
 #include "VGlobalRunParameter.h"
 #include "VHistogramUtilities.h"
+#include "VTableCalculator.h"
 
 #include <fstream>
 #include <iostream>
@@ -40,6 +41,50 @@ void copyDirectory( TDirectory* source, const char* hx = 0, unsigned int i_noise
 // flag if woff_0500 should be copied
 bool fCopy_woff_0500 = false;
 
+// quantile sketches (needed for merging of tables filled in independent jobs)
+// are written to a temporary file, unless they should be kept in the combined file
+bool fKeepSketches = false;
+TFile* fSketchFile = 0;
+
+/*
+ * directory for quantile sketches of the tables in directory adir of the combined file
+ * (same directory structure in the temporary sketch file)
+ */
+TDirectory* getSketchDirectory( TDirectory* adir )
+{
+    if( fKeepSketches || !fSketchFile || !adir )
+    {
+        return adir;
+    }
+    string iPath = adir->GetPath();
+    if( iPath.find( ":/" ) != string::npos )
+    {
+        iPath = iPath.substr( iPath.find( ":/" ) + 2 );
+    }
+    TDirectory* iDir = fSketchFile;
+    while( iPath.size() > 0 )
+    {
+        string iName = iPath.substr( 0, iPath.find( "/" ) );
+        iPath = ( iPath.find( "/" ) != string::npos ? iPath.substr( iPath.find( "/" ) + 1 ) : "" );
+        if( iName.size() == 0 )
+        {
+            continue;
+        }
+        TDirectory* iSubDir = iDir->GetDirectory( iName.c_str() );
+        if( !iSubDir )
+        {
+            iSubDir = iDir->mkdir( iName.c_str() );
+        }
+        if( !iSubDir )
+        {
+            cout << "error while creating directory " << iName << " in " << fSketchFile->GetName() << endl;
+            exit( EXIT_FAILURE );
+        }
+        iDir = iSubDir;
+    }
+    return iDir;
+}
+
 /*
  * extract noise from file name
  * (is only a second order correction and depends of course on the
@@ -147,6 +192,86 @@ string check_for_similar_noise_values( string iTelescopeType, const char* hx, un
     
 }
 
+/*
+ * merge a lookup table filled in independent jobs
+ *
+ * quantile sketches of the table already in the combined file
+ * and of the new table (iSketchNew) are merged; all table histograms
+ * (median, sigma, mpv, mean, nevents) are recalculated from the merged sketches
+ *
+ */
+bool mergeLookupTable( TDirectory* adir, TTree* iSketchNew )
+{
+    if( !adir || !iSketchNew )
+    {
+        return false;
+    }
+    // table variable and histogram name suffix (<variable>_sketch_<suffix>)
+    string iName = iSketchNew->GetName();
+    size_t iPos = iName.find( "_sketch_" );
+    if( iPos == string::npos )
+    {
+        return false;
+    }
+    string iVariable = iName.substr( 0, iPos );
+    string iSuffix = iName.substr( iPos + 8 );
+    
+    // table type and settings used for filling
+    bool iEnergy = false;
+    bool iPE = false;
+    float iMinShowerPerBin = 10.;
+    float iCompression = 100.;
+    iSketchNew->SetBranchAddress( "energy", &iEnergy );
+    iSketchNew->SetBranchAddress( "pe", &iPE );
+    iSketchNew->SetBranchAddress( "minshowerperbin", &iMinShowerPerBin );
+    iSketchNew->SetBranchAddress( "compression", &iCompression );
+    iSketchNew->GetEntry( 0 );
+    iSketchNew->ResetBranchAddresses();
+    
+    // keep sketches and title of the existing table in memory
+    char hname[1000];
+    char htitle[1000];
+    bool bTitle = false;
+    sprintf( hname, "%s_median_%s", iVariable.c_str(), iSuffix.c_str() );
+    TH2F* hOld = ( TH2F* )adir->Get( hname );
+    if( hOld )
+    {
+        sprintf( htitle, "%s", hOld->GetTitle() );
+        bTitle = true;
+    }
+    TDirectory* iSketchDir = getSketchDirectory( adir );
+    TTree* iSketchOld = ( TTree* )iSketchDir->Get( iName.c_str() );
+    if( !iSketchOld )
+    {
+        return false;
+    }
+    gROOT->cd();
+    TTree* iSketchOldCopy = iSketchOld->CloneTree();
+    
+    // remove tables of previous files
+    const char* iTableTypes[] = { "median", "sigma", "mpv", "mean", "nevents" };
+    for( unsigned int i = 0; i < 5; i++ )
+    {
+        sprintf( hname, "%s_%s_%s;*", iVariable.c_str(), iTableTypes[i], iSuffix.c_str() );
+        adir->Delete( hname );
+    }
+    sprintf( hname, "%s;*", iName.c_str() );
+    iSketchDir->Delete( hname );
+    
+    cout << "\t merging " << iVariable << " tables in " << adir->GetPath() << endl;
+    VTableCalculator iTable( iVariable, iSuffix, true, adir, iEnergy, iPE );
+    iTable.setWrite1DHistograms( false );
+    iTable.setMinRequiredShowerPerBin( iMinShowerPerBin );
+    iTable.setQuantileSketchCompression( iCompression );
+    iTable.setQuantileSketchDirectory( iSketchDir );
+    iTable.readQuantileSketches( iSketchOldCopy );
+    iTable.readQuantileSketches( iSketchNew );
+    delete iSketchOldCopy;
+    iTable.terminate( adir, ( bTitle ? htitle : 0 ) );
+    
+    return true;
+}
+
 /*
  * read a list of lookup tables files
  *
@@ -204,15 +329,26 @@ int main( int argc, char* argv[] )
     if( argc < 2 )
     {
         cout << "combine several tables from different files into one single table file" << endl << endl;
-        cout << "combineLookupTables <file with list of tables> <output file name> [do not copy woff_0500 directory (default = 0 = false)] " << endl;
+        cout << "combineLookupTables <file with list of tables> <output file name> [do not copy woff_0500 directory (default = 0 = false)] [-keepSketches]" << endl;
+        cout << endl;
+        cout << "   -keepSketches: keep quantile sketches in the combined file" << endl;
+        cout << "                  (required if the combined file is merged again with other tables)" << endl;
         cout << endl;
         exit( EXIT_SUCCESS );
     }
     string fListOfFiles = argv[1];
     string fOFile       = argv[2];
-    if( argc > 3 )
+    for( int i = 3; i < argc; i++ )
     {
-        fCopy_woff_0500 = ( bool )( atoi( argv[3] ) );
+        string iArg = argv[i];
+        if( iArg == "-keepSketches" )
+        {
+            fKeepSketches = true;
+        }
+        else
+        {
+            fCopy_woff_0500 = ( bool )( atoi( argv[i] ) );
+        }
     }
     
     /////////////////////////////////////
@@ -235,6 +371,17 @@ int main( int argc, char* argv[] )
         cout << "error while opening combined file: " << fOFile << endl;
         exit( EXIT_FAILURE );
     }
+    // temporary file for quantile sketches
+    string fSketchFileName = fOFile + ".sketches.root";
+    if( !fKeepSketches )
+    {
+        fSketchFile = new TFile( fSketchFileName.c_str(), "RECREATE" );
+        if( fSketchFile->IsZombie() )
+        {
+            cout << "error while opening temporary file for quantile sketches: " << fSketchFileName << endl;
+            exit( EXIT_FAILURE );
+        }
+    }
     
     //////////////////////////////////////////////////////////////////
     // loop over all lookup tables and copy them into the main file
@@ -283,6 +430,11 @@ int main( int argc, char* argv[] )
     }
     
     fROFile->Close();
+    if( fSketchFile )
+    {
+        fSketchFile->Close();
+        gSystem->Unlink( fSketchFileName.c_str() );
+    }
     cout << endl;
     cout << "finished..." << endl;
 }
@@ -340,8 +492,20 @@ void copyDirectory( TDirectory* source, const char* hx, unsigned int noise_from_
         }
     }
     adir->cd();
-    //loop on all entries of this directory
+    // tables filled in independent jobs: merge quantile sketches
+    // (table histograms are recalculated from the merged sketches)
+    bool bMergeTables = false;
     TKey* key;
+    TIter nextsketch( source->GetListOfKeys() );
+    while( ( key = ( TKey* )nextsketch() ) )
+    {
+        string iName = key->GetName();
+        if( iName.find( "_sketch_" ) != string::npos && getSketchDirectory( adir )->GetKey( key->GetName() ) )
+        {
+            bMergeTables = true;
+        }
+    }
+    //loop on all entries of this directory
     TIter nextkey( source->GetListOfKeys() );
     while( ( key = ( TKey* )nextkey() ) )
     {
@@ -371,6 +535,17 @@ void copyDirectory( TDirectory* source, const char* hx, unsigned int noise_from_
             copyDirectory( subdir, 0, noise_from_filename );
             adir->cd();
         }
+        else if( bMergeTables )
+        {
+            string iName = key->GetName();
+            if( iName.find( "_sketch_" ) != string::npos )
+            {
+                source->cd();
+                TTree* iSketch = ( TTree* )key->ReadObj();
+                mergeLookupTable( adir, iSketch );
+                delete iSketch;
+            }
+        }
         else
         {
             source->cd();
@@ -380,8 +555,16 @@ void copyDirectory( TDirectory* source, const char* hx, unsigned int noise_from_
             {
                 cout << gDirectory->GetPath() << endl;
             }
+            // quantile sketches (needed for merging of tables)
+            if( iName.find( "_sketch_" ) != string::npos && obj->InheritsFrom( "TTree" ) )
+            {
+                getSketchDirectory( adir )->cd();
+                TTree* iSketch = ( ( TTree* )obj )->CloneTree();
+                iSketch->Write();
+                delete iSketch;
+            }
             // copy only median and mpv histogram
-            if( iName.find( "median" ) != string::npos
+            else if( iName.find( "median" ) != string::npos
                     || iName.find( "Median" ) != string::npos
                     || iName.find( "mpv" ) != string::npos
                     || iName.find( "mean" ) != string::npos
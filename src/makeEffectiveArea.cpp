@@ -193,6 +193,8 @@ int main( int argc, char* argv[] )
         fRunPara->fGammaHadronCutSelector = fCuts.back()->getGammaHadronCutSelector();
         fRunPara->fDirectionCutSelector   = fCuts.back()->getDirectionCutSelector();
         fCuts.back()->initializeCuts( -1, fRunPara->fGammaHadronProbabilityFile );
+        // events are evaluated repeatedly (resolution IRFs and effective areas)
+        fCuts.back()->setTMVAResultCaching( true );
         fCuts.back()->printCutSummary();
     }
 
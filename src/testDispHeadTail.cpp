@@ -0,0 +1,176 @@
+/*! \file testDispHeadTail.cpp
+ *  \brief test disp head/tail sign search
+ *
+ *  compares the head/tail signs found by VDispAnalyzer::find_smallest_diff_signs()
+ *  with a test of all 2^N sign combinations (as before the branch-and-bound search)
+ *  for 2 to 8 images:
+ *
+ *  - random image positions, orientations, disp values and weights (incl. negative weights)
+ *  - zero weights (single images and all images)
+ *  - ties: images with disp = 0, all images at the same position (mirror-symmetric
+ *    combinations), positions and directions on a coarse grid (equal distances)
+ *
+ *  sign vectors must be identical (including the resolution of ties)
+ *
+ */
+
+#include <iostream>
+#include <stdio.h>
+#include <stdlib.h>
+#include <vector>
+
+#include "TMath.h"
+#include "TRandom3.h"
+
+#include "VDispAnalyzer.h"
+
+using namespace std;
+
+/*
+ * access to private methods of VDispAnalyzer (friend class)
+ */
+class VDispAnalyzerTest
+{
+    public:
+        static vector< float > findSigns( VDispAnalyzer* iDisp,
+                                          const vector< float >& x, const vector< float >& y,
+                                          const vector< float >& cosphi, const vector< float >& sinphi,
+                                          const vector< float >& v_disp, const vector< float >& v_weight )
+        {
+            return iDisp->find_smallest_diff_signs( x, y, cosphi, sinphi, v_disp, v_weight );
+        }
+    
+        /*
+         * test of all sign combinations
+         * (bit n of combination s set for sign -1 of image n; first combination
+         *  with the smallest dispersion)
+         */
+        static vector< float > findSignsAllCombinations( VDispAnalyzer* iDisp,
+                const vector< float >& x, const vector< float >& y,
+                const vector< float >& cosphi, const vector< float >& sinphi,
+                const vector< float >& v_disp, const vector< float >& v_weight )
+        {
+            unsigned int N = x.size();
+            vector< float > v_xs( N, 0. );
+            vector< float > v_ys( N, 0. );
+            vector< float > i_sign( N, 1. );
+            vector< float > i_bestSign( N, 1. );
+            float xs = 0.;
+            float ys = 0.;
+            float disp_diff = 0.;
+            float i_smallest_diff = 1.e20;
+            for( unsigned int s = 0; s < ( 1u << N ); s++ )
+            {
+                for( unsigned int i = 0; i < N; i++ )
+                {
+                    i_sign[i] = ( ( s >> i ) & 1 ? -1. : 1. );
+                    v_xs[i] = x[i] - i_sign[i] * v_disp[i] * cosphi[i];
+                    v_ys[i] = y[i] - i_sign[i] * v_disp[i] * sinphi[i];
+                }
+                iDisp->calculateMeanShowerDirection( v_xs, v_ys, v_weight, xs, ys, disp_diff, N );
+                if( disp_diff < i_smallest_diff )
+                {
+                    i_smallest_diff = disp_diff;
+                    i_bestSign = i_sign;
+                }
+            }
+            return i_bestSign;
+        }
+};
+
+int main( int argc, char* argv[] )
+{
+    unsigned int iNTests = 2000;
+    if( argc > 1 )
+    {
+        iNTests = atoi( argv[1] );
+    }
+    if( argc > 2 || iNTests == 0 )
+    {
+        cout << "./testDispHeadTail [number of events per multiplicity and test type (default=2000)]" << endl;
+        exit( EXIT_FAILURE );
+    }
+    
+    // fixed seed: test failures must be reproducible
+    TRandom3 i_random( 42 );
+    VDispAnalyzer* i_disp = new VDispAnalyzer();
+    
+    const char* i_typeName[5] = { "random", "zero weights", "disp = 0", "same positions", "grid" };
+    
+    unsigned int i_nfailed = 0;
+    for( unsigned int N = 2; N <= 8; N++ )
+    {
+        vector< float > x( N, 0. );
+        vector< float > y( N, 0. );
+        vector< float > cosphi( N, 0. );
+        vector< float > sinphi( N, 0. );
+        vector< float > v_disp( N, 0. );
+        vector< float > v_weight( N, 0. );
+        for( unsigned int t = 0; t < 5; t++ )
+        {
+            unsigned int i_ndiff = 0;
+            for( unsigned int e = 0; e < iNTests; e++ )
+            {
+                for( unsigned int i = 0; i < N; i++ )
+                {
+                    double phi = i_random.Uniform( 0., 2. * TMath::Pi() );
+                    x[i] = i_random.Uniform( -2., 2. );
+                    y[i] = i_random.Uniform( -2., 2. );
+                    cosphi[i] = cos( phi );
+                    sinphi[i] = sin( phi );
+                    v_disp[i] = i_random.Uniform( 0., 2. );
+                    v_weight[i] = i_random.Uniform( -0.2, 1. );
+                    // zero weights (all images for every 10th event)
+                    if( t == 1 && ( e % 10 == 0 || i_random.Uniform() < 0.3 ) )
+                    {
+                        v_weight[i] = 0.;
+                    }
+                    // disp = 0: both signs give the same direction
+                    if( t == 2 && i_random.Uniform() < 0.4 )
+                    {
+                        v_disp[i] = 0.;
+                    }
+                    // same positions: flipping all signs mirrors all directions
+                    if( t == 3 )
+                    {
+                        x[i] = 0.;
+                        y[i] = 0.;
+                    }
+                    // grid: equal distances between directions
+                    if( t == 4 )
+                    {
+                        int i_phi = ( int )i_random.Integer( 4 );
+                        x[i] = ( float )( ( int )i_random.Integer( 5 ) - 2 );
+                        y[i] = ( float )( ( int )i_random.Integer( 5 ) - 2 );
+                        cosphi[i] = ( i_phi == 0 ? 1. : ( i_phi == 2 ? -1. : 0. ) );
+                        sinphi[i] = ( i_phi == 1 ? 1. : ( i_phi == 3 ? -1. : 0. ) );
+                        v_disp[i] = ( float )i_random.Integer( 3 );
+                        v_weight[i] = ( float )( 1 + i_random.Integer( 2 ) );
+                    }
+                }
+                vector< float > i_sign = VDispAnalyzerTest::findSigns( i_disp, x, y, cosphi, sinphi, v_disp, v_weight );
+                vector< float > i_signAll = VDispAnalyzerTest::findSignsAllCombinations( i_disp, x, y, cosphi, sinphi, v_disp, v_weight );
+                if( i_sign != i_signAll )
+                {
+                    i_ndiff++;
+                }
+            }
+            cout << "\t " << N << " images, " << i_typeName[t] << ": differences " << i_ndiff;
+            cout << " (" << iNTests << " events)" << endl;
+            if( i_ndiff > 0 )
+            {
+                i_nfailed++;
+            }
+        }
+    }
+    delete i_disp;
+    
+    if( i_nfailed > 0 )
+    {
+        cout << endl << "error: head/tail signs differ from test of all sign combinations (" << i_nfailed << " tests)" << endl;
+        exit( EXIT_FAILURE );
+    }
+    cout << endl << "all head/tail signs identical" << endl;
+    
+    return 0;
+}
@@ -0,0 +1,156 @@
+/*! \file testImageAnalysisThreads.cpp
+ *  \brief compare image parameters of a serial and a threaded evndisp analysis
+ *
+ *  compares all leaves of the image parameter trees (Tel_<N>/tpars; including
+ *  the log likelihood fit results) and of the shower parameter tree entry by
+ *  entry for two evndisp output files of the same run, e.g.
+ *
+ *  evndisp -sourcefile 64080.cvbf -nthreads=1 -outputfile serial.root ...
+ *  evndisp -sourcefile 64080.cvbf -nthreads=8 -outputfile threads.root ...
+ *
+ *  ./testImageAnalysisThreads serial.root threads.root
+ *
+ *  (image parameters are expected to be identical)
+ *
+ */
+
+#include <iostream>
+#include <stdlib.h>
+#include <string>
+
+#include "TFile.h"
+#include "TLeaf.h"
+#include "TMath.h"
+#include "TObjArray.h"
+#include "TTree.h"
+
+using namespace std;
+
+bool isDifferent( double a, double b )
+{
+    if( TMath::IsNaN( a ) || TMath::IsNaN( b ) )
+    {
+        return !( TMath::IsNaN( a ) && TMath::IsNaN( b ) );
+    }
+    return ( a != b );
+}
+
+/*
+ * compare all leaves of two trees entry by entry
+ *
+ * (returns number of entries with differences; -1 if trees cannot be compared)
+ */
+int compareTrees( TTree* t1, TTree* t2, string iName )
+{
+    if( !t1 && !t2 )
+    {
+        return 0;
+    }
+    if( !t1 || !t2 )
+    {
+        cout << "\t " << iName << ": tree missing in one of the files" << endl;
+        return -1;
+    }
+    if( t1->GetEntries() != t2->GetEntries() )
+    {
+        cout << "\t " << iName << ": different number of entries (" << t1->GetEntries() << ", " << t2->GetEntries() << ")" << endl;
+        return -1;
+    }
+    TObjArray* iLeaves = t1->GetListOfLeaves();
+    if( !iLeaves )
+    {
+        return 0;
+    }
+    int n = 0;
+    for( Long64_t i = 0; i < t1->GetEntries(); i++ )
+    {
+        t1->GetEntry( i );
+        t2->GetEntry( i );
+        bool bDiff = false;
+        for( int l = 0; l < iLeaves->GetEntriesFast(); l++ )
+        {
+            TLeaf* l1 = ( TLeaf* )iLeaves->At( l );
+            TLeaf* l2 = t2->GetLeaf( l1->GetName() );
+            if( !l2 || l1->GetLen() != l2->GetLen() )
+            {
+                bDiff = true;
+                break;
+            }
+            for( int j = 0; j < l1->GetLen(); j++ )
+            {
+                if( isDifferent( l1->GetValue( j ), l2->GetValue( j ) ) )
+                {
+                    if( n < 10 )
+                    {
+                        cout << "\t " << iName << ", entry " << i << ": " << l1->GetName() << "[" << j << "] ";
+                        cout << l1->GetValue( j ) << " " << l2->GetValue( j ) << endl;
+                    }
+                    bDiff = true;
+                }
+            }
+        }
+        if( bDiff )
+        {
+            n++;
+        }
+    }
+    return n;
+}
+
+int main( int argc, char* argv[] )
+{
+    if( argc != 3 )
+    {
+        cout << "./testImageAnalysisThreads <evndisp file (serial analysis)> <evndisp file (threaded analysis)>" << endl;
+        exit( EXIT_FAILURE );
+    }
+    TFile f1( argv[1] );
+    TFile f2( argv[2] );
+    if( f1.IsZombie() || f2.IsZombie() )
+    {
+        cout << "error opening evndisp files " << argv[1] << " " << argv[2] << endl;
+        exit( EXIT_FAILURE );
+    }
+    
+    unsigned int i_nfailed = 0;
+    unsigned int i_ntrees = 0;
+    // image parameter trees of all telescopes
+    for( unsigned int t = 1; t < 1000; t++ )
+    {
+        string iName = "Tel_" + to_string( t ) + "/tpars";
+        TTree* t1 = ( TTree* )f1.Get( iName.c_str() );
+        TTree* t2 = ( TTree* )f2.Get( iName.c_str() );
+        if( !t1 && !t2 )
+        {
+            continue;
+        }
+        int n = compareTrees( t1, t2, iName );
+        cout << iName << ": " << ( t1 ? t1->GetEntries() : 0 ) << " entries, differences " << n << endl;
+        if( n != 0 )
+        {
+            i_nfailed++;
+        }
+        i_ntrees++;
+    }
+    // shower parameters
+    int n = compareTrees( ( TTree* )f1.Get( "showerpars" ), ( TTree* )f2.Get( "showerpars" ), "showerpars" );
+    cout << "showerpars: differences " << n << endl;
+    if( n != 0 )
+    {
+        i_nfailed++;
+    }
+    
+    if( i_ntrees == 0 )
+    {
+        cout << endl << "error: no image parameter trees found" << endl;
+        exit( EXIT_FAILURE );
+    }
+    if( i_nfailed > 0 )
+    {
+        cout << endl << "error: serial and threaded image analysis differ (" << i_nfailed << " trees)" << endl;
+        exit( EXIT_FAILURE );
+    }
+    cout << endl << "all image parameters identical" << endl;
+    
+    return 0;
+}
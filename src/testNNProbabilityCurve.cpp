@@ -0,0 +1,130 @@
+/*! \file testNNProbabilityCurve.cpp
+ *  \brief test tabulated rate contour curves for NN image cleaning
+ *
+ *  fills tabulated rate contours (VNNProbabilityCurve; 2nn, 3nn, 4nn and
+ *  boundary curves) for IPR graphs with different point spacings and slopes
+ *  (including negative charges) and compares IPR rates and time differences
+ *  with the direct evaluation of the IPR graph and rate contour function
+ *  (see VImageCleaning::defineRateContourFunction())
+ *
+ *  asserts relative differences below 2e-3 (maximum) and 1e-5 (mean)
+ *
+ */
+
+#include <iostream>
+#include <stdlib.h>
+#include <string>
+
+#include "TGraph.h"
+#include "TMath.h"
+#include "TRandom3.h"
+
+#include "VNNProbabilityCurve.h"
+
+using namespace std;
+
+/*
+ * IPR rate from graph (limited to >= 100 Hz, 100 Hz above iChargeMax)
+ * (as in VImageCleaning::NNChargeAndTimeCut() before tabulation)
+ */
+double getIPR( TGraph* iIPR, double iCharge, double iChargeMax )
+{
+    double i_ipr = iIPR->Eval( iCharge, 0, "" );
+    if( i_ipr < 100. || iCharge > iChargeMax )
+    {
+        i_ipr = 100.;
+    }
+    return i_ipr;
+}
+
+int main( int argc, char* argv[] )
+{
+    if( argc > 1 )
+    {
+        cout << "./testNNProbabilityCurve" << endl;
+        exit( EXIT_FAILURE );
+    }
+    
+    const double i_rate = 1.e3;
+    const double i_combFactor = 1.2e4;
+    const double i_refIPR = 4.e5;
+    const double i_maxDiff_max = 2.e-3;
+    const double i_maxDiff_mean = 1.e-5;
+    
+    // fixed seed: test failures must be reproducible
+    TRandom3 i_random( 42 );
+    unsigned int i_nfailed = 0;
+    // IPR graphs: point spacing [p.e.] and slope of the exponential rate decrease [p.e.]
+    double i_spacing[3] = { 0.02, 0.05, 0.1 };
+    double i_slope[3] = { 0.3, 0.5, 1.0 };
+    for( unsigned int g = 0; g < 9; g++ )
+    {
+        double i_qmin = -1.5;
+        double i_qmax = 12.;
+        TGraph i_IPR;
+        for( double q = i_qmin; q <= i_qmax + 1.e-6; q += i_spacing[g % 3] )
+        {
+            i_IPR.SetPoint( i_IPR.GetN(), q, 5.e8 * TMath::Exp( -1. * ( q - i_qmin ) / i_slope[g / 3] ) );
+        }
+        
+        // 2nn, 3nn, 4nn and boundary curves
+        for( unsigned int c = 0; c < 4; c++ )
+        {
+            bool bBoundary = ( c == 3 );
+            float i_nfold = ( bBoundary ? 2. : 2. + c );
+            VNNProbabilityCurve i_curve;
+            if( !i_curve.fill( &i_IPR, i_qmax, i_nfold, bBoundary ) )
+            {
+                cout << "error filling curve " << c << " for IPR graph " << g << endl;
+                exit( EXIT_FAILURE );
+            }
+            if( bBoundary )
+            {
+                i_curve.setParameters( i_rate, i_combFactor, i_refIPR );
+            }
+            else
+            {
+                i_curve.setParameters( i_rate, i_combFactor );
+            }
+            
+            double i_diff_max = 0.;
+            double i_diff_mean = 0.;
+            unsigned int n = 200000;
+            for( unsigned int i = 0; i < n; i++ )
+            {
+                // charges below, inside and above the IPR graph range
+                float q = i_random.Uniform( i_qmin - 0.5, i_qmax + 1. );
+                double i_ipr = getIPR( &i_IPR, q, i_qmax );
+                double i_dT = 0.;
+                if( bBoundary )
+                {
+                    i_dT = 1.e9 * i_rate / ( i_combFactor * i_ipr * i_refIPR );
+                }
+                else
+                {
+                    i_dT = 1.e9 * TMath::Exp( 1. / ( i_nfold - 1. ) * TMath::Log( i_rate / ( i_combFactor * TMath::Power( i_ipr, i_nfold ) ) ) );
+                }
+                double i_d = TMath::Max( TMath::Abs( i_curve.getDeltaT( q ) / i_dT - 1. ),
+                                         TMath::Abs( i_curve.getIPR( q ) / i_ipr - 1. ) );
+                i_diff_max = TMath::Max( i_diff_max, i_d );
+                i_diff_mean += i_d / ( double )n;
+            }
+            cout << "\t IPR graph " << g << " (spacing " << i_spacing[g % 3] << " p.e., slope " << i_slope[g / 3] << " p.e.), ";
+            cout << ( bBoundary ? "boundary" : "nfold " ) << ( bBoundary ? "" : to_string( ( int )i_nfold ) );
+            cout << ": relative difference max " << i_diff_max << ", mean " << i_diff_mean << endl;
+            if( i_diff_max > i_maxDiff_max || i_diff_mean > i_maxDiff_mean )
+            {
+                i_nfailed++;
+            }
+        }
+    }
+    
+    if( i_nfailed > 0 )
+    {
+        cout << endl << "error: tabulated and direct rate contours differ (" << i_nfailed << " curves)" << endl;
+        exit( EXIT_FAILURE );
+    }
+    cout << endl << "all curves within tolerance" << endl;
+    
+    return 0;
+}
@@ -0,0 +1,197 @@
+/*! \file testRingKernel.cpp
+ *  \brief test ring background model alpha maps from ring kernels
+ *
+ *  calculates ring background model alpha maps (on and off, correlated and
+ *  uncorrelated maps, with and without exclusion regions)
+ *
+ *  - with random sampling (VStereoMaps::RM_getAlpha(), averaged over several
+ *    calculations with different random numbers)
+ *  - from ring kernels (VStereoMaps::RM_getAlpha_RingKernel())
+ *
+ *  and compares the alpha maps in all bins inside the fiducial area
+ *  (bins kept by VStereoMaps::cleanup()):
+ *
+ *  - relative difference of the sum of all bins
+ *  - RMS of the pulls (difference / standard error of the mean of the random sampling)
+ *
+ *  Without exclusion regions, the ring kernels are the expectation value of the
+ *  random sampling (differences are sampling noise only). With exclusion regions,
+ *  the ring kernels evaluate exclusions at bin centres; the tolerances are larger.
+ *  Uncorrelated on maps must be identical.
+ *
+ */
+
+#include <cmath>
+#include <iostream>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string>
+#include <vector>
+
+#include "TH2D.h"
+#include "TMath.h"
+
+#include "VAnaSumRunParameter.h"
+#include "VRadialAcceptance.h"
+#include "VStereoMaps.h"
+
+using namespace std;
+
+/*
+ * access to private methods of VStereoMaps (friend class)
+ */
+class VStereoMapsTest
+{
+    public:
+        static void setAcceptance( VStereoMaps* iMaps, VRadialAcceptance* iAcceptance )
+        {
+            iMaps->fAcceptance = iAcceptance;
+        }
+        static void getAlpha( VStereoMaps* iMaps, bool iIsOn, bool iRingKernel )
+        {
+            iMaps->setRingKernelIntegration( iRingKernel );
+            iMaps->RM_getAlpha( iIsOn );
+        }
+};
+
+int main( int argc, char* argv[] )
+{
+    unsigned int iNRandom = 20;
+    if( argc > 1 )
+    {
+        iNRandom = atoi( argv[1] );
+    }
+    if( argc > 2 || iNRandom < 2 )
+    {
+        cout << "./testRingKernel [number of alpha maps with random sampling (default=20)]" << endl;
+        exit( EXIT_FAILURE );
+    }
+    
+    VAnaSumRunParameterDataClass i_runlist;
+    i_runlist.fWobbleWestMod = 0.5;
+    i_runlist.fWobbleNorthMod = 0.3;
+    i_runlist.fmaxradius = 1.5;
+    i_runlist.fRM_RingRadius = 0.5;
+    i_runlist.fRM_RingWidth = 0.2;
+    // (radius of source region)^2
+    i_runlist.fSourceRadius = 0.01;
+    
+    const int nxy = 60;
+    const double xymax = 1.5;
+    
+    // tolerances: without / with exclusion regions
+    const double i_maxSumDiff[2] = { 3.e-3, 5.e-3 };
+    const double i_maxRMSPull[2] = { 1.3, 1.5 };
+    
+    unsigned int i_nfailed = 0;
+    // test 0: on, 1: off, 2: on (uncorrelated maps), 3: on (exclusion regions), 4: off (exclusion regions)
+    for( unsigned int t = 0; t < 5; t++ )
+    {
+        bool i_isOn = ( t == 0 || t == 2 || t == 3 );
+        bool i_uc = ( t == 2 );
+        unsigned int i_excl = ( t >= 3 ? 1 : 0 );
+        
+        char hname[200];
+        sprintf( hname, "hstereo_%u", t );
+        TH2D* h_stereo = new TH2D( hname, "", nxy, -xymax, xymax, nxy, -xymax, xymax );
+        sprintf( hname, "halpha_%u", t );
+        TH2D* h_alpha = new TH2D( hname, "", nxy, -xymax, xymax, nxy, -xymax, xymax );
+        
+        // acceptance 1; exclusion region around a source position and fiducial area
+        VRadialAcceptance* i_acceptance = new VRadialAcceptance( "IGNOREACCEPTANCE" );
+        if( i_excl )
+        {
+            i_acceptance->setSource( 0.3, 0.2, 0.25, 1.4 );
+        }
+        else
+        {
+            i_acceptance->setSource( 0., 0., 0., 5. );
+        }
+        // fixed seed: test failures must be reproducible
+        VStereoMaps* i_maps = new VStereoMaps( i_uc, 42 + t, false );
+        i_maps->setRunList( i_runlist );
+        i_maps->setHistograms( h_stereo, h_alpha, 0 );
+        VStereoMapsTest::setAcceptance( i_maps, i_acceptance );
+        
+        // random sampling: mean and variance per bin
+        vector< double > i_sum( nxy * nxy, 0. );
+        vector< double > i_sum2( nxy * nxy, 0. );
+        for( unsigned int r = 0; r < iNRandom; r++ )
+        {
+            VStereoMapsTest::getAlpha( i_maps, i_isOn, false );
+            for( int i = 0; i < nxy; i++ )
+            {
+                for( int j = 0; j < nxy; j++ )
+                {
+                    double a = h_alpha->GetBinContent( i + 1, j + 1 );
+                    i_sum[i + j * nxy] += a;
+                    i_sum2[i + j * nxy] += a * a;
+                }
+            }
+        }
+        // ring kernels
+        h_alpha->Reset();
+        VStereoMapsTest::getAlpha( i_maps, i_isOn, true );
+        
+        // compare bins inside the fiducial area
+        // (see VStereoMaps::cleanup(); north wobble offset is inverted in setRunList())
+        double w = h_alpha->GetXaxis()->GetBinWidth( 2 );
+        double i_sumKernel = 0.;
+        double i_sumRandom = 0.;
+        double i_sumPull2 = 0.;
+        unsigned int i_nbins = 0;
+        unsigned int i_ndiff = 0;
+        for( int i = 0; i < nxy; i++ )
+        {
+            double x = h_alpha->GetXaxis()->GetBinCenter( i + 1 ) + i_runlist.fWobbleWestMod;
+            for( int j = 0; j < nxy; j++ )
+            {
+                double y = h_alpha->GetYaxis()->GetBinCenter( j + 1 ) - i_runlist.fWobbleNorthMod;
+                if( x * x + y * y > ( i_runlist.fmaxradius - w ) * ( i_runlist.fmaxradius - w ) )
+                {
+                    continue;
+                }
+                double i_mean = i_sum[i + j * nxy] / ( double )iNRandom;
+                double i_var = ( i_sum2[i + j * nxy] / ( double )iNRandom - i_mean * i_mean ) * ( double )iNRandom / ( double )( iNRandom - 1 );
+                double i_kernel = h_alpha->GetBinContent( i + 1, j + 1 );
+                i_sumKernel += i_kernel;
+                i_sumRandom += i_mean;
+                i_nbins++;
+                if( i_var > 1.e-12 * i_mean * i_mean )
+                {
+                    i_sumPull2 += ( i_kernel - i_mean ) * ( i_kernel - i_mean ) / ( i_var / ( double )iNRandom );
+                }
+                else if( TMath::Abs( i_kernel - i_mean ) > 1.e-9 * ( TMath::Abs( i_kernel ) + TMath::Abs( i_mean ) ) + 1.e-12 )
+                {
+                    i_ndiff++;
+                }
+            }
+        }
+        double i_sumDiff = ( i_sumRandom > 0. ? i_sumKernel / i_sumRandom - 1. : 1. );
+        double i_rmsPull = ( i_nbins > 0 ? sqrt( i_sumPull2 / ( double )i_nbins ) : 0. );
+        
+        cout << "\t alpha map " << t << " (" << ( i_isOn ? "on" : "off" );
+        cout << ( i_uc ? ", uncorrelated" : "" ) << ( i_excl ? ", exclusion regions" : "" ) << ", " << i_nbins << " bins): ";
+        cout << "relative difference of sum " << i_sumDiff << ", RMS of pulls " << i_rmsPull;
+        cout << ", bins differing without sampling noise " << i_ndiff << endl;
+        if( i_nbins == 0 || TMath::Abs( i_sumDiff ) > i_maxSumDiff[i_excl]
+                || i_rmsPull > i_maxRMSPull[i_excl] || i_ndiff > 0 )
+        {
+            i_nfailed++;
+        }
+        
+        // (deletes acceptance)
+        delete i_maps;
+        delete h_stereo;
+        delete h_alpha;
+    }
+    
+    if( i_nfailed > 0 )
+    {
+        cout << endl << "error: alpha maps from ring kernels differ from random sampling (" << i_nfailed << " maps)" << endl;
+        exit( EXIT_FAILURE );
+    }
+    cout << endl << "all alpha maps within tolerance" << endl;
+    
+    return 0;
+}
@@ -0,0 +1,181 @@
+/*! \file testStereoMaps.cpp
+ *  \brief test correlated sky maps filled from event lists
+ *
+ *  fills random events (several smoothing radii, weights and area ratios;
+ *  events on bin edges and outside of the map) into correlated sky maps
+ *
+ *  - event by event (VStereoMaps::makeTwoDStereo_BoxSmooth())
+ *  - from the event lists (VStereoMaps::fillCorrelatedMaps())
+ *
+ *  and compares bin contents, bin errors, entries and statistics of the
+ *  stereo, alpha and area ratio histograms
+ *
+ */
+
+#include <iostream>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string>
+
+#include "TH1D.h"
+#include "TH2D.h"
+#include "TMath.h"
+#include "TRandom3.h"
+
+#include "VAnaSumRunParameter.h"
+#include "VStereoMaps.h"
+
+using namespace std;
+
+/*
+ * access to private methods of VStereoMaps (friend class)
+ */
+class VStereoMapsTest
+{
+    public:
+        static void fill( VStereoMaps* iMaps, double x, double y, double iWeight, double iThetaCutMax, double iAreaRatio )
+        {
+            iMaps->makeTwoDStereo_BoxSmooth( x, y, iWeight, iThetaCutMax, iAreaRatio );
+        }
+};
+
+bool isDifferent( double a, double b )
+{
+    return ( TMath::Abs( a - b ) > 1.e-9 * ( TMath::Abs( a ) + TMath::Abs( b ) ) + 1.e-12 );
+}
+
+/*
+ * compare contents, errors, entries and statistics of two histograms
+ *
+ * (returns number of differences)
+ */
+unsigned int compareHistograms( TH1* h1, TH1* h2 )
+{
+    unsigned int n = 0;
+    for( int i = 0; i < h1->GetNcells(); i++ )
+    {
+        if( isDifferent( h1->GetBinContent( i ), h2->GetBinContent( i ) )
+                || isDifferent( h1->GetBinError( i ), h2->GetBinError( i ) ) )
+        {
+            n++;
+        }
+    }
+    if( isDifferent( h1->GetEntries(), h2->GetEntries() ) )
+    {
+        n++;
+    }
+    double s1[TH1::kNstat];
+    double s2[TH1::kNstat];
+    h1->GetStats( s1 );
+    h2->GetStats( s2 );
+    for( int i = 0; i < TH1::kNstat; i++ )
+    {
+        if( isDifferent( s1[i], s2[i] ) )
+        {
+            n++;
+        }
+    }
+    return n;
+}
+
+int main( int argc, char* argv[] )
+{
+    unsigned int iNTests = 20;
+    if( argc > 1 )
+    {
+        iNTests = atoi( argv[1] );
+    }
+    if( argc > 2 || iNTests == 0 )
+    {
+        cout << "./testStereoMaps [number of test maps (default=20)]" << endl;
+        exit( EXIT_FAILURE );
+    }
+    
+    // fixed seed: test failures must be reproducible
+    TRandom3 i_random( 42 );
+    VAnaSumRunParameterDataClass i_runlist;
+    i_runlist.fWobbleWestMod = 0.5;
+    i_runlist.fWobbleNorthMod = 0.3;
+    i_runlist.fmaxradius = 1.8;
+    
+    unsigned int i_nfailed = 0;
+    for( unsigned int t = 0; t < iNTests; t++ )
+    {
+        int nx = 40 + ( t % 7 ) * 10;
+        int ny = nx + t % 3;
+        double R[3] = { 0.05 + 0.01 * t, 0.1, 0.3 + 0.003 * t };
+        double W[3] = { 1., 0.3, 1. };
+        
+        // method 0: event by event; method 1: from event lists
+        TH2D* h_stereo[2];
+        TH2D* h_alpha[2];
+        TH1D* h_ratio[2];
+        VStereoMaps* i_maps[2];
+        for( unsigned int m = 0; m < 2; m++ )
+        {
+            char hname[200];
+            sprintf( hname, "hstereo_%u_%u", t, m );
+            h_stereo[m] = new TH2D( hname, "", nx, -2., 2., ny, -2., 2. );
+            sprintf( hname, "halpha_%u_%u", t, m );
+            h_alpha[m] = new TH2D( hname, "", nx, -2., 2., ny, -2., 2. );
+            sprintf( hname, "hratio_%u_%u", t, m );
+            h_ratio[m] = new TH1D( hname, "", 10, 0., 2.5 );
+            // anasum maps are Sumw2'd (see VStereoHistograms)
+            if( t % 2 == 0 )
+            {
+                h_stereo[m]->Sumw2();
+                h_alpha[m]->Sumw2();
+                h_ratio[m]->Sumw2();
+            }
+            i_maps[m] = new VStereoMaps( false, 0, false );
+            i_maps[m]->setRunList( i_runlist );
+            i_maps[m]->setHistograms( h_stereo[m], h_alpha[m], h_ratio[m] );
+            i_maps[m]->setCorrelatedMapsFromEventList( m == 1 );
+        }
+        
+        unsigned int i_nevents = ( t % 4 < 2 ? 50 : 20000 );
+        for( unsigned int e = 0; e < i_nevents; e++ )
+        {
+            double x = i_random.Uniform( -2.2, 2.2 );
+            double y = i_random.Uniform( -2.2, 2.2 );
+            // events on bin edges
+            if( e % 10 == 0 )
+            {
+                x = -2. + 4. / ( double )nx * ( double )( e % nx );
+            }
+            unsigned int k = e % 3;
+            for( unsigned int m = 0; m < 2; m++ )
+            {
+                VStereoMapsTest::fill( i_maps[m], x, y, W[k], R[k], 1. + k );
+            }
+        }
+        i_maps[1]->fillCorrelatedMaps();
+        
+        unsigned int i_diff = compareHistograms( h_stereo[0], h_stereo[1] );
+        i_diff += compareHistograms( h_alpha[0], h_alpha[1] );
+        i_diff += compareHistograms( h_ratio[0], h_ratio[1] );
+        cout << "\t map " << t << " (" << nx << "x" << ny << " bins, " << i_nevents << " events";
+        cout << ( t % 2 == 0 ? ", Sumw2" : "" ) << "): differences " << i_diff << endl;
+        if( i_diff > 0 )
+        {
+            i_nfailed++;
+        }
+        
+        for( unsigned int m = 0; m < 2; m++ )
+        {
+            delete i_maps[m];
+            delete h_stereo[m];
+            delete h_alpha[m];
+            delete h_ratio[m];
+        }
+    }
+    
+    if( i_nfailed > 0 )
+    {
+        cout << endl << "error: correlated maps from event lists differ from event by event filling (" << i_nfailed << " maps)" << endl;
+        exit( EXIT_FAILURE );
+    }
+    cout << endl << "all maps identical" << endl;
+    
+    return 0;
+}
@@ -0,0 +1,330 @@
+/*! \file testTableCalculator.cpp
+ *  \brief test and benchmark lookup table reading of mscw_energy
+ *
+ *  replays the events of a mscw_energy output file (image parameters of all
+ *  images per event) through the mscw, mscl and energy lookup tables of one
+ *  table directory and reports the number of events per second for the two
+ *  table reading paths of mscw_energy (see VTableLookup::getTables()):
+ *
+ *  - histogram interpolation in VTableCalculator::calc() (used if tables
+ *    cannot be compiled)
+ *  - compiled tables (default): expected values interpolated for all
+ *    telescopes in VTableLookupCompiled (as in VTableLookup::fillTableValues())
+ *    and passed to VTableCalculator::calc() with setTableValues()
+ *
+ *  results of both methods are compared event by event
+ *
+ *  example:
+ *
+ *  ./testTableCalculator 64080.mscw.root table.root tel_1/NOISE_00200/ze_200/woff_0500/az_0 10
+ *
+ */
+
+#include <chrono>
+#include <iostream>
+#include <stdlib.h>
+#include <string>
+#include <vector>
+
+#include "TDirectory.h"
+#include "TFile.h"
+#include "TMath.h"
+#include "TTree.h"
+
+#include "VGlobalRunParameter.h"
+#include "VTableCalculator.h"
+#include "VTableLookupCompiled.h"
+
+using namespace std;
+
+/*
+ * recorded event stream (image parameters of all events in contiguous arrays)
+ */
+struct sEventStream
+{
+    vector< unsigned int > fFirstImage;   // [event]
+    vector< unsigned int > fNImages;      // [event]
+    vector< double > fR;                  // [image]
+    vector< double > fSize;
+    vector< double > fLoss;
+    vector< double > fDist;
+    vector< double > fWidth;
+    vector< double > fLength;
+};
+
+struct sTableResults
+{
+    vector< double > fMSCW;
+    vector< double > fMSCL;
+    vector< double > fEnergy;
+    vector< double > fEChi2;
+    vector< double > fdE;
+};
+
+/*
+ * read image parameters of all events from a mscw_energy output file
+ */
+bool readEventStream( string iFile, sEventStream& iS )
+{
+    TFile iF( iFile.c_str() );
+    if( iF.IsZombie() )
+    {
+        cout << "error opening mscw_energy file " << iFile << endl;
+        return false;
+    }
+    TTree* t = ( TTree* )iF.Get( "data" );
+    if( !t )
+    {
+        cout << "error: data tree not found in " << iFile << endl;
+        return false;
+    }
+    Int_t NImages = 0;
+    Double_t R[VDST_MAXTELESCOPES];
+    Float_t size[VDST_MAXTELESCOPES];
+    Float_t loss[VDST_MAXTELESCOPES];
+    Float_t dist[VDST_MAXTELESCOPES];
+    Float_t width[VDST_MAXTELESCOPES];
+    Float_t length[VDST_MAXTELESCOPES];
+    t->SetBranchStatus( "*", 0 );
+    t->SetBranchStatus( "NImages", 1 );
+    t->SetBranchStatus( "R", 1 );
+    t->SetBranchStatus( "size", 1 );
+    t->SetBranchStatus( "loss", 1 );
+    t->SetBranchStatus( "dist", 1 );
+    t->SetBranchStatus( "width", 1 );
+    t->SetBranchStatus( "length", 1 );
+    t->SetBranchAddress( "NImages", &NImages );
+    t->SetBranchAddress( "R", R );
+    t->SetBranchAddress( "size", size );
+    t->SetBranchAddress( "loss", loss );
+    t->SetBranchAddress( "dist", dist );
+    t->SetBranchAddress( "width", width );
+    t->SetBranchAddress( "length", length );
+
+    for( Long64_t i = 0; i < t->GetEntries(); i++ )
+    {
+        t->GetEntry( i );
+        if( NImages <= 0 || NImages > VDST_MAXTELESCOPES )
+        {
+            continue;
+        }
+        iS.fFirstImage.push_back( iS.fR.size() );
+        iS.fNImages.push_back( NImages );
+        for( int j = 0; j < NImages; j++ )
+        {
+            iS.fR.push_back( R[j] );
+            iS.fSize.push_back( size[j] );
+            iS.fLoss.push_back( loss[j] );
+            iS.fDist.push_back( dist[j] );
+            iS.fWidth.push_back( width[j] );
+            iS.fLength.push_back( length[j] );
+        }
+    }
+    iF.Close();
+    cout << "read " << iS.fNImages.size() << " events with " << iS.fR.size() << " images from " << iFile << endl;
+
+    return ( iS.fNImages.size() > 0 );
+}
+
+/*
+ * lookup tables of one type compiled into contiguous arrays
+ * (see VTableCalculatorData::compile())
+ */
+struct sCompiledTable
+{
+    VTableLookupCompiled fTable;
+    int fTableID;
+    vector< double > fMedian;             // [telescope]
+    vector< double > fSigma;              // [telescope]
+};
+
+/*
+ * replay all events through the mscw, mscl and energy tables
+ *
+ * tables are read by histogram interpolation (iCompiled == 0) or
+ * from the compiled tables (as in VTableLookup::fillTableValues())
+ *
+ * (energies are calculated here from the image size)
+ */
+void replayEventStream( sEventStream& iS, VTableCalculator** iCalc, sCompiledTable* iCompiled,
+                        sTableResults& iR, vector< double >& iMT, vector< double >& iST )
+{
+    unsigned int nevents = iS.fNImages.size();
+    iR.fMSCW.resize( nevents );
+    iR.fMSCL.resize( nevents );
+    iR.fEnergy.resize( nevents );
+    iR.fEChi2.resize( nevents );
+    iR.fdE.resize( nevents );
+    iMT.resize( VDST_MAXTELESCOPES );
+    iST.resize( VDST_MAXTELESCOPES );
+    double i_dummy = 0.;
+    for( unsigned int e = 0; e < nevents; e++ )
+    {
+        unsigned int i = iS.fFirstImage[e];
+        int n = ( int )iS.fNImages[e];
+        if( iCompiled )
+        {
+            for( int tel = 0; tel < n; tel++ )
+            {
+                bool bValid = ( iS.fR[i + tel] >= 0. && iS.fSize[i + tel] > 0. );
+                double i_logs = ( bValid ? log10( iS.fSize[i + tel] ) : 0. );
+                for( unsigned int t = 0; t < 3; t++ )
+                {
+                    if( bValid )
+                    {
+                        iCompiled[t].fTable.interpolate( iCompiled[t].fTableID, i_logs, iS.fR[i + tel],
+                                                         iCompiled[t].fMedian[tel], iCompiled[t].fSigma[tel] );
+                    }
+                    else
+                    {
+                        iCompiled[t].fMedian[tel] = 0.;
+                        iCompiled[t].fSigma[tel] = 0.;
+                    }
+                }
+            }
+            for( unsigned int t = 0; t < 3; t++ )
+            {
+                iCalc[t]->setTableValues( &iCompiled[t].fMedian[0], &iCompiled[t].fSigma[0] );
+            }
+        }
+        iR.fMSCW[e] = iCalc[0]->calc( n, &iS.fR[i], &iS.fSize[i], &iS.fLoss[i], &iS.fDist[i], &iS.fWidth[i],
+                                      &iMT[0], i_dummy, i_dummy, &iST[0] );
+        iR.fMSCL[e] = iCalc[1]->calc( n, &iS.fR[i], &iS.fSize[i], &iS.fLoss[i], &iS.fDist[i], &iS.fLength[i],
+                                      &iMT[0], i_dummy, i_dummy, &iST[0] );
+        iR.fEnergy[e] = iCalc[2]->calc( n, &iS.fR[i], &iS.fSize[i], &iS.fLoss[i], &iS.fDist[i], 0,
+                                        &iMT[0], iR.fEChi2[e], iR.fdE[e], &iST[0] );
+    }
+}
+
+bool isDifferent( double a, double b )
+{
+    return ( TMath::Abs( a - b ) > 1.e-5 * TMath::Max( 1., TMath::Abs( a ) ) );
+}
+
+unsigned int compareResults( sTableResults& a, sTableResults& b )
+{
+    unsigned int n = 0;
+    for( unsigned int e = 0; e < a.fMSCW.size(); e++ )
+    {
+        if( isDifferent( a.fMSCW[e], b.fMSCW[e] ) || isDifferent( a.fMSCL[e], b.fMSCL[e] )
+                || isDifferent( a.fEnergy[e], b.fEnergy[e] ) || isDifferent( a.fEChi2[e], b.fEChi2[e] )
+                || isDifferent( a.fdE[e], b.fdE[e] ) )
+        {
+            n++;
+        }
+    }
+    return n;
+}
+
+int main( int argc, char* argv[] )
+{
+    if( argc < 4 )
+    {
+        cout << "./testTableCalculator <mscw_energy file> <lookup table file> <table directory> [number of replays (default=10)]" << endl;
+        cout << endl;
+        cout << "   table directory: e.g. tel_1/NOISE_00200/ze_200/woff_0500/az_0" << endl;
+        exit( EXIT_FAILURE );
+    }
+    unsigned int iNReplays = 10;
+    if( argc > 4 )
+    {
+        iNReplays = atoi( argv[4] );
+    }
+    if( iNReplays == 0 )
+    {
+        iNReplays = 1;
+    }
+
+    sEventStream i_events;
+    if( !readEventStream( argv[1], i_events ) )
+    {
+        exit( EXIT_FAILURE );
+    }
+
+    TFile iTableFile( argv[2] );
+    if( iTableFile.IsZombie() )
+    {
+        cout << "error opening lookup table file " << argv[2] << endl;
+        exit( EXIT_FAILURE );
+    }
+    TDirectory* iTableDir = ( TDirectory* )iTableFile.Get( argv[3] );
+    if( !iTableDir )
+    {
+        cout << "error: table directory " << argv[3] << " not found in " << argv[2] << endl;
+        exit( EXIT_FAILURE );
+    }
+
+    vector< double > i_mt;
+    vector< double > i_st;
+    sTableResults i_resultsHistogram;
+    sTableResults i_resultsCompiled;
+    double i_tHistogram = 0.;
+
+    // method 0: histogram interpolation; method 1: compiled tables
+    bool bFailed = false;
+    for( unsigned int m = 0; m < 2; m++ )
+    {
+        VTableCalculator i_mscw( "width", "tb", false, ( TDirectory* )iTableDir->Get( "mscw" ), false );
+        VTableCalculator i_mscl( "length", "tb", false, ( TDirectory* )iTableDir->Get( "mscl" ), false );
+        VTableCalculator i_energy( "energySR", "tb", false, ( TDirectory* )iTableDir->Get( "energySR" ), true );
+        VTableCalculator* i_calc[3] = { &i_mscw, &i_mscl, &i_energy };
+        sCompiledTable i_compiled[3];
+        for( unsigned int t = 0; t < 3; t++ )
+        {
+            // (histogram interpolation: tables are read by calc())
+            if( m == 1 )
+            {
+                i_compiled[t].fTableID = i_compiled[t].fTable.addTable( i_calc[t]->getHistoMedian() );
+                if( i_compiled[t].fTableID < 0 )
+                {
+                    cout << "error: table cannot be compiled (missing table or variable bin widths)" << endl;
+                    exit( EXIT_FAILURE );
+                }
+                i_compiled[t].fMedian.assign( VDST_MAXTELESCOPES, 0. );
+                i_compiled[t].fSigma.assign( VDST_MAXTELESCOPES, 0. );
+            }
+        }
+
+        sTableResults* i_results = ( m == 0 ? &i_resultsHistogram : &i_resultsCompiled );
+
+        // first pass: read tables and fill scratch buffers (not timed)
+        replayEventStream( i_events, i_calc, ( m == 1 ? i_compiled : 0 ), *i_results, i_mt, i_st );
+
+        auto i_start = chrono::steady_clock::now();
+        for( unsigned int r = 0; r < iNReplays; r++ )
+        {
+            replayEventStream( i_events, i_calc, ( m == 1 ? i_compiled : 0 ), *i_results, i_mt, i_st );
+        }
+        double i_t = chrono::duration< double >( chrono::steady_clock::now() - i_start ).count();
+        double i_rate = ( i_t > 0. ? ( double )( i_events.fNImages.size() * iNReplays ) / i_t : 0. );
+        if( m == 0 )
+        {
+            i_tHistogram = i_t;
+            cout << "\t histogram interpolation: " << i_rate << " events/s" << endl;
+        }
+        else
+        {
+            unsigned int i_diff = compareResults( i_resultsHistogram, i_resultsCompiled );
+            cout << "\t compiled tables:         " << i_rate << " events/s";
+            if( i_t > 0. )
+            {
+                cout << " (speed up " << i_tHistogram / i_t << ")";
+            }
+            cout << ", events with different results: " << i_diff << endl;
+            if( i_diff > 0 )
+            {
+                bFailed = true;
+            }
+        }
+    }
+    iTableFile.Close();
+
+    if( bFailed )
+    {
+        cout << endl << "error: histogram and array interpolation give different results" << endl;
+        exit( EXIT_FAILURE );
+    }
+    cout << endl << "all results identical" << endl;
+
+    return 0;
+}
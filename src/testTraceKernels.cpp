@@ -0,0 +1,323 @@
+/*! \file testTraceKernels.cpp
+ *  \brief test and benchmark vectorized trace kernels
+ *
+ *  compares trace sums (fixed window), average times and trace maxima
+ *  of VTraceKernels with the per-channel code in VTraceHandler
+ *  for VERITAS (499 pixel) and CTA (1855, 2048 pixel) camera sizes
+ *
+ *  image moments (Hillas parameters) must be identical for all instruction
+ *  sets; differences to a sum in pixel order are rounding only
+ *
+ */
+
+#include <chrono>
+#include <iostream>
+#include <stdint.h>
+#include <stdlib.h>
+#include <vector>
+
+#include "TMath.h"
+#include "TRandom3.h"
+
+#include "VTraceHandler.h"
+#include "VTraceKernels.h"
+
+using namespace std;
+
+struct sTraceResults
+{
+    vector< double > fSum;
+    vector< double > fTime;
+    vector< double > fMax;
+    vector< unsigned int > fMaxPos;
+};
+
+/*
+ * fill random traces: pedestal + noise + pulse in some channels
+ */
+void fillTraces( vector< vector< uint16_t > >& iTraces, vector< double >& iPed,
+                 unsigned int iNChannels, unsigned int iNSamples, TRandom3& iRandom )
+{
+    iTraces.assign( iNChannels, vector< uint16_t >( iNSamples, 0 ) );
+    iPed.assign( iNChannels, 0. );
+    for( unsigned int c = 0; c < iNChannels; c++ )
+    {
+        iPed[c] = iRandom.Gaus( 15., 1. );
+        double i_amplitude = 0.;
+        double i_t0 = iRandom.Uniform( 0., ( double )iNSamples );
+        if( iRandom.Uniform() < 0.2 )
+        {
+            i_amplitude = iRandom.Exp( 50. );
+        }
+        for( unsigned int i = 0; i < iNSamples; i++ )
+        {
+            double t = iRandom.Gaus( iPed[c], 2. );
+            t += i_amplitude * TMath::Gaus( ( double )i, i_t0, 1.5 );
+            // some zero samples (zero suppressed)
+            if( c % 17 == 0 || t < 0. )
+            {
+                t = 0.;
+            }
+            iTraces[c][i] = ( uint16_t )t;
+        }
+    }
+}
+
+/*
+ * per-channel reference (VTraceHandler)
+ */
+void analyseTraces_perChannel( vector< vector< uint16_t > >& iTraces, vector< double >& iPed,
+                               unsigned int iFirst, unsigned int iLast, sTraceResults& iR )
+{
+    VTraceHandler i_traceHandler;
+    unsigned int nch = iTraces.size();
+    iR.fSum.resize( nch );
+    iR.fTime.resize( nch );
+    iR.fMax.resize( nch );
+    iR.fMaxPos.resize( nch );
+    unsigned int n255 = 0;
+    for( unsigned int c = 0; c < nch; c++ )
+    {
+        i_traceHandler.setTrace( iTraces[c], iPed[c], c );
+        i_traceHandler.setTraceIntegrationmethod( 1 );
+        iR.fSum[c] = i_traceHandler.getTraceSum( iFirst, iLast, false );
+        iR.fTime[c] = i_traceHandler.getTraceAverageTime();
+        iR.fMax[c] = i_traceHandler.getTraceMax( n255, iR.fMaxPos[c] );
+    }
+}
+
+/*
+ * vectorized kernels (transpose to sample-major layout, then all channels at once)
+ */
+void analyseTraces_kernels( vector< vector< uint16_t > >& iTraces, vector< double >& iPed,
+                            unsigned int iFirst, unsigned int iLast, sTraceResults& iR,
+                            vector< double >& iTraceBlock, vector< double >& iTCharge )
+{
+    unsigned int nch = iTraces.size();
+    unsigned int ns = iTraces[0].size();
+    iTraceBlock.resize( nch * ns );
+    iTCharge.resize( nch );
+    iR.fSum.resize( nch );
+    iR.fTime.resize( nch );
+    iR.fMax.resize( nch );
+    iR.fMaxPos.resize( nch );
+    for( unsigned int c = 0; c < nch; c++ )
+    {
+        for( unsigned int i = 0; i < ns; i++ )
+        {
+            iTraceBlock[i * nch + c] = ( double )iTraces[c][i];
+        }
+    }
+    VTraceKernels::fixedWindowSums( &iTraceBlock[0], nch, nch, iFirst, iLast, &iPed[0], false, &iR.fSum[0], &iTCharge[0] );
+    VTraceKernels::traceMax( &iTraceBlock[0], nch, nch, 0, ns, &iR.fMax[0], &iR.fMaxPos[0] );
+    for( unsigned int c = 0; c < nch; c++ )
+    {
+        iR.fTime[c] = 0.;
+        if( TMath::IsNaN( iR.fSum[c] ) || TMath::Abs( iR.fSum[c] ) < 1.e-10 )
+        {
+            iR.fSum[c] = 0.;
+        }
+        else
+        {
+            iR.fTime[c] = iTCharge[c] / iR.fSum[c];
+        }
+        iR.fMax[c] -= iPed[c];
+    }
+}
+
+/*
+ * random image: pixel positions, signals and image/border pixel mask
+ */
+void fillImage( vector< double >& iX, vector< double >& iY, vector< double >& iSignal, vector< unsigned char >& iMask,
+                unsigned int iNPixel, TRandom3& iRandom )
+{
+    iX.resize( iNPixel );
+    iY.resize( iNPixel );
+    iSignal.resize( iNPixel );
+    iMask.resize( iNPixel );
+    double i_cx = iRandom.Uniform( -1., 1. );
+    double i_cy = iRandom.Uniform( -1., 1. );
+    for( unsigned int i = 0; i < iNPixel; i++ )
+    {
+        iX[i] = iRandom.Uniform( -2., 2. );
+        iY[i] = iRandom.Uniform( -2., 2. );
+        iSignal[i] = iRandom.Gaus( 0., 5. );
+        iMask[i] = 0;
+        if( ( iX[i] - i_cx ) * ( iX[i] - i_cx ) + ( iY[i] - i_cy ) * ( iY[i] - i_cy ) < 0.3 )
+        {
+            iSignal[i] += iRandom.Exp( 100. );
+            iMask[i] = 1;
+        }
+    }
+}
+
+/*
+ * image moments as sum in pixel order (reference) and sum of absolute values
+ */
+void imageMoments_pixelOrder( vector< double >& iX, vector< double >& iY, vector< double >& iSignal, vector< unsigned char >& iMask,
+                              double* iMoments, double* iAbsMoments )
+{
+    for( unsigned int m = 0; m < 10; m++ )
+    {
+        iMoments[m] = 0.;
+        iAbsMoments[m] = 0.;
+    }
+    for( unsigned int i = 0; i < iX.size(); i++ )
+    {
+        if( !iMask[i] )
+        {
+            continue;
+        }
+        double x = iX[i];
+        double y = iY[i];
+        double s = iSignal[i];
+        double t[10] = { s, s * x, s * y, s * x * x, s * y * y, s * x * y, s * x * x * x, s * y * y * y, s * x * x * y, s * y * y * x };
+        for( unsigned int m = 0; m < 10; m++ )
+        {
+            iMoments[m] += t[m];
+            iAbsMoments[m] += TMath::Abs( t[m] );
+        }
+    }
+}
+
+unsigned int compareResults( sTraceResults& a, sTraceResults& b )
+{
+    unsigned int n = 0;
+    for( unsigned int c = 0; c < a.fSum.size(); c++ )
+    {
+        if( a.fSum[c] != b.fSum[c] || a.fTime[c] != b.fTime[c]
+                || a.fMax[c] != b.fMax[c] || a.fMaxPos[c] != b.fMaxPos[c] )
+        {
+            n++;
+        }
+    }
+    return n;
+}
+
+int main( int argc, char* argv[] )
+{
+    unsigned int iNEvents = 2000;
+    unsigned int iNSamples = 64;
+    if( argc > 1 )
+    {
+        iNEvents = atoi( argv[1] );
+    }
+    if( argc > 2 )
+    {
+        iNSamples = atoi( argv[2] );
+    }
+    if( argc > 3 || iNEvents == 0 || iNSamples < 8 )
+    {
+        cout << "./testTraceKernels [number of events (default=2000)] [number of samples (default=64, >=8)]" << endl;
+        exit( EXIT_FAILURE );
+    }
+    cout << "best instruction set on this CPU: " << VTraceKernels::getInstructionSetName( VTraceKernels::getBestInstructionSet() ) << endl;
+    unsigned int iBestSet = VTraceKernels::getBestInstructionSet();
+
+    vector< unsigned int > iCameraSize;
+    iCameraSize.push_back( 499 );
+    iCameraSize.push_back( 1855 );
+    iCameraSize.push_back( 2048 );
+
+    unsigned int iFirst = 2;
+    unsigned int iLast = iNSamples / 2 + 2;
+
+    // fixed seed: test failures must be reproducible
+    TRandom3 i_random( 42 );
+    vector< vector< uint16_t > > i_traces;
+    vector< double > i_ped;
+    vector< double > i_traceBlock;
+    vector< double > i_tcharge;
+    sTraceResults i_resultsChannel;
+    sTraceResults i_resultsKernel;
+    vector< double > i_x;
+    vector< double > i_y;
+    vector< double > i_signal;
+    vector< unsigned char > i_mask;
+    double i_moments[3][10];
+    double i_momentsPixelOrder[10];
+    double i_absMoments[10];
+
+    bool bFailed = false;
+    for( unsigned int t = 0; t < iCameraSize.size(); t++ )
+    {
+        cout << endl;
+        cout << "camera with " << iCameraSize[t] << " pixels, " << iNSamples << " samples, ";
+        cout << iNEvents << " events (summation window [" << iFirst << ", " << iLast << "))" << endl;
+        fillTraces( i_traces, i_ped, iCameraSize[t], iNSamples, i_random );
+
+        // per-channel code
+        auto i_start = chrono::steady_clock::now();
+        for( unsigned int e = 0; e < iNEvents; e++ )
+        {
+            analyseTraces_perChannel( i_traces, i_ped, iFirst, iLast, i_resultsChannel );
+        }
+        double i_tChannel = chrono::duration< double, micro >( chrono::steady_clock::now() - i_start ).count() / iNEvents;
+        cout << "\t per channel (VTraceHandler): " << i_tChannel << " us/event" << endl;
+
+        // kernels for all instruction sets
+        for( unsigned int s = 0; s <= iBestSet; s++ )
+        {
+            VTraceKernels::setInstructionSet( s );
+            i_start = chrono::steady_clock::now();
+            for( unsigned int e = 0; e < iNEvents; e++ )
+            {
+                analyseTraces_kernels( i_traces, i_ped, iFirst, iLast, i_resultsKernel, i_traceBlock, i_tcharge );
+            }
+            double i_tKernel = chrono::duration< double, micro >( chrono::steady_clock::now() - i_start ).count() / iNEvents;
+            unsigned int i_diff = compareResults( i_resultsChannel, i_resultsKernel );
+            cout << "\t kernel (" << VTraceKernels::getInstructionSetName( s ) << "): " << i_tKernel << " us/event";
+            cout << " (speed up " << i_tChannel / i_tKernel << "), ";
+            cout << "channels with different results: " << i_diff << endl;
+            if( i_diff > 0 )
+            {
+                bFailed = true;
+            }
+        }
+        VTraceKernels::setInstructionSet( iBestSet );
+
+        // image moments
+        unsigned int i_ndiff = 0;
+        double i_maxRelDiff = 0.;
+        for( unsigned int e = 0; e < 200; e++ )
+        {
+            fillImage( i_x, i_y, i_signal, i_mask, iCameraSize[t], i_random );
+            imageMoments_pixelOrder( i_x, i_y, i_signal, i_mask, i_momentsPixelOrder, i_absMoments );
+            for( unsigned int s = 0; s <= iBestSet; s++ )
+            {
+                VTraceKernels::setInstructionSet( s );
+                VTraceKernels::imageMoments( &i_x[0], &i_y[0], &i_signal[0], &i_mask[0], iCameraSize[t], ( e % 2 == 1 ), i_moments[s] );
+            }
+            for( unsigned int m = 0; m < 10; m++ )
+            {
+                for( unsigned int s = 1; s <= iBestSet; s++ )
+                {
+                    if( i_moments[s][m] != i_moments[0][m] )
+                    {
+                        i_ndiff++;
+                    }
+                }
+                if( e % 2 == 0 && i_absMoments[m] > 0. )
+                {
+                    i_maxRelDiff = TMath::Max( i_maxRelDiff, TMath::Abs( i_moments[0][m] - i_momentsPixelOrder[m] ) / i_absMoments[m] );
+                }
+            }
+        }
+        VTraceKernels::setInstructionSet( iBestSet );
+        cout << "\t image moments: differences between instruction sets " << i_ndiff;
+        cout << ", maximum difference to sum in pixel order (relative to sum of absolute values) " << i_maxRelDiff << endl;
+        if( i_ndiff > 0 || i_maxRelDiff > 1.e-12 )
+        {
+            bFailed = true;
+        }
+    }
+
+    if( bFailed )
+    {
+        cout << endl << "error: kernels and per-channel code give different results (or image moments differ)" << endl;
+        exit( EXIT_FAILURE );
+    }
+    cout << endl << "all results identical" << endl;
+
+    return 0;
+}